@@ -1,6 +1,9 @@
 // Base adapter class - interface for exchange connections with callback system
 
-import { Trade, OrderBook, Ticker, SymbolInfo, AssetType, MarketDataAdapter } from '../types';
+import { Trade, TradeHistory, OrderBook, OrderBookDelta, Ticker, SymbolInfo, AssetType, MarketDataAdapter } from '../types';
+
+// Longest a subscribe will hold out for the symbol's backfill
+const HISTORY_WAIT_MS = 5000;
 
 export abstract class BaseAdapter implements MarketDataAdapter {
   abstract name: string;
@@ -12,11 +15,16 @@ export abstract class BaseAdapter implements MarketDataAdapter {
   // Callback arrays for each event type
   private tradeCallbacks: ((trade: Trade) => void)[] = [];
   private orderBookCallbacks: ((orderBook: OrderBook) => void)[] = [];
+  private orderBookDeltaCallbacks: ((delta: OrderBookDelta) => void)[] = [];
   private tickerCallbacks: ((ticker: Ticker) => void)[] = [];
+  private historyCallbacks: ((history: TradeHistory) => void)[] = [];
   private errorCallbacks: ((error: Error) => void)[] = [];
   private connectCallbacks: (() => void)[] = [];
   private disconnectCallbacks: (() => void)[] = [];
   
+  // Subscribes waiting on a symbol's backfill
+  private historyWaits: Map<string, { promise: Promise<void>; settle: () => void }> = new Map();
+  
   // Reconnection handling
   private reconnectTimer: NodeJS.Timeout | null = null;
   private reconnectAttempts: number = 0;
@@ -30,6 +38,15 @@ export abstract class BaseAdapter implements MarketDataAdapter {
   abstract unsubscribe(symbol: string): Promise<void>;
   abstract validateSymbol(symbol: string): Promise<SymbolInfo>;
 
+  // Adapters that don't keep a local book just have nothing to hand out
+  getOrderBook(_symbol: string, _depth: number): OrderBook | null {
+    return null;
+  }
+
+  getBookSnapshot(_symbol: string, _depth: number): OrderBookDelta | null {
+    return null;
+  }
+
   // Register event listeners
   onTrade(callback: (trade: Trade) => void): void {
     this.tradeCallbacks.push(callback);
@@ -39,10 +56,19 @@ export abstract class BaseAdapter implements MarketDataAdapter {
     this.orderBookCallbacks.push(callback);
   }
 
+  onOrderBookDelta(callback: (delta: OrderBookDelta) => void): void {
+    this.orderBookDeltaCallbacks.push(callback);
+  }
+
   onTicker(callback: (ticker: Ticker) => void): void {
     this.tickerCallbacks.push(callback);
   }
 
+  // Trades from before the subscription - for caches, never shown as live prints
+  onHistory(callback: (history: TradeHistory) => void): void {
+    this.historyCallbacks.push(callback);
+  }
+
   onError(callback: (error: Error) => void): void {
     this.errorCallbacks.push(callback);
   }
@@ -64,10 +90,58 @@ export abstract class BaseAdapter implements MarketDataAdapter {
     this.orderBookCallbacks.forEach(cb => cb(orderBook));
   }
 
+  protected emitOrderBookDelta(delta: OrderBookDelta): void {
+    this.orderBookDeltaCallbacks.forEach(cb => cb(delta));
+  }
+
   protected emitTicker(ticker: Ticker): void {
     this.tickerCallbacks.forEach(cb => cb(ticker));
   }
 
+  protected emitHistory(history: TradeHistory): void {
+    this.historyCallbacks.forEach(cb => cb(history));
+    this.settleHistory(history.symbol);
+  }
+
+  /**
+   * Resolves once the symbol's backfill has been emitted (or given up on)
+   * 
+   * subscribe() returns this, so the server only confirms the first
+   * subscriber once the history is in the cache and the tape it gets
+   * starts full. Capped at HISTORY_WAIT_MS - a slow backfill just arrives
+   * too late for that client. A second caller gets the same wait.
+   */
+  protected waitForHistory(symbol: string): Promise<void> {
+    const existing = this.historyWaits.get(symbol);
+    if (existing) return existing.promise;
+    
+    let resolve: () => void = () => {};
+    const promise = new Promise<void>(r => (resolve = r));
+    const timer = setTimeout(() => this.settleHistory(symbol), HISTORY_WAIT_MS);
+    this.historyWaits.set(symbol, {
+      promise,
+      settle: () => {
+        clearTimeout(timer);
+        resolve();
+      },
+    });
+    return promise;
+  }
+
+  /**
+   * The wait for a symbol already being subscribed, if there is one
+   */
+  protected pendingHistory(symbol: string): Promise<void> {
+    return this.historyWaits.get(symbol)?.promise ?? Promise.resolve();
+  }
+
+  protected settleHistory(symbol: string): void {
+    const wait = this.historyWaits.get(symbol);
+    if (!wait) return;
+    this.historyWaits.delete(symbol);
+    wait.settle();
+  }
+
   protected emitError(error: Error): void {
     this.errorCallbacks.forEach(cb => cb(error));
   }
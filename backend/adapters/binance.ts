@@ -1,14 +1,75 @@
 // Binance WebSocket adapter - handles trade, order book, and ticker streams
 
-import WebSocket from 'ws';
 import axios from 'axios';
+import { performance } from 'perf_hooks';
 import { BaseAdapter } from './base';
-import { Trade, OrderBook, Ticker, SymbolInfo, AssetType, OrderBookLevel } from '../types';
+import { Trade, OrderBook, OrderBookDelta, Ticker, SymbolInfo, AssetType } from '../types';
+import { LocalOrderBook } from '../services/orderBookEngine';
+import { parseTradeFrame } from './binanceParser';
+import { BinanceShard } from './binanceShard';
+import { metrics } from '../services/metrics';
 
 interface BinanceConfig {
   apiKey?: string;
   apiSecret?: string;
   testnet?: boolean;
+  maxShards?: number;         // Upper bound on concurrent stream connections
+  symbolsPerShard?: number;   // Open another shard before one carries more than this
+  exchangeInfoRefreshMs?: number;   // How often the cached symbol list is refreshed
+}
+
+// Binance rejects more than 1024 streams on one connection - stay well under
+const MAX_STREAMS_PER_SHARD = 300;
+
+// How often shard/symbol rates are sampled, and how often we consider moving a symbol
+const RATE_SAMPLE_MS = 1000;
+const REBALANCE_EVERY_SAMPLES = 30;
+
+// Only rebalance when the hottest shard is this much busier than the coolest
+const REBALANCE_RATIO = 2;
+const REBALANCE_MIN_DIFF = 50;   // frames/sec
+
+// REST snapshot depth used to seed the local book (weight 50 on Binance)
+const DEPTH_SNAPSHOT_LIMIT = 1000;
+
+// Recent trades fetched on subscribe to backfill the tape (the endpoint's maximum, weight 2)
+const HISTORY_TRADES_LIMIT = 1000;
+const HISTORY_TIMEOUT_MS = 3000;
+
+// Levels in the 'orderbook' snapshots we emit for clients that don't take deltas
+const TOP_LEVELS = 20;
+
+// Per frame: 'trade' is the Buffer fast path, parse only; 'json' is everything
+// else, where parsing and handling are one step (depth diffs applied included)
+const parseSeconds = metrics.histogram('tapeflow_binance_parse_seconds', 'Binance frame parse time', 'path');
+const duplicateTrades = metrics.counter('tapeflow_binance_duplicate_trades_total', 'Trades dropped as already emitted (a symbol moving between shards)');
+
+// Back off a little before refetching a snapshot that was already stale
+const RESYNC_RETRY_MS = 250;
+
+// The full exchangeInfo costs weight 20 once; per-symbol lookups cost weight
+// on every validate. It changes rarely, so refresh it in the background.
+const EXCHANGE_INFO_REFRESH_MS = 60 * 60 * 1000;
+
+interface ExchangeSymbol {
+  baseAsset: string;
+  quoteAsset: string;
+  status: string;
+}
+
+/**
+ * Sync state for one symbol's diff-depth stream
+ * 
+ * Until the REST snapshot lands, diff events are buffered. Once synced,
+ * every event must pick up exactly where the last one left off (U <= last u + 1);
+ * anything else means we dropped something and have to start over.
+ */
+interface DepthSync {
+  book: LocalOrderBook;
+  buffered: any[];
+  synced: boolean;
+  fetching: boolean;
+  emittedSeq: number;   // seq of the last delta we emitted - the next one's prevSeq
 }
 
 export class BinanceAdapter extends BaseAdapter {
@@ -16,11 +77,30 @@ export class BinanceAdapter extends BaseAdapter {
   supportedAssetTypes: AssetType[] = ['crypto'];
   
   private config: BinanceConfig;
-  private ws: WebSocket | null = null;
   private baseUrl: string;
   private wsBaseUrl: string;
-  private streamId: number = 1;  // Binance uses IDs to match sub/unsub responses
-  private subscribedStreams: Set<string> = new Set();
+  private depthSyncs: Map<string, DepthSync> = new Map();
+  
+  // Shard pool - each symbol's streams live on exactly one connection
+  private shards: BinanceShard[] = [];
+  private symbolShards: Map<string, BinanceShard> = new Map();
+  private nextShardId: number = 1;
+  private maxShards: number;
+  private symbolsPerShard: number;
+  
+  // Per-symbol frame counts, folded into smoothed rates every RATE_SAMPLE_MS
+  private symbolCounts: Map<string, number> = new Map();
+  private symbolRates: Map<string, number> = new Map();
+  
+  // Highest trade id emitted per symbol - Binance ids only go up
+  private lastTradeIds: Map<string, number> = new Map();
+  private rateTimer: NodeJS.Timeout | null = null;
+  private rateSamples: number = 0;
+  
+  // Every symbol's status from exchangeInfo - null until the first load lands
+  private exchangeInfo: Map<string, ExchangeSymbol> | null = null;
+  private exchangeInfoLoad: Promise<void> | null = null;
+  private exchangeInfoTimer: NodeJS.Timeout | null = null;
 
   constructor(config: BinanceConfig = {}) {
     super();
@@ -35,52 +115,203 @@ export class BinanceAdapter extends BaseAdapter {
     this.wsBaseUrl = config.testnet
       ? 'wss://testnet.binance.vision/stream'
       : 'wss://stream.binance.com:9443/stream';
+    
+    this.maxShards = Math.max(1, config.maxShards ?? 4);
+    this.symbolsPerShard = Math.max(1, config.symbolsPerShard ?? 20);
   }
 
   /**
-   * Open WebSocket connection to Binance
+   * Open the first stream connection to Binance
    * 
-   * We connect to the combined stream endpoint and wait for the socket to open.
-   * Individual symbol subscriptions are sent after the connection is established.
+   * More shards are opened on demand as symbols are added. Each shard is a
+   * combined-stream socket with its own reconnect loop; the adapter counts as
+   * connected while at least one of them is open.
    */
   async connect(): Promise<void> {
     console.log('[Binance] Connecting...');
     
-    return new Promise((resolve, reject) => {
-      this.ws = new WebSocket(this.wsBaseUrl);
-      
-      this.ws.on('open', () => {
-        console.log('[Binance] WebSocket opened');
-        this.emitConnect();
-        resolve();
-      });
-
-      this.ws.on('message', (data: Buffer) => {
-        this.handleMessage(data.toString());
-      });
-
-      this.ws.on('error', (error: Error) => {
-        console.error('[Binance] WebSocket error:', error);
-        this.emitError(error);
-        reject(error);
-      });
+    const shard = this.shards[0] ?? this.createShard();
+    if (!this.rateTimer) {
+      this.rateTimer = setInterval(() => this.sampleRates(), RATE_SAMPLE_MS);
+    }
+    if (!this.exchangeInfoTimer) {
+      this.loadExchangeInfo();
+      this.exchangeInfoTimer = setInterval(
+        () => this.loadExchangeInfo(),
+        this.config.exchangeInfoRefreshMs ?? EXCHANGE_INFO_REFRESH_MS
+      );
+      this.exchangeInfoTimer.unref();
+    }
+    await shard.connect();
+  }
 
-      this.ws.on('close', () => {
-        console.log('[Binance] WebSocket closed');
-        this.emitDisconnect();
-        // Try to reconnect if we didn't intentionally disconnect
-        if (this.connected) {
-          this.attemptReconnect();
+  private createShard(): BinanceShard {
+    const shard = new BinanceShard(this.nextShardId++, this.wsBaseUrl, {
+      onFrame: (data) => this.handleFrame(data),
+      onOpen: () => {
+        if (!this.connected) this.emitConnect();
+      },
+      onClose: (closed) => {
+        // Diffs for this shard's symbols are gone - their books need a fresh snapshot
+        for (const symbol of closed.symbols) {
+          const sync = this.depthSyncs.get(symbol);
+          if (sync) this.resetDepthSync(sync);
         }
-      });
-
-      // Don't hang forever if connection fails
-      setTimeout(() => {
-        if (!this.connected) {
-          reject(new Error('Connection timeout'));
+        if (this.connected && !this.shards.some(s => s.isOpen)) {
+          this.emitDisconnect();
         }
-      }, 10000);
+      },
+      onError: (error) => this.emitError(error),
     });
+    this.shards.push(shard);
+    return shard;
+  }
+
+  /**
+   * Route one frame from any shard
+   */
+  private handleFrame(data: Buffer): void {
+    const start = performance.now();
+    // Trades are the bulk of the traffic - take them straight off the Buffer
+    const trade = parseTradeFrame(data);
+    if (trade) {
+      parseSeconds.observe((performance.now() - start) / 1000, 'trade');
+      this.countFrame(trade.symbol);
+      this.emitTradeOnce(trade);
+      return;
+    }
+    this.handleMessage(data.toString());
+    parseSeconds.observe((performance.now() - start) / 1000, 'json');
+  }
+
+  private countFrame(symbol: string): void {
+    this.symbolCounts.set(symbol, (this.symbolCounts.get(symbol) ?? 0) + 1);
+  }
+
+  /**
+   * Pick the shard for a new symbol
+   * 
+   * Least busy shard with room, by observed message rate. A new connection is
+   * opened instead once every shard is at symbolsPerShard (or out of streams),
+   * until we hit maxShards - after that the least busy one takes it anyway.
+   */
+  private pickShard(streamCount: number): BinanceShard {
+    let best: BinanceShard | null = null;
+    let fallback: BinanceShard | null = null;
+    
+    for (const shard of this.shards) {
+      const hasStreams = shard.streams.size + streamCount <= MAX_STREAMS_PER_SHARD;
+      if (hasStreams && (!fallback || shard.messageRate < fallback.messageRate)) {
+        fallback = shard;
+      }
+      if (!hasStreams || shard.symbols.size >= this.symbolsPerShard) continue;
+      if (!best || shard.messageRate < best.messageRate ||
+          (shard.messageRate === best.messageRate && shard.symbols.size < best.symbols.size)) {
+        best = shard;
+      }
+    }
+    
+    if (best) return best;
+    if (this.shards.length < this.maxShards || !fallback) {
+      const shard = this.createShard();
+      shard.start();
+      console.log(`[Binance] Opened shard ${shard.id} (${this.shards.length}/${this.maxShards})`);
+      return shard;
+    }
+    return fallback;
+  }
+
+  /**
+   * Fold frame counts into smoothed rates and, every so often, rebalance
+   */
+  private sampleRates(): void {
+    const now = Date.now();
+    for (const shard of this.shards) {
+      shard.sampleRate(now);
+    }
+    
+    for (const symbol of this.symbolShards.keys()) {
+      const count = this.symbolCounts.get(symbol) ?? 0;
+      const rate = (count / RATE_SAMPLE_MS) * 1000;
+      const prev = this.symbolRates.get(symbol) ?? rate;
+      this.symbolRates.set(symbol, prev * 0.7 + rate * 0.3);
+    }
+    this.symbolCounts.clear();
+    
+    if (++this.rateSamples % REBALANCE_EVERY_SAMPLES === 0) {
+      this.rebalance();
+    }
+  }
+
+  /**
+   * Move one symbol from the busiest shard to the quietest if that evens them out
+   * 
+   * A move is unsubscribe-then-subscribe, so the symbol's book resyncs and a
+   * few hundred ms of its trades can be missed, or arrive on both shards
+   * (emitTradeOnce drops the repeats) - which is why we only do it when the
+   * imbalance is large, and one symbol at a time.
+   */
+  private rebalance(): void {
+    const open = this.shards.filter(s => s.isOpen);
+    if (open.length < 2) return;
+    
+    let hottest = open[0];
+    let coolest = open[0];
+    for (const shard of open) {
+      if (shard.messageRate > hottest.messageRate) hottest = shard;
+      if (shard.messageRate < coolest.messageRate) coolest = shard;
+    }
+    
+    const diff = hottest.messageRate - coolest.messageRate;
+    if (hottest.symbols.size < 2 || diff < REBALANCE_MIN_DIFF ||
+        hottest.messageRate < coolest.messageRate * REBALANCE_RATIO) {
+      return;
+    }
+    
+    // The symbol whose rate is closest to half the gap evens things out best
+    let candidate: string | null = null;
+    let bestGap = diff;
+    for (const symbol of hottest.symbols) {
+      const rate = this.symbolRates.get(symbol) ?? 0;
+      if (rate <= 0 || rate >= diff) continue;
+      const gap = Math.abs(diff - 2 * rate);
+      if (gap < bestGap) {
+        bestGap = gap;
+        candidate = symbol;
+      }
+    }
+    
+    if (!candidate || coolest.streams.size + 3 > MAX_STREAMS_PER_SHARD) return;
+    
+    console.log(`[Binance] Rebalancing ${candidate} from shard ${hottest.id} (${hottest.messageRate.toFixed(0)}/s) to shard ${coolest.id} (${coolest.messageRate.toFixed(0)}/s)`);
+    const streams = this.streamsFor(candidate.toLowerCase());
+    hottest.removeSymbol(candidate, streams);
+    coolest.addSymbol(candidate, streams);
+    this.symbolShards.set(candidate, coolest);
+    
+    const sync = this.depthSyncs.get(candidate);
+    if (sync) this.resetDepthSync(sync);
+  }
+
+  private streamsFor(lowerSymbol: string): string[] {
+    return [
+      `${lowerSymbol}@trade`,
+      `${lowerSymbol}@depth@100ms`,
+      `${lowerSymbol}@ticker`,
+    ];
+  }
+
+  /**
+   * Pool stats for /health
+   */
+  getShardStats(): { id: number; open: boolean; symbols: string[]; streams: number; messageRate: number }[] {
+    return this.shards.map(shard => ({
+      id: shard.id,
+      open: shard.isOpen,
+      symbols: Array.from(shard.symbols),
+      streams: shard.streams.size,
+      messageRate: Math.round(shard.messageRate),
+    }));
   }
 
   /**
@@ -117,6 +348,7 @@ export class BinanceAdapter extends BaseAdapter {
     // Stream names look like "btcusdt@trade" - extract the symbol
     const symbolMatch = stream.match(/^([a-z0-9]+)@/);
     const symbol = symbolMatch ? symbolMatch[1].toUpperCase() : null;
+    if (symbol) this.countFrame(symbol);
     
     if (stream.includes('@trade')) {
       this.handleTrade({ ...data, s: symbol || data.s });
@@ -172,60 +404,176 @@ export class BinanceAdapter extends BaseAdapter {
       side: msg.m ? 'sell' : 'buy',  // m=true means buyer is maker, so aggressor is seller
       exchange: 'BINANCE',
     };
+    this.emitTradeOnce(trade);
+  }
+
+  /**
+   * Emit a live trade unless one with this id or a later one already went out
+   * 
+   * While a symbol moves between shards, the new shard's SUBSCRIBE can take
+   * effect before the old one's UNSUBSCRIBE and both deliver its @trade
+   * stream for a moment; the repeats are dropped here so CVD, volume and
+   * rates downstream don't count them twice. Trades without a numeric id
+   * (ours, generated) always go through.
+   */
+  private emitTradeOnce(trade: Trade): void {
+    const id = Number(trade.id);
+    if (Number.isFinite(id)) {
+      const last = this.lastTradeIds.get(trade.symbol);
+      if (last !== undefined && id <= last) {
+        duplicateTrades.inc();
+        return;
+      }
+      this.lastTradeIds.set(trade.symbol, id);
+    }
     this.emitTrade(trade);
   }
 
   /**
-   * Process order book depth update
+   * Process a diff-depth event
    * 
-   * Binance's depth20@100ms stream sends complete snapshots (not deltas).
-   * Format: { lastUpdateId, bids: [[price, qty], ...], asks: [[price, qty], ...] }
+   * The @depth@100ms stream sends only the levels that changed since the
+   * previous event: { U: firstUpdateId, u: finalUpdateId, b: [[price, qty]], a: [...] }
+   * with qty "0" meaning the level was removed. Events are buffered until the
+   * REST snapshot arrives, then applied in order on top of it.
    */
   private handleDepthUpdate(msg: any): void {
-    const symbol = msg.s || msg.symbol;
+    const symbol = (msg.s || msg.symbol)?.toUpperCase();
+    const sync = symbol ? this.depthSyncs.get(symbol) : undefined;
+    if (!sync) return;  // Unsubscribed while the event was in flight
     
-    // Handle both snapshot format (bids/asks) and update format (b/a)
-    const rawBids = msg.bids || msg.b || [];
-    const rawAsks = msg.asks || msg.a || [];
-    
-    if (rawBids.length === 0 && rawAsks.length === 0) {
-      console.log(`[Binance] Empty depth update for ${symbol}:`, msg);
+    if (!sync.synced) {
+      sync.buffered.push(msg);
+      if (!sync.fetching) {
+        this.syncOrderBook(symbol);
+      }
       return;
     }
     
-    // Convert string arrays to OrderBookLevel objects, filter out zero-size levels
-    const bids: OrderBookLevel[] = rawBids.map((level: string[]) => ({
-      price: parseFloat(level[0]),
-      size: parseFloat(level[1]),
-    })).filter((l: OrderBookLevel) => l.size > 0);
-
-    const asks: OrderBookLevel[] = rawAsks.map((level: string[]) => ({
-      price: parseFloat(level[0]),
-      size: parseFloat(level[1]),
-    })).filter((l: OrderBookLevel) => l.size > 0);
+    this.applyDepthDiff(sync, msg);
+  }
 
-    // Ensure proper ordering: bids high-to-low, asks low-to-high
-    bids.sort((a, b) => b.price - a.price);
-    asks.sort((a, b) => a.price - b.price);
+  /**
+   * Apply one diff event to a synced book and emit what changed
+   */
+  private applyDepthDiff(sync: DepthSync, msg: any): void {
+    const { book } = sync;
+    const firstId: number = msg.U;
+    const finalId: number = msg.u;
+    
+    // Already covered by the snapshot (or a duplicate)
+    if (finalId <= book.lastUpdateId) return;
+    
+    // Gap in the sequence - our book no longer matches the exchange
+    if (firstId > book.lastUpdateId + 1) {
+      console.log(`[Binance] Depth gap for ${book.symbol} (have ${book.lastUpdateId}, got ${firstId}) - resyncing`);
+      this.resetDepthSync(sync);
+      sync.buffered.push(msg);
+      this.syncOrderBook(book.symbol);
+      return;
+    }
+    
+    const bids: [number, number][] = [];
+    const asks: [number, number][] = [];
+    let topChanged = false;
+    
+    for (const level of msg.b || []) {
+      const price = parseFloat(level[0]);
+      const size = parseFloat(level[1]);
+      const index = book.applyLevel('bid', price, size);
+      if (index < 0) continue;
+      bids.push([price, size]);
+      if (index < TOP_LEVELS) topChanged = true;
+    }
+    
+    for (const level of msg.a || []) {
+      const price = parseFloat(level[0]);
+      const size = parseFloat(level[1]);
+      const index = book.applyLevel('ask', price, size);
+      if (index < 0) continue;
+      asks.push([price, size]);
+      if (index < TOP_LEVELS) topChanged = true;
+    }
+    
+    book.lastUpdateId = finalId;
+    book.trim(bids, asks);
+    
+    const timestamp = msg.E || Date.now();
+    
+    if (bids.length > 0 || asks.length > 0) {
+      this.emitOrderBookDelta({
+        symbol: book.symbol,
+        assetType: 'crypto',
+        timestamp,
+        seq: finalId,
+        prevSeq: sync.emittedSeq,
+        bids,
+        asks,
+      });
+      sync.emittedSeq = finalId;
+    }
+    
+    // Snapshot clients only care about the top of the book
+    if (topChanged) {
+      this.emitOrderBook(this.buildOrderBook(book, TOP_LEVELS, timestamp));
+    }
+  }
 
-    // Calculate spread from best bid/ask
-    const bestBid = bids[0]?.price || 0;
-    const bestAsk = asks[0]?.price || 0;
+  /**
+   * Cut a top-N OrderBook from the local book
+   */
+  private buildOrderBook(book: LocalOrderBook, depth: number, timestamp: number): OrderBook {
+    const bestBid = book.bestBid();
+    const bestAsk = book.bestAsk();
     const spread = bestAsk - bestBid;
     const spreadPercent = bestBid > 0 ? (spread / bestBid) * 100 : 0;
-
-    const orderBook: OrderBook = {
-      symbol: symbol?.toUpperCase() || 'UNKNOWN',
+    
+    return {
+      symbol: book.symbol,
       assetType: 'crypto',
-      timestamp: msg.E || Date.now(),
-      bids,
-      asks,
+      timestamp,
+      bids: book.topBids(depth),
+      asks: book.topAsks(depth),
       spread,
       spreadPercent,
+      seq: book.lastUpdateId,
     };
-    
-    console.log(`[Binance] Order book update for ${orderBook.symbol}: ${bids.length} bids, ${asks.length} asks, spread: ${spread.toFixed(4)}`);
-    this.emitOrderBook(orderBook);
+  }
+
+  /**
+   * Full replacement state for a delta client - its seq is the book's update ID
+   */
+  private buildBookSnapshot(sync: DepthSync, depth: number): OrderBookDelta {
+    const { book } = sync;
+    return {
+      symbol: book.symbol,
+      assetType: 'crypto',
+      timestamp: Date.now(),
+      seq: sync.emittedSeq,
+      prevSeq: 0,
+      bids: book.topBidPairs(depth),
+      asks: book.topAskPairs(depth),
+      snapshot: true,
+    };
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    const sync = this.depthSyncs.get(symbol.toUpperCase());
+    return sync?.synced ? this.buildOrderBook(sync.book, depth, Date.now()) : null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    const sync = this.depthSyncs.get(symbol.toUpperCase());
+    return sync?.synced ? this.buildBookSnapshot(sync, depth) : null;
+  }
+
+  /**
+   * Drop the local book so the next diff event triggers a fresh snapshot
+   */
+  private resetDepthSync(sync: DepthSync): void {
+    sync.book.clear();
+    sync.buffered = [];
+    sync.synced = false;
   }
 
   /**
@@ -253,20 +601,31 @@ export class BinanceAdapter extends BaseAdapter {
   }
 
   /**
-   * Close the WebSocket connection and clean up
+   * Close every shard and clean up
    */
   async disconnect(): Promise<void> {
     console.log('[Binance] Disconnecting...');
     
     this.clearReconnectTimer();
+    if (this.rateTimer) {
+      clearInterval(this.rateTimer);
+      this.rateTimer = null;
+    }
+    if (this.exchangeInfoTimer) {
+      clearInterval(this.exchangeInfoTimer);
+      this.exchangeInfoTimer = null;
+    }
     
-    if (this.ws) {
-      this.ws.close();
-      this.ws = null;
+    for (const shard of this.shards) {
+      shard.close();
     }
+    this.shards = [];
+    this.symbolShards.clear();
+    this.symbolCounts.clear();
+    this.symbolRates.clear();
     
     this.subscriptions.clear();
-    this.subscribedStreams.clear();
+    this.depthSyncs.clear();
     this.emitDisconnect();
     console.log('[Binance] Disconnected');
   }
@@ -276,87 +635,113 @@ export class BinanceAdapter extends BaseAdapter {
    * 
    * We subscribe to three streams per symbol:
    * - trade: Real-time trade executions
-   * - depth20@100ms: Order book snapshots at 10 updates/second
+   * - depth@100ms: Order book diffs at 10 updates/second, applied to a local book
    * - ticker: 24hr rolling statistics
+   * 
+   * Resolves once the recent-trade backfill has landed (or timed out), so
+   * the caller can hand it to its first subscriber.
    */
   async subscribe(symbol: string, assetType: AssetType = 'crypto'): Promise<void> {
     // Binance expects lowercase symbols with no separators
     const lowerSymbol = symbol.toLowerCase().replace('/', '').replace('-', '');
     
-    // Don't subscribe twice
+    // Don't subscribe twice - but a caller that arrives mid-backfill waits for it too
     if (this.subscriptions.has(lowerSymbol.toUpperCase())) {
-      return;
+      return this.pendingHistory(lowerSymbol.toUpperCase());
     }
     
     this.subscriptions.add(lowerSymbol.toUpperCase());
+    this.depthSyncs.set(lowerSymbol.toUpperCase(), {
+      book: new LocalOrderBook(lowerSymbol.toUpperCase()),
+      buffered: [],
+      synced: false,
+      fetching: false,
+      emittedSeq: 0,
+    });
     
-    const streams = [
-      `${lowerSymbol}@trade`,
-      `${lowerSymbol}@depth20@100ms`,
-      `${lowerSymbol}@ticker`,
-    ];
-    
-    if (this.ws && this.ws.readyState === WebSocket.OPEN) {
-      // Send subscription request using Binance's SUBSCRIBE method
-      this.ws.send(JSON.stringify({
-        method: 'SUBSCRIBE',
-        params: streams,
-        id: this.streamId++,
-      }));
-      
-      streams.forEach(s => this.subscribedStreams.add(s));
-    }
+    // The shard sends SUBSCRIBE now if it's open, or as soon as it opens
+    const streams = this.streamsFor(lowerSymbol);
+    const shard = this.pickShard(streams.length);
+    shard.addSymbol(lowerSymbol.toUpperCase(), streams);
+    this.symbolShards.set(lowerSymbol.toUpperCase(), shard);
     
-    console.log(`[Binance] Subscribed to ${lowerSymbol.toUpperCase()} (trade, depth, ticker)`);
+    console.log(`[Binance] Subscribed to ${lowerSymbol.toUpperCase()} on shard ${shard.id} (trade, depth, ticker)`);
     
-    // Fetch initial snapshots so we don't have to wait for the first stream update
-    this.fetchOrderBookSnapshot(lowerSymbol.toUpperCase());
+    // Seed the local book right away - diffs that arrive meanwhile get buffered
+    this.syncOrderBook(lowerSymbol.toUpperCase());
     this.fetchTickerSnapshot(lowerSymbol.toUpperCase());
+    
+    const history = this.waitForHistory(lowerSymbol.toUpperCase());
+    this.fetchTradeHistory(lowerSymbol.toUpperCase());
+    return history;
   }
 
   /**
-   * Fetch initial order book via REST API
+   * Seed (or reseed) the local book from a REST snapshot
    * 
-   * The WebSocket only sends updates - we need to grab the initial state
-   * so the UI has something to show immediately.
+   * Follows Binance's diff-depth procedure: drop buffered events the snapshot
+   * already covers (u <= lastUpdateId), and if the first remaining event starts
+   * after lastUpdateId + 1 the snapshot is too old - fetch another one.
    */
-  private async fetchOrderBookSnapshot(symbol: string): Promise<void> {
+  private async syncOrderBook(symbol: string): Promise<void> {
+    const sync = this.depthSyncs.get(symbol);
+    if (!sync || sync.fetching) return;
+    sync.fetching = true;
+    
     try {
-      const response = await axios.get(`${this.baseUrl}/depth`, {
-        params: { symbol, limit: 20 },
-      });
+      const data = await this.fetchOrderBookSnapshot(symbol);
       
-      const data = response.data;
-      const bids: OrderBookLevel[] = data.bids.map((level: string[]) => ({
-        price: parseFloat(level[0]),
-        size: parseFloat(level[1]),
-      }));
+      // Unsubscribed (or resubscribed) while we were waiting
+      if (this.depthSyncs.get(symbol) !== sync) return;
       
-      const asks: OrderBookLevel[] = data.asks.map((level: string[]) => ({
-        price: parseFloat(level[0]),
-        size: parseFloat(level[1]),
-      }));
-
-      const bestBid = bids[0]?.price || 0;
-      const bestAsk = asks[0]?.price || 0;
-      const spread = bestAsk - bestBid;
-      const spreadPercent = bestBid > 0 ? (spread / bestBid) * 100 : 0;
-
-      const orderBook: OrderBook = {
-        symbol,
-        assetType: 'crypto',
-        timestamp: Date.now(),
-        bids,
-        asks,
-        spread,
-        spreadPercent,
-      };
-      this.emitOrderBook(orderBook);
+      const lastUpdateId: number = data.lastUpdateId;
+      const pending = sync.buffered.filter(event => event.u > lastUpdateId);
+      
+      if (pending.length > 0 && pending[0].U > lastUpdateId + 1) {
+        console.log(`[Binance] Depth snapshot for ${symbol} is stale - refetching`);
+        sync.fetching = false;
+        setTimeout(() => this.syncOrderBook(symbol), RESYNC_RETRY_MS);
+        return;
+      }
+      
+      sync.book.applySnapshot(this.parseLevels(data.bids), this.parseLevels(data.asks), lastUpdateId);
+      sync.buffered = [];
+      sync.synced = true;
+      sync.emittedSeq = lastUpdateId;
+      
+      // Delta clients replace their book, snapshot clients get the usual top 20
+      this.emitOrderBookDelta(this.buildBookSnapshot(sync, DEPTH_SNAPSHOT_LIMIT));
+      this.emitOrderBook(this.buildOrderBook(sync.book, TOP_LEVELS, Date.now()));
+      
+      for (const event of pending) {
+        if (!sync.synced) break;  // A gap in the backlog already kicked off a resync
+        this.applyDepthDiff(sync, event);
+      }
+      
+      console.log(`[Binance] Order book synced for ${symbol} at update ${lastUpdateId} (${pending.length} buffered diffs applied)`);
     } catch (error) {
       console.error(`[Binance] Error fetching order book for ${symbol}:`, error);
+    } finally {
+      sync.fetching = false;
     }
   }
 
+  /**
+   * Fetch a deep order book snapshot via REST API
+   * 
+   * The WebSocket only sends diffs - this is the base they apply to.
+   */
+  private async fetchOrderBookSnapshot(symbol: string): Promise<any> {
+    const response = await axios.get(`${this.baseUrl}/depth`, {
+      params: { symbol, limit: DEPTH_SNAPSHOT_LIMIT },
+    });
+    return response.data;
+  }
+
+  private parseLevels(raw: string[][]): [number, number][] {
+    return raw.map(level => [parseFloat(level[0]), parseFloat(level[1])] as [number, number]);
+  }
+
   /**
    * Fetch initial 24hr ticker via REST API
    */
@@ -387,6 +772,42 @@ export class BinanceAdapter extends BaseAdapter {
     }
   }
 
+  /**
+   * Fetch the most recent aggregate trades via REST API
+   * 
+   * Live prints come from the trade stream and may already have started -
+   * the cache only takes the ones older than those, so the overlap is
+   * dropped there. aggTrades folds same-price fills of one taker order into
+   * one row, so its IDs are the last trade ID of each run.
+   */
+  private async fetchTradeHistory(symbol: string): Promise<void> {
+    try {
+      const response = await axios.get(`${this.baseUrl}/aggTrades`, {
+        params: { symbol, limit: HISTORY_TRADES_LIMIT },
+        timeout: HISTORY_TIMEOUT_MS,
+      });
+      if (!this.subscriptions.has(symbol)) return;
+      
+      const trades = (response.data as any[]).map((row): Trade => ({
+        id: String(row.l),
+        symbol,
+        assetType: 'crypto',
+        timestamp: row.T,
+        price: parseFloat(row.p),
+        volume: parseFloat(row.q),
+        // Buyer was the maker = the seller hit the bid
+        side: row.m ? 'sell' : 'buy',
+        exchange: 'BINANCE',
+      }));
+      this.emitHistory({ symbol, trades });
+      console.log(`[Binance] Backfilled ${trades.length} trades for ${symbol}`);
+    } catch (error) {
+      console.error(`[Binance] Error fetching trade history for ${symbol}:`, (error as Error).message);
+    } finally {
+      this.settleHistory(symbol);
+    }
+  }
+
   /**
    * Unsubscribe from a symbol's market data streams
    */
@@ -394,35 +815,85 @@ export class BinanceAdapter extends BaseAdapter {
     const lowerSymbol = symbol.toLowerCase().replace('/', '').replace('-', '');
     const upperSymbol = lowerSymbol.toUpperCase();
     
-    const streams = [
-      `${lowerSymbol}@trade`,
-      `${lowerSymbol}@depth20@100ms`,
-      `${lowerSymbol}@ticker`,
-    ];
-    
-    if (this.ws && this.ws.readyState === WebSocket.OPEN) {
-      this.ws.send(JSON.stringify({
-        method: 'UNSUBSCRIBE',
-        params: streams,
-        id: this.streamId++,
-      }));
+    const shard = this.symbolShards.get(upperSymbol);
+    if (shard) {
+      shard.removeSymbol(upperSymbol, this.streamsFor(lowerSymbol));
+      this.symbolShards.delete(upperSymbol);
       
-      streams.forEach(s => this.subscribedStreams.delete(s));
+      // Keep one connection around, but don't hold idle extra shards open
+      if (shard.symbols.size === 0 && this.shards.length > 1) {
+        shard.close();
+        this.shards = this.shards.filter(s => s !== shard);
+        console.log(`[Binance] Closed idle shard ${shard.id}`);
+      }
     }
     
     this.subscriptions.delete(upperSymbol);
+    this.depthSyncs.delete(upperSymbol);
+    this.symbolRates.delete(upperSymbol);
+    this.lastTradeIds.delete(upperSymbol);
     console.log(`[Binance] Unsubscribed from ${upperSymbol}`);
   }
 
+  /**
+   * Fetch every symbol's status in one request and swap in the new map
+   * 
+   * Concurrent callers share the request in flight. A failed refresh keeps
+   * the previous map - stale statuses beat no validation at all.
+   */
+  private loadExchangeInfo(): Promise<void> {
+    if (this.exchangeInfoLoad) return this.exchangeInfoLoad;
+    
+    this.exchangeInfoLoad = (async () => {
+      try {
+        const response = await axios.get(`${this.baseUrl}/exchangeInfo`);
+        const symbols: Map<string, ExchangeSymbol> = new Map();
+        for (const info of response.data.symbols ?? []) {
+          symbols.set(info.symbol, { baseAsset: info.baseAsset, quoteAsset: info.quoteAsset, status: info.status });
+        }
+        this.exchangeInfo = symbols;
+        console.log(`[Binance] Cached exchangeInfo for ${symbols.size} symbols`);
+      } catch (error: any) {
+        console.error('[Binance] Error fetching exchangeInfo:', error.message);
+      } finally {
+        this.exchangeInfoLoad = null;
+      }
+    })();
+    return this.exchangeInfoLoad;
+  }
+
   /**
    * Check if a symbol exists and is actively trading on Binance
    * 
-   * Hits the exchangeInfo endpoint which returns symbol status.
-   * "TRADING" means it's active, anything else means we can't subscribe.
+   * Answered from the cached exchangeInfo. "TRADING" means it's active,
+   * anything else means we can't subscribe. Only if the full list has never
+   * loaded do we ask about the one symbol directly.
    */
   async validateSymbol(symbol: string): Promise<SymbolInfo> {
     const upperSymbol = symbol.toUpperCase().replace('/', '').replace('-', '');
     
+    if (!this.exchangeInfo) await this.loadExchangeInfo();
+    if (this.exchangeInfo) {
+      const info = this.exchangeInfo.get(upperSymbol);
+      if (!info) {
+        return {
+          symbol: upperSymbol,
+          name: upperSymbol,
+          assetType: 'crypto',
+          valid: false,
+          error: 'Symbol not found on Binance',
+        };
+      }
+      return {
+        symbol: upperSymbol,
+        name: `${info.baseAsset}/${info.quoteAsset}`,
+        assetType: 'crypto',
+        exchange: 'BINANCE',
+        valid: info.status === 'TRADING',
+        error: info.status !== 'TRADING' ? `Symbol status: ${info.status}` : undefined,
+      };
+    }
+    
     try {
       const response = await axios.get(`${this.baseUrl}/exchangeInfo`, {
         params: { symbol: upperSymbol },
@@ -0,0 +1,229 @@
+// Fast path for Binance @trade frames - reads fields straight out of the socket Buffer
+
+import { Trade } from '../types';
+
+/**
+ * Combined-stream trade frames always look like
+ *
+ *   {"stream":"btcusdt@trade","data":{"e":"trade","E":1704067200001,"s":"BTCUSDT",
+ *     "t":123456,"p":"88000.01000000","q":"0.50000000","T":1704067200000,"m":true,"M":true}}
+ *
+ * so instead of toString() + JSON.parse() + a regex on the stream name, we
+ * walk the bytes once and only build the Trade itself. Anything that isn't
+ * a well-formed trade frame returns null and goes down the generic path.
+ */
+
+const PREFIX = Buffer.from('{"stream":"');
+const DATA_KEY = Buffer.from(',"data":{');
+const TRADE_SUFFIX = Buffer.from('@trade');
+
+const QUOTE = 0x22;     // "
+const COLON = 0x3a;     // :
+const COMMA = 0x2c;     // ,
+const CLOSE = 0x7d;     // }
+const DOT = 0x2e;       // .
+const MINUS = 0x2d;     // -
+const ZERO = 0x30;
+const LOWER_T = 0x74;   // t (also the first byte of `true`)
+
+// Digits we can accumulate in a double without losing integer precision
+const MAX_EXACT_DIGITS = 15;
+
+const POW10: number[] = [];
+for (let i = 0; i <= 22; i++) POW10.push(Math.pow(10, i));
+
+/**
+ * Stream name -> symbol, keyed by a hash of the name's bytes
+ *
+ * There are only ever a handful of streams, so this is a couple of entries
+ * checked byte-for-byte - no string is built for the lookup.
+ */
+interface StreamEntry {
+  bytes: Buffer;
+  symbol: string;
+}
+
+const streamCache: Map<number, StreamEntry> = new Map();
+
+function hashBytes(buf: Buffer, start: number, end: number): number {
+  let h = 0x811c9dc5;
+  for (let i = start; i < end; i++) {
+    h ^= buf[i];
+    h = Math.imul(h, 0x01000193);
+  }
+  return h >>> 0;
+}
+
+function matchesAt(buf: Buffer, start: number, expected: Buffer): boolean {
+  if (start + expected.length > buf.length) return false;
+  for (let i = 0; i < expected.length; i++) {
+    if (buf[start + i] !== expected[i]) return false;
+  }
+  return true;
+}
+
+function lookupSymbol(buf: Buffer, start: number, end: number): string {
+  const hash = hashBytes(buf, start, end);
+  const entry = streamCache.get(hash);
+  if (entry && entry.bytes.length === end - start && matchesAt(buf, start, entry.bytes)) {
+    return entry.symbol;
+  }
+
+  // "btcusdt@trade" -> "BTCUSDT"
+  const symbol = buf.toString('latin1', start, end - TRADE_SUFFIX.length).toUpperCase();
+  // Copy the name - buf is reused by the socket once we return
+  if (!entry) streamCache.set(hash, { bytes: Buffer.from(buf.subarray(start, end)), symbol });
+  return symbol;
+}
+
+/**
+ * Parse an unsigned/signed decimal ("88000.01000000") between start and end
+ *
+ * For up to 15 significant digits mantissa / 10^scale is exactly what
+ * parseFloat would give (both operands are exact, the division rounds once).
+ * Longer numbers fall back to parseFloat.
+ */
+function parseDecimal(buf: Buffer, start: number, end: number): number {
+  let i = start;
+  let negative = false;
+  if (buf[i] === MINUS) {
+    negative = true;
+    i++;
+  }
+
+  // Trailing zeros after the point don't change the value, skip them
+  let last = end;
+  let hasDot = false;
+  for (let j = i; j < end; j++) {
+    if (buf[j] === DOT) {
+      hasDot = true;
+      break;
+    }
+  }
+  if (hasDot) {
+    while (last > i && buf[last - 1] === ZERO) last--;
+    if (last > i && buf[last - 1] === DOT) last--;
+  }
+
+  let mantissa = 0;
+  let digits = 0;
+  let scale = 0;
+  let afterDot = false;
+  for (; i < last; i++) {
+    const c = buf[i];
+    if (c === DOT) {
+      afterDot = true;
+      continue;
+    }
+    const d = c - ZERO;
+    if (d < 0 || d > 9) return NaN;
+    if (mantissa !== 0 || d !== 0) digits++;
+    mantissa = mantissa * 10 + d;
+    if (afterDot) scale++;
+  }
+
+  if (digits > MAX_EXACT_DIGITS || scale > 22) {
+    return parseFloat(buf.toString('latin1', start, end));
+  }
+
+  const value = scale > 0 ? mantissa / POW10[scale] : mantissa;
+  return negative ? -value : value;
+}
+
+/**
+ * Try to parse a combined-stream @trade frame
+ *
+ * Returns the normalized Trade (same shape BinanceAdapter.handleTrade builds)
+ * or null if the frame is something else.
+ */
+export function parseTradeFrame(buf: Buffer): Trade | null {
+  if (!matchesAt(buf, 0, PREFIX)) return null;
+
+  // Stream name
+  const nameStart = PREFIX.length;
+  let i = nameStart;
+  while (i < buf.length && buf[i] !== QUOTE) i++;
+  const nameEnd = i;
+  if (nameEnd - nameStart <= TRADE_SUFFIX.length || !matchesAt(buf, nameEnd - TRADE_SUFFIX.length, TRADE_SUFFIX)) {
+    return null;
+  }
+
+  i = nameEnd + 1;
+  if (!matchesAt(buf, i, DATA_KEY)) return null;
+  i += DATA_KEY.length;
+
+  let idStart = -1;
+  let idEnd = -1;
+  let price = NaN;
+  let volume = NaN;
+  let tradeTime = 0;
+  let eventTime = 0;
+  let buyerIsMaker = false;
+
+  // Walk "k":value pairs until the data object closes
+  const end = buf.length;
+  while (i < end && buf[i] !== CLOSE) {
+    if (buf[i] === COMMA) i++;
+    if (buf[i] !== QUOTE) return null;
+
+    const keyStart = i + 1;
+    i = keyStart;
+    while (i < end && buf[i] !== QUOTE) i++;
+    const keyLength = i - keyStart;
+    const key = buf[keyStart];
+    i++;
+    if (buf[i] !== COLON) return null;
+    i++;
+
+    let valueStart: number;
+    let valueEnd: number;
+    if (buf[i] === QUOTE) {
+      // Binance never escapes anything in these fields
+      valueStart = i + 1;
+      i = valueStart;
+      while (i < end && buf[i] !== QUOTE) i++;
+      valueEnd = i;
+      i++;
+    } else {
+      valueStart = i;
+      while (i < end && buf[i] !== COMMA && buf[i] !== CLOSE) i++;
+      valueEnd = i;
+    }
+
+    if (keyLength !== 1) continue;
+    switch (key) {
+      case 0x74: // t - trade ID
+        idStart = valueStart;
+        idEnd = valueEnd;
+        break;
+      case 0x70: // p - price
+        price = parseDecimal(buf, valueStart, valueEnd);
+        break;
+      case 0x71: // q - quantity
+        volume = parseDecimal(buf, valueStart, valueEnd);
+        break;
+      case 0x54: // T - trade time
+        tradeTime = parseDecimal(buf, valueStart, valueEnd);
+        break;
+      case 0x45: // E - event time
+        eventTime = parseDecimal(buf, valueStart, valueEnd);
+        break;
+      case 0x6d: // m - buyer is maker
+        buyerIsMaker = buf[valueStart] === LOWER_T;
+        break;
+    }
+  }
+
+  if (i >= end || Number.isNaN(price) || Number.isNaN(volume)) return null;
+
+  return {
+    id: idStart >= 0 ? buf.toString('latin1', idStart, idEnd) : `${Date.now()}-${Math.random().toString(36).substr(2, 9)}`,
+    symbol: lookupSymbol(buf, nameStart, nameEnd),
+    assetType: 'crypto',
+    timestamp: tradeTime || eventTime,
+    price,
+    volume,
+    side: buyerIsMaker ? 'sell' : 'buy',  // m=true means buyer is maker, so aggressor is seller
+    exchange: 'BINANCE',
+  };
+}
@@ -0,0 +1,207 @@
+// One combined-stream connection in the Binance shard pool
+
+import WebSocket from 'ws';
+
+// Binance allows 5 incoming control messages per second per connection
+const CONTROL_INTERVAL_MS = 250;
+const CONTROL_MAX_PARAMS = 200;
+
+const RECONNECT_BASE_MS = 1000;
+const RECONNECT_MAX_MS = 30000;
+const CONNECT_TIMEOUT_MS = 10000;
+
+// Weight of the latest one-second window in the smoothed message rate
+const RATE_SMOOTHING = 0.3;
+
+export interface ShardHandlers {
+  onFrame: (data: Buffer) => void;
+  onOpen: (shard: BinanceShard) => void;
+  onClose: (shard: BinanceShard) => void;
+  onError: (error: Error) => void;
+}
+
+interface ControlMessage {
+  method: 'SUBSCRIBE' | 'UNSUBSCRIBE';
+  params: string[];
+}
+
+/**
+ * A single socket and the streams it carries
+ *
+ * Each shard owns its own reconnect loop: when it drops, only its symbols
+ * stall, and on reopen it resubscribes just its own streams in one go.
+ * Control messages go through a small queue so we never trip Binance's
+ * per-connection message limit when a lot of symbols land at once.
+ */
+export class BinanceShard {
+  readonly streams: Set<string> = new Set();
+  readonly symbols: Set<string> = new Set();
+  messageRate: number = 0;     // Frames/sec, smoothed
+
+  private ws: WebSocket | null = null;
+  private controlQueue: ControlMessage[] = [];
+  private controlTimer: NodeJS.Timeout | null = null;
+  private reconnectTimer: NodeJS.Timeout | null = null;
+  private reconnectAttempts: number = 0;
+  private closing: boolean = false;
+  private requestId: number = 1;
+  private windowCount: number = 0;
+  private windowStart: number = Date.now();
+
+  constructor(readonly id: number, private url: string, private handlers: ShardHandlers) {}
+
+  get isOpen(): boolean {
+    return this.ws !== null && this.ws.readyState === WebSocket.OPEN;
+  }
+
+  /**
+   * Open the socket - resolves once it's open, rejects on error or timeout.
+   * Reconnects after a drop are handled internally.
+   */
+  connect(): Promise<void> {
+    this.closing = false;
+
+    return new Promise((resolve, reject) => {
+      const ws = new WebSocket(this.url);
+      this.ws = ws;
+
+      const timeout = setTimeout(() => {
+        if (ws.readyState !== WebSocket.OPEN) {
+          ws.terminate();
+          reject(new Error('Connection timeout'));
+        }
+      }, CONNECT_TIMEOUT_MS);
+
+      ws.on('open', () => {
+        clearTimeout(timeout);
+        console.log(`[Binance] Shard ${this.id} opened`);
+        this.reconnectAttempts = 0;
+
+        // Fresh socket carries nothing yet - resubscribe everything it owns
+        this.controlQueue = [];
+        if (this.streams.size > 0) {
+          this.enqueue('SUBSCRIBE', Array.from(this.streams));
+        }
+
+        this.handlers.onOpen(this);
+        resolve();
+      });
+
+      ws.on('message', (data: Buffer) => {
+        this.windowCount++;
+        this.handlers.onFrame(data);
+      });
+
+      ws.on('error', (error: Error) => {
+        clearTimeout(timeout);
+        console.error(`[Binance] Shard ${this.id} error:`, error.message);
+        this.handlers.onError(error);
+        reject(error);
+      });
+
+      ws.on('close', () => {
+        clearTimeout(timeout);
+        if (this.ws !== ws) return;
+        this.ws = null;
+        console.log(`[Binance] Shard ${this.id} closed (${this.symbols.size} symbols)`);
+        this.handlers.onClose(this);
+        if (!this.closing) {
+          this.scheduleReconnect();
+        }
+      });
+    });
+  }
+
+  /**
+   * Start connecting in the background (new shards opened on demand)
+   */
+  start(): void {
+    this.connect().catch(() => {
+      // The close handler schedules the retry
+    });
+  }
+
+  /**
+   * Exponential backoff, capped - a shard keeps trying so its symbols come
+   * back on their own once Binance is reachable again
+   */
+  private scheduleReconnect(): void {
+    if (this.reconnectTimer) return;
+
+    const delay = Math.min(RECONNECT_BASE_MS * Math.pow(2, this.reconnectAttempts), RECONNECT_MAX_MS);
+    this.reconnectAttempts++;
+    console.log(`[Binance] Shard ${this.id} reconnecting in ${delay}ms (attempt ${this.reconnectAttempts})`);
+
+    this.reconnectTimer = setTimeout(() => {
+      this.reconnectTimer = null;
+      this.start();
+    }, delay);
+  }
+
+  addSymbol(symbol: string, streams: string[]): void {
+    this.symbols.add(symbol);
+    streams.forEach(s => this.streams.add(s));
+    if (this.isOpen) {
+      this.enqueue('SUBSCRIBE', streams);
+    }
+    // Not open yet: the open handler subscribes everything in this.streams
+  }
+
+  removeSymbol(symbol: string, streams: string[]): void {
+    this.symbols.delete(symbol);
+    streams.forEach(s => this.streams.delete(s));
+    if (this.isOpen) {
+      this.enqueue('UNSUBSCRIBE', streams);
+    }
+  }
+
+  private enqueue(method: ControlMessage['method'], params: string[]): void {
+    for (let i = 0; i < params.length; i += CONTROL_MAX_PARAMS) {
+      this.controlQueue.push({ method, params: params.slice(i, i + CONTROL_MAX_PARAMS) });
+    }
+    if (!this.controlTimer) {
+      this.sendNextControl();
+      this.controlTimer = setInterval(() => this.sendNextControl(), CONTROL_INTERVAL_MS);
+    }
+  }
+
+  private sendNextControl(): void {
+    const message = this.controlQueue.shift();
+    if (message && this.ws && this.ws.readyState === WebSocket.OPEN) {
+      this.ws.send(JSON.stringify({ ...message, id: this.requestId++ }));
+    }
+    if (this.controlQueue.length === 0 && this.controlTimer) {
+      clearInterval(this.controlTimer);
+      this.controlTimer = null;
+    }
+  }
+
+  /**
+   * Fold the frames counted since the last call into messageRate
+   */
+  sampleRate(now: number): void {
+    const elapsed = now - this.windowStart;
+    if (elapsed <= 0) return;
+    const rate = (this.windowCount / elapsed) * 1000;
+    this.messageRate = this.messageRate * (1 - RATE_SMOOTHING) + rate * RATE_SMOOTHING;
+    this.windowCount = 0;
+    this.windowStart = now;
+  }
+
+  close(): void {
+    this.closing = true;
+    if (this.reconnectTimer) {
+      clearTimeout(this.reconnectTimer);
+      this.reconnectTimer = null;
+    }
+    if (this.controlTimer) {
+      clearInterval(this.controlTimer);
+      this.controlTimer = null;
+    }
+    this.controlQueue = [];
+    if (this.ws) {
+      this.ws.close();
+      this.ws = null;
+    }
+  }
+}
@@ -0,0 +1,270 @@
+// Bus adapter - edge nodes take market data from ingest nodes instead of the exchange
+
+import net from 'net';
+import { BaseAdapter } from './base';
+import { AssetType, OrderBook, OrderBookDelta, Signal, SymbolInfo } from '../types';
+import { MirrorBook } from '../services/mirrorBook';
+import { BusPeer, BusEvent, IngestMessage, symbolOwner } from '../services/bus';
+
+const CONNECT_TIMEOUT_MS = 5_000;
+const VALIDATE_TIMEOUT_MS = 10_000;
+const MAX_RECONNECT_DELAY_MS = 10_000;
+
+export interface BusConfig {
+  nodes: string[];      // Ingest nodes as host:port, in shard order
+  node: string;         // Our name, shown in the ingest node's /health
+}
+
+interface IngestLink {
+  index: number;
+  address: string;
+  peer: BusPeer | null;
+  connected: boolean;
+  remoteNode: string;
+  attempts: number;
+  timer: NodeJS.Timeout | null;
+}
+
+/**
+ * Market data from the ingest tier
+ *
+ * Each symbol belongs to exactly one ingest node (symbolOwner over the
+ * node count), so subscribe/validate go straight to that node and nothing
+ * else. Signals arrive ready-made from the ingest node's engine and are
+ * handed out through onSignal. A dropped link is retried on its own; its
+ * symbols' books are cleared and resynced from the snapshot the ingest
+ * node sends on resubscribe, so delta clients see a fresh snapshot.
+ */
+export class BusAdapter extends BaseAdapter {
+  name = 'Bus';
+  supportedAssetTypes: AssetType[] = ['crypto'];
+
+  private links: IngestLink[];
+  private books: Map<string, MirrorBook> = new Map();
+  private signalCallbacks: ((signal: Signal) => void)[] = [];
+  private pendingValidations: Map<number, (info: SymbolInfo) => void> = new Map();
+  private nextValidationId = 1;
+  private stopped = false;
+
+  constructor(private config: BusConfig) {
+    super();
+    if (config.nodes.length === 0) throw new Error('BusAdapter needs at least one ingest node');
+    this.links = config.nodes.map((address, index) => ({
+      index,
+      address,
+      peer: null,
+      connected: false,
+      remoteNode: '',
+      attempts: 0,
+      timer: null,
+    }));
+  }
+
+  onSignal(callback: (signal: Signal) => void): void {
+    this.signalCallbacks.push(callback);
+  }
+
+  async connect(): Promise<void> {
+    this.stopped = false;
+    const attempts = this.links.filter(link => !link.peer).map(link => this.openLink(link));
+    // Wait for the first round of dials so an early validate has somewhere to go
+    await Promise.race([
+      Promise.all(attempts),
+      new Promise<void>(resolve => setTimeout(resolve, CONNECT_TIMEOUT_MS)),
+    ]);
+  }
+
+  async disconnect(): Promise<void> {
+    this.stopped = true;
+    for (const link of this.links) {
+      if (link.timer) clearTimeout(link.timer);
+      link.timer = null;
+      link.peer?.socket.destroy();
+      link.peer = null;
+      link.connected = false;
+    }
+    this.books.clear();
+    this.subscriptions.clear();
+    this.emitDisconnect();
+    console.log('[Bus] Disconnected');
+  }
+
+  async subscribe(symbol: string, _assetType: AssetType = 'crypto'): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (this.subscriptions.has(upperSymbol)) return this.pendingHistory(upperSymbol);
+    this.subscriptions.add(upperSymbol);
+    this.books.set(upperSymbol, new MirrorBook(upperSymbol));
+    const peer = this.ownerOf(upperSymbol).peer;
+    if (!peer) return;
+    // The ingest node answers with the recent trades once its own subscribe is done
+    const history = this.waitForHistory(upperSymbol);
+    peer.send({ op: 'sub', symbol: upperSymbol });
+    return history;
+  }
+
+  async unsubscribe(symbol: string): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    this.subscriptions.delete(upperSymbol);
+    this.books.delete(upperSymbol);
+    this.settleHistory(upperSymbol);
+    this.ownerOf(upperSymbol).peer?.send({ op: 'unsub', symbol: upperSymbol });
+  }
+
+  async validateSymbol(symbol: string): Promise<SymbolInfo> {
+    const upperSymbol = symbol.toUpperCase();
+    const link = this.ownerOf(upperSymbol);
+    const unavailable = (error: string): SymbolInfo => ({
+      symbol: upperSymbol,
+      name: upperSymbol,
+      assetType: 'crypto',
+      valid: false,
+      error,
+    });
+    if (!link.connected || !link.peer) return unavailable(`Ingest node ${link.address} is unreachable`);
+
+    const id = this.nextValidationId++;
+    const peer = link.peer;
+    return new Promise(resolve => {
+      const timer = setTimeout(() => {
+        this.pendingValidations.delete(id);
+        resolve(unavailable(`Ingest node ${link.address} did not answer`));
+      }, VALIDATE_TIMEOUT_MS);
+      this.pendingValidations.set(id, info => {
+        clearTimeout(timer);
+        resolve(info);
+      });
+      peer.send({ op: 'validate', id, symbol: upperSymbol });
+    });
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    return this.books.get(symbol.toUpperCase())?.orderBook(depth) ?? null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    return this.books.get(symbol.toUpperCase())?.snapshot(depth) ?? null;
+  }
+
+  /**
+   * Per-ingest-node view for /health: who we route to and what over it
+   */
+  getLinkStats(): { shard: number; address: string; node: string; connected: boolean; symbols: string[] }[] {
+    return this.links.map(link => ({
+      shard: link.index,
+      address: link.address,
+      node: link.remoteNode,
+      connected: link.connected,
+      symbols: Array.from(this.subscriptions).filter(s => this.ownerOf(s) === link),
+    }));
+  }
+
+  private ownerOf(symbol: string): IngestLink {
+    return this.links[symbolOwner(symbol, this.links.length)];
+  }
+
+  /**
+   * Dial one ingest node - resolves once the first attempt connects or fails
+   */
+  private openLink(link: IngestLink): Promise<void> {
+    const [host, port] = link.address.split(':');
+    const socket = net.connect({ host: host || 'localhost', port: Number(port) });
+    const peer = new BusPeer(socket, (message: IngestMessage) => this.handle(link, message));
+    link.peer = peer;
+
+    let settle: () => void = () => {};
+    const settled = new Promise<void>(resolve => (settle = resolve));
+
+    socket.on('connect', () => {
+      settle();
+      link.connected = true;
+      link.attempts = 0;
+      peer.send({ op: 'hello', node: this.config.node });
+      for (const symbol of this.subscriptions) {
+        if (this.ownerOf(symbol) === link) peer.send({ op: 'sub', symbol });
+      }
+      console.log(`[Bus] Connected to ingest node ${link.address} (shard ${link.index}/${this.links.length})`);
+      if (!this.connected) this.emitConnect();
+    });
+
+    socket.on('error', (error) => {
+      console.error(`[Bus] Ingest node ${link.address} error:`, error.message);
+    });
+
+    socket.on('close', () => {
+      settle();
+      const wasConnected = link.connected;
+      link.connected = false;
+      link.peer = null;
+      // The ingest node resends full books on resubscribe - until then these are stale
+      for (const [symbol, book] of this.books) {
+        if (this.ownerOf(symbol) === link) book.reset();
+      }
+      if (wasConnected) {
+        console.warn(`[Bus] Lost ingest node ${link.address}`);
+        if (this.links.every(l => !l.connected)) this.emitDisconnect();
+      }
+      if (!this.stopped) this.scheduleReconnect(link);
+    });
+
+    return settled;
+  }
+
+  private scheduleReconnect(link: IngestLink): void {
+    const delay = Math.min(MAX_RECONNECT_DELAY_MS, 500 * Math.pow(2, link.attempts));
+    link.attempts++;
+    link.timer = setTimeout(() => {
+      link.timer = null;
+      if (!this.stopped) void this.openLink(link);
+    }, delay);
+  }
+
+  private handle(link: IngestLink, message: IngestMessage): void {
+    switch (message.op) {
+      case 'welcome':
+        link.remoteNode = message.node;
+        if (message.shards !== this.links.length || message.shard !== link.index) {
+          console.warn(
+            `[Bus] ${link.address} says it is shard ${message.shard}/${message.shards}, ` +
+            `but BUS_INGEST_NODES lists it as ${link.index}/${this.links.length} - symbols will be misrouted`
+          );
+        }
+        break;
+      case 'event':
+        this.handleEvent(message.event);
+        break;
+      case 'validation': {
+        const resolve = this.pendingValidations.get(message.id);
+        this.pendingValidations.delete(message.id);
+        resolve?.(message.data);
+        break;
+      }
+    }
+  }
+
+  private handleEvent(event: BusEvent): void {
+    // Anything already in flight when we unsubscribed is dropped here
+    if (!this.subscriptions.has(event.data.symbol)) return;
+
+    switch (event.kind) {
+      case 'trade':
+        this.emitTrade(event.data);
+        break;
+      case 'orderbook':
+        this.emitOrderBook(event.data);
+        break;
+      case 'delta':
+        this.books.get(event.data.symbol)?.apply(event.data);
+        this.emitOrderBookDelta(event.data);
+        break;
+      case 'ticker':
+        this.emitTicker(event.data);
+        break;
+      case 'signal':
+        this.signalCallbacks.forEach(cb => cb(event.data));
+        break;
+      case 'history':
+        this.emitHistory(event.data);
+        break;
+    }
+  }
+}
@@ -0,0 +1,143 @@
+// Bybit spot adapter - v5 public stream: trades, 50-level book, ticker
+
+import axios from 'axios';
+import { VenueAdapter } from './venue';
+import { VenueSocketOptions } from './venueSocket';
+import { SymbolInfo, Trade, Ticker } from '../types';
+
+// Bybit drops a socket that hasn't pinged in 30s
+const PING_INTERVAL_MS = 20000;
+
+// Spot books come in 1, 50 or 200 levels
+const BOOK_DEPTH = 50;
+
+// A subscribe carries at most 10 topics
+const TOPICS_PER_MESSAGE = 10;
+
+/**
+ * Bybit spot market data
+ *
+ * Symbols are named the same as ours (BTCUSDT). The book stream opens with a
+ * snapshot and then sends deltas; Bybit re-sends a snapshot whenever the
+ * book has to be reset on their side, which replaces ours outright.
+ */
+export class BybitAdapter extends VenueAdapter {
+  name = 'Bybit';
+  readonly exchange = 'BYBIT';
+
+  protected readonly url = 'wss://stream.bybit.com/v5/public/spot';
+  protected readonly socketOptions: VenueSocketOptions = {
+    pingIntervalMs: PING_INTERVAL_MS,
+    ping: () => JSON.stringify({ op: 'ping' }),
+  };
+  private readonly restUrl = 'https://api.bybit.com/v5/market';
+
+  venueSymbol(symbol: string): string {
+    return symbol.toUpperCase();
+  }
+
+  protected subscribeMessages(venueSymbols: string[]): string[] {
+    return this.topicMessages('subscribe', venueSymbols);
+  }
+
+  protected unsubscribeMessages(venueSymbols: string[]): string[] {
+    return this.topicMessages('unsubscribe', venueSymbols);
+  }
+
+  private topicMessages(op: 'subscribe' | 'unsubscribe', venueSymbols: string[]): string[] {
+    const topics = venueSymbols.flatMap(s => [`publicTrade.${s}`, `orderbook.${BOOK_DEPTH}.${s}`, `tickers.${s}`]);
+    const messages: string[] = [];
+    for (let i = 0; i < topics.length; i += TOPICS_PER_MESSAGE) {
+      messages.push(JSON.stringify({ op, args: topics.slice(i, i + TOPICS_PER_MESSAGE) }));
+    }
+    return messages;
+  }
+
+  /**
+   * { topic: 'publicTrade.BTCUSDT' | 'orderbook.50.BTCUSDT' | 'tickers.BTCUSDT', type, ts, data }
+   * Command replies ({ op, success }) and pongs carry no topic.
+   */
+  protected handleMessage(data: string): void {
+    const msg = JSON.parse(data);
+    if (typeof msg.topic !== 'string') {
+      if (msg.success === false) console.error(`[Bybit] ${msg.op} failed: ${msg.ret_msg}`);
+      return;
+    }
+
+    const dot = msg.topic.lastIndexOf('.');
+    const symbol = this.symbolFor(msg.topic.slice(dot + 1));
+    if (!symbol) return;  // Unsubscribed while the message was in flight
+
+    if (msg.topic.startsWith('publicTrade.')) {
+      for (const row of msg.data ?? []) this.emitTrade(this.parseTrade(symbol, row));
+    } else if (msg.topic.startsWith('orderbook.')) {
+      this.applyBook(symbol, this.parseLevels(msg.data?.b), this.parseLevels(msg.data?.a), msg.type === 'snapshot', msg.ts || Date.now());
+    } else if (msg.topic.startsWith('tickers.')) {
+      this.emitTicker(this.parseTicker(symbol, msg.data, msg.ts));
+    }
+  }
+
+  /**
+   * { T: time, S: 'Buy' | 'Sell' (taker side), v: size, p: price, i: trade ID }
+   */
+  private parseTrade(symbol: string, row: any): Trade {
+    return {
+      id: String(row.i ?? this.generateTradeId()),
+      symbol,
+      assetType: 'crypto',
+      timestamp: Number(row.T),
+      price: parseFloat(row.p),
+      volume: parseFloat(row.v),
+      side: row.S === 'Buy' ? 'buy' : row.S === 'Sell' ? 'sell' : 'neutral',
+      exchange: this.exchange,
+    };
+  }
+
+  private parseLevels(raw: string[][] | undefined): [number, number][] {
+    return (raw ?? []).map(level => [parseFloat(level[0]), parseFloat(level[1])] as [number, number]);
+  }
+
+  /**
+   * price24hPcnt is a fraction (0.0168 = 1.68%)
+   */
+  private parseTicker(symbol: string, data: any, ts: number): Ticker {
+    const lastPrice = parseFloat(data.lastPrice);
+    const openPrice = parseFloat(data.prevPrice24h);
+    return {
+      symbol,
+      assetType: 'crypto',
+      timestamp: ts || Date.now(),
+      lastPrice,
+      priceChange: lastPrice - openPrice,
+      priceChangePercent: parseFloat(data.price24hPcnt) * 100,
+      highPrice: parseFloat(data.highPrice24h),
+      lowPrice: parseFloat(data.lowPrice24h),
+      volume: parseFloat(data.volume24h),
+      quoteVolume: parseFloat(data.turnover24h),
+      openPrice,
+    };
+  }
+
+  async validateSymbol(symbol: string): Promise<SymbolInfo> {
+    const upperSymbol = symbol.toUpperCase();
+    try {
+      const response = await axios.get(`${this.restUrl}/instruments-info`, {
+        params: { category: 'spot', symbol: upperSymbol },
+      });
+      const info = response.data?.result?.list?.[0];
+      if (!info) {
+        return { symbol: upperSymbol, name: upperSymbol, assetType: 'crypto', valid: false, error: 'Symbol not found on Bybit' };
+      }
+      return {
+        symbol: upperSymbol,
+        name: `${info.baseCoin}/${info.quoteCoin}`,
+        assetType: 'crypto',
+        exchange: this.exchange,
+        valid: info.status === 'Trading',
+        error: info.status !== 'Trading' ? `Symbol status: ${info.status}` : undefined,
+      };
+    } catch (error: any) {
+      return { symbol: upperSymbol, name: upperSymbol, assetType: 'crypto', valid: false, error: error.message || 'Failed to validate symbol' };
+    }
+  }
+}
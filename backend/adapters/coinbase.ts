@@ -0,0 +1,158 @@
+// Coinbase Exchange adapter - public feed: matches, batched level 2, ticker
+
+import axios from 'axios';
+import { VenueAdapter, baseAsset } from './venue';
+import { VenueSocketOptions } from './venueSocket';
+import { SymbolInfo, Trade, Ticker } from '../types';
+
+export interface CoinbaseConfig {
+  quote?: 'USD' | 'USDT';   // Which Coinbase book stands in for our USDT pair
+}
+
+/**
+ * Coinbase Exchange market data
+ *
+ * Coinbase's liquidity is in USD books, so by default BTCUSDT maps to
+ * BTC-USD: its prints land on the tape and its levels in the cross-venue
+ * book at USD prices, a few basis points off the USDT venues. quote 'USDT'
+ * takes the (much thinner) BTC-USDT book instead.
+ *
+ * The feed pings at the protocol level, which ws answers by itself. A match's
+ * side is the maker's, so the aggressor is the other side. level2_batch
+ * sends the whole book as a snapshot and then l2update changes; it has no
+ * sequence numbers, so a reconnect is the only resync.
+ */
+export class CoinbaseAdapter extends VenueAdapter {
+  name = 'Coinbase';
+  readonly exchange = 'COINBASE';
+
+  protected readonly url = 'wss://ws-feed.exchange.coinbase.com';
+  protected readonly socketOptions: VenueSocketOptions = {};
+  private readonly restUrl = 'https://api.exchange.coinbase.com';
+  private readonly quote: 'USD' | 'USDT';
+
+  constructor(config: CoinbaseConfig = {}) {
+    super();
+    this.quote = config.quote ?? 'USD';
+  }
+
+  venueSymbol(symbol: string): string {
+    return `${baseAsset(symbol.toUpperCase())}-${this.quote}`;
+  }
+
+  protected subscribeMessages(venueSymbols: string[]): string[] {
+    return venueSymbols.length > 0 ? [this.channelMessage('subscribe', venueSymbols)] : [];
+  }
+
+  protected unsubscribeMessages(venueSymbols: string[]): string[] {
+    return venueSymbols.length > 0 ? [this.channelMessage('unsubscribe', venueSymbols)] : [];
+  }
+
+  private channelMessage(type: 'subscribe' | 'unsubscribe', productIds: string[]): string {
+    return JSON.stringify({ type, product_ids: productIds, channels: ['matches', 'level2_batch', 'ticker'] });
+  }
+
+  /**
+   * Every message is { type, product_id, ... }
+   */
+  protected handleMessage(data: string): void {
+    const msg = JSON.parse(data);
+    if (msg.type === 'error') {
+      console.error(`[Coinbase] ${msg.message}${msg.reason ? `: ${msg.reason}` : ''}`);
+      return;
+    }
+
+    const symbol = typeof msg.product_id === 'string' ? this.symbolFor(msg.product_id) : undefined;
+    if (!symbol) return;
+
+    switch (msg.type) {
+      case 'match':
+        this.emitTrade(this.parseMatch(symbol, msg));
+        break;
+      case 'snapshot':
+        this.applyBook(symbol, this.parseLevels(msg.bids), this.parseLevels(msg.asks), true, Date.now());
+        break;
+      case 'l2update':
+        this.handleChanges(symbol, msg);
+        break;
+      case 'ticker':
+        this.emitTicker(this.parseTicker(symbol, msg));
+        break;
+      // 'last_match' is the print before we subscribed - not a live one
+    }
+  }
+
+  /**
+   * changes: [side ('buy' | 'sell'), price, size][] - size '0' removes
+   */
+  private handleChanges(symbol: string, msg: any): void {
+    const bids: [number, number][] = [];
+    const asks: [number, number][] = [];
+    for (const [side, price, size] of msg.changes ?? []) {
+      (side === 'buy' ? bids : asks).push([parseFloat(price), parseFloat(size)]);
+    }
+    this.applyBook(symbol, bids, asks, false, Date.parse(msg.time) || Date.now());
+  }
+
+  private parseMatch(symbol: string, msg: any): Trade {
+    return {
+      id: String(msg.trade_id ?? this.generateTradeId()),
+      symbol,
+      assetType: 'crypto',
+      timestamp: Date.parse(msg.time),
+      price: parseFloat(msg.price),
+      volume: parseFloat(msg.size),
+      // side is the resting order's - a 'sell' maker was lifted by a buyer
+      side: msg.side === 'sell' ? 'buy' : msg.side === 'buy' ? 'sell' : 'neutral',
+      exchange: this.exchange,
+    };
+  }
+
+  private parseLevels(raw: string[][] | undefined): [number, number][] {
+    return (raw ?? []).map(level => [parseFloat(level[0]), parseFloat(level[1])] as [number, number]);
+  }
+
+  private parseTicker(symbol: string, msg: any): Ticker {
+    const lastPrice = parseFloat(msg.price);
+    const openPrice = parseFloat(msg.open_24h);
+    const volume = parseFloat(msg.volume_24h);
+    return {
+      symbol,
+      assetType: 'crypto',
+      timestamp: Date.parse(msg.time) || Date.now(),
+      lastPrice,
+      priceChange: lastPrice - openPrice,
+      priceChangePercent: openPrice > 0 ? ((lastPrice - openPrice) / openPrice) * 100 : 0,
+      highPrice: parseFloat(msg.high_24h),
+      lowPrice: parseFloat(msg.low_24h),
+      volume,
+      quoteVolume: volume * lastPrice,   // Not sent - close enough for a header readout
+      openPrice,
+    };
+  }
+
+  async validateSymbol(symbol: string): Promise<SymbolInfo> {
+    const upperSymbol = symbol.toUpperCase();
+    try {
+      const response = await axios.get(`${this.restUrl}/products/${this.venueSymbol(upperSymbol)}`);
+      const info = response.data;
+      return {
+        symbol: upperSymbol,
+        name: `${info.base_currency}/${info.quote_currency}`,
+        assetType: 'crypto',
+        exchange: this.exchange,
+        valid: info.status === 'online' && !info.trading_disabled,
+        error: info.status !== 'online' ? `Product status: ${info.status}` : undefined,
+      };
+    } catch (error: any) {
+      const notFound = error.response?.status === 404;
+      return {
+        symbol: upperSymbol,
+        name: upperSymbol,
+        assetType: 'crypto',
+        valid: false,
+        error: notFound ? 'Symbol not found on Coinbase' : error.message || 'Failed to validate symbol',
+      };
+    }
+  }
+}
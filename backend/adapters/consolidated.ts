@@ -0,0 +1,275 @@
+// Consolidated adapter - several venues behind one adapter: one merged tape and one summed book per symbol
+
+import { BaseAdapter } from './base';
+import { AssetType, OrderBook, OrderBookDelta, SymbolInfo, Trade } from '../types';
+import { TradeMerger } from '../services/tradeMerger';
+import { ConsolidatedBook } from '../services/consolidatedBook';
+
+// Levels in the 'orderbook' snapshots we emit for clients that don't take deltas
+const TOP_LEVELS = 20;
+
+// Depth of the snapshot sent when a venue's share of a book is replaced - all
+// of it, since the deltas cover every level
+const SNAPSHOT_LEVELS = Infinity;
+
+export interface ConsolidatedConfig {
+  reorderMs: number;   // Longest a trade is held for the other venues to catch up
+}
+
+export interface VenueStats {
+  name: string;
+  connected: boolean;
+  symbols: number;
+}
+
+/**
+ * Fans one subscription out to every venue that lists the symbol and puts
+ * the results back together
+ *
+ * - Trades: merged into exchange-time order by a TradeMerger (bounded
+ *   reorder buffer per venue); each keeps its venue in Trade.exchange.
+ * - Book: venue deltas are summed into one ConsolidatedBook, which goes out
+ *   with its own seq chain, so clients see one ordinary book.
+ * - Ticker: the first venue is the primary and its 24h stats are the
+ *   symbol's - summing 24h volume and mixing venues' highs would read oddly.
+ * - History: whatever backfills the venues emit during subscribe, merged.
+ *
+ * The first venue also decides what a valid symbol is; the others are asked
+ * once per symbol and simply skipped when they don't list it.
+ */
+export class ConsolidatedAdapter extends BaseAdapter {
+  name = 'Consolidated';
+  supportedAssetTypes: AssetType[] = ['crypto'];
+
+  private merger: TradeMerger;
+  private books: Map<string, ConsolidatedBook> = new Map();
+  private symbolVenues: Map<string, number[]> = new Map();   // Venues carrying each subscribed symbol
+  private histories: Map<string, Trade[]> = new Map();       // Backfill collected while subscribing
+  private listings: Map<string, boolean>[];                  // Per venue - does it list the symbol
+  private venueUp: boolean[];
+
+  constructor(readonly venues: BaseAdapter[], config: ConsolidatedConfig) {
+    super();
+    this.merger = new TradeMerger(venues.map(v => v.name), config.reorderMs, trade => this.emitTrade(trade));
+    this.listings = venues.map(() => new Map());
+    this.venueUp = venues.map(() => false);
+    venues.forEach((venue, i) => this.wire(venue, i));
+  }
+
+  private wire(venue: BaseAdapter, index: number): void {
+    venue.onTrade(trade => this.merger.push(index, trade));
+    venue.onOrderBookDelta(delta => this.applyVenueDelta(index, delta));
+    // Venue top-of-book is ignored - ours is cut from the summed book
+    venue.onTicker(ticker => {
+      if (this.symbolVenues.get(ticker.symbol)?.[0] === index) this.emitTicker(ticker);
+    });
+    venue.onHistory(history => this.histories.get(history.symbol)?.push(...history.trades));
+    venue.onError(error => this.emitError(new Error(`${venue.name}: ${error.message}`)));
+    venue.onConnect(() => {
+      this.venueUp[index] = true;
+      if (!this.connected) this.emitConnect();
+    });
+    venue.onDisconnect(() => {
+      this.venueUp[index] = false;
+      // Its levels are gone with it; clients get the book without them
+      for (const book of this.books.values()) {
+        if (book.removeVenue(index)) this.emitSnapshot(book, Date.now());
+      }
+      if (this.connected && !this.venueUp.some(Boolean)) this.emitDisconnect();
+    });
+  }
+
+  /**
+   * Connects every venue; one failing to come up isn't fatal - the others
+   * stream, and the venue's own reconnect brings it in later
+   */
+  async connect(): Promise<void> {
+    console.log(`[Consolidated] Connecting ${this.venues.map(v => v.name).join(', ')}...`);
+    await Promise.all(this.venues.map(venue =>
+      venue.connect().catch(error => console.error(`[Consolidated] ${venue.name} failed to connect:`, error.message))
+    ));
+  }
+
+  async disconnect(): Promise<void> {
+    await Promise.all(this.venues.map(venue => venue.disconnect()));
+    for (const symbol of this.subscriptions) this.merger.removeSymbol(symbol);
+    this.merger.stop();
+    this.subscriptions.clear();
+    this.symbolVenues.clear();
+    this.books.clear();
+    this.histories.clear();
+    this.emitDisconnect();
+  }
+
+  /**
+   * Resolves, like a single venue's, once the backfill is in
+   */
+  async subscribe(symbol: string, assetType: AssetType = 'crypto'): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (this.subscriptions.has(upperSymbol)) return this.pendingHistory(upperSymbol);
+    this.subscriptions.add(upperSymbol);
+    const history = this.waitForHistory(upperSymbol);
+    this.subscribeVenues(upperSymbol, assetType).catch(error => {
+      console.error(`[Consolidated] Subscribe ${upperSymbol} failed:`, error.message);
+      this.settleHistory(upperSymbol);
+    });
+    return history;
+  }
+
+  private async subscribeVenues(symbol: string, assetType: AssetType): Promise<void> {
+    const carrying = await this.venuesListing(symbol);
+    // Unsubscribed while we were asking around
+    if (!this.subscriptions.has(symbol)) {
+      this.settleHistory(symbol);
+      return;
+    }
+
+    this.symbolVenues.set(symbol, carrying);
+    this.books.set(symbol, new ConsolidatedBook(symbol, this.venues.length));
+    this.merger.addSymbol(symbol, carrying);
+    this.histories.set(symbol, []);
+
+    await Promise.all(carrying.map(i =>
+      this.venues[i].subscribe(symbol, assetType).catch(error =>
+        console.error(`[Consolidated] ${this.venues[i].name} subscribe ${symbol} failed:`, error.message)
+      )
+    ));
+
+    const trades = this.histories.get(symbol) ?? [];
+    this.histories.delete(symbol);
+    if (!this.subscriptions.has(symbol)) {
+      this.settleHistory(symbol);
+      return;
+    }
+    trades.sort((a, b) => a.timestamp - b.timestamp);
+    this.emitHistory({ symbol, trades });
+    console.log(`[Consolidated] Subscribed to ${symbol} on ${carrying.map(i => this.venues[i].name).join(', ')}`);
+  }
+
+  /**
+   * Indexes of the venues to subscribe a symbol on - the primary always,
+   * the rest if they list it (cached; a failed lookup is asked again next time)
+   */
+  private async venuesListing(symbol: string): Promise<number[]> {
+    const listed = await Promise.all(this.venues.map(async (venue, i) => {
+      if (i === 0) return true;
+      const known = this.listings[i].get(symbol);
+      if (known !== undefined) return known;
+      const info = await venue.validateSymbol(symbol);
+      if (info.valid || info.error?.includes('not found')) this.listings[i].set(symbol, info.valid);
+      return info.valid;
+    }));
+    return listed.flatMap((isListed, i) => (isListed ? [i] : []));
+  }
+
+  async unsubscribe(symbol: string): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (!this.subscriptions.delete(upperSymbol)) return;
+    const carrying = this.symbolVenues.get(upperSymbol) ?? [];
+    this.symbolVenues.delete(upperSymbol);
+    this.books.delete(upperSymbol);
+    this.merger.removeSymbol(upperSymbol);
+    this.settleHistory(upperSymbol);
+    await Promise.all(carrying.map(i => this.venues[i].unsubscribe(upperSymbol)));
+    console.log(`[Consolidated] Unsubscribed from ${upperSymbol}`);
+  }
+
+  /**
+   * The primary venue's answer, unless it doesn't list the symbol and
+   * another venue does
+   */
+  async validateSymbol(symbol: string): Promise<SymbolInfo> {
+    const primary = await this.venues[0].validateSymbol(symbol);
+    if (primary.valid) return primary;
+    for (let i = 1; i < this.venues.length; i++) {
+      const info = await this.venues[i].validateSymbol(symbol);
+      // Only a definite answer is cached - a timeout is asked again next time
+      if (info.valid || info.error?.includes('not found')) this.listings[i].set(symbol.toUpperCase(), info.valid);
+      if (info.valid) return info;
+    }
+    return primary;
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    const book = this.books.get(symbol.toUpperCase());
+    return book?.synced ? this.buildOrderBook(book, depth, Date.now()) : null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    const book = this.books.get(symbol.toUpperCase());
+    return book?.synced ? this.buildBookSnapshot(book, depth, Date.now()) : null;
+  }
+
+  getVenueStats(): VenueStats[] {
+    return this.venues.map((venue, i) => ({
+      name: venue.name,
+      connected: this.venueUp[i],
+      symbols: Array.from(this.symbolVenues.values()).filter(carrying => carrying.includes(i)).length,
+    }));
+  }
+
+  /**
+   * First venue of the given class, for venue-specific stats
+   */
+  findVenue<T extends BaseAdapter>(type: abstract new (...args: any[]) => T): T | null {
+    return (this.venues.find(venue => venue instanceof type) as T | undefined) ?? null;
+  }
+
+  private applyVenueDelta(venue: number, delta: OrderBookDelta): void {
+    const book = this.books.get(delta.symbol);
+    if (!book) return;
+    const change = book.apply(venue, delta);
+    if (!change) return;
+    if (change === 'snapshot') {
+      this.emitSnapshot(book, delta.timestamp);
+      return;
+    }
+
+    const prevSeq = book.seq;
+    book.book.lastUpdateId = ++book.seq;
+    this.emitOrderBookDelta({
+      symbol: book.symbol,
+      assetType: 'crypto',
+      timestamp: delta.timestamp,
+      seq: book.seq,
+      prevSeq,
+      bids: change.bids,
+      asks: change.asks,
+    });
+    if (change.topChanged) this.emitOrderBook(this.buildOrderBook(book, TOP_LEVELS, delta.timestamp));
+  }
+
+  private emitSnapshot(book: ConsolidatedBook, timestamp: number): void {
+    book.book.lastUpdateId = ++book.seq;
+    this.emitOrderBookDelta(this.buildBookSnapshot(book, SNAPSHOT_LEVELS, timestamp));
+    this.emitOrderBook(this.buildOrderBook(book, TOP_LEVELS, timestamp));
+  }
+
+  private buildOrderBook(book: ConsolidatedBook, depth: number, timestamp: number): OrderBook {
+    const bestBid = book.book.bestBid();
+    const spread = book.book.bestAsk() - bestBid;
+    return {
+      symbol: book.symbol,
+      assetType: 'crypto',
+      timestamp,
+      bids: book.book.topBids(depth),
+      asks: book.book.topAsks(depth),
+      spread,
+      spreadPercent: bestBid > 0 ? (spread / bestBid) * 100 : 0,
+      seq: book.seq,
+    };
+  }
+
+  private buildBookSnapshot(book: ConsolidatedBook, depth: number, timestamp: number): OrderBookDelta {
+    return {
+      symbol: book.symbol,
+      assetType: 'crypto',
+      timestamp,
+      seq: book.seq,
+      prevSeq: 0,
+      bids: book.book.topBidPairs(depth),
+      asks: book.book.topAskPairs(depth),
+      snapshot: true,
+    };
+  }
+}
@@ -1,3 +1,13 @@
-// Exchange adapter exports - currently only Binance is supported
+// Exchange adapter exports - Binance, Bybit, OKX and Coinbase live data (alone or consolidated),
+// replay of captured sessions, synthetic load, the ingest-node bus for edge nodes, and the
+// shared-ring feed for fan-out workers
 
 export { BinanceAdapter } from './binance';
+export { BybitAdapter } from './bybit';
+export { OkxAdapter } from './okx';
+export { CoinbaseAdapter } from './coinbase';
+export { ConsolidatedAdapter } from './consolidated';
+export { ReplayAdapter } from './replay';
+export { SyntheticAdapter } from './synthetic';
+export { BusAdapter } from './bus';
+export { WorkerFeedAdapter } from './workerFeed';
@@ -0,0 +1,226 @@
+// Replay adapter - plays a tick capture file back through the normal adapter callbacks
+
+import { BaseAdapter } from './base';
+import { AssetType, OrderBook, OrderBookDelta, SymbolInfo } from '../types';
+import { MirrorBook } from '../services/mirrorBook';
+import { TickFileReader, TickEvent } from '../services/tickFile';
+
+// At max speed, yield to the event loop after this many events
+const MAX_SPEED_BATCH = 2000;
+// Longest we sleep between checks at timed speeds (keeps timing smooth across gaps)
+const MAX_SLEEP_MS = 50;
+
+export interface ReplayConfig {
+  file: string;
+  speed?: number;     // 1 = recorded pace, N = N times faster, 0 = as fast as possible
+  loop?: boolean;     // Start over at the end of the file
+}
+
+/**
+ * Market data from a capture file instead of an exchange
+ *
+ * Events come out in recorded order, paced by their capture times scaled by
+ * speed, with every timestamp shifted onto the playback clock so latency
+ * and rate tracking downstream behave as if the data were live. Only
+ * subscribed symbols are emitted, but every symbol's book is kept current
+ * from the recorded deltas, so a late subscriber gets a synced book right
+ * away - just like the live adapter.
+ */
+export class ReplayAdapter extends BaseAdapter {
+  name = 'Replay';
+  supportedAssetTypes: AssetType[] = ['crypto'];
+
+  private reader: TickFileReader | null = null;
+  private speed: number;
+  private loop: boolean;
+  private books: Map<string, MirrorBook> = new Map();
+  private knownSymbols: Set<string> = new Set();
+
+  private chunkIndex = 0;
+  private events: TickEvent[] = [];
+  private eventIndex = 0;
+  private fileStart = 0;
+  private clockStart = 0;
+  private timer: NodeJS.Timeout | null = null;
+  private immediate: NodeJS.Immediate | null = null;
+
+  constructor(private config: ReplayConfig) {
+    super();
+    this.speed = Math.max(0, config.speed ?? 1);
+    this.loop = config.loop ?? false;
+  }
+
+  async connect(): Promise<void> {
+    if (this.reader) return;
+    this.reader = new TickFileReader(this.config.file);
+    for (let i = 0; i < this.reader.chunks.length; i++) {
+      for (const s of this.reader.chunkStrings(i)) this.knownSymbols.add(s);
+    }
+
+    const chunks = this.reader.chunks;
+    const span = chunks.length > 0 ? (chunks[chunks.length - 1].lastTime - chunks[0].firstTime) / 1000 : 0;
+    console.log(`[Replay] ${this.config.file}: ${chunks.length} chunks, ${span.toFixed(0)}s recorded, speed ${this.speed || 'max'}`);
+
+    this.emitConnect();
+    this.restart();
+  }
+
+  async disconnect(): Promise<void> {
+    this.stopTimers();
+    this.reader?.close();
+    this.reader = null;
+    this.books.clear();
+    this.subscriptions.clear();
+    this.emitDisconnect();
+    console.log('[Replay] Disconnected');
+  }
+
+  async subscribe(symbol: string, _assetType: AssetType = 'crypto'): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (this.subscriptions.has(upperSymbol)) return;
+    this.subscriptions.add(upperSymbol);
+    console.log(`[Replay] Subscribed to ${upperSymbol}`);
+
+    const book = this.books.get(upperSymbol);
+    const snapshot = book?.snapshot(1000);
+    const orderBook = book?.orderBook(20);
+    if (snapshot) this.emitOrderBookDelta(snapshot);
+    if (orderBook) this.emitOrderBook(orderBook);
+  }
+
+  async unsubscribe(symbol: string): Promise<void> {
+    this.subscriptions.delete(symbol.toUpperCase());
+    console.log(`[Replay] Unsubscribed from ${symbol.toUpperCase()}`);
+  }
+
+  async validateSymbol(symbol: string): Promise<SymbolInfo> {
+    const upperSymbol = symbol.toUpperCase();
+    const valid = this.knownSymbols.has(upperSymbol);
+    return {
+      symbol: upperSymbol,
+      name: upperSymbol,
+      assetType: 'crypto',
+      exchange: 'REPLAY',
+      valid,
+      error: valid ? undefined : 'Symbol not in the replay file',
+    };
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    return this.books.get(symbol.toUpperCase())?.orderBook(depth) ?? null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    return this.books.get(symbol.toUpperCase())?.snapshot(depth) ?? null;
+  }
+
+  private stopTimers(): void {
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    if (this.immediate) {
+      clearImmediate(this.immediate);
+      this.immediate = null;
+    }
+  }
+
+  /**
+   * Rewind to the first chunk and restart the playback clock
+   */
+  private restart(): void {
+    if (!this.reader || this.reader.chunks.length === 0) return;
+    this.books.clear();
+    this.chunkIndex = 0;
+    this.events = this.reader.readChunk(0);
+    this.eventIndex = 0;
+    this.fileStart = this.reader.chunks[0].firstTime;
+    this.clockStart = Date.now();
+    this.pump();
+  }
+
+  /**
+   * Emit everything that's due, then sleep until the next event is
+   */
+  private pump(): void {
+    this.timer = null;
+    this.immediate = null;
+    if (!this.reader) return;
+
+    const now = Date.now();
+    const horizon = this.speed > 0 ? this.fileStart + (now - this.clockStart) * this.speed : Infinity;
+    let budget = MAX_SPEED_BATCH;
+
+    for (;;) {
+      if (this.eventIndex >= this.events.length) {
+        if (!this.nextChunk()) {
+          if (this.loop) {
+            console.log('[Replay] End of file - looping');
+            this.restart();
+          } else {
+            console.log('[Replay] End of file');
+          }
+          return;
+        }
+        continue;
+      }
+
+      const event = this.events[this.eventIndex];
+      if (event.time > horizon) break;
+      this.eventIndex++;
+      this.dispatch(event, now);
+
+      if (this.speed === 0 && --budget === 0) break;
+    }
+
+    if (this.speed === 0) {
+      this.immediate = setImmediate(() => this.pump());
+    } else {
+      const next = this.events[this.eventIndex];
+      const due = this.clockStart + (next.time - this.fileStart) / this.speed;
+      this.timer = setTimeout(() => this.pump(), Math.min(MAX_SLEEP_MS, Math.max(0, due - Date.now())));
+    }
+  }
+
+  private nextChunk(): boolean {
+    if (!this.reader || this.chunkIndex + 1 >= this.reader.chunks.length) return false;
+    this.chunkIndex++;
+    this.events = this.reader.readChunk(this.chunkIndex);
+    this.eventIndex = 0;
+    return true;
+  }
+
+  private dispatch(event: TickEvent, now: number): void {
+    // Move the record onto the playback clock
+    const playbackTime = this.speed > 0 ? this.clockStart + (event.time - this.fileStart) / this.speed : now;
+    const data = event.data;
+    data.timestamp += playbackTime - event.time;
+
+    if (event.kind === 'delta') this.applyDelta(event.data);
+    if (!this.subscriptions.has(data.symbol)) return;
+
+    switch (event.kind) {
+      case 'trade':
+        this.emitTrade(event.data);
+        break;
+      case 'orderbook':
+        this.emitOrderBook(event.data);
+        break;
+      case 'delta':
+        this.emitOrderBookDelta(event.data);
+        break;
+      case 'ticker':
+        this.emitTicker(event.data);
+        break;
+    }
+  }
+
+  private applyDelta(delta: OrderBookDelta): void {
+    let book = this.books.get(delta.symbol);
+    if (!book) {
+      book = new MirrorBook(delta.symbol);
+      this.books.set(delta.symbol, book);
+    }
+    book.apply(delta);
+  }
+}
@@ -0,0 +1,284 @@
+// Synthetic adapter - generated trades and book updates at a fixed rate, for load testing
+
+import { BaseAdapter } from './base';
+import { AssetType, OrderBook, OrderBookDelta, SymbolInfo } from '../types';
+import { LocalOrderBook } from '../services/orderBookEngine';
+
+// Generator cadence - events owed since the last tick are emitted together
+const TICK_MS = 5;
+// Share of events that are trades; the rest are book deltas
+const TRADE_SHARE = 0.8;
+const LEVELS_PER_DELTA = 8;
+const BOOK_LEVELS = 200;
+const TOP_LEVELS = 20;
+const TICKER_INTERVAL_MS = 1000;
+
+export interface SyntheticConfig {
+  rate: number;       // Events per second, shared by all subscribed symbols
+}
+
+interface SyntheticSymbol {
+  book: LocalOrderBook;
+  tick: number;
+  mid: number;
+  open: number;
+  high: number;
+  low: number;
+  volume: number;
+  nextTradeId: number;
+  seq: number;
+}
+
+/**
+ * Market data that never stops and never varies in rate
+ *
+ * Every subscribed symbol gets a random-walk price with a consistent book
+ * around it. Timestamps are the moment of emission, so anything measured
+ * against them downstream is pure server/client-side latency. Any USDT
+ * symbol is accepted.
+ */
+export class SyntheticAdapter extends BaseAdapter {
+  name = 'Synthetic';
+  supportedAssetTypes: AssetType[] = ['crypto'];
+
+  private rate: number;
+  private symbols: Map<string, SyntheticSymbol> = new Map();
+  private order: string[] = [];
+  private cursor = 0;
+  private owed = 0;
+  private lastTick = 0;
+  private lastTicker = 0;
+  private timer: NodeJS.Timeout | null = null;
+
+  constructor(config: SyntheticConfig) {
+    super();
+    this.rate = Math.max(0, config.rate);
+  }
+
+  async connect(): Promise<void> {
+    if (this.timer) return;
+    console.log(`[Synthetic] Generating ${this.rate} events/sec`);
+    this.lastTick = Date.now();
+    this.timer = setInterval(() => this.generate(), TICK_MS);
+    this.emitConnect();
+  }
+
+  async disconnect(): Promise<void> {
+    if (this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+    this.symbols.clear();
+    this.order = [];
+    this.subscriptions.clear();
+    this.emitDisconnect();
+    console.log('[Synthetic] Disconnected');
+  }
+
+  async subscribe(symbol: string, _assetType: AssetType = 'crypto'): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (this.subscriptions.has(upperSymbol)) return;
+    this.subscriptions.add(upperSymbol);
+    this.symbols.set(upperSymbol, this.createSymbol(upperSymbol));
+    this.order = Array.from(this.subscriptions);
+
+    const state = this.symbols.get(upperSymbol)!;
+    this.emitOrderBookDelta(this.buildBookSnapshot(state, BOOK_LEVELS));
+    this.emitOrderBook(this.buildOrderBook(state, TOP_LEVELS));
+  }
+
+  async unsubscribe(symbol: string): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    this.subscriptions.delete(upperSymbol);
+    this.symbols.delete(upperSymbol);
+    this.order = Array.from(this.subscriptions);
+  }
+
+  async validateSymbol(symbol: string): Promise<SymbolInfo> {
+    const upperSymbol = symbol.toUpperCase();
+    return {
+      symbol: upperSymbol,
+      name: upperSymbol,
+      assetType: 'crypto',
+      exchange: 'SYNTHETIC',
+      valid: true,
+    };
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    const state = this.symbols.get(symbol.toUpperCase());
+    return state ? this.buildOrderBook(state, depth) : null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    const state = this.symbols.get(symbol.toUpperCase());
+    return state ? this.buildBookSnapshot(state, depth) : null;
+  }
+
+  /**
+   * Seed a symbol - the starting price is derived from the name, so runs
+   * are comparable
+   */
+  private createSymbol(symbol: string): SyntheticSymbol {
+    let hash = 0;
+    for (let i = 0; i < symbol.length; i++) hash = (hash * 31 + symbol.charCodeAt(i)) >>> 0;
+    const mid = 10 + (hash % 5000) * 10;
+    const tick = 0.01;
+
+    const book = new LocalOrderBook(symbol);
+    const bids: [number, number][] = [];
+    const asks: [number, number][] = [];
+    for (let i = 0; i < BOOK_LEVELS; i++) {
+      bids.push([this.round(mid - (i + 1) * tick, tick), this.randomSize()]);
+      asks.push([this.round(mid + (i + 1) * tick, tick), this.randomSize()]);
+    }
+    book.applySnapshot(bids, asks, 1);
+
+    return { book, tick, mid, open: mid, high: mid, low: mid, volume: 0, nextTradeId: 1, seq: 1 };
+  }
+
+  private round(price: number, tick: number): number {
+    return Math.round(price / tick) * tick;
+  }
+
+  private randomSize(): number {
+    return Math.round((0.01 + Math.random() * Math.random() * 5) * 1000) / 1000;
+  }
+
+  /**
+   * Emit however many events are owed since the last tick, round-robin
+   * across subscribed symbols
+   */
+  private generate(): void {
+    const now = Date.now();
+    this.owed += (this.rate * (now - this.lastTick)) / 1000;
+    this.lastTick = now;
+    if (this.order.length === 0) {
+      this.owed = 0;
+      return;
+    }
+
+    while (this.owed >= 1) {
+      this.owed--;
+      const state = this.symbols.get(this.order[this.cursor++ % this.order.length])!;
+      if (Math.random() < TRADE_SHARE) this.emitSyntheticTrade(state, now);
+      else this.emitSyntheticDelta(state, now);
+    }
+
+    if (now - this.lastTicker >= TICKER_INTERVAL_MS) {
+      this.lastTicker = now;
+      for (const state of this.symbols.values()) this.emitSyntheticTicker(state, now);
+    }
+  }
+
+  private emitSyntheticTrade(state: SyntheticSymbol, now: number): void {
+    const side = Math.random() < 0.5 ? 'buy' : 'sell';
+    const price = side === 'buy' ? state.book.bestAsk() : state.book.bestBid();
+    const volume = this.randomSize();
+    state.volume += volume;
+
+    this.emitTrade({
+      id: String(state.nextTradeId++),
+      symbol: state.book.symbol,
+      assetType: 'crypto',
+      timestamp: now,
+      price,
+      volume,
+      side,
+      exchange: 'SYNTHETIC',
+    });
+  }
+
+  /**
+   * Drift the mid by up to a tick and rewrite a handful of levels near it
+   */
+  private emitSyntheticDelta(state: SyntheticSymbol, now: number): void {
+    const { book, tick } = state;
+    state.mid = this.round(state.mid + (Math.floor(Math.random() * 3) - 1) * tick, tick);
+    state.high = Math.max(state.high, state.mid);
+    state.low = Math.min(state.low, state.mid);
+
+    const bids: [number, number][] = [];
+    const asks: [number, number][] = [];
+    for (let i = 0; i < LEVELS_PER_DELTA; i++) {
+      const offset = (1 + Math.floor(Math.random() * TOP_LEVELS)) * tick;
+      const bid = this.round(state.mid - offset, tick);
+      const ask = this.round(state.mid + offset, tick);
+      const bidSize = Math.random() < 0.1 ? 0 : this.randomSize();
+      const askSize = Math.random() < 0.1 ? 0 : this.randomSize();
+      if (book.applyLevel('bid', bid, bidSize) >= 0) bids.push([bid, bidSize]);
+      if (book.applyLevel('ask', ask, askSize) >= 0) asks.push([ask, askSize]);
+    }
+
+    // Anything that crossed the new mid is gone
+    while (book.bestBid() >= state.mid - tick / 2 && book.bestBid() > 0) {
+      bids.push([book.bestBid(), 0]);
+      book.applyLevel('bid', book.bestBid(), 0);
+    }
+    while (book.bestAsk() <= state.mid + tick / 2 && book.bestAsk() > 0) {
+      asks.push([book.bestAsk(), 0]);
+      book.applyLevel('ask', book.bestAsk(), 0);
+    }
+    book.trim(bids, asks);
+
+    const prevSeq = state.seq;
+    state.seq++;
+    book.lastUpdateId = state.seq;
+
+    this.emitOrderBookDelta({
+      symbol: book.symbol,
+      assetType: 'crypto',
+      timestamp: now,
+      seq: state.seq,
+      prevSeq,
+      bids,
+      asks,
+    });
+    this.emitOrderBook(this.buildOrderBook(state, TOP_LEVELS, now));
+  }
+
+  private emitSyntheticTicker(state: SyntheticSymbol, now: number): void {
+    const priceChange = state.mid - state.open;
+    this.emitTicker({
+      symbol: state.book.symbol,
+      assetType: 'crypto',
+      timestamp: now,
+      lastPrice: state.mid,
+      priceChange,
+      priceChangePercent: (priceChange / state.open) * 100,
+      highPrice: state.high,
+      lowPrice: state.low,
+      volume: state.volume,
+      quoteVolume: state.volume * state.mid,
+      openPrice: state.open,
+    });
+  }
+
+  private buildOrderBook(state: SyntheticSymbol, depth: number, timestamp: number = Date.now()): OrderBook {
+    const bestBid = state.book.bestBid();
+    const spread = state.book.bestAsk() - bestBid;
+    return {
+      symbol: state.book.symbol,
+      assetType: 'crypto',
+      timestamp,
+      bids: state.book.topBids(depth),
+      asks: state.book.topAsks(depth),
+      spread,
+      spreadPercent: bestBid > 0 ? (spread / bestBid) * 100 : 0,
+      seq: state.seq,
+    };
+  }
+
+  private buildBookSnapshot(state: SyntheticSymbol, depth: number): OrderBookDelta {
+    return {
+      symbol: state.book.symbol,
+      assetType: 'crypto',
+      timestamp: Date.now(),
+      seq: state.seq,
+      prevSeq: 0,
+      bids: state.book.topBidPairs(depth),
+      asks: state.book.topAskPairs(depth),
+      snapshot: true,
+    };
+  }
+}
@@ -0,0 +1,244 @@
+// Venue adapter base - the single-socket exchanges (Bybit, OKX, Coinbase) share subscriptions,
+// local books and parse timing here, and only translate their own messages
+
+import { performance } from 'perf_hooks';
+import { BaseAdapter } from './base';
+import { VenueSocket, VenueSocketOptions } from './venueSocket';
+import { AssetType, OrderBook, OrderBookDelta } from '../types';
+import { LocalOrderBook } from '../services/orderBookEngine';
+import { metrics } from '../services/metrics';
+
+// Levels in the 'orderbook' snapshots we emit for clients that don't take deltas
+const TOP_LEVELS = 20;
+
+const parseSeconds = metrics.histogram('tapeflow_venue_parse_seconds', 'Exchange message parse and handling time', 'venue');
+
+/**
+ * One symbol's book on this venue
+ *
+ * seq is ours, not the venue's: every venue numbers its updates its own way
+ * (or not at all), so emitted deltas are simply chained 1, 2, 3... and a
+ * venue-side resync goes out as a snapshot. venueSeq is for adapters whose
+ * venue does sequence its updates, to spot a gap.
+ */
+export interface VenueBook {
+  book: LocalOrderBook;
+  synced: boolean;
+  seq: number;
+  venueSeq: number;
+}
+
+/**
+ * An exchange reached over one socket, with TapeFlow symbols (BTCUSDT) on
+ * the outside and the venue's own names (BTC-USDT, BTC-USD) on the wire
+ *
+ * Subclasses say how to name a symbol, what to send to (un)subscribe, and
+ * how to read a message; they call applyBook with the levels they parsed
+ * and get deltas, snapshots and top-of-book emitted the same way the
+ * Binance adapter does. Books reset when the socket drops and come back
+ * from the snapshot the venue sends on resubscribe.
+ */
+export abstract class VenueAdapter extends BaseAdapter {
+  supportedAssetTypes: AssetType[] = ['crypto'];
+
+  // 'BYBIT', 'OKX' - what goes in Trade.exchange
+  abstract readonly exchange: string;
+
+  protected books: Map<string, VenueBook> = new Map();
+  private symbolsByVenue: Map<string, string> = new Map();
+  private socket: VenueSocket | null = null;
+
+  protected abstract readonly url: string;
+  protected abstract readonly socketOptions: VenueSocketOptions;
+
+  // The venue's name for a TapeFlow symbol
+  abstract venueSymbol(symbol: string): string;
+  protected abstract subscribeMessages(venueSymbols: string[]): string[];
+  protected abstract unsubscribeMessages(venueSymbols: string[]): string[];
+  protected abstract handleMessage(data: string): void;
+
+  async connect(): Promise<void> {
+    if (this.socket) return;
+    console.log(`[${this.name}] Connecting...`);
+    this.socket = new VenueSocket(this.name, this.url, {
+      onOpen: () => {
+        // Fresh socket carries nothing yet - resubscribe everything we hold
+        this.sendAll(this.subscribeMessages(Array.from(this.symbolsByVenue.keys())));
+        if (!this.connected) this.emitConnect();
+      },
+      onMessage: (data) => {
+        const start = performance.now();
+        try {
+          this.handleMessage(data);
+        } catch (error) {
+          console.error(`[${this.name}] Error handling message:`, (error as Error).message);
+        }
+        parseSeconds.observe((performance.now() - start) / 1000, this.exchange);
+      },
+      onClose: () => {
+        for (const state of this.books.values()) this.resetBook(state);
+        if (this.connected) this.emitDisconnect();
+      },
+      onError: (error) => this.emitError(error),
+    }, this.socketOptions);
+    await this.socket.connect();
+  }
+
+  async disconnect(): Promise<void> {
+    this.socket?.close();
+    this.socket = null;
+    this.subscriptions.clear();
+    this.symbolsByVenue.clear();
+    this.books.clear();
+    this.emitDisconnect();
+    console.log(`[${this.name}] Disconnected`);
+  }
+
+  async subscribe(symbol: string, _assetType: AssetType = 'crypto'): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (this.subscriptions.has(upperSymbol)) return;
+    const venueSymbol = this.venueSymbol(upperSymbol);
+    this.subscriptions.add(upperSymbol);
+    this.symbolsByVenue.set(venueSymbol, upperSymbol);
+    this.books.set(upperSymbol, { book: new LocalOrderBook(upperSymbol), synced: false, seq: 0, venueSeq: 0 });
+    // Not open yet: the open handler subscribes everything we hold
+    this.sendAll(this.subscribeMessages([venueSymbol]));
+    console.log(`[${this.name}] Subscribed to ${upperSymbol} (${venueSymbol})`);
+  }
+
+  async unsubscribe(symbol: string): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (!this.subscriptions.delete(upperSymbol)) return;
+    const venueSymbol = this.venueSymbol(upperSymbol);
+    this.symbolsByVenue.delete(venueSymbol);
+    this.books.delete(upperSymbol);
+    this.sendAll(this.unsubscribeMessages([venueSymbol]));
+    console.log(`[${this.name}] Unsubscribed from ${upperSymbol}`);
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    const state = this.books.get(symbol.toUpperCase());
+    return state?.synced ? this.buildOrderBook(state, depth, Date.now()) : null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    const state = this.books.get(symbol.toUpperCase());
+    return state?.synced ? this.buildBookSnapshot(state, depth) : null;
+  }
+
+  /**
+   * TapeFlow symbol for a venue symbol we're subscribed to
+   */
+  protected symbolFor(venueSymbol: string): string | undefined {
+    return this.symbolsByVenue.get(venueSymbol);
+  }
+
+  protected send(message: string): void {
+    this.socket?.send(message);
+  }
+
+  private sendAll(messages: string[]): void {
+    for (const message of messages) this.send(message);
+  }
+
+  /**
+   * Apply parsed levels to a symbol's book and emit what changed
+   *
+   * snapshot replaces the book and goes out as a snapshot delta; otherwise
+   * levels are applied one by one (size 0 removes) and only the ones that
+   * actually changed are emitted. Updates before the first snapshot are
+   * dropped - the venue sends one right after subscribing.
+   */
+  protected applyBook(symbol: string, bids: [number, number][], asks: [number, number][], snapshot: boolean, timestamp: number): void {
+    const state = this.books.get(symbol);
+    if (!state) return;
+    const { book } = state;
+
+    if (snapshot) {
+      book.applySnapshot(bids, asks, ++state.seq);
+      book.trim();
+      state.synced = true;
+      this.emitOrderBookDelta(this.buildBookSnapshot(state, Math.max(bids.length, asks.length), timestamp));
+      this.emitOrderBook(this.buildOrderBook(state, TOP_LEVELS, timestamp));
+      return;
+    }
+    if (!state.synced) return;
+
+    const changedBids: [number, number][] = [];
+    const changedAsks: [number, number][] = [];
+    let topChanged = false;
+    for (const [price, size] of bids) {
+      const index = book.applyLevel('bid', price, size);
+      if (index < 0) continue;
+      changedBids.push([price, size]);
+      if (index < TOP_LEVELS) topChanged = true;
+    }
+    for (const [price, size] of asks) {
+      const index = book.applyLevel('ask', price, size);
+      if (index < 0) continue;
+      changedAsks.push([price, size]);
+      if (index < TOP_LEVELS) topChanged = true;
+    }
+    book.trim(changedBids, changedAsks);
+
+    if (changedBids.length > 0 || changedAsks.length > 0) {
+      const prevSeq = state.seq;
+      book.lastUpdateId = ++state.seq;
+      this.emitOrderBookDelta({
+        symbol,
+        assetType: 'crypto',
+        timestamp,
+        seq: state.seq,
+        prevSeq,
+        bids: changedBids,
+        asks: changedAsks,
+      });
+    }
+    if (topChanged) this.emitOrderBook(this.buildOrderBook(state, TOP_LEVELS, timestamp));
+  }
+
+  /**
+   * Forget a book until the venue sends the next snapshot
+   */
+  protected resetBook(state: VenueBook): void {
+    state.book.clear();
+    state.synced = false;
+    state.venueSeq = 0;
+  }
+
+  private buildOrderBook(state: VenueBook, depth: number, timestamp: number): OrderBook {
+    const { book } = state;
+    const bestBid = book.bestBid();
+    const spread = book.bestAsk() - bestBid;
+    return {
+      symbol: book.symbol,
+      assetType: 'crypto',
+      timestamp,
+      bids: book.topBids(depth),
+      asks: book.topAsks(depth),
+      spread,
+      spreadPercent: bestBid > 0 ? (spread / bestBid) * 100 : 0,
+      seq: state.seq,
+    };
+  }
+
+  private buildBookSnapshot(state: VenueBook, depth: number, timestamp: number = Date.now()): OrderBookDelta {
+    return {
+      symbol: state.book.symbol,
+      assetType: 'crypto',
+      timestamp,
+      seq: state.seq,
+      prevSeq: 0,
+      bids: state.book.topBidPairs(depth),
+      asks: state.book.topAskPairs(depth),
+      snapshot: true,
+    };
+  }
+}
+
+/**
+ * Base asset of a TapeFlow symbol - the server only takes USDT pairs
+ */
+export function baseAsset(symbol: string): string {
+  return symbol.endsWith('USDT') ? symbol.slice(0, -4) : symbol;
+}
@@ -0,0 +1,140 @@
+// One reconnecting WebSocket to an exchange, with the keepalive that exchange wants
+
+import WebSocket from 'ws';
+
+const RECONNECT_BASE_MS = 1000;
+const RECONNECT_MAX_MS = 30000;
+const CONNECT_TIMEOUT_MS = 10000;
+
+export interface VenueSocketHandlers {
+  onOpen: () => void;
+  onMessage: (data: string) => void;
+  onClose: () => void;
+  onError: (error: Error) => void;
+}
+
+export interface VenueSocketOptions {
+  pingIntervalMs?: number;    // Application-level ping, for venues that drop quiet sockets
+  ping?: () => string;        // What to send - protocol pings are answered by ws itself
+}
+
+/**
+ * The socket half of a venue adapter
+ *
+ * Same shape as a Binance shard without the pool: one connection, its own
+ * backoff loop, and onOpen on every (re)open so the adapter can resubscribe
+ * whatever it holds. Messages are handed over as text - every venue here
+ * speaks JSON.
+ */
+export class VenueSocket {
+  private ws: WebSocket | null = null;
+  private reconnectTimer: NodeJS.Timeout | null = null;
+  private pingTimer: NodeJS.Timeout | null = null;
+  private reconnectAttempts: number = 0;
+  private closing: boolean = false;
+
+  constructor(
+    private readonly name: string,
+    private readonly url: string,
+    private readonly handlers: VenueSocketHandlers,
+    private readonly options: VenueSocketOptions = {}
+  ) {}
+
+  get isOpen(): boolean {
+    return this.ws !== null && this.ws.readyState === WebSocket.OPEN;
+  }
+
+  /**
+   * Open the socket - resolves once it's open, rejects on error or timeout.
+   * Reconnects after a drop are handled internally.
+   */
+  connect(): Promise<void> {
+    this.closing = false;
+
+    return new Promise((resolve, reject) => {
+      const ws = new WebSocket(this.url);
+      this.ws = ws;
+
+      const timeout = setTimeout(() => {
+        if (ws.readyState !== WebSocket.OPEN) {
+          ws.terminate();
+          reject(new Error('Connection timeout'));
+        }
+      }, CONNECT_TIMEOUT_MS);
+
+      ws.on('open', () => {
+        clearTimeout(timeout);
+        console.log(`[${this.name}] Connected`);
+        this.reconnectAttempts = 0;
+        this.startPing();
+        this.handlers.onOpen();
+        resolve();
+      });
+
+      ws.on('message', (data: Buffer) => this.handlers.onMessage(data.toString()));
+
+      ws.on('error', (error: Error) => {
+        clearTimeout(timeout);
+        console.error(`[${this.name}] Socket error:`, error.message);
+        this.handlers.onError(error);
+        reject(error);
+      });
+
+      ws.on('close', () => {
+        clearTimeout(timeout);
+        if (this.ws !== ws) return;
+        this.ws = null;
+        this.stopPing();
+        console.log(`[${this.name}] Socket closed`);
+        this.handlers.onClose();
+        if (!this.closing) this.scheduleReconnect();
+      });
+    });
+  }
+
+  send(message: string): void {
+    if (this.ws && this.ws.readyState === WebSocket.OPEN) this.ws.send(message);
+  }
+
+  close(): void {
+    this.closing = true;
+    if (this.reconnectTimer) {
+      clearTimeout(this.reconnectTimer);
+      this.reconnectTimer = null;
+    }
+    this.stopPing();
+    if (this.ws) {
+      this.ws.close();
+      this.ws = null;
+    }
+  }
+
+  private scheduleReconnect(): void {
+    if (this.reconnectTimer) return;
+
+    const delay = Math.min(RECONNECT_BASE_MS * Math.pow(2, this.reconnectAttempts), RECONNECT_MAX_MS);
+    this.reconnectAttempts++;
+    console.log(`[${this.name}] Reconnecting in ${delay}ms (attempt ${this.reconnectAttempts})`);
+
+    this.reconnectTimer = setTimeout(() => {
+      this.reconnectTimer = null;
+      this.connect().catch(() => {
+        // The close handler schedules the next retry
+      });
+    }, delay);
+  }
+
+  private startPing(): void {
+    const { pingIntervalMs, ping } = this.options;
+    if (!pingIntervalMs || !ping) return;
+    this.stopPing();
+    this.pingTimer = setInterval(() => this.send(ping()), pingIntervalMs);
+  }
+
+  private stopPing(): void {
+    if (this.pingTimer) {
+      clearInterval(this.pingTimer);
+      this.pingTimer = null;
+    }
+  }
+}
@@ -0,0 +1,187 @@
+// Worker feed adapter - a fan-out worker's view of the adapter running on the main thread
+
+import { MessagePort } from 'worker_threads';
+import { BaseAdapter } from './base';
+import { AssetType, OrderBook, OrderBookDelta, Signal, SymbolInfo } from '../types';
+import { MirrorBook } from '../services/mirrorBook';
+import { SharedRing, decodeEvent } from '../services/sharedRing';
+import { MainToWorker, WorkerToMain, WorkerStats } from '../services/fanoutPool';
+import { FamilySnapshot } from '../services/metrics';
+
+// Records handled before yielding, so the worker's own sockets keep moving
+const DRAIN_BATCH = 4096;
+
+/**
+ * Market data for a fan-out worker, read from its shared ring
+ *
+ * To the rest of server.ts this is just another adapter: subscribe and
+ * validate go to the main thread over the control port, events come back
+ * through the ring and are re-emitted, and a MirrorBook per symbol answers
+ * getOrderBook/getBookSnapshot for late joiners the same way BusAdapter
+ * does on an edge. Signals are detected once on the main thread.
+ */
+export class WorkerFeedAdapter extends BaseAdapter {
+  name = 'WorkerFeed';
+  supportedAssetTypes: AssetType[] = ['crypto'];
+
+  private ring: SharedRing;
+  private books: Map<string, MirrorBook> = new Map();
+  private signalCallbacks: ((signal: Signal) => void)[] = [];
+  private pending: Map<number, (data: any) => void> = new Map();
+  private nextRequestId = 1;
+  private draining = false;
+
+  constructor(ring: SharedArrayBuffer, private port: MessagePort) {
+    super();
+    this.ring = new SharedRing(ring);
+    port.on('message', (message: MainToWorker) => this.handle(message));
+  }
+
+  onSignal(callback: (signal: Signal) => void): void {
+    this.signalCallbacks.push(callback);
+  }
+
+  async connect(): Promise<void> {
+    this.emitConnect();
+    this.drain();
+  }
+
+  async disconnect(): Promise<void> {
+    this.books.clear();
+    this.subscriptions.clear();
+    this.emitDisconnect();
+  }
+
+  async subscribe(symbol: string, _assetType: AssetType = 'crypto'): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    if (this.subscriptions.has(upperSymbol)) return this.pendingHistory(upperSymbol);
+    this.subscriptions.add(upperSymbol);
+    this.books.set(upperSymbol, new MirrorBook(upperSymbol));
+    // The main thread puts the recent trades in the ring once its subscribe is done
+    const history = this.waitForHistory(upperSymbol);
+    this.send({ op: 'sub', symbol: upperSymbol });
+    return history;
+  }
+
+  async unsubscribe(symbol: string): Promise<void> {
+    const upperSymbol = symbol.toUpperCase();
+    this.subscriptions.delete(upperSymbol);
+    this.books.delete(upperSymbol);
+    this.settleHistory(upperSymbol);
+    this.send({ op: 'unsub', symbol: upperSymbol });
+  }
+
+  validateSymbol(symbol: string): Promise<SymbolInfo> {
+    return this.request<SymbolInfo>(id => ({ op: 'validate', id, symbol: symbol.toUpperCase() }));
+  }
+
+  /**
+   * Process-wide /health from the main thread (clients summed over workers)
+   */
+  health(): Promise<Record<string, unknown>> {
+    return this.request<Record<string, unknown>>(id => ({ op: 'health', id }));
+  }
+
+  /**
+   * Process-wide /metrics text, rendered on the main thread
+   */
+  metrics(): Promise<string> {
+    return this.request<string>(id => ({ op: 'metrics', id }));
+  }
+
+  reportStats(stats: WorkerStats, metrics: FamilySnapshot[]): void {
+    this.send({ op: 'stats', stats, metrics });
+  }
+
+  getOrderBook(symbol: string, depth: number): OrderBook | null {
+    return this.books.get(symbol.toUpperCase())?.orderBook(depth) ?? null;
+  }
+
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null {
+    return this.books.get(symbol.toUpperCase())?.snapshot(depth) ?? null;
+  }
+
+  private send(message: WorkerToMain): void {
+    this.port.postMessage(message);
+  }
+
+  private request<T>(build: (id: number) => WorkerToMain): Promise<T> {
+    const id = this.nextRequestId++;
+    return new Promise(resolve => {
+      this.pending.set(id, resolve);
+      this.send(build(id));
+    });
+  }
+
+  private handle(message: MainToWorker): void {
+    switch (message.op) {
+      case 'wake':
+        this.drain();
+        break;
+      case 'validation':
+      case 'health':
+      case 'metrics': {
+        const resolve = this.pending.get(message.id);
+        this.pending.delete(message.id);
+        resolve?.(message.data);
+        break;
+      }
+    }
+  }
+
+  /**
+   * Empty the ring in slices, then tell the producer we're idle
+   */
+  private drain(): void {
+    if (this.draining) return;
+    this.draining = true;
+
+    const run = () => {
+      for (let i = 0; i < DRAIN_BATCH; i++) {
+        const record = this.ring.pop();
+        if (!record) {
+          if (this.ring.sleep()) {
+            this.draining = false;
+            return;
+          }
+          continue;
+        }
+        try {
+          this.dispatch(record);
+        } catch (error) {
+          console.error('[WorkerFeed] Bad record:', (error as Error).message);
+        }
+      }
+      setImmediate(run);
+    };
+    run();
+  }
+
+  private dispatch(record: Buffer): void {
+    const event = decodeEvent(record);
+    // Anything already in the ring when we unsubscribed is dropped here
+    if (!this.subscriptions.has(event.data.symbol)) return;
+
+    switch (event.kind) {
+      case 'trade':
+        this.emitTrade(event.data);
+        break;
+      case 'orderbook':
+        this.emitOrderBook(event.data);
+        break;
+      case 'delta':
+        this.books.get(event.data.symbol)?.apply(event.data);
+        this.emitOrderBookDelta(event.data);
+        break;
+      case 'ticker':
+        this.emitTicker(event.data);
+        break;
+      case 'signal':
+        this.signalCallbacks.forEach(cb => cb(event.data));
+        break;
+      case 'history':
+        this.emitHistory(event.data);
+        break;
+    }
+  }
+}
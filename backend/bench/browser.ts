@@ -0,0 +1,123 @@
+// Browser benchmark - headless Chrome on the real dashboard, fed by the synthetic server
+//
+//   cd frontend && npm run dev                     # the app under test, in another terminal
+//   npm run bench:browser                          # 2k events/s on 2 symbols for 30s
+//   npm run bench:browser -- --rate 20000 --list BTCUSDT,ETHUSDT,SOLUSDT --duration 60
+//
+// Needs puppeteer (npm i -D puppeteer - it's not a regular dependency since
+// it downloads a browser). The dashboard connects to ws://localhost:3001 by
+// default, so that's where the synthetic server is started; --server false
+// benches whatever is already listening there instead.
+//
+// Everything comes from the app's own ?perf probe (frontend/src/services/
+// perfProbe.ts): frame interval and scheduled work per frame from the frame
+// scheduler, and event timestamp -> paint for TapeTable and OrderBook.
+
+import { ChildProcess } from 'child_process';
+import axios from 'axios';
+import { parseArgs, startServer, sleep, summariseSamples, formatLatency, reportResult } from './harness';
+
+const args = parseArgs({
+  app: 'http://localhost:5173',
+  rate: 2000,
+  list: 'BTCUSDT,ETHUSDT',
+  duration: 30,
+  warmup: 5,
+  port: 3001,
+  server: true,
+  headful: false,
+  json: '',
+  baseline: '',
+  tolerance: 0.2,
+});
+
+const GATED_METRICS: Record<string, boolean> = {
+  frameP99: true,
+  workP99: true,
+  tapeP99: true,
+  bookP99: true,
+};
+
+interface PerfSnapshot {
+  frameInterval: number[];
+  frameWork: number[];
+  tape: number[];
+  book: number[];
+  lateFrames: number;
+}
+
+function loadPuppeteer(): any {
+  try {
+    // eslint-disable-next-line @typescript-eslint/no-var-requires
+    return require('puppeteer');
+  } catch {
+    console.error('[bench] puppeteer is not installed - run: npm i -D puppeteer');
+    process.exit(1);
+  }
+}
+
+async function main() {
+  const puppeteer = loadPuppeteer();
+
+  try {
+    await axios.get(args.app, { timeout: 2000 });
+  } catch {
+    throw new Error(`Nothing at ${args.app} - start the frontend first (cd frontend && npm run dev)`);
+  }
+
+  let server: ChildProcess | null = null;
+  if (args.server) {
+    server = await startServer({ port: args.port, source: 'synthetic', rate: args.rate, replayFile: '', replaySpeed: '1' });
+  }
+
+  console.log(
+    `\nBrowser benchmark: ${args.app}, ${args.server ? `${args.rate} events/s synthetic` : 'external server'}, ` +
+    `${args.list}, ${args.duration}s after ${args.warmup}s warmup\n`
+  );
+
+  const browser = await puppeteer.launch({ headless: !args.headful, args: ['--disable-background-timer-throttling'] });
+  try {
+    const page = await browser.newPage();
+    await page.setViewport({ width: 1600, height: 1000 });
+    await page.goto(`${args.app}/?perf=${encodeURIComponent(args.list)}`, { waitUntil: 'load' });
+    // Page-side expressions are strings - this build has no DOM types
+    await page.waitForFunction('window.__tapeflowPerf !== undefined', { timeout: 10_000 });
+
+    await sleep(args.warmup * 1000);
+    await page.evaluate('window.__tapeflowPerf.reset()');
+    await sleep(args.duration * 1000);
+    const perf: PerfSnapshot = await page.evaluate('window.__tapeflowPerf.snapshot()');
+
+    const frames = summariseSamples(perf.frameInterval);
+    const work = summariseSamples(perf.frameWork);
+    const tape = summariseSamples(perf.tape);
+    const book = summariseSamples(perf.book);
+
+    console.log(formatLatency('frame', frames));
+    console.log(formatLatency('work', work));
+    console.log(formatLatency('tape', tape));
+    console.log(formatLatency('book', book));
+    console.log(`\n  fps ${(perf.frameInterval.length / args.duration).toFixed(0)}  late frames ${perf.lateFrames}\n`);
+
+    const result: Record<string, number> = {
+      rate: args.rate,
+      fps: perf.frameInterval.length / args.duration,
+      frameP99: frames.p99,
+      workP99: work.p99,
+      tapeP50: tape.p50,
+      tapeP99: tape.p99,
+      bookP50: book.p50,
+      bookP99: book.p99,
+      lateFrames: perf.lateFrames,
+    };
+    reportResult(result, args, GATED_METRICS);
+  } finally {
+    await browser.close();
+    server?.kill();
+  }
+}
+
+main().catch(error => {
+  console.error('[bench] Failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,257 @@
+// Bench helpers - spawn a server on a given data source, sample its process, summarise latencies
+
+import fs from 'fs';
+import { spawn, ChildProcess } from 'child_process';
+import path from 'path';
+import axios from 'axios';
+
+const BACKEND_DIR = path.join(__dirname, '..');
+const STARTUP_TIMEOUT_MS = 20_000;
+
+/**
+ * Minimal --flag value parsing: numbers where the default is a number,
+ * bare flags are true
+ */
+export function parseArgs<T extends Record<string, string | number | boolean>>(defaults: T): T {
+  const base: Record<string, string | number | boolean> = defaults;
+  const args: Record<string, string | number | boolean> = { ...base };
+  const argv = process.argv.slice(2);
+  for (let i = 0; i < argv.length; i++) {
+    if (!argv[i].startsWith('--')) continue;
+    const key = argv[i].slice(2);
+    const next = argv[i + 1];
+    const hasValue = next !== undefined && !next.startsWith('--');
+    const value = hasValue ? next : 'true';
+    if (hasValue) i++;
+
+    switch (typeof base[key]) {
+      case 'number': args[key] = Number(value); break;
+      case 'boolean': args[key] = value !== 'false'; break;
+      default: args[key] = value;
+    }
+  }
+  return args as T;
+}
+
+export interface ServerOptions {
+  port: number;
+  source: 'synthetic' | 'replay';
+  rate: number;           // Synthetic events/sec
+  replayFile: string;
+  replaySpeed: string;    // Number or 'max'
+  workers?: number;       // FANOUT_WORKERS for the server (0 = single thread)
+}
+
+/**
+ * Start server.ts in its own process so the bench's own CPU doesn't count
+ * against it
+ */
+export async function startServer(options: ServerOptions): Promise<ChildProcess> {
+  const child = spawn(process.execPath, [require.resolve('tsx/cli'), 'server.ts'], {
+    cwd: BACKEND_DIR,
+    stdio: ['ignore', 'pipe', 'pipe'],
+    env: {
+      ...process.env,
+      PORT: String(options.port),
+      DATA_SOURCE: options.source,
+      SYNTHETIC_RATE: String(options.rate),
+      REPLAY_FILE: options.replayFile,
+      REPLAY_SPEED: options.replaySpeed,
+      REPLAY_LOOP: 'true',
+      CAPTURE_DIR: '',
+      FANOUT_WORKERS: String(options.workers ?? 0),
+    },
+  });
+  child.stderr?.on('data', (data: Buffer) => process.stderr.write(`[server] ${data}`));
+  child.stdout?.resume();
+
+  const deadline = Date.now() + STARTUP_TIMEOUT_MS;
+  while (Date.now() < deadline) {
+    if (child.exitCode !== null) throw new Error(`Server exited with code ${child.exitCode}`);
+    try {
+      await axios.get(`http://localhost:${options.port}/health`, { timeout: 500 });
+      return child;
+    } catch {
+      await sleep(250);
+    }
+  }
+  child.kill();
+  throw new Error('Server did not come up in time');
+}
+
+export function sleep(ms: number): Promise<void> {
+  return new Promise(resolve => setTimeout(resolve, ms));
+}
+
+export interface ProcessSample {
+  cpuPercent: number;     // Of one core, since the previous sample
+  rssMb: number;
+}
+
+/**
+ * Reads the process counters the server exposes on /health
+ */
+export class ProcessSampler {
+  private lastCpu = 0;
+  private lastUptime = 0;
+  readonly samples: ProcessSample[] = [];
+
+  constructor(private port: number) {}
+
+  async sample(): Promise<void> {
+    const { data } = await axios.get(`http://localhost:${this.port}/health`, { timeout: 1000 });
+    const cpu = data.process.cpu.user + data.process.cpu.system;   // microseconds
+    const uptime = data.process.uptime;                            // seconds
+    if (this.lastUptime > 0 && uptime > this.lastUptime) {
+      this.samples.push({
+        cpuPercent: ((cpu - this.lastCpu) / 1e4) / (uptime - this.lastUptime),
+        rssMb: data.process.rss / 1024 / 1024,
+      });
+    }
+    this.lastCpu = cpu;
+    this.lastUptime = uptime;
+  }
+
+  summary(): { cpuAvg: number; cpuMax: number; rssAvg: number; rssMax: number } {
+    const n = Math.max(1, this.samples.length);
+    let cpuSum = 0, cpuMax = 0, rssSum = 0, rssMax = 0;
+    for (const s of this.samples) {
+      cpuSum += s.cpuPercent;
+      rssSum += s.rssMb;
+      cpuMax = Math.max(cpuMax, s.cpuPercent);
+      rssMax = Math.max(rssMax, s.rssMb);
+    }
+    return { cpuAvg: cpuSum / n, cpuMax, rssAvg: rssSum / n, rssMax };
+  }
+}
+
+// 0.1ms buckets up to 5s - fixed memory however many samples come in
+const BUCKET_MS = 0.1;
+const BUCKETS = 50_000;
+
+/**
+ * Fixed-bucket latency histogram
+ */
+export class Histogram {
+  private counts = new Uint32Array(BUCKETS + 1);
+  private total = 0;
+  private sum = 0;
+  private maxValue = 0;
+
+  record(ms: number): void {
+    const value = ms < 0 ? 0 : ms;
+    this.counts[Math.min(BUCKETS, Math.floor(value / BUCKET_MS))]++;
+    this.total++;
+    this.sum += value;
+    if (value > this.maxValue) this.maxValue = value;
+  }
+
+  get count(): number {
+    return this.total;
+  }
+
+  get max(): number {
+    return this.maxValue;
+  }
+
+  get mean(): number {
+    return this.total > 0 ? this.sum / this.total : 0;
+  }
+
+  percentile(p: number): number {
+    if (this.total === 0) return 0;
+    const target = Math.ceil(this.total * p);
+    let seen = 0;
+    for (let i = 0; i <= BUCKETS; i++) {
+      seen += this.counts[i];
+      if (seen >= target) return i * BUCKET_MS;
+    }
+    return this.maxValue;
+  }
+}
+
+export interface LatencySummary {
+  count: number;
+  mean: number;
+  p50: number;
+  p90: number;
+  p99: number;
+  p999: number;
+  max: number;
+}
+
+export function summarise(histogram: Histogram): LatencySummary {
+  return {
+    count: histogram.count,
+    mean: histogram.mean,
+    p50: histogram.percentile(0.5),
+    p90: histogram.percentile(0.9),
+    p99: histogram.percentile(0.99),
+    p999: histogram.percentile(0.999),
+    max: histogram.max,
+  };
+}
+
+/**
+ * Summary from plain samples (small sets - browser frame times)
+ */
+export function summariseSamples(samples: number[]): LatencySummary {
+  const histogram = new Histogram();
+  for (const sample of samples) histogram.record(sample);
+  return summarise(histogram);
+}
+
+export function formatLatency(name: string, s: LatencySummary): string {
+  const ms = (v: number) => v.toFixed(1).padStart(7);
+  return `  ${name.padEnd(10)} n=${String(s.count).padStart(9)}  mean ${ms(s.mean)}  ` +
+    `p50 ${ms(s.p50)}  p90 ${ms(s.p90)}  p99 ${ms(s.p99)}  p99.9 ${ms(s.p999)}  max ${ms(s.max)} ms`;
+}
+
+/**
+ * Compare a run against a saved one - returns what got worse by more than
+ * the tolerance (0.2 = 20%)
+ */
+export function compareToBaseline(
+  current: Record<string, number>,
+  baseline: Record<string, number>,
+  higherIsWorse: Record<string, boolean>,
+  tolerance: number
+): string[] {
+  const regressions: string[] = [];
+  for (const [key, worseIfHigher] of Object.entries(higherIsWorse)) {
+    const now = current[key];
+    const before = baseline[key];
+    if (now === undefined || before === undefined || before === 0) continue;
+    const change = (now - before) / before;
+    if (worseIfHigher ? change > tolerance : change < -tolerance) {
+      regressions.push(`${key}: ${before.toFixed(2)} -> ${now.toFixed(2)} (${(change * 100).toFixed(0)}%)`);
+    }
+  }
+  return regressions;
+}
+
+/**
+ * Write the run's metrics (--json) and gate it against a saved run
+ * (--baseline) - sets a non-zero exit code on regression
+ */
+export function reportResult(
+  result: Record<string, number>,
+  options: { json: string; baseline: string; tolerance: number },
+  gated: Record<string, boolean>
+): void {
+  if (options.json) {
+    fs.writeFileSync(options.json, JSON.stringify(result, null, 2));
+    console.log(`  wrote ${options.json}`);
+  }
+  if (!options.baseline) return;
+
+  const baseline = JSON.parse(fs.readFileSync(options.baseline, 'utf8'));
+  const regressions = compareToBaseline(result, baseline, gated, options.tolerance);
+  if (regressions.length > 0) {
+    console.log(`  REGRESSED vs ${options.baseline}:`);
+    for (const line of regressions) console.log(`    ${line}`);
+    process.exitCode = 1;
+  } else {
+    console.log(`  ok vs ${options.baseline} (tolerance ${(options.tolerance * 100).toFixed(0)}%)`);
+  }
+}
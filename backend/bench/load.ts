@@ -0,0 +1,201 @@
+// Load benchmark - drive the server with synthetic or replayed traffic and measure fan-out latency
+//
+//   npm run bench:load                                         # 5k events/s, 10 symbols, 50 clients, 30s
+//   npm run bench:load -- --rate 50000 --symbols 20 --clients 200 --encoding binary
+//   npm run bench:load -- --deltas --maxRate 1                    # background-tab clients
+//   npm run bench:load -- --workers 8 --clients 2000 --encoding binary   # fan-out across threads
+//   npm run bench:load -- --source replay --replay captures/x.tfc --list BTCUSDT,ETHUSDT
+//   npm run bench:load -- --json out.json --baseline bench/baseline.json   # non-zero exit on regression
+//
+// The server runs in its own process (DATA_SOURCE=synthetic or replay), so
+// CPU and RSS are the server's alone, read from /health once a second.
+// Latency is receive time minus the event timestamp, which the synthetic
+// and replay adapters set to the moment of emission - so it covers
+// batching, serialisation, the socket and the client's parse. Everything
+// runs on one machine clock; ms resolution. The clients share this process,
+// so at the top rates use --encoding binary or the bench itself becomes
+// the bottleneck (watch for clientCpu near 100%).
+
+import WebSocket from 'ws';
+import { ChildProcess } from 'child_process';
+import { FRAME_HISTORY, HEADER_SIZE, TRADE_RECORD_SIZE } from '../services/binaryProtocol';
+import {
+  parseArgs, startServer, sleep, ProcessSampler, Histogram, summarise, formatLatency, reportResult,
+} from './harness';
+
+const args = parseArgs({
+  source: 'synthetic',
+  rate: 5000,
+  symbols: 10,
+  list: '',
+  clients: 50,
+  duration: 30,
+  warmup: 3,
+  encoding: 'json',
+  deltas: false,
+  maxRate: 0,           // Book/ticker cap per symbol the clients ask for (0 = everything)
+  workers: 0,           // Server fan-out worker threads
+  port: 3101,
+  url: '',              // Bench an already-running server instead of spawning one
+  replay: '',
+  speed: 'max',
+  json: '',
+  baseline: '',
+  tolerance: 0.2,
+});
+
+// Metrics checked against a baseline, and which direction is a regression
+const GATED_METRICS: Record<string, boolean> = {
+  deliveredPerSec: false,
+  tradeP50: true,
+  tradeP99: true,
+  bookP99: true,
+  cpuAvg: true,
+  rssMax: true,
+};
+
+let measuring = false;
+const tradeLatency = new Histogram();
+const bookLatency = new Histogram();
+let messages = 0;
+let bytes = 0;
+
+function symbolList(): string[] {
+  if (args.list) return args.list.split(',').map(s => s.trim().toUpperCase()).filter(Boolean);
+  return Array.from({ length: args.symbols }, (_, i) => `BENCH${String(i + 1).padStart(3, '0')}USDT`);
+}
+
+function handleBinary(data: Buffer, now: number): void {
+  // Subscribe-time history is old by design - not a latency sample
+  if (data[0] === FRAME_HISTORY) return;
+  const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+  const count = view.getUint16(2, true);
+  for (let i = 0; i < count; i++) {
+    tradeLatency.record(now - view.getFloat64(HEADER_SIZE + i * TRADE_RECORD_SIZE + 16, true));
+  }
+}
+
+function handleJson(text: string, now: number): void {
+  const msg = JSON.parse(text);
+  switch (msg.type) {
+    case 'trades':
+      for (const trade of msg.data) tradeLatency.record(now - trade.timestamp);
+      break;
+    case 'trade':
+      tradeLatency.record(now - msg.data.timestamp);
+      break;
+    case 'orderbook':
+    case 'orderbook_delta':
+      if (!msg.data.snapshot) bookLatency.record(now - msg.data.timestamp);
+      break;
+  }
+}
+
+function connectClient(url: string, symbol: string): Promise<WebSocket> {
+  return new Promise((resolve, reject) => {
+    const ws = new WebSocket(url);
+    ws.on('open', () => {
+      ws.send(JSON.stringify({
+        type: 'subscribe',
+        symbols: [symbol],
+        encoding: args.encoding === 'binary' ? 'binary' : 'json',
+        bookDeltas: args.deltas,
+        maxRate: args.maxRate,
+      }));
+      resolve(ws);
+    });
+    ws.on('error', reject);
+    ws.on('message', (data: Buffer, isBinary: boolean) => {
+      if (!measuring) return;
+      const now = Date.now();
+      messages++;
+      bytes += data.length;
+      if (isBinary) handleBinary(data, now);
+      else handleJson(data.toString(), now);
+    });
+  });
+}
+
+async function main() {
+  const symbols = symbolList();
+  let server: ChildProcess | null = null;
+
+  if (!args.url) {
+    if (args.source === 'replay' && !args.replay) throw new Error('--source replay needs --replay <file>');
+    server = await startServer({
+      port: args.port,
+      source: args.source === 'replay' ? 'replay' : 'synthetic',
+      rate: args.rate,
+      replayFile: args.replay,
+      replaySpeed: args.speed,
+      workers: args.workers,
+    });
+  }
+  const httpPort = args.url ? Number(new URL(args.url).port || 80) : args.port;
+  const wsUrl = args.url ? args.url.replace(/^http/, 'ws') : `ws://localhost:${args.port}`;
+
+  console.log(
+    `\nLoad benchmark: ${args.source}${args.source === 'synthetic' ? ` ${args.rate} events/s` : ` ${args.replay} @ ${args.speed}`}, ` +
+    `${symbols.length} symbols, ${args.clients} clients${args.workers > 0 ? ` on ${args.workers} workers` : ''}, ${args.encoding}${args.deltas ? ' + book deltas' : ''}${args.maxRate > 0 ? ` @ ${args.maxRate}/s` : ''}, ` +
+    `${args.duration}s after ${args.warmup}s warmup\n`
+  );
+
+  const sockets: WebSocket[] = [];
+  for (let i = 0; i < args.clients; i++) {
+    sockets.push(await connectClient(wsUrl, symbols[i % symbols.length]));
+  }
+
+  const sampler = new ProcessSampler(httpPort);
+  await sleep(args.warmup * 1000);
+  await sampler.sample();
+
+  measuring = true;
+  const clientCpuStart = process.cpuUsage();
+  const start = Date.now();
+  while (Date.now() - start < args.duration * 1000) {
+    await sleep(1000);
+    await sampler.sample();
+  }
+  measuring = false;
+  const elapsed = (Date.now() - start) / 1000;
+  const clientCpu = process.cpuUsage(clientCpuStart);
+
+  for (const ws of sockets) ws.close();
+  server?.kill();
+
+  const trades = summarise(tradeLatency);
+  const book = summarise(bookLatency);
+  const proc = sampler.summary();
+  const clientCpuPercent = ((clientCpu.user + clientCpu.system) / 1e4) / elapsed;
+
+  console.log(formatLatency('trades', trades));
+  console.log(formatLatency('book', book));
+  console.log(
+    `\n  delivered  ${(messages / elapsed).toFixed(0)} msgs/s  ${(bytes / elapsed / 1024 / 1024).toFixed(1)} MB/s  ` +
+    `${((trades.count + book.count) / elapsed).toFixed(0)} events/s to clients`
+  );
+  console.log(`  server     cpu ${proc.cpuAvg.toFixed(0)}% avg / ${proc.cpuMax.toFixed(0)}% max  rss ${proc.rssAvg.toFixed(0)}MB avg / ${proc.rssMax.toFixed(0)}MB max`);
+  console.log(`  clientCpu  ${clientCpuPercent.toFixed(0)}%\n`);
+
+  const result: Record<string, number> = {
+    rate: args.rate,
+    symbols: symbols.length,
+    clients: args.clients,
+    workers: args.workers,
+    deliveredPerSec: (trades.count + book.count) / elapsed,
+    tradeP50: trades.p50,
+    tradeP99: trades.p99,
+    tradeP999: trades.p999,
+    bookP50: book.p50,
+    bookP99: book.p99,
+    cpuAvg: proc.cpuAvg,
+    rssMax: proc.rssMax,
+    clientCpu: clientCpuPercent,
+  };
+  reportResult(result, args, GATED_METRICS);
+}
+
+main().catch(error => {
+  console.error('[bench] Failed:', error);
+  process.exit(1);
+});
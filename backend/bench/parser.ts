@@ -0,0 +1,169 @@
+// Parser benchmark - Buffer fast path vs the generic toString/JSON.parse path
+//
+//   npm run bench:parser                 # replay bench/fixtures/binance-stream.jsonl
+//   npm run bench:parser -- --record 60  # capture 60s of live Binance frames first
+//
+// The checked-in fixture is a short sample in Binance's combined-stream wire
+// format (trades, diff depth, tickers in roughly live proportions). Record a
+// real session before drawing conclusions for a specific symbol set.
+
+import fs from 'fs';
+import path from 'path';
+import WebSocket from 'ws';
+import { parseTradeFrame } from '../adapters/binanceParser';
+import { Trade } from '../types';
+
+const FIXTURE = path.join(__dirname, 'fixtures', 'binance-stream.jsonl');
+const RECORD_STREAMS = ['btcusdt@trade', 'ethusdt@trade', 'solusdt@trade', 'btcusdt@depth@100ms', 'btcusdt@ticker'];
+const BENCH_MS = Number(process.env.BENCH_MS ?? 2000);
+
+/**
+ * What BinanceAdapter did per frame before the fast path:
+ * toString -> JSON.parse -> regex on stream -> spread -> Trade
+ */
+function legacyParse(buf: Buffer): Trade | null {
+  const msg = JSON.parse(buf.toString());
+  if (!msg.stream) return null;
+
+  const symbolMatch = msg.stream.match(/^([a-z0-9]+)@/);
+  const symbol = symbolMatch ? symbolMatch[1].toUpperCase() : null;
+  if (!msg.stream.includes('@trade')) return null;
+
+  const data = { ...msg.data, s: symbol || msg.data.s };
+  return {
+    id: data.t?.toString(),
+    symbol: data.s,
+    assetType: 'crypto',
+    timestamp: data.T || data.E,
+    price: parseFloat(data.p),
+    volume: parseFloat(data.q),
+    side: data.m ? 'sell' : 'buy',
+    exchange: 'BINANCE',
+  };
+}
+
+/**
+ * What it does now: fast path for trades, generic parse for everything else
+ */
+function fastParse(buf: Buffer): Trade | null {
+  const trade = parseTradeFrame(buf);
+  if (trade) return trade;
+  JSON.parse(buf.toString());
+  return null;
+}
+
+function loadFrames(): Buffer[] {
+  return fs.readFileSync(FIXTURE, 'utf8')
+    .split('\n')
+    .filter(line => line.length > 0)
+    .map(line => Buffer.from(line));
+}
+
+/**
+ * Both paths must produce identical trades - a faster wrong parser is worthless
+ */
+function verify(frames: Buffer[]): number {
+  let mismatches = 0;
+  for (const frame of frames) {
+    const a = legacyParse(frame);
+    const b = parseTradeFrame(frame);
+    const same = a === null
+      ? b === null
+      : b !== null && a.id === b.id && a.symbol === b.symbol && a.price === b.price &&
+        a.volume === b.volume && a.timestamp === b.timestamp && a.side === b.side;
+    if (!same) {
+      mismatches++;
+      if (mismatches <= 5) {
+        console.log('  mismatch:', frame.toString().slice(0, 160));
+        console.log('    legacy:', JSON.stringify(a));
+        console.log('    fast:  ', JSON.stringify(b));
+      }
+    }
+  }
+  return mismatches;
+}
+
+function run(name: string, frames: Buffer[], parse: (buf: Buffer) => Trade | null) {
+  // Warm up so both paths are measured after the JIT has settled
+  for (let i = 0; i < 20; i++) {
+    for (const frame of frames) parse(frame);
+  }
+
+  let count = 0;
+  let trades = 0;
+  const heapBefore = process.memoryUsage().heapUsed;
+  const start = process.hrtime.bigint();
+  const deadline = Date.now() + BENCH_MS;
+
+  while (Date.now() < deadline) {
+    for (const frame of frames) {
+      if (parse(frame)) trades++;
+      count++;
+    }
+  }
+
+  const elapsedNs = Number(process.hrtime.bigint() - start);
+  const heapDelta = process.memoryUsage().heapUsed - heapBefore;
+  const nsPerFrame = elapsedNs / count;
+
+  console.log(
+    `  ${name.padEnd(8)} ${nsPerFrame.toFixed(0).padStart(6)} ns/frame  ` +
+    `${(1e9 / nsPerFrame / 1000).toFixed(0).padStart(6)}k frames/s  ` +
+    `${trades} trades  heap ${(heapDelta / 1024 / 1024).toFixed(1)}MB`
+  );
+  return nsPerFrame;
+}
+
+/**
+ * Capture raw frames from Binance into the fixture file
+ */
+function record(seconds: number): Promise<void> {
+  const url = `wss://stream.binance.com:9443/stream?streams=${RECORD_STREAMS.join('/')}`;
+  console.log(`[bench] Recording ${seconds}s from ${url}`);
+
+  return new Promise((resolve, reject) => {
+    const out = fs.createWriteStream(FIXTURE);
+    const ws = new WebSocket(url);
+    let frames = 0;
+
+    ws.on('message', (data: Buffer) => {
+      out.write(data.toString() + '\n');
+      frames++;
+    });
+    ws.on('error', reject);
+    ws.on('open', () => {
+      setTimeout(() => {
+        ws.close();
+        out.end(() => {
+          console.log(`[bench] Wrote ${frames} frames to ${FIXTURE}`);
+          resolve();
+        });
+      }, seconds * 1000);
+    });
+  });
+}
+
+async function main() {
+  const recordIndex = process.argv.indexOf('--record');
+  if (recordIndex >= 0) {
+    await record(Number(process.argv[recordIndex + 1] ?? 30));
+  }
+
+  const frames = loadFrames();
+  const tradeFrames = frames.filter(f => parseTradeFrame(f) !== null).length;
+  console.log(`\nParser benchmark: ${frames.length} frames (${tradeFrames} trades), ${BENCH_MS}ms per path\n`);
+
+  const mismatches = verify(frames);
+  console.log(`  verify   ${mismatches === 0 ? 'ok - identical trades' : `${mismatches} mismatches`}\n`);
+
+  const legacy = run('legacy', frames, legacyParse);
+  const fast = run('fast', frames, fastParse);
+  console.log(`\n  speedup  ${(legacy / fast).toFixed(2)}x\n`);
+
+  if (mismatches > 0) process.exitCode = 1;
+}
+
+main().catch(error => {
+  console.error('[bench] Failed:', error);
+  process.exit(1);
+});
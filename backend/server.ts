@@ -1,12 +1,31 @@
-// WebSocket server - bridges Binance streams to frontend clients
+// WebSocket server - bridges exchange streams (or a replayed capture) to frontend clients,
+// standalone or as an ingest/edge node of a cluster
 
 import express from 'express';
 import http from 'http';
+import { ListenOptions } from 'net';
+import os from 'os';
+import { performance } from 'perf_hooks';
+import { isMainThread, parentPort, workerData } from 'worker_threads';
 import { WebSocketServer, WebSocket } from 'ws';
 import cors from 'cors';
 import dotenv from 'dotenv';
-import { BinanceAdapter } from './adapters';
-import { Trade, OrderBook, Ticker, ClientMessage, ServerMessage } from './types';
+import {
+  BinanceAdapter, BybitAdapter, OkxAdapter, CoinbaseAdapter, ConsolidatedAdapter,
+  ReplayAdapter, SyntheticAdapter, BusAdapter, WorkerFeedAdapter,
+} from './adapters';
+import { BaseAdapter } from './adapters/base';
+import { Trade, OrderBook, OrderBookDelta, Ticker, Signal, ClientMessage, ServerMessage, TradeFilter, WireEncoding } from './types';
+import { FRAME_HISTORY, encodeTradeFrame, getSymbolId } from './services/binaryProtocol';
+import { TradeBatcher } from './services/tradeBatcher';
+import { SignalEngine } from './services/signalEngine';
+import { captureAdapter, TickFileWriter } from './services/tickFile';
+import { ClientChannel, ChannelConfig } from './services/clientChannel';
+import { BusServer, BusServerHandlers, BusEvent, parseShard } from './services/bus';
+import { FanoutPool, FanoutWorkerData } from './services/fanoutPool';
+import { SymbolStateCache } from './services/symbolState';
+import { metrics, mergeSnapshots, renderPrometheus, trackEventLoopLag } from './services/metrics';
+import { SymbolTradeFilter, TradeFilterRegistry, normalizeTradeFilter } from './services/tradeFilter';
 
 dotenv.config();
 
@@ -22,84 +41,591 @@ app.use(cors({
 
 app.use(express.json());
 
-// Singleton adapter - we reuse one connection to Binance for all clients
-let binanceAdapter: BinanceAdapter | null = null;
+// Trades are coalesced per symbol for up to TRADE_BATCH_WINDOW_MS (or
+// TRADE_BATCH_MAX trades) and sent as one 'trades' frame. 0 disables batching.
+const tradeBatcher = new TradeBatcher(
+  {
+    windowMs: Number(process.env.TRADE_BATCH_WINDOW_MS ?? 10),
+    maxBatch: Number(process.env.TRADE_BATCH_MAX ?? 200),
+  },
+  (symbol, trades) => broadcastTrades(symbol, trades),
+);
 
-// Track what each client is subscribed to so we can clean up properly
-const clientSubscriptions: Map<WebSocket, Set<string>> = new Map();
+// Whale/velocity/wall/spoof detection runs here once per symbol, and
+// subscribers just get the resulting 'signal' messages
+const signalEngine = new SignalEngine((signal: Signal) => {
+  if (eventSink) eventSink.publish({ kind: 'signal', data: signal });
+  else broadcastSignal(signal);
+});
+
+// Levels a delta client gets in its initial (or resync) snapshot - the whole
+// book. Deltas cover every level the adapter keeps (its trims included), so
+// a shorter seed would leave the client with isolated levels past it.
+const BOOK_DELTA_DEPTH = Infinity;
+
+// Levels in the legacy 'orderbook' snapshot sent to everyone else
+const BOOK_SNAPSHOT_DEPTH = 20;
+
+// Last ticker and the SYMBOL_CACHE_TRADES most recent trades per symbol (backfilled
+// on first subscribe), sent to every new subscriber right after 'subscribed'
+// so a tab opens populated
+const stateCache = new SymbolStateCache(Number(process.env.SYMBOL_CACHE_TRADES ?? 1000));
+
+// Where market data comes from: the live exchange streams, a capture file
+// played back through the same callbacks (REPLAY_SPEED 'max' = no pacing),
+// or generated load at SYNTHETIC_RATE events/sec for benchmarks
+type DataSource = 'binance' | 'replay' | 'synthetic';
+const DATA_SOURCE: DataSource =
+  process.env.DATA_SOURCE === 'replay' || process.env.DATA_SOURCE === 'synthetic' ? process.env.DATA_SOURCE : 'binance';
+const REPLAY_FILE = process.env.REPLAY_FILE ?? '';
+const REPLAY_SPEED = process.env.REPLAY_SPEED === 'max' ? 0 : Number(process.env.REPLAY_SPEED ?? 1);
+const REPLAY_LOOP = process.env.REPLAY_LOOP === 'true';
+const SYNTHETIC_RATE = Number(process.env.SYNTHETIC_RATE ?? 1000);
+
+// Live venues, first one primary (ticker, symbol validation). More than one
+// and they're consolidated: trades merged in exchange-time order, holding
+// each for up to CONSOLIDATE_REORDER_MS for the slower venues, and books
+// summed. COINBASE_QUOTE picks the Coinbase book (USD is where its volume is).
+type Exchange = 'binance' | 'bybit' | 'okx' | 'coinbase';
+const KNOWN_EXCHANGES: Exchange[] = ['binance', 'bybit', 'okx', 'coinbase'];
+const EXCHANGES: Exchange[] = Array.from(new Set(
+  (process.env.EXCHANGES ?? 'binance').split(',').map(s => s.trim().toLowerCase())
+    .filter((s): s is Exchange => {
+      if (KNOWN_EXCHANGES.includes(s as Exchange)) return true;
+      if (s) console.warn(`Ignoring unknown exchange '${s}' (known: ${KNOWN_EXCHANGES.join(', ')})`);
+      return false;
+    })
+));
+if (EXCHANGES.length === 0) EXCHANGES.push('binance');
+const CONSOLIDATE_REORDER_MS = Number(process.env.CONSOLIDATE_REORDER_MS ?? 50);
+const COINBASE_QUOTE = process.env.COINBASE_QUOTE === 'USDT' ? 'USDT' : 'USD';
+
+// Live sessions are recorded here when set (one new file per server run)
+const CAPTURE_DIR = process.env.CAPTURE_DIR ?? '';
+
+// Cluster role. 'standalone' does everything in one process. An 'ingest'
+// node holds the upstream feed for its INGEST_SHARD (i/n) of the symbols and
+// publishes it on BUS_PORT; an 'edge' node takes no upstream feed at all and
+// serves browser clients from the ingest nodes in BUS_INGEST_NODES (host:port,
+// in shard order). Run as many edges behind the load balancer as needed.
+type NodeRole = 'standalone' | 'ingest' | 'edge';
+const NODE_ROLE: NodeRole =
+  process.env.NODE_ROLE === 'ingest' || process.env.NODE_ROLE === 'edge' ? process.env.NODE_ROLE : 'standalone';
+const NODE_NAME = process.env.NODE_NAME || `${os.hostname()}:${process.env.PORT || 3001}`;
+const BUS_PORT = Number(process.env.BUS_PORT ?? 4100);
+const BUS_INGEST_NODES = (process.env.BUS_INGEST_NODES ?? '').split(',').map(s => s.trim()).filter(Boolean);
+const INGEST_SHARD = parseShard(process.env.INGEST_SHARD ?? '0/1');
+
+// What clients are told their data comes from
+const SOURCE_NAME = NODE_ROLE === 'edge' ? 'bus' : DATA_SOURCE === 'binance' ? EXCHANGES.join('+') : DATA_SOURCE;
+
+// FANOUT_WORKERS > 0 keeps the adapter (parsing, books, signals) on the
+// main thread and moves every client connection onto that many worker
+// threads, fed through per-worker SharedArrayBuffer rings of
+// FANOUT_RING_BYTES. Each worker runs this same file.
+const FANOUT_WORKERS = NODE_ROLE === 'ingest' ? 0 : Math.max(0, Number(process.env.FANOUT_WORKERS ?? 0));
+const FANOUT_RING_BYTES = Number(process.env.FANOUT_RING_BYTES ?? 8_388_608);
+const fanoutWorker: FanoutWorkerData | null = isMainThread ? null : workerData;
+const THREAD_NAME = fanoutWorker ? `worker${fanoutWorker.index}` : 'main';
+
+// Slow consumers: once a client's socket has CLIENT_HIGH_WATER_BYTES queued,
+// its book and ticker go latest-only and trades are summarised until it
+// drains below CLIENT_LOW_WATER_BYTES. SLOW_CLIENT_POLICY=disconnect also
+// drops clients behind for longer than CLIENT_MAX_LAG_MS.
+const channelConfig: ChannelConfig = {
+  highWaterBytes: Number(process.env.CLIENT_HIGH_WATER_BYTES ?? 1_048_576),
+  lowWaterBytes: Number(process.env.CLIENT_LOW_WATER_BYTES ?? 262_144),
+  maxBufferBytes: Number(process.env.CLIENT_MAX_BUFFER_BYTES ?? 16_777_216),
+  maxLagMs: Number(process.env.CLIENT_MAX_LAG_MS ?? 10_000),
+  policy: process.env.SLOW_CLIENT_POLICY === 'disconnect' ? 'disconnect' : 'conflate',
+};
+
+// Singleton adapter - we reuse one upstream connection for all clients
+let marketAdapter: BaseAdapter | null = null;
+let captureWriter: TickFileWriter | null = null;
+
+// Ingest role, or the main thread of a fan-out pool: where this process's
+// events go instead of straight to browsers
+let busServer: BusServer | null = null;
+let fanoutPool: FanoutPool | null = null;
+let eventSink: { publish(event: BusEvent): void } | null = null;
+
+/**
+ * Per-connection state
+ * 
+ * subscriptions lets us clean up properly when the client goes away,
+ * encoding is whatever the client asked for in its last subscribe.
+ * bookDeltas clients get 'orderbook_delta' messages instead of snapshots.
+ * filters holds the trade filter of each symbol subscribed with one.
+ * Market data goes out through channel, which handles backpressure.
+ */
+interface ClientState {
+  subscriptions: Set<string>;
+  encoding: WireEncoding;
+  bookDeltas: boolean;
+  filters: Map<string, SymbolTradeFilter>;
+  channel: ClientChannel;
+}
+
+const clients: Map<WebSocket, ClientState> = new Map();
+
+// Clients asking for the same filter on a symbol share one instance, so it
+// runs (and its output is serialized) once per batch however many there are
+const tradeFilters = new TradeFilterRegistry();
+
+// Hot-path instrumentation, scraped from /metrics. Trade lag is exchange
+// timestamp -> now at each stage: 'recv' as the adapter hands a trade over,
+// 'broadcast' as its batch is queued to clients (oldest trade in the batch).
+const upstreamEvents = metrics.counter('tapeflow_upstream_events_total', 'Trades, book updates and tickers from the adapter', 'symbol');
+const tradeLag = metrics.histogram('tapeflow_trade_lag_seconds', 'Exchange timestamp to this stage', 'stage');
+const filteredTrades = metrics.counter('tapeflow_filtered_trades_total', 'Trades not sent because of a client trade filter');
+const broadcastSeconds = metrics.histogram('tapeflow_broadcast_seconds', 'Serializing and queueing one message for every subscriber', 'type');
+const clientBufferedBytes = metrics.gauge('tapeflow_client_buffered_bytes', 'Bytes queued on a client socket', 'client');
+const clientCount = metrics.gauge('tapeflow_clients', 'Connected clients', 'thread');
+const slowClientCount = metrics.gauge('tapeflow_slow_clients', 'Clients over the high-water mark', 'thread');
+
+trackEventLoopLag(THREAD_NAME);
+metrics.onCollect(() => {
+  clientBufferedBytes.clear();
+  let slow = 0;
+  for (const state of clients.values()) {
+    clientBufferedBytes.set(state.channel.bufferedBytes, `${THREAD_NAME}/${state.channel.id}`);
+    if (state.channel.isBehind) slow++;
+  }
+  clientCount.set(clients.size, THREAD_NAME);
+  slowClientCount.set(slow, THREAD_NAME);
+});
+
+// Reverse index: symbol -> clients watching it, so a broadcast only touches
+// the sockets that actually care about that symbol
+const symbolSubscribers: Map<string, Set<WebSocket>> = new Map();
 
 // Track which symbols have at least one subscriber (for cleanup)
 const subscribedSymbols: Set<string> = new Set();
 
-console.log('\nTapeFlow Server Starting...');
-console.log('Data Source: Binance WebSocket (public API)');
-console.log('Supported: USDT perpetual pairs only\n');
+// Workers share the main thread's console - one banner is enough
+if (!fanoutWorker) {
+  console.log('\nTapeFlow Server Starting...');
+  if (NODE_ROLE !== 'standalone') {
+    console.log(`Node: ${NODE_NAME}, ${NODE_ROLE}${NODE_ROLE === 'ingest' ? ` shard ${INGEST_SHARD.shard}/${INGEST_SHARD.shards}` : ''}`);
+  }
+  if (FANOUT_WORKERS > 0) {
+    console.log(`Fan-out: ${FANOUT_WORKERS} worker threads`);
+  }
+  if (NODE_ROLE === 'edge') {
+    console.log(`Data Source: Ingest nodes ${BUS_INGEST_NODES.join(', ') || '(BUS_INGEST_NODES not set)'}\n`);
+  } else if (DATA_SOURCE === 'replay') {
+    console.log(`Data Source: Replay of ${REPLAY_FILE || '(REPLAY_FILE not set)'}\n`);
+  } else if (DATA_SOURCE === 'synthetic') {
+    console.log(`Data Source: Synthetic load, ${SYNTHETIC_RATE} events/sec\n`);
+  } else if (EXCHANGES.length > 1) {
+    console.log(`Data Source: ${EXCHANGES.join(', ')} consolidated (reorder window ${CONSOLIDATE_REORDER_MS}ms)`);
+    console.log(`Supported: USDT pairs listed on ${EXCHANGES[0]}${EXCHANGES.includes('coinbase') ? `, Coinbase via ${COINBASE_QUOTE}` : ''}\n`);
+  } else if (EXCHANGES[0] === 'binance') {
+    console.log('Data Source: Binance WebSocket (public API)');
+    console.log('Supported: USDT perpetual pairs only\n');
+  } else {
+    console.log(`Data Source: ${EXCHANGES[0]} WebSocket (public API)`);
+    console.log('Supported: USDT pairs only\n');
+  }
+}
+
+function createAdapter(): BaseAdapter {
+  if (fanoutWorker && parentPort) {
+    return new WorkerFeedAdapter(fanoutWorker.ring, parentPort);
+  }
+  if (NODE_ROLE === 'edge') {
+    if (BUS_INGEST_NODES.length === 0) throw new Error('NODE_ROLE=edge needs BUS_INGEST_NODES');
+    return new BusAdapter({ nodes: BUS_INGEST_NODES, node: NODE_NAME });
+  }
+  if (DATA_SOURCE === 'replay') {
+    if (!REPLAY_FILE) throw new Error('DATA_SOURCE=replay needs REPLAY_FILE');
+    return new ReplayAdapter({ file: REPLAY_FILE, speed: REPLAY_SPEED, loop: REPLAY_LOOP });
+  }
+  if (DATA_SOURCE === 'synthetic') {
+    return new SyntheticAdapter({ rate: SYNTHETIC_RATE });
+  }
+  const venues = EXCHANGES.map(createVenueAdapter);
+  return venues.length === 1 ? venues[0] : new ConsolidatedAdapter(venues, { reorderMs: CONSOLIDATE_REORDER_MS });
+}
+
+function createVenueAdapter(exchange: Exchange): BaseAdapter {
+  switch (exchange) {
+    case 'bybit':
+      return new BybitAdapter();
+    case 'okx':
+      return new OkxAdapter();
+    case 'coinbase':
+      return new CoinbaseAdapter({ quote: COINBASE_QUOTE });
+    case 'binance':
+      return new BinanceAdapter({
+        maxShards: Number(process.env.BINANCE_MAX_SHARDS ?? 4),
+        symbolsPerShard: Number(process.env.BINANCE_SYMBOLS_PER_SHARD ?? 20),
+      });
+  }
+}
 
 /**
- * Lazy-initialize the Binance adapter
+ * The live Binance adapter, on its own or inside a consolidated one
+ */
+function binanceAdapter(): BinanceAdapter | null {
+  if (marketAdapter instanceof BinanceAdapter) return marketAdapter;
+  if (marketAdapter instanceof ConsolidatedAdapter) return marketAdapter.findVenue(BinanceAdapter);
+  return null;
+}
+
+/**
+ * Lazy-initialize the market data adapter
  * 
  * We don't connect until the first client subscribes. This avoids
  * wasting bandwidth if the server is running but no one's using it.
  */
-async function initBinanceAdapter(): Promise<BinanceAdapter> {
-  if (binanceAdapter) return binanceAdapter;
+async function initAdapter(): Promise<BaseAdapter> {
+  if (marketAdapter) return marketAdapter;
   
-  binanceAdapter = new BinanceAdapter({});
-  await binanceAdapter.connect();
+  const adapter = createAdapter();
+  marketAdapter = adapter;
+  await adapter.connect();
   
-  // Wire up event handlers to broadcast data to subscribed clients
-  binanceAdapter.onTrade((trade: Trade) => {
-    broadcastToSubscribers(trade.symbol, {
-      type: 'trade',
-      data: trade,
-      timestamp: Date.now(),
+  // Record the live session before anything else sees the events
+  const live = DATA_SOURCE === 'binance' && NODE_ROLE !== 'edge' && !fanoutWorker;
+  if (CAPTURE_DIR && live) {
+    captureWriter = captureAdapter(adapter, CAPTURE_DIR);
+  }
+  
+  adapter.onError((error: Error) => {
+    console.error(`[${adapter.name}] Error:`, error.message);
+  });
+  
+  adapter.onDisconnect(() => {
+    console.log(`[${adapter.name}] Disconnected - will attempt reconnect`);
+  });
+  
+  // Keep the last-known state whatever this process does downstream
+  adapter.onTrade((trade: Trade) => stateCache.recordTrade(trade));
+  adapter.onOrderBook((orderBook: OrderBook) => stateCache.recordOrderBook(orderBook));
+  adapter.onTicker((ticker: Ticker) => stateCache.recordTicker(ticker));
+  adapter.onHistory((history) => stateCache.seedTrades(history.symbol, history.trades));
+  
+  // A fan-out worker's adapter only relays the main thread's, which counts these
+  if (!fanoutWorker) {
+    adapter.onTrade((trade: Trade) => {
+      upstreamEvents.inc(trade.symbol);
+      tradeLag.observe((Date.now() - trade.timestamp) / 1000, 'recv');
     });
+    adapter.onOrderBook((orderBook: OrderBook) => upstreamEvents.inc(orderBook.symbol));
+    adapter.onOrderBookDelta((delta: OrderBookDelta) => upstreamEvents.inc(delta.symbol));
+    adapter.onTicker((ticker: Ticker) => upstreamEvents.inc(ticker.symbol));
+  }
+  
+  // An edge or a fan-out worker gets signals ready-made from upstream
+  // instead of detecting them again
+  const upstream = adapter instanceof BusAdapter || adapter instanceof WorkerFeedAdapter ? adapter : null;
+  const localSignals = upstream === null;
+  
+  // Ingest nodes and fan-out main threads hand everything on - the edges
+  // or workers do the client fan-out
+  if (eventSink) {
+    publishToSink(adapter, eventSink, localSignals);
+    upstream?.onSignal(signal => eventSink?.publish({ kind: 'signal', data: signal }));
+    return adapter;
+  }
+  
+  upstream?.onSignal(broadcastSignal);
+  
+  // Wire up event handlers to broadcast data to subscribed clients
+  adapter.onTrade((trade: Trade) => {
+    tradeBatcher.add(trade);
+    if (localSignals) signalEngine.handleTrade(trade);
   });
   
-  binanceAdapter.onOrderBook((orderBook: OrderBook) => {
-    broadcastToSubscribers(orderBook.symbol, {
+  adapter.onOrderBook((orderBook: OrderBook) => {
+    if (localSignals) signalEngine.handleOrderBook(orderBook);
+    broadcastOrderBook(orderBook.symbol, {
       type: 'orderbook',
       data: orderBook,
       timestamp: Date.now(),
-    });
+    }, false);
+  });
+  
+  adapter.onOrderBookDelta((delta: OrderBookDelta) => {
+    if (localSignals) signalEngine.handleOrderBookDelta(delta);
+    broadcastOrderBook(delta.symbol, {
+      type: 'orderbook_delta',
+      data: delta,
+      symbol: delta.symbol,
+      timestamp: Date.now(),
+    }, true);
   });
   
-  binanceAdapter.onTicker((ticker: Ticker) => {
+  adapter.onTicker((ticker: Ticker) => {
     broadcastToSubscribers(ticker.symbol, {
       type: 'ticker',
       data: ticker,
       timestamp: Date.now(),
-    });
+    }, `ticker:${ticker.symbol.toUpperCase()}`);
   });
   
-  binanceAdapter.onError((error: Error) => {
-    console.error('[Binance] Error:', error.message);
+  return adapter;
+}
+
+/**
+ * Ingest role or fan-out main thread: publish everything the adapter emits
+ * 
+ * Signals are detected here, once for everything downstream, and published
+ * next to the market data (see the signalEngine callback).
+ */
+function publishToSink(adapter: BaseAdapter, sink: { publish(event: BusEvent): void }, localSignals: boolean): void {
+  adapter.onTrade((trade: Trade) => {
+    sink.publish({ kind: 'trade', data: trade });
+    if (localSignals) signalEngine.handleTrade(trade);
+  });
+  
+  adapter.onOrderBook((orderBook: OrderBook) => {
+    if (localSignals) signalEngine.handleOrderBook(orderBook);
+    sink.publish({ kind: 'orderbook', data: orderBook });
   });
   
-  binanceAdapter.onDisconnect(() => {
-    console.log('[Binance] Disconnected - will attempt reconnect');
+  adapter.onOrderBookDelta((delta: OrderBookDelta) => {
+    if (localSignals) signalEngine.handleOrderBookDelta(delta);
+    sink.publish({ kind: 'delta', data: delta });
   });
   
-  return binanceAdapter;
+  adapter.onTicker((ticker: Ticker) => {
+    sink.publish({ kind: 'ticker', data: ticker });
+  });
+}
+
+function broadcastSignal(signal: Signal): void {
+  broadcastToSubscribers(signal.symbol, {
+    type: 'signal',
+    data: signal,
+    symbol: signal.symbol,
+    timestamp: signal.timestamp,
+  });
 }
 
 /**
  * Send a message to all clients subscribed to a particular symbol
+ * 
+ * The message is serialized once and the same string is handed to every
+ * subscriber. With 40 dashboards on BTCUSDT that's 1 stringify per trade
+ * instead of 40, and we only walk the sockets watching this symbol.
+ * Messages with a latestKey only matter in their newest state, so a slow
+ * client gets just the last one per key.
  */
-function broadcastToSubscribers(symbol: string, message: ServerMessage): void {
+function broadcastToSubscribers(symbol: string, message: ServerMessage, latestKey?: string): void {
+  const subscribers = symbolSubscribers.get(symbol.toUpperCase());
+  if (!subscribers || subscribers.size === 0) return;
+  
+  const start = performance.now();
+  const payload = JSON.stringify(message);
+  for (const client of subscribers) {
+    const channel = clients.get(client)?.channel;
+    if (!channel) continue;
+    if (latestKey) channel.sendLatest(latestKey, payload);
+    else channel.send(payload);
+  }
+  broadcastSeconds.observe((performance.now() - start) / 1000, message.type);
+}
+
+/**
+ * A batch of trades and its two encodings, each built on first use
+ */
+interface TradeBatch {
+  trades: Trade[];
+  json: () => string;
+  binary: () => Buffer;
+}
+
+function tradeBatch(symbol: string, trades: Trade[]): TradeBatch {
+  let jsonPayload: string | null = null;
+  let binaryPayload: Buffer | null = null;
+  return {
+    trades,
+    json: () => (jsonPayload ??= JSON.stringify({ type: 'trades', data: trades, symbol, timestamp: Date.now() })),
+    binary: () => (binaryPayload ??= encodeTradeFrame(trades)),
+  };
+}
+
+/**
+ * Send a batch of trades to everyone watching the symbol, in each client's encoding
+ * 
+ * Both encodings are built lazily and at most once per batch, so a symbol with
+ * only binary subscribers never pays for JSON.stringify and vice versa.
+ * Filtered subscribers get their filter's share of the batch, worked out
+ * and encoded once per distinct filter - and nothing at all if no trade
+ * passed.
+ */
+function broadcastTrades(symbol: string, trades: Trade[]): void {
+  const subscribers = symbolSubscribers.get(symbol);
+  if (!subscribers || subscribers.size === 0) return;
+  
+  const start = performance.now();
+  const unfiltered = tradeBatch(symbol, trades);
+  let filtered: Map<SymbolTradeFilter, TradeBatch> | null = null;
+  
+  for (const client of subscribers) {
+    const state = clients.get(client);
+    if (!state) continue;
+    
+    let batch = unfiltered;
+    const filter = state.filters.get(symbol);
+    if (filter) {
+      filtered ??= new Map();
+      let passed = filtered.get(filter);
+      if (!passed) {
+        passed = tradeBatch(symbol, filter.apply(trades));
+        filtered.set(filter, passed);
+      }
+      filteredTrades.inc('', trades.length - passed.trades.length);
+      if (passed.trades.length === 0) continue;
+      batch = passed;
+    }
+    state.channel.sendTrades(symbol, batch.trades, state.encoding === 'binary' ? batch.binary : batch.json);
+  }
+  broadcastSeconds.observe((performance.now() - start) / 1000, 'trades');
+  tradeLag.observe((Date.now() - trades[0].timestamp) / 1000, 'broadcast');
+}
+
+/**
+ * Send a book message only to subscribers on the matching book protocol
+ * 
+ * Delta clients must never see a 20-level snapshot (it would truncate their
+ * deep book) and snapshot clients can't do anything with a delta. Snapshots
+ * are latest-only for slow or rate-capped clients; deltas are merged under
+ * a rate cap, or dropped for a slow client and the book resent.
+ */
+function broadcastOrderBook(symbol: string, message: ServerMessage, deltas: boolean): void {
   const upperSymbol = symbol.toUpperCase();
+  const subscribers = symbolSubscribers.get(upperSymbol);
+  if (!subscribers || subscribers.size === 0) return;
+  
+  const start = performance.now();
+  let payload: string | null = null;
+  const serialize = () => (payload ??= JSON.stringify(message));
+  for (const client of subscribers) {
+    const state = clients.get(client);
+    if (!state || state.bookDeltas !== deltas) continue;
+    if (deltas) state.channel.sendDelta(upperSymbol, message.data as OrderBookDelta, serialize);
+    else state.channel.sendLatest(`orderbook:${upperSymbol}`, serialize());
+  }
+  broadcastSeconds.observe((performance.now() - start) / 1000, message.type);
+}
+
+/**
+ * Send a client the current book for a symbol, in whichever form it takes
+ * 
+ * Nothing is sent if the adapter hasn't synced the book yet - the client will
+ * get it with everyone else as soon as the snapshot lands.
+ */
+function sendCurrentBook(ws: WebSocket, symbol: string): void {
+  const state = clients.get(ws);
+  if (!marketAdapter || !state) return;
   
-  for (const [client, subscriptions] of clientSubscriptions) {
-    if (subscriptions.has(upperSymbol) && client.readyState === WebSocket.OPEN) {
-      client.send(JSON.stringify(message));
+  if (state.bookDeltas) {
+    const snapshot = marketAdapter.getBookSnapshot(symbol, BOOK_DELTA_DEPTH);
+    if (snapshot) {
+      state.channel.sendSnapshot(symbol, JSON.stringify({ type: 'orderbook_delta', data: snapshot, symbol, timestamp: Date.now() }));
+    }
+  } else {
+    const orderBook = marketAdapter.getOrderBook(symbol, BOOK_SNAPSHOT_DEPTH) ?? stateCache.orderBook(symbol);
+    if (orderBook) {
+      state.channel.sendLatest(`orderbook:${symbol}`, JSON.stringify({ type: 'orderbook', data: orderBook, timestamp: Date.now() }));
     }
   }
 }
 
+/**
+ * Send a client the cached ticker and recent trades for a symbol
+ * 
+ * The trades go out as one history message the client ingests in a single
+ * pass - for binary clients the cache's records are copied out as they are.
+ * since (from a resubscribe) skips the ones it already has.
+ */
+function sendRecentState(ws: WebSocket, symbol: string, since: number): void {
+  const state = clients.get(ws);
+  if (!state) return;
+  
+  const filter = state.filters.get(symbol);
+  if (filter) {
+    // Filtered history is picked out of the cache and encoded for this client
+    const trades = filter.applyToHistory(stateCache.recentTrades(symbol, since));
+    if (trades.length > 0) {
+      state.channel.sendHistory(() => state.encoding === 'binary'
+        ? encodeTradeFrame(trades, FRAME_HISTORY)
+        : JSON.stringify({ type: 'trade_history', data: trades, symbol, timestamp: Date.now() }));
+    }
+  } else if (state.encoding === 'binary') {
+    const frame = stateCache.historyFrame(symbol, since);
+    if (frame) state.channel.sendHistory(() => frame);
+  } else {
+    const trades = stateCache.recentTrades(symbol, since);
+    if (trades.length > 0) {
+      state.channel.sendHistory(() => JSON.stringify({ type: 'trade_history', data: trades, symbol, timestamp: Date.now() }));
+    }
+  }
+  
+  const ticker = stateCache.ticker(symbol);
+  if (ticker) {
+    state.channel.sendLatest(`ticker:${symbol}`, JSON.stringify({ type: 'ticker', data: ticker, timestamp: Date.now() }));
+  }
+}
+
+/**
+ * Set (or with null, clear) the trade filter on one of a client's subscriptions
+ */
+function setTradeFilter(state: ClientState, symbol: string, spec: TradeFilter | null): void {
+  const previous = state.filters.get(symbol);
+  if (previous) {
+    tradeFilters.release(previous);
+    state.filters.delete(symbol);
+  }
+  if (spec) state.filters.set(symbol, tradeFilters.acquire(symbol, spec));
+}
+
+/**
+ * Add a client to a symbol's subscriber set
+ */
+function addSubscriber(symbol: string, ws: WebSocket): void {
+  let subscribers = symbolSubscribers.get(symbol);
+  if (!subscribers) {
+    subscribers = new Set();
+    symbolSubscribers.set(symbol, subscribers);
+  }
+  subscribers.add(ws);
+}
+
+/**
+ * Remove a client from a symbol's subscriber set
+ */
+function removeSubscriber(symbol: string, ws: WebSocket): void {
+  const subscribers = symbolSubscribers.get(symbol);
+  if (!subscribers) return;
+  subscribers.delete(ws);
+  if (subscribers.size === 0) {
+    symbolSubscribers.delete(symbol);
+  }
+}
+
 // Handle new client connections
-wss.on('connection', (ws: WebSocket) => {
-  console.log('Client connected');
-  clientSubscriptions.set(ws, new Set());
+wss.on('connection', (ws: WebSocket, req: http.IncomingMessage) => {
+  const address = req.socket.remoteAddress ?? 'unknown';
+  
+  // Ingest nodes only serve edges, over the bus
+  if (NODE_ROLE === 'ingest') {
+    ws.close(1013, 'Ingest node - connect to an edge node');
+    return;
+  }
+  
+  console.log(`Client connected (${address})`);
+  clients.set(ws, {
+    subscriptions: new Set(),
+    encoding: 'json',
+    bookDeltas: false,
+    filters: new Map(),
+    channel: new ClientChannel(ws, channelConfig, address, (symbol) => sendCurrentBook(ws, symbol)),
+  });
   
   // Let the client know we're ready
   ws.send(JSON.stringify({
@@ -122,6 +648,12 @@ wss.on('connection', (ws: WebSocket) => {
         case 'validate':
           await handleValidate(ws, message);
           break;
+        case 'resync':
+          // Client saw a seq gap in its deltas - hand it a fresh snapshot
+          if (message.symbol && clients.get(ws)?.subscriptions.has(message.symbol.toUpperCase())) {
+            sendCurrentBook(ws, message.symbol.toUpperCase());
+          }
+          break;
         case 'ping':
           // Simple heartbeat - client can use this to check latency
           ws.send(JSON.stringify({ type: 'pong', timestamp: Date.now() }));
@@ -140,13 +672,16 @@ wss.on('connection', (ws: WebSocket) => {
   ws.on('close', () => {
     console.log('Client disconnected');
     // Clean up: unsubscribe from any symbols this client was watching
-    const subscriptions = clientSubscriptions.get(ws);
-    if (subscriptions) {
-      for (const symbol of subscriptions) {
+    const state = clients.get(ws);
+    clients.delete(ws);
+    if (state) {
+      state.channel.close();
+      for (const symbol of state.subscriptions) {
+        setTradeFilter(state, symbol, null);
+        removeSubscriber(symbol, ws);
         cleanupSymbolSubscription(symbol);
       }
     }
-    clientSubscriptions.delete(ws);
   });
   
   ws.on('error', (error) => {
@@ -162,6 +697,24 @@ wss.on('connection', (ws: WebSocket) => {
  */
 async function handleSubscribe(ws: WebSocket, message: ClientMessage): Promise<void> {
   const symbols = message.symbols || (message.symbol ? [message.symbol] : []);
+  const state = clients.get(ws);
+  
+  if (state && message.encoding) {
+    state.encoding = message.encoding === 'binary' ? 'binary' : 'json';
+  }
+  
+  if (state && message.bookDeltas !== undefined) {
+    state.bookDeltas = message.bookDeltas === true;
+  }
+  
+  // Book/ticker updates per second per symbol - a subscribe with no symbols
+  // is enough to change it later (e.g. when the tab goes to the background)
+  if (state && message.maxRate !== undefined) {
+    state.channel.setMaxRate(Math.max(0, Number(message.maxRate) || 0));
+  }
+  
+  // undefined leaves filters alone, null (or a filter that passes everything) clears them
+  const filter = message.filter === undefined ? undefined : normalizeTradeFilter(message.filter);
   
   for (const symbol of symbols) {
     const upperSymbol = symbol.toUpperCase();
@@ -177,14 +730,21 @@ async function handleSubscribe(ws: WebSocket, message: ClientMessage): Promise<v
       continue;
     }
     
-    // Track this subscription for the client
-    const subscriptions = clientSubscriptions.get(ws);
-    if (subscriptions) {
-      subscriptions.add(upperSymbol);
+    // Already streaming to this client - a subscribe carrying a filter only swaps the filter
+    if (state?.subscriptions.has(upperSymbol) && filter !== undefined) {
+      const wasFiltered = state.filters.has(upperSymbol);
+      setTradeFilter(state, upperSymbol, filter);
+      // Dropping a filter resends the recent tape, which the client has only seen filtered
+      if (wasFiltered && !filter) sendRecentState(ws, upperSymbol, 0);
+      continue;
     }
     
-    // Start streaming data from Binance
-    const adapter = await initBinanceAdapter();
+    // Track this subscription for the client
+    state?.subscriptions.add(upperSymbol);
+    if (state && filter !== undefined) setTradeFilter(state, upperSymbol, filter);
+    
+    // Start streaming data from upstream
+    const adapter = await initAdapter();
     await adapter.subscribe(upperSymbol, 'crypto');
     subscribedSymbols.add(upperSymbol);
     
@@ -192,11 +752,23 @@ async function handleSubscribe(ws: WebSocket, message: ClientMessage): Promise<v
     ws.send(JSON.stringify({
       type: 'subscribed',
       symbol: upperSymbol,
-      source: 'binance',
+      symbolId: getSymbolId(upperSymbol),
+      encoding: state?.encoding ?? 'json',
+      source: SOURCE_NAME,
       assetType: 'crypto',
       timestamp: Date.now(),
     }));
     
+    // Only start fanning out after 'subscribed' is on the wire, so the client
+    // knows the symbol ID before the first binary frame references it
+    if (clients.has(ws)) {
+      addSubscriber(upperSymbol, ws);
+      // Late joiners start from the live book, ticker and tape instead of
+      // waiting for the next change
+      sendCurrentBook(ws, upperSymbol);
+      sendRecentState(ws, upperSymbol, Number(message.since) || 0);
+    }
+    
     console.log(`Subscribed to ${upperSymbol}`);
   }
 }
@@ -211,10 +783,11 @@ async function handleUnsubscribe(ws: WebSocket, message: ClientMessage): Promise
     const upperSymbol = symbol.toUpperCase();
     
     // Remove from this client's subscription list
-    const subscriptions = clientSubscriptions.get(ws);
-    if (subscriptions) {
-      subscriptions.delete(upperSymbol);
-    }
+    const state = clients.get(ws);
+    if (state) setTradeFilter(state, upperSymbol, null);
+    state?.subscriptions.delete(upperSymbol);
+    state?.channel.forget(upperSymbol);
+    removeSubscriber(upperSymbol, ws);
     
     // If no clients are watching this symbol anymore, stop the Binance stream
     cleanupSymbolSubscription(upperSymbol);
@@ -239,18 +812,16 @@ function cleanupSymbolSubscription(symbol: string): void {
   const upperSymbol = symbol.toUpperCase();
   
   // See if any client is still subscribed
-  let hasSubscribers = false;
-  for (const [_, subscriptions] of clientSubscriptions) {
-    if (subscriptions.has(upperSymbol)) {
-      hasSubscribers = true;
-      break;
-    }
-  }
+  const hasSubscribers = (symbolSubscribers.get(upperSymbol)?.size ?? 0) > 0;
   
-  // No one watching? Shut down the Binance stream for this symbol
-  if (!hasSubscribers && binanceAdapter) {
-    binanceAdapter.unsubscribe(upperSymbol);
+  // No one watching? Shut down the upstream stream for this symbol
+  if (!hasSubscribers && marketAdapter) {
+    marketAdapter.unsubscribe(upperSymbol);
     subscribedSymbols.delete(upperSymbol);
+    tradeBatcher.clear(upperSymbol);
+    signalEngine.clear(upperSymbol);
+    stateCache.clear(upperSymbol);
+    upstreamEvents.remove(upperSymbol);
   }
 }
 
@@ -288,7 +859,7 @@ async function handleValidate(ws: WebSocket, message: ClientMessage): Promise<vo
   }
   
   try {
-    const adapter = await initBinanceAdapter();
+    const adapter = await initAdapter();
     const validation = await adapter.validateSymbol(symbol);
     ws.send(JSON.stringify({
       type: 'validation',
@@ -309,13 +880,113 @@ async function handleValidate(ws: WebSocket, message: ClientMessage): Promise<vo
   }
 }
 
-// Simple health check - useful for monitoring and load balancers
-app.get('/health', (req, res) => {
-  res.json({
+/**
+ * This node's place in the cluster, for /health
+ * 
+ * An ingest node lists the symbols it currently owns upstream and which
+ * edges take each; an edge lists every ingest node, whether it's reachable
+ * and which of our symbols route to it.
+ */
+function nodeStatus(): Record<string, unknown> {
+  if (NODE_ROLE === 'ingest') {
+    return {
+      role: NODE_ROLE,
+      name: NODE_NAME,
+      shard: `${INGEST_SHARD.shard}/${INGEST_SHARD.shards}`,
+      busPort: BUS_PORT,
+      ownedSymbols: busServer?.ownedSymbols() ?? [],
+      edges: busServer?.getEdgeStats() ?? [],
+    };
+  }
+  if (NODE_ROLE === 'edge') {
+    return {
+      role: NODE_ROLE,
+      name: NODE_NAME,
+      ingest: marketAdapter instanceof BusAdapter ? marketAdapter.getLinkStats() : [],
+    };
+  }
+  return { role: NODE_ROLE, name: NODE_NAME };
+}
+
+function localClientStats(): { clients: number; slowClients: number } {
+  return {
+    clients: clients.size,
+    slowClients: Array.from(clients.values()).filter(state => state.channel.isBehind).length,
+  };
+}
+
+/**
+ * /health body - on a fan-out pool this is built on the main thread, with
+ * client counts summed from what the workers last reported
+ */
+function healthReport(): Record<string, unknown> {
+  const local = fanoutPool ? fanoutPool.totals() : localClientStats();
+  return {
     status: 'ok',
-    dataSource: 'binance',
-    activeConnections: clientSubscriptions.size,
+    dataSource: SOURCE_NAME,
+    node: nodeStatus(),
+    activeConnections: local.clients,
     subscribedSymbols: Array.from(subscribedSymbols),
+    slowClients: local.slowClients,
+    shards: binanceAdapter()?.getShardStats() ?? [],
+    venues: marketAdapter instanceof ConsolidatedAdapter ? marketAdapter.getVenueStats() : [],
+    fanout: fanoutPool ? fanoutPool.getWorkerStats() : [],
+    // Raw counters - the load bench samples these to work out CPU% and memory
+    process: {
+      rss: process.memoryUsage().rss,
+      cpu: process.cpuUsage(),
+      uptime: process.uptime(),
+    },
+  };
+}
+
+/**
+ * /metrics body - on a fan-out pool the main thread's metrics merged with
+ * what each worker last reported (at most a second old)
+ */
+function metricsReport(): string {
+  const own = metrics.snapshot();
+  return renderPrometheus(fanoutPool ? mergeSnapshots([own, ...fanoutPool.metricsSnapshots()]) : own);
+}
+
+// Simple health check - useful for monitoring and load balancers
+app.get('/health', async (req, res) => {
+  if (fanoutWorker) {
+    const adapter = await initAdapter();
+    if (adapter instanceof WorkerFeedAdapter) {
+      res.json(await adapter.health());
+      return;
+    }
+  }
+  res.json(healthReport());
+});
+
+// Prometheus scrape target - stage timings, per-symbol event counts, client
+// queues and event-loop lag for every thread of this process
+app.get('/metrics', async (req, res) => {
+  let body = '';
+  if (fanoutWorker) {
+    const adapter = await initAdapter();
+    if (adapter instanceof WorkerFeedAdapter) body = await adapter.metrics();
+  } else {
+    body = metricsReport();
+  }
+  res.type('text/plain; version=0.0.4').send(body);
+});
+
+// Per-client outbound lag - who is behind, by how much, and what was held back
+// (per worker on a fan-out pool - whichever one took this request)
+app.get('/clients', (req, res) => {
+  res.json({
+    policy: channelConfig.policy,
+    worker: fanoutWorker?.index,
+    clients: Array.from(clients.values()).map(state => ({
+      ...state.channel.getStats(),
+      subscriptions: Array.from(state.subscriptions),
+      encoding: state.encoding,
+      bookDeltas: state.bookDeltas,
+      filters: Object.fromEntries(Array.from(state.filters, ([symbol, filter]) => [symbol, filter.spec])),
+    })),
   });
 });
 
@@ -323,12 +994,23 @@ app.get('/health', (req, res) => {
 app.get('/api/info', (req, res) => {
   res.json({
     name: 'TapeFlow',
-    dataSource: 'Binance WebSocket API',
-    supportedPairs: 'USDT perpetual futures',
+    dataSource: NODE_ROLE === 'edge' ? 'Ingest node bus'
+      : DATA_SOURCE === 'replay' ? 'Tick capture replay'
+      : DATA_SOURCE === 'synthetic' ? 'Synthetic load generator'
+      : EXCHANGES.length > 1 ? `Consolidated ${EXCHANGES.join(', ')} WebSocket APIs`
+      : `${EXCHANGES[0]} WebSocket API`,
+    supportedPairs: EXCHANGES[0] === 'binance' ? 'USDT perpetual futures' : 'USDT spot pairs',
     features: [
       'Real-time trades',
-      'Level 2 order book (20 levels)',
+      'Level 2 order book (incremental deltas or 20-level snapshots)',
       '24hr ticker statistics',
+      'Server-side whale, velocity, wall and spoof signals',
+      'Tick capture (CAPTURE_DIR) and replay (DATA_SOURCE=replay)',
+      'Ingest/edge scale-out over a TCP bus (NODE_ROLE)',
+      'Client fan-out across worker threads (FANOUT_WORKERS)',
+      'Prometheus metrics on /metrics',
+      'Per-subscription trade filters (min notional, side, sampling)',
+      'Bybit, OKX and Coinbase feeds, consolidated tape and book across venues (EXCHANGES)',
     ],
   });
 });
@@ -336,22 +1018,108 @@ app.get('/api/info', (req, res) => {
 // Fire it up
 const PORT = process.env.PORT || 3001;
 
-server.listen(PORT, () => {
+/**
+ * Upstream subscriptions on behalf of downstream consumers (edges or
+ * fan-out workers), refcounted by whoever calls these - the same rule
+ * clients get in standalone mode
+ */
+function upstreamHandlers(): BusServerHandlers {
+  return {
+    subscribe: (symbol) => {
+      subscribedSymbols.add(symbol);
+      return initAdapter()
+        .then(adapter => adapter.subscribe(symbol, 'crypto'))
+        .catch(error => console.error(`[Upstream] Subscribe ${symbol} failed:`, error.message));
+    },
+    unsubscribe: (symbol) => {
+      subscribedSymbols.delete(symbol);
+      marketAdapter?.unsubscribe(symbol);
+      signalEngine.clear(symbol);
+      stateCache.clear(symbol);
+      upstreamEvents.remove(symbol);
+    },
+    validate: async (symbol) => (await initAdapter()).validateSymbol(symbol),
+    currentState: (symbol) => ({
+      snapshot: marketAdapter?.getBookSnapshot(symbol, BOOK_DELTA_DEPTH) ?? null,
+      orderBook: marketAdapter?.getOrderBook(symbol, BOOK_SNAPSHOT_DEPTH) ?? stateCache.orderBook(symbol),
+      ticker: stateCache.ticker(symbol),
+    }),
+    recentTrades: (symbol) => stateCache.recentTrades(symbol),
+  };
+}
+
+const onListening = () => {
   console.log(`TapeFlow Server running on port ${PORT}`);
   console.log(`WebSocket: ws://localhost:${PORT}`);
-  console.log(`Health: http://localhost:${PORT}/health\n`);
-});
+  console.log(`Health: http://localhost:${PORT}/health`);
+  console.log(`Metrics: http://localhost:${PORT}/metrics\n`);
+};
 
-// Clean shutdown - close client connections and Binance stream gracefully
+if (fanoutWorker) {
+  // Every worker binds the port with reusePort; without it, worker 0 opens
+  // the port and hands its socket to the others through the main thread.
+  // Either way each worker accepts its own share of the connections.
+  if (fanoutWorker.reusePort) {
+    // Not in Node 20's typings yet
+    server.listen({ port: fanoutWorker.port, reusePort: true } as ListenOptions);
+  } else if (fanoutWorker.listenFd === null) {
+    server.listen(fanoutWorker.port, () => {
+      // No public API for this before reusePort - the fd of the listening TCP handle
+      const fd: unknown = (server as any)._handle?.fd;
+      if (typeof fd !== 'number' || fd < 0) {
+        throw new Error('[Fanout] Listening socket has no fd to share with the other workers - upgrade Node for reusePort, or unset FANOUT_WORKERS');
+      }
+      parentPort?.postMessage({ op: 'listening', fd });
+    });
+  } else {
+    server.listen({ fd: fanoutWorker.listenFd });
+  }
+  
+  // The main thread sums these for /health and merges the metrics into /metrics
+  setInterval(() => {
+    if (marketAdapter instanceof WorkerFeedAdapter) marketAdapter.reportStats(localClientStats(), metrics.snapshot());
+  }, 1000).unref();
+  initAdapter();
+} else if (FANOUT_WORKERS > 0) {
+  fanoutPool = new FanoutPool(__filename, FANOUT_WORKERS, FANOUT_RING_BYTES, {
+    ...upstreamHandlers(),
+    health: healthReport,
+    metrics: metricsReport,
+  });
+  eventSink = fanoutPool;
+  fanoutPool.start(Number(PORT));
+  onListening();
+} else {
+  server.listen(PORT, onListening);
+}
+
+// Ingest nodes own their shard's upstream subscriptions for as long as any
+// edge wants them
+if (NODE_ROLE === 'ingest') {
+  busServer = new BusServer(BUS_PORT, NODE_NAME, INGEST_SHARD.shard, INGEST_SHARD.shards, upstreamHandlers());
+  eventSink = busServer;
+  busServer.listen();
+}
+
+// Clean shutdown - close client connections, the upstream stream and any capture file
 process.on('SIGINT', async () => {
   console.log('\nShutting down...');
   
-  for (const [client, _] of clientSubscriptions) {
+  tradeBatcher.stop();
+  signalEngine.stop();
+  busServer?.close();
+  await fanoutPool?.close();
+  
+  for (const client of clients.keys()) {
     client.close();
   }
   
-  if (binanceAdapter) {
-    await binanceAdapter.disconnect();
+  if (marketAdapter) {
+    await marketAdapter.disconnect();
+  }
+  
+  if (captureWriter) {
+    await captureWriter.close();
   }
   
   server.close(() => {
@@ -0,0 +1,118 @@
+// Binary trade frames - fixed-layout records for clients that opt in at subscribe time
+
+import { Trade, TradeSide } from '../types';
+
+/**
+ * Frame layout (all little-endian)
+ *
+ * Header (4 bytes):
+ *   u8  frameType   FRAME_TRADES (live) or FRAME_HISTORY (subscribe-time backfill)
+ *   u8  version     PROTOCOL_VERSION
+ *   u16 count       Number of trade records that follow
+ *
+ * Trade record (36 bytes):
+ *   f64 price
+ *   f64 volume
+ *   f64 timestamp   Exchange time, unix ms
+ *   f64 tradeId     Exchange trade ID (NaN if the exchange didn't give a numeric one)
+ *   u16 symbolId    Assigned by the server, announced in the 'subscribed' message
+ *   u8  side        0 = neutral, 1 = buy, 2 = sell
+ *   u8  venue       Index into VENUES
+ *
+ * A JSON trade envelope is ~250 bytes, so this is roughly 7x smaller and the
+ * browser can read it with a DataView instead of JSON.parse.
+ *
+ * Keep this in sync with frontend/src/services/binaryProtocol.ts
+ */
+export const PROTOCOL_VERSION = 1;
+export const FRAME_TRADES = 1;
+export const FRAME_HISTORY = 2;
+export const HEADER_SIZE = 4;
+export const TRADE_RECORD_SIZE = 36;
+export const MAX_TRADES_PER_FRAME = 0xffff;
+
+// Append only - the index is what's on the wire
+export const VENUES = ['', 'BINANCE', 'BYBIT', 'OKX', 'COINBASE'];
+
+const SIDE_CODES: Record<TradeSide, number> = { neutral: 0, buy: 1, sell: 2 };
+const SIDES: TradeSide[] = ['neutral', 'buy', 'sell'];
+
+// Symbol IDs are handed out on first subscribe and never reused while the
+// process is up, so a client can cache the mapping for the whole session
+const symbolIds: Map<string, number> = new Map();
+
+export function getSymbolId(symbol: string): number {
+  const upperSymbol = symbol.toUpperCase();
+  let id = symbolIds.get(upperSymbol);
+  if (id === undefined) {
+    id = symbolIds.size + 1;
+    symbolIds.set(upperSymbol, id);
+  }
+  return id;
+}
+
+function getVenueCode(exchange?: string): number {
+  if (!exchange) return 0;
+  const code = VENUES.indexOf(exchange.toUpperCase());
+  return code > 0 ? code : 0;
+}
+
+/**
+ * Write a frame header at the start of buffer
+ */
+export function writeFrameHeader(buffer: Buffer, frameType: number, count: number): void {
+  buffer.writeUInt8(frameType, 0);
+  buffer.writeUInt8(PROTOCOL_VERSION, 1);
+  buffer.writeUInt16LE(count, 2);
+}
+
+/**
+ * Write a single trade record at the given byte offset
+ */
+export function writeTradeRecord(view: DataView, offset: number, trade: Trade): void {
+  const numericId = Number(trade.id);
+  view.setFloat64(offset, trade.price, true);
+  view.setFloat64(offset + 8, trade.volume, true);
+  view.setFloat64(offset + 16, trade.timestamp, true);
+  view.setFloat64(offset + 24, Number.isFinite(numericId) ? numericId : NaN, true);
+  view.setUint16(offset + 32, getSymbolId(trade.symbol), true);
+  view.setUint8(offset + 34, SIDE_CODES[trade.side] ?? 0);
+  view.setUint8(offset + 35, getVenueCode(trade.exchange));
+}
+
+/**
+ * Read a trade record back (the symbol isn't looked up - the caller knows it)
+ */
+export function readTradeRecord(view: DataView, offset: number, symbol: string): Trade {
+  const timestamp = view.getFloat64(offset + 16, true);
+  const tradeId = view.getFloat64(offset + 24, true);
+  const trade: Trade = {
+    id: Number.isNaN(tradeId) ? `${timestamp}-${offset}` : String(tradeId),
+    symbol,
+    assetType: 'crypto',
+    timestamp,
+    price: view.getFloat64(offset, true),
+    volume: view.getFloat64(offset + 8, true),
+    side: SIDES[view.getUint8(offset + 34)] ?? 'neutral',
+  };
+  const venue = VENUES[view.getUint8(offset + 35)];
+  if (venue) trade.exchange = venue;
+  return trade;
+}
+
+/**
+ * Encode one or more trades into a single binary frame
+ */
+export function encodeTradeFrame(trades: Trade[], frameType: number = FRAME_TRADES): Buffer {
+  const count = Math.min(trades.length, MAX_TRADES_PER_FRAME);
+  const buffer = Buffer.allocUnsafe(HEADER_SIZE + count * TRADE_RECORD_SIZE);
+  const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+
+  writeFrameHeader(buffer, frameType, count);
+
+  for (let i = 0; i < count; i++) {
+    writeTradeRecord(view, HEADER_SIZE + i * TRADE_RECORD_SIZE, trades[i]);
+  }
+
+  return buffer;
+}
@@ -0,0 +1,284 @@
+// Market data bus - ingest nodes publish normalised events to edge nodes over TCP
+
+import net from 'net';
+import { Trade, TradeHistory, OrderBook, OrderBookDelta, Ticker, Signal, SymbolInfo } from '../types';
+
+/**
+ * Wire format: one JSON object per line, both directions
+ *
+ * edge -> ingest:  hello, sub, unsub, validate
+ * ingest -> edge:  welcome, event, validation
+ *
+ * An edge sends 'sub' for every symbol one of its clients watches on that
+ * ingest node; the ingest node answers with the current book (if it has
+ * one) and then streams that symbol's events until the edge unsubscribes
+ * or goes away. Once the upstream subscribe has finished, the edge also
+ * gets one 'history' event with the recent trades, backfill included.
+ * Signals are computed once on the ingest node and travel as events too.
+ */
+export type BusEvent =
+  | { kind: 'trade'; data: Trade }
+  | { kind: 'orderbook'; data: OrderBook }
+  | { kind: 'delta'; data: OrderBookDelta }
+  | { kind: 'ticker'; data: Ticker }
+  | { kind: 'signal'; data: Signal }
+  | { kind: 'history'; data: TradeHistory };
+
+export type EdgeMessage =
+  | { op: 'hello'; node: string }
+  | { op: 'sub'; symbol: string }
+  | { op: 'unsub'; symbol: string }
+  | { op: 'validate'; id: number; symbol: string };
+
+export type IngestMessage =
+  | { op: 'welcome'; node: string; shard: number; shards: number }
+  | { op: 'event'; event: BusEvent }
+  | { op: 'validation'; id: number; data: SymbolInfo };
+
+// An edge this far behind is cut off rather than buffered without limit
+const MAX_PEER_BUFFER_BYTES = 64 * 1024 * 1024;
+
+/**
+ * Which of shards ingest nodes owns a symbol (FNV-1a of the name)
+ *
+ * Static, so every edge routes the same way without asking anyone - the
+ * catch is that changing the shard count moves symbols between nodes.
+ */
+export function symbolOwner(symbol: string, shards: number): number {
+  let hash = 0x811c9dc5;
+  const upperSymbol = symbol.toUpperCase();
+  for (let i = 0; i < upperSymbol.length; i++) {
+    hash ^= upperSymbol.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193) >>> 0;
+  }
+  return shards > 0 ? hash % shards : 0;
+}
+
+/**
+ * "i/n" -> { shard: i, shards: n }
+ */
+export function parseShard(spec: string): { shard: number; shards: number } {
+  const [shard, shards] = spec.split('/').map(Number);
+  if (!Number.isInteger(shard) || !Number.isInteger(shards) || shards < 1 || shard < 0 || shard >= shards) {
+    throw new Error(`Bad shard spec '${spec}' - expected i/n, e.g. 0/2`);
+  }
+  return { shard, shards };
+}
+
+/**
+ * One side of a bus connection - line framing and write coalescing
+ *
+ * Writes made in the same tick go out as one socket write, which matters
+ * when a trade burst turns into hundreds of lines.
+ */
+export class BusPeer {
+  private pending: string[] = [];
+  private flushScheduled = false;
+  private partial = '';
+
+  constructor(readonly socket: net.Socket, onMessage: (message: any) => void) {
+    socket.setNoDelay(true);
+    socket.setEncoding('utf8');
+    socket.on('data', (chunk: string) => {
+      const lines = (this.partial + chunk).split('\n');
+      this.partial = lines.pop() ?? '';
+      for (const line of lines) {
+        if (line.length === 0) continue;
+        try {
+          onMessage(JSON.parse(line));
+        } catch (error) {
+          console.error('[Bus] Bad message:', (error as Error).message);
+        }
+      }
+    });
+  }
+
+  get address(): string {
+    return `${this.socket.remoteAddress ?? '?'}:${this.socket.remotePort ?? '?'}`;
+  }
+
+  send(message: EdgeMessage | IngestMessage): void {
+    this.sendLine(JSON.stringify(message));
+  }
+
+  /**
+   * Pre-serialised message - lets a publisher stringify once for every peer
+   */
+  sendLine(line: string): void {
+    if (this.socket.destroyed) return;
+    this.pending.push(line);
+    if (this.flushScheduled) return;
+    this.flushScheduled = true;
+    setImmediate(() => this.flush());
+  }
+
+  private flush(): void {
+    this.flushScheduled = false;
+    if (this.socket.destroyed || this.pending.length === 0) return;
+    if (this.socket.writableLength > MAX_PEER_BUFFER_BYTES) {
+      console.warn(`[Bus] Dropping ${this.address} - ${(this.socket.writableLength / 1024 / 1024).toFixed(0)}MB behind`);
+      this.pending = [];
+      this.socket.destroy();
+      return;
+    }
+    this.socket.write(this.pending.join('\n') + '\n');
+    this.pending = [];
+  }
+}
+
+export interface BusServerHandlers {
+  subscribe(symbol: string): Promise<void>;     // Resolves once the backfill is cached - never rejects
+  unsubscribe(symbol: string): void;
+  validate(symbol: string): Promise<SymbolInfo>;
+  currentState(symbol: string): { snapshot: OrderBookDelta | null; orderBook: OrderBook | null; ticker: Ticker | null };
+  recentTrades(symbol: string): Trade[];
+}
+
+interface EdgeState {
+  peer: BusPeer;
+  node: string;
+  symbols: Set<string>;
+}
+
+/**
+ * Ingest side of the bus - serves this node's shard of symbols to edges
+ *
+ * The upstream subscription for a symbol lives exactly as long as at least
+ * one edge wants it, the same rule server.ts applies to browser clients.
+ */
+export class BusServer {
+  private server: net.Server;
+  private edges: Set<EdgeState> = new Set();
+  private interest: Map<string, Set<EdgeState>> = new Map();
+  private subscribed: Map<string, Promise<void>> = new Map();
+
+  constructor(
+    private port: number,
+    private node: string,
+    readonly shard: number,
+    readonly shards: number,
+    private handlers: BusServerHandlers
+  ) {
+    this.server = net.createServer(socket => this.accept(socket));
+  }
+
+  listen(): void {
+    this.server.listen(this.port, () => {
+      console.log(`[Bus] Ingest node ${this.node} (shard ${this.shard}/${this.shards}) listening on ${this.port}`);
+    });
+  }
+
+  /**
+   * Send an event to every edge that wants its symbol
+   */
+  publish(event: BusEvent): void {
+    const edges = this.interest.get(event.data.symbol.toUpperCase());
+    if (!edges || edges.size === 0) return;
+    const line = JSON.stringify({ op: 'event', event });
+    for (const edge of edges) edge.peer.sendLine(line);
+  }
+
+  ownedSymbols(): string[] {
+    return Array.from(this.interest.keys());
+  }
+
+  getEdgeStats(): { node: string; address: string; symbols: string[]; bufferedBytes: number }[] {
+    return Array.from(this.edges, edge => ({
+      node: edge.node,
+      address: edge.peer.address,
+      symbols: Array.from(edge.symbols),
+      bufferedBytes: edge.peer.socket.writableLength,
+    }));
+  }
+
+  close(): void {
+    for (const edge of this.edges) edge.peer.socket.destroy();
+    this.server.close();
+  }
+
+  private accept(socket: net.Socket): void {
+    const edge: EdgeState = {
+      peer: new BusPeer(socket, (message: EdgeMessage) => this.handle(edge, message)),
+      node: '?',
+      symbols: new Set(),
+    };
+    this.edges.add(edge);
+    edge.peer.send({ op: 'welcome', node: this.node, shard: this.shard, shards: this.shards });
+    console.log(`[Bus] Edge connected from ${edge.peer.address}`);
+
+    socket.on('error', (error) => console.error(`[Bus] Edge ${edge.node} error:`, error.message));
+    socket.on('close', () => {
+      this.edges.delete(edge);
+      for (const symbol of edge.symbols) this.removeInterest(symbol, edge);
+      console.log(`[Bus] Edge ${edge.node} disconnected`);
+    });
+  }
+
+  private handle(edge: EdgeState, message: EdgeMessage): void {
+    switch (message.op) {
+      case 'hello':
+        edge.node = message.node;
+        break;
+      case 'sub':
+        this.addInterest(message.symbol.toUpperCase(), edge);
+        break;
+      case 'unsub':
+        this.removeInterest(message.symbol.toUpperCase(), edge);
+        break;
+      case 'validate':
+        this.handlers.validate(message.symbol)
+          .catch((error: Error): SymbolInfo => ({
+            symbol: message.symbol.toUpperCase(),
+            name: message.symbol.toUpperCase(),
+            assetType: 'crypto',
+            valid: false,
+            error: error.message || 'Validation failed',
+          }))
+          .then(data => edge.peer.send({ op: 'validation', id: message.id, data }));
+        break;
+    }
+  }
+
+  private addInterest(symbol: string, edge: EdgeState): void {
+    if (symbolOwner(symbol, this.shards) !== this.shard) {
+      console.warn(`[Bus] Edge ${edge.node} asked for ${symbol}, which shard ${symbolOwner(symbol, this.shards)} owns`);
+      return;
+    }
+    if (edge.symbols.has(symbol)) return;
+    edge.symbols.add(symbol);
+
+    let edges = this.interest.get(symbol);
+    if (!edges) {
+      edges = new Set();
+      this.interest.set(symbol, edges);
+      this.subscribed.set(symbol, this.handlers.subscribe(symbol));
+    }
+    edges.add(edge);
+
+    // A late edge gets the book and ticker now instead of waiting for the next push
+    const { snapshot, orderBook, ticker } = this.handlers.currentState(symbol);
+    if (snapshot) edge.peer.send({ op: 'event', event: { kind: 'delta', data: snapshot } });
+    if (orderBook) edge.peer.send({ op: 'event', event: { kind: 'orderbook', data: orderBook } });
+    if (ticker) edge.peer.send({ op: 'event', event: { kind: 'ticker', data: ticker } });
+
+    // Recent trades once the upstream subscribe is done - the edge holds its
+    // first client's confirmation until this arrives, even if it's empty
+    this.subscribed.get(symbol)?.then(() => {
+      if (!edge.symbols.has(symbol) || !this.edges.has(edge)) return;
+      const history: TradeHistory = { symbol, trades: this.handlers.recentTrades(symbol) };
+      edge.peer.send({ op: 'event', event: { kind: 'history', data: history } });
+    });
+  }
+
+  private removeInterest(symbol: string, edge: EdgeState): void {
+    edge.symbols.delete(symbol);
+    const edges = this.interest.get(symbol);
+    if (!edges) return;
+    edges.delete(edge);
+    if (edges.size === 0) {
+      this.interest.delete(symbol);
+      this.subscribed.delete(symbol);
+      this.handlers.unsubscribe(symbol);
+    }
+  }
+}
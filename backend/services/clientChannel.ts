@@ -0,0 +1,463 @@
+// Client channel - per-socket outbound path with backpressure, a slow-consumer policy and rate-capped conflation
+
+import { WebSocket } from 'ws';
+import { Trade, TradeSummary, OrderBookDelta } from '../types';
+
+/**
+ * What happens to a client whose socket buffer passes the high-water mark
+ *
+ * - conflate: book snapshots and tickers are held back latest-only, trades
+ *   are folded into one 'trade_summary' per symbol, deltas are dropped and
+ *   the book is resynced once the socket drains
+ * - disconnect: the same while it catches up, but a client still behind
+ *   after maxLagMs is closed
+ *
+ * Either way a client whose buffer reaches maxBufferBytes is closed.
+ */
+export type SlowConsumerPolicy = 'conflate' | 'disconnect';
+
+export interface ChannelConfig {
+  highWaterBytes: number;   // bufferedAmount above this = behind
+  lowWaterBytes: number;    // ...and caught up again below this
+  maxBufferBytes: number;   // Hard cap - closed no matter the policy
+  maxLagMs: number;         // 'disconnect' policy: longest a client may stay behind
+  policy: SlowConsumerPolicy;
+}
+
+export interface ChannelStats {
+  id: number;
+  address: string;
+  bufferedBytes: number;
+  behind: boolean;
+  lagMs: number;            // How long it has been behind (0 if it isn't)
+  maxRate: number;          // Book/ticker updates per second per symbol the client asked for, 0 = uncapped
+  messagesSent: number;
+  bytesSent: number;
+  conflated: number;        // Book/ticker messages replaced by a newer one
+  tradesSummarised: number;
+  deltasDropped: number;
+  deltasMerged: number;     // Deltas folded into a later one by the rate cap
+  behindEpisodes: number;
+}
+
+/**
+ * Deltas held back by the rate cap, merged level by level - the newest size
+ * per price wins, and the seq range covers everything folded in
+ */
+interface MergedDelta {
+  first: OrderBookDelta;
+  seq: number;
+  timestamp: number;
+  bids: Map<number, number>;
+  asks: Map<number, number>;
+}
+
+// 4000-4999 are free for applications
+const CLOSE_SLOW_CONSUMER = 4008;
+const DRAIN_CHECK_MS = 50;
+
+// Channels currently behind - polled until their sockets drain
+const lagging: Set<ClientChannel> = new Set();
+let drainTimer: NodeJS.Timeout | null = null;
+
+function watchDrain(channel: ClientChannel): void {
+  lagging.add(channel);
+  if (drainTimer) return;
+  drainTimer = setInterval(() => {
+    for (const c of lagging) c.checkDrain();
+    if (lagging.size === 0 && drainTimer) {
+      clearInterval(drainTimer);
+      drainTimer = null;
+    }
+  }, DRAIN_CHECK_MS);
+  drainTimer.unref();
+}
+
+let nextChannelId = 1;
+
+/**
+ * Everything sent to one client goes through here
+ *
+ * While the socket keeps up, messages go straight to ws.send. Once
+ * bufferedAmount passes the high-water mark the channel stops adding to
+ * the kernel/ws backlog: it keeps only what can be rebuilt or summarised,
+ * and writes that out in one go when the buffer falls under the low-water
+ * mark. Memory per slow client is bounded by its symbol count rather than
+ * by how long the link stays bad.
+ *
+ * A client can also cap book and ticker updates with maxRate. Those are
+ * latest-value streams, so anything arriving sooner than 1/maxRate after
+ * the last write is held, replaced by newer values (deltas are merged), and
+ * written when its slot comes round - a background dashboard asking for
+ * 1/s gets one book and one ticker per symbol per second, however fast
+ * the exchange is.
+ */
+export class ClientChannel {
+  readonly id = nextChannelId++;
+  private behindSince = 0;
+  private latest: Map<string, string> = new Map();       // key -> newest payload
+  private summaries: Map<string, TradeSummary> = new Map();
+  private staleBooks: Set<string> = new Set();
+  private merged: Map<string, MergedDelta> = new Map();   // symbol -> held deltas
+  private lastSent: Map<string, number> = new Map();      // key -> last write, while capped
+  private minIntervalMs = 0;
+  private flushTimer: NodeJS.Timeout | null = null;
+  private flushAt = 0;
+  private closed = false;
+  private stats = {
+    messagesSent: 0,
+    bytesSent: 0,
+    conflated: 0,
+    tradesSummarised: 0,
+    deltasDropped: 0,
+    deltasMerged: 0,
+    behindEpisodes: 0,
+  };
+
+  /**
+   * resync(symbol) must send a fresh book snapshot through this channel -
+   * called when deltas were dropped for that symbol
+   */
+  constructor(
+    private ws: WebSocket,
+    private config: ChannelConfig,
+    private address: string,
+    private resync: (symbol: string) => void
+  ) {}
+
+  get isBehind(): boolean {
+    return this.behindSince > 0;
+  }
+
+  get bufferedBytes(): number {
+    return this.ws.bufferedAmount;
+  }
+
+  /**
+   * Cap book/ticker updates to rate per second per symbol (0 = uncapped)
+   */
+  setMaxRate(rate: number): void {
+    this.minIntervalMs = rate > 0 ? 1000 / rate : 0;
+    if (this.minIntervalMs === 0) {
+      this.lastSent.clear();
+      this.flushPaced();
+    }
+  }
+
+  /**
+   * Messages that can't be conflated or rebuilt (control replies, signals)
+   */
+  send(payload: string | Buffer): void {
+    if (!this.writable()) return;
+    this.write(payload);
+  }
+
+  /**
+   * Book snapshots and tickers - only the newest per key matters
+   */
+  sendLatest(key: string, payload: string): void {
+    if (!this.writable()) return;
+    if (this.isBehind || (this.minIntervalMs > 0 && !this.isDue(key))) {
+      if (this.latest.has(key)) this.stats.conflated++;
+      this.latest.set(key, payload);
+      if (!this.isBehind) this.scheduleFlush(key);
+      return;
+    }
+    this.writePaced(key, payload);
+  }
+
+  /**
+   * Incremental book updates - merged under the rate cap, dropped while
+   * behind (the book is resent whole once the client catches up).
+   * payload() is only called if this delta goes out as-is.
+   */
+  sendDelta(symbol: string, delta: OrderBookDelta, payload: () => string): void {
+    // A snapshot replaces the book - merged into a delta it would lose the
+    // levels it removed, so it supersedes whatever is held and goes now
+    if (delta.snapshot) {
+      this.sendSnapshot(symbol, payload());
+      return;
+    }
+    if (!this.writable()) return;
+    if (this.isBehind) {
+      this.staleBooks.add(symbol);
+      this.merged.delete(symbol);
+      this.stats.deltasDropped++;
+      return;
+    }
+
+    if (this.minIntervalMs > 0) {
+      const key = `delta:${symbol}`;
+      if (this.merged.has(symbol) || !this.isDue(key)) {
+        this.mergeDelta(symbol, delta);
+        this.scheduleFlush(key);
+        return;
+      }
+      this.lastSent.set(key, Date.now());
+    }
+    this.write(payload());
+  }
+
+  /**
+   * A full book for a delta client - supersedes anything held for the symbol
+   */
+  sendSnapshot(symbol: string, payload: string): void {
+    this.merged.delete(symbol);
+    if (!this.writable()) return;
+    // Behind: the book is resent once the socket drains, this one would only add to the backlog
+    if (this.isBehind) {
+      this.staleBooks.add(symbol);
+      return;
+    }
+    this.staleBooks.delete(symbol);
+    this.write(payload);
+    if (this.minIntervalMs > 0) this.lastSent.set(`delta:${symbol}`, Date.now());
+  }
+
+  /**
+   * A trade batch - payload() builds this client's encoding and is only
+   * called if the batch actually goes out
+   */
+  sendTrades(symbol: string, trades: Trade[], payload: () => string | Buffer): void {
+    if (!this.writable()) return;
+    if (this.isBehind) {
+      this.summarise(symbol, trades);
+      return;
+    }
+    this.write(payload());
+  }
+
+  /**
+   * Subscribe-time backfill - skipped for a client that's already behind,
+   * where it would only add to the backlog
+   */
+  sendHistory(payload: () => string | Buffer): void {
+    if (!this.writable() || this.isBehind) return;
+    this.write(payload());
+  }
+
+  /**
+   * Drop anything held back for a symbol the client no longer watches
+   */
+  forget(symbol: string): void {
+    for (const key of this.latest.keys()) {
+      if (key.endsWith(`:${symbol}`)) this.latest.delete(key);
+    }
+    for (const key of this.lastSent.keys()) {
+      if (key.endsWith(`:${symbol}`)) this.lastSent.delete(key);
+    }
+    this.summaries.delete(symbol);
+    this.staleBooks.delete(symbol);
+    this.merged.delete(symbol);
+  }
+
+  close(): void {
+    this.closed = true;
+    lagging.delete(this);
+    if (this.flushTimer) clearTimeout(this.flushTimer);
+    this.flushTimer = null;
+    this.latest.clear();
+    this.summaries.clear();
+    this.staleBooks.clear();
+    this.merged.clear();
+    this.lastSent.clear();
+  }
+
+  getStats(): ChannelStats {
+    return {
+      id: this.id,
+      address: this.address,
+      bufferedBytes: this.bufferedBytes,
+      behind: this.isBehind,
+      lagMs: this.isBehind ? Date.now() - this.behindSince : 0,
+      maxRate: this.minIntervalMs > 0 ? 1000 / this.minIntervalMs : 0,
+      ...this.stats,
+    };
+  }
+
+  /**
+   * Called by the drain poller while behind
+   */
+  checkDrain(): void {
+    if (this.closed || this.ws.readyState !== WebSocket.OPEN) {
+      lagging.delete(this);
+      return;
+    }
+
+    const buffered = this.ws.bufferedAmount;
+    if (buffered >= this.config.lowWaterBytes) {
+      this.enforcePolicy(buffered);
+      return;
+    }
+
+    // Caught up - write out what was held back, book resyncs first so
+    // summaries and snapshots land on a consistent book
+    this.behindSince = 0;
+    lagging.delete(this);
+
+    const stale = Array.from(this.staleBooks);
+    this.staleBooks.clear();
+    for (const symbol of stale) this.resync(symbol);
+
+    for (const summary of this.summaries.values()) {
+      this.write(JSON.stringify({ type: 'trade_summary', data: summary, symbol: summary.symbol, timestamp: Date.now() }));
+    }
+    this.summaries.clear();
+
+    for (const symbol of Array.from(this.merged.keys())) this.writeMerged(symbol);
+    for (const [key, payload] of this.latest) this.writePaced(key, payload);
+  }
+
+  private isDue(key: string): boolean {
+    return Date.now() - (this.lastSent.get(key) ?? 0) >= this.minIntervalMs;
+  }
+
+  private writePaced(key: string, payload: string): void {
+    this.write(payload);
+    this.latest.delete(key);
+    if (this.minIntervalMs > 0) this.lastSent.set(key, Date.now());
+  }
+
+  private writeMerged(symbol: string): void {
+    const merged = this.merged.get(symbol);
+    if (!merged) return;
+    this.merged.delete(symbol);
+    if (this.minIntervalMs > 0) this.lastSent.set(`delta:${symbol}`, Date.now());
+
+    const delta: OrderBookDelta = {
+      symbol: merged.first.symbol,
+      assetType: merged.first.assetType,
+      timestamp: merged.timestamp,
+      seq: merged.seq,
+      prevSeq: merged.first.prevSeq,
+      bids: Array.from(merged.bids),
+      asks: Array.from(merged.asks),
+    };
+    this.write(JSON.stringify({ type: 'orderbook_delta', data: delta, symbol, timestamp: Date.now() }));
+  }
+
+  private mergeDelta(symbol: string, delta: OrderBookDelta): void {
+    let merged = this.merged.get(symbol);
+    if (!merged) {
+      merged = { first: delta, seq: delta.seq, timestamp: delta.timestamp, bids: new Map(), asks: new Map() };
+      this.merged.set(symbol, merged);
+    } else {
+      this.stats.deltasMerged++;
+    }
+    for (const [price, size] of delta.bids) merged.bids.set(price, size);
+    for (const [price, size] of delta.asks) merged.asks.set(price, size);
+    merged.seq = delta.seq;
+    merged.timestamp = delta.timestamp;
+  }
+
+  /**
+   * Make sure a paced flush runs by the time key's next slot opens
+   */
+  private scheduleFlush(key: string): void {
+    this.armFlush((this.lastSent.get(key) ?? 0) + this.minIntervalMs);
+  }
+
+  private armFlush(at: number): void {
+    if (this.flushTimer && this.flushAt <= at) return;
+    if (this.flushTimer) clearTimeout(this.flushTimer);
+    this.flushAt = at;
+    this.flushTimer = setTimeout(() => {
+      this.flushTimer = null;
+      this.flushPaced();
+    }, Math.max(0, at - Date.now()));
+  }
+
+  /**
+   * Write every held value whose slot has opened, then sleep until the next
+   */
+  private flushPaced(): void {
+    if (this.closed || this.isBehind || this.ws.readyState !== WebSocket.OPEN) return;
+    const now = Date.now();
+    let next = Infinity;
+
+    for (const [key, payload] of this.latest) {
+      const at = (this.lastSent.get(key) ?? 0) + this.minIntervalMs;
+      if (at <= now) this.writePaced(key, payload);
+      else next = Math.min(next, at);
+    }
+    for (const symbol of Array.from(this.merged.keys())) {
+      const at = (this.lastSent.get(`delta:${symbol}`) ?? 0) + this.minIntervalMs;
+      if (at <= now) this.writeMerged(symbol);
+      else next = Math.min(next, at);
+    }
+
+    if (next < Infinity) this.armFlush(next);
+  }
+
+  private writable(): boolean {
+    if (this.closed || this.ws.readyState !== WebSocket.OPEN) return false;
+    if (this.isBehind) return !this.enforcePolicy(this.ws.bufferedAmount);
+
+    const buffered = this.ws.bufferedAmount;
+    if (buffered > this.config.highWaterBytes) {
+      this.behindSince = Date.now();
+      this.stats.behindEpisodes++;
+      watchDrain(this);
+      return !this.enforcePolicy(buffered);
+    }
+    return true;
+  }
+
+  /**
+   * Close the client if it's past what the policy tolerates - returns
+   * true if it did
+   */
+  private enforcePolicy(buffered: number): boolean {
+    const overCap = buffered > this.config.maxBufferBytes;
+    const tooSlow = this.config.policy === 'disconnect' && Date.now() - this.behindSince > this.config.maxLagMs;
+    if (!overCap && !tooSlow) return false;
+
+    console.warn(
+      `[Channel] Closing slow client #${this.id} (${this.address}): ` +
+      `${(buffered / 1024).toFixed(0)}KB buffered, behind ${Date.now() - this.behindSince}ms`
+    );
+    this.ws.close(CLOSE_SLOW_CONSUMER, 'Slow consumer');
+    this.close();
+    return true;
+  }
+
+  private write(payload: string | Buffer): void {
+    this.ws.send(payload);
+    this.stats.messagesSent++;
+    this.stats.bytesSent += typeof payload === 'string' ? Buffer.byteLength(payload) : payload.length;
+  }
+
+  private summarise(symbol: string, trades: Trade[]): void {
+    if (trades.length === 0) return;
+    let summary = this.summaries.get(symbol);
+    if (!summary) {
+      summary = {
+        symbol,
+        assetType: trades[0].assetType,
+        firstTimestamp: trades[0].timestamp,
+        lastTimestamp: trades[0].timestamp,
+        count: 0,
+        volume: 0,
+        buyVolume: 0,
+        sellVolume: 0,
+        open: trades[0].price,
+        high: trades[0].price,
+        low: trades[0].price,
+        close: trades[0].price,
+      };
+      this.summaries.set(symbol, summary);
+    }
+
+    for (const trade of trades) {
+      summary.count++;
+      summary.volume += trade.volume;
+      if (trade.side === 'buy') summary.buyVolume += trade.volume;
+      else if (trade.side === 'sell') summary.sellVolume += trade.volume;
+      if (trade.price > summary.high) summary.high = trade.price;
+      if (trade.price < summary.low) summary.low = trade.price;
+      summary.close = trade.price;
+      summary.lastTimestamp = trade.timestamp;
+    }
+    this.stats.tradesSummarised += trades.length;
+  }
+}
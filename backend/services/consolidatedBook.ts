@@ -0,0 +1,119 @@
+// Consolidated book - one symbol's resting liquidity summed across venues, kept current from their deltas
+
+import { OrderBookDelta } from '../types';
+import { BookSide, LocalOrderBook, MAX_BOOK_LEVELS } from './orderBookEngine';
+
+// Levels whose index is below this count as a top-of-book change
+const TOP_LEVELS = 20;
+
+// Summed sizes drift by float error as venues add and remove; below this a level is gone
+const EPSILON = 1e-9;
+
+/**
+ * What one venue delta did to the consolidated book - the levels whose
+ * total changed, with their new total (0 = gone)
+ */
+export interface ConsolidatedChange {
+  bids: [number, number][];
+  asks: [number, number][];
+  topChanged: boolean;
+}
+
+/**
+ * Cross-venue book for one symbol
+ *
+ * Keeps a mirror of each venue's book and one summed book; a venue's level
+ * going from a to b moves the total at that price by b - a, so a delta
+ * costs a couple of lookups per level whatever the venue count. Prices are
+ * kept as the venues quote them - venues on a different tick grid just add
+ * levels. The summed book can be crossed (one venue's bid above another's
+ * ask); that's the market, not a bug, and is passed on as is.
+ *
+ * seq numbers the consolidated deltas; the owner bumps it as it emits them.
+ */
+export class ConsolidatedBook {
+  readonly book: LocalOrderBook;
+  seq = 0;
+  private venueBooks: (LocalOrderBook | null)[];
+
+  constructor(readonly symbol: string, venueCount: number) {
+    // Never trimmed - every level in it belongs to some venue's (trimmed) book
+    this.book = new LocalOrderBook(symbol, Infinity);
+    this.venueBooks = new Array(venueCount).fill(null);
+  }
+
+  /**
+   * True once any venue's book is in
+   */
+  get synced(): boolean {
+    return this.venueBooks.some(book => book !== null);
+  }
+
+  /**
+   * Apply one venue's delta
+   *
+   * A venue snapshot replaces that venue's share wholesale and returns
+   * 'snapshot' - the caller sends the consolidated book as a snapshot rather
+   * than a delta the size of the venue's book. Deltas from a venue whose
+   * snapshot hasn't arrived are dropped. null means nothing changed.
+   */
+  apply(venue: number, delta: OrderBookDelta): ConsolidatedChange | 'snapshot' | null {
+    if (delta.snapshot) {
+      this.removeVenue(venue);
+      const venueBook = new LocalOrderBook(this.symbol, MAX_BOOK_LEVELS);
+      venueBook.applySnapshot(delta.bids, delta.asks, delta.seq);
+      venueBook.trim();
+      this.venueBooks[venue] = venueBook;
+      const ignored: ConsolidatedChange = { bids: [], asks: [], topChanged: false };
+      for (const [price, size] of venueBook.topBidPairs(Infinity)) this.addToTotal('bid', price, size, ignored);
+      for (const [price, size] of venueBook.topAskPairs(Infinity)) this.addToTotal('ask', price, size, ignored);
+      return 'snapshot';
+    }
+
+    const venueBook = this.venueBooks[venue];
+    if (!venueBook) return null;
+
+    const change: ConsolidatedChange = { bids: [], asks: [], topChanged: false };
+    for (const [price, size] of delta.bids) this.setVenueLevel(venueBook, 'bid', price, size, change);
+    for (const [price, size] of delta.asks) this.setVenueLevel(venueBook, 'ask', price, size, change);
+
+    // The venue's far levels fall off its book without a delta - take them out of the total too
+    while (venueBook.bids.length > MAX_BOOK_LEVELS) {
+      this.setVenueLevel(venueBook, 'bid', venueBook.bids.prices[venueBook.bids.length - 1], 0, change);
+    }
+    while (venueBook.asks.length > MAX_BOOK_LEVELS) {
+      this.setVenueLevel(venueBook, 'ask', venueBook.asks.prices[venueBook.asks.length - 1], 0, change);
+    }
+
+    return change.bids.length > 0 || change.asks.length > 0 ? change : null;
+  }
+
+  /**
+   * Take a venue's share out (it disconnected) - true if it had one
+   */
+  removeVenue(venue: number): boolean {
+    const venueBook = this.venueBooks[venue];
+    if (!venueBook) return false;
+    const ignored: ConsolidatedChange = { bids: [], asks: [], topChanged: false };
+    for (const [price, size] of venueBook.topBidPairs(Infinity)) this.addToTotal('bid', price, -size, ignored);
+    for (const [price, size] of venueBook.topAskPairs(Infinity)) this.addToTotal('ask', price, -size, ignored);
+    this.venueBooks[venue] = null;
+    return true;
+  }
+
+  private setVenueLevel(venueBook: LocalOrderBook, side: BookSide, price: number, size: number, change: ConsolidatedChange): void {
+    const previous = venueBook.sizeAt(side, price);
+    if (previous === size) return;
+    venueBook.applyLevel(side, price, size);
+    this.addToTotal(side, price, size - previous, change);
+  }
+
+  private addToTotal(side: BookSide, price: number, diff: number, change: ConsolidatedChange): void {
+    let total = this.book.sizeAt(side, price) + diff;
+    if (total < EPSILON) total = 0;
+    const index = this.book.applyLevel(side, price, total);
+    if (index < 0) return;
+    (side === 'bid' ? change.bids : change.asks).push([price, total]);
+    if (index < TOP_LEVELS) change.topChanged = true;
+  }
+}
@@ -0,0 +1,291 @@
+// Fan-out pool - client connections spread over worker threads, fed from the adapter thread through shared rings
+
+import { Worker } from 'worker_threads';
+import { SymbolInfo } from '../types';
+import { BusEvent, BusServerHandlers } from './bus';
+import { SharedRing, encodeEvent } from './sharedRing';
+import { FamilySnapshot } from './metrics';
+
+// Wait before restarting a worker that died, so a crash loop doesn't spin
+const RESPAWN_DELAY_MS = 1000;
+
+/**
+ * listen({ reusePort }) - Node 22.12+ / 23.1+, on Linux and FreeBSD
+ */
+function reusePortSupported(): boolean {
+  const [major, minor] = process.versions.node.split('.').map(Number);
+  const node = major >= 24 || (major === 23 && minor >= 1) || (major === 22 && minor >= 12);
+  return node && (process.platform === 'linux' || process.platform === 'freebsd');
+}
+
+export const REUSE_PORT = reusePortSupported();
+
+/**
+ * What a fan-out worker is started with
+ *
+ * With reusePort every worker binds the port itself and the kernel spreads
+ * connections over them; each socket is its own, so a worker can die and
+ * be restarted alone. Older Nodes have no SO_REUSEPORT (and sockets can't
+ * be handed to a worker thread once accepted), so there worker 0 listens
+ * and reports the listening socket's fd, and the rest accept on that same
+ * fd - one socket shared by all, which goes down with any of them.
+ */
+export interface FanoutWorkerData {
+  index: number;
+  ring: SharedArrayBuffer;
+  port: number;
+  reusePort: boolean;
+  listenFd: number | null;
+}
+
+export interface WorkerStats {
+  clients: number;
+  slowClients: number;
+}
+
+// Control plane only - market data never goes through postMessage
+export type WorkerToMain =
+  | { op: 'listening'; fd: number }
+  | { op: 'sub'; symbol: string }
+  | { op: 'unsub'; symbol: string }
+  | { op: 'validate'; id: number; symbol: string }
+  | { op: 'health'; id: number }
+  | { op: 'metrics'; id: number }
+  | { op: 'stats'; stats: WorkerStats; metrics: FamilySnapshot[] };
+
+export type MainToWorker =
+  | { op: 'wake' }
+  | { op: 'validation'; id: number; data: SymbolInfo }
+  | { op: 'health'; id: number; data: Record<string, unknown> }
+  | { op: 'metrics'; id: number; data: string };
+
+export interface FanoutHandlers extends BusServerHandlers {
+  health(): Record<string, unknown>;
+  metrics(): string;
+}
+
+interface FanoutWorker {
+  index: number;
+  worker: Worker;
+  ring: SharedRing;
+  symbols: Set<string>;
+  // Symbols that lost an event to a full ring - resynced before their next one
+  stale: Set<string>;
+  stats: WorkerStats;
+  metrics: FamilySnapshot[];   // As of the worker's last stats report
+}
+
+/**
+ * Main-thread side of the fan-out workers
+ *
+ * Works like BusServer, one level down: each worker says which symbols its
+ * clients watch, the upstream subscription lives while any worker wants
+ * it, and publish() encodes an event once and copies it into the ring of
+ * every worker that wants its symbol. A full ring drops the event for that
+ * worker only; the symbol's book is re-sent as a snapshot ahead of its next
+ * event so delta clients never apply across the gap.
+ */
+export class FanoutPool {
+  private workers: FanoutWorker[] = [];
+  private interest: Map<string, Set<FanoutWorker>> = new Map();
+  private subscribed: Map<string, Promise<void>> = new Map();
+  private stopping = false;
+
+  constructor(
+    private script: string,
+    private count: number,
+    private ringBytes: number,
+    private handlers: FanoutHandlers
+  ) {}
+
+  /**
+   * Spawn every worker on the port, or without reusePort worker 0 first and
+   * the rest on its listening socket
+   */
+  start(port: number): void {
+    if (REUSE_PORT) {
+      for (let i = 0; i < this.count; i++) this.spawn(i, port, null);
+      console.log(`[Fanout] ${this.count} workers accepting on port ${port} (reusePort)`);
+      return;
+    }
+    const first = this.spawn(0, port, null);
+    first.worker.once('message', (message: WorkerToMain) => {
+      if (message.op !== 'listening') return;
+      for (let i = 1; i < this.count; i++) this.spawn(i, port, message.fd);
+      console.log(`[Fanout] ${this.count} workers accepting on port ${port}`);
+    });
+  }
+
+  publish(event: BusEvent): void {
+    const symbol = event.data.symbol.toUpperCase();
+    const targets = this.interest.get(symbol);
+    if (!targets || targets.size === 0) return;
+
+    const record = encodeEvent(event);
+    for (const target of targets) {
+      if (target.stale.has(symbol) && !this.resync(target, symbol)) continue;
+      if (!this.push(target, record)) target.stale.add(symbol);
+    }
+  }
+
+  getWorkerStats(): Record<string, unknown>[] {
+    return this.workers.map(w => ({
+      index: w.index,
+      ...w.stats,
+      symbols: Array.from(w.symbols),
+      ringBytes: w.ring.capacity,
+      ringUsed: w.ring.usedBytes(),
+      dropped: w.ring.dropped(),
+    }));
+  }
+
+  metricsSnapshots(): FamilySnapshot[][] {
+    return this.workers.map(w => w.metrics);
+  }
+
+  totals(): WorkerStats {
+    return this.workers.reduce(
+      (sum, w) => ({ clients: sum.clients + w.stats.clients, slowClients: sum.slowClients + w.stats.slowClients }),
+      { clients: 0, slowClients: 0 }
+    );
+  }
+
+  async close(): Promise<void> {
+    this.stopping = true;
+    await Promise.all(this.workers.map(w => w.worker.terminate()));
+  }
+
+  private spawn(index: number, port: number, listenFd: number | null): FanoutWorker {
+    const ring = SharedRing.create(this.ringBytes);
+    const workerData: FanoutWorkerData = { index, ring: ring.buffer, port, reusePort: REUSE_PORT, listenFd };
+    const worker = new Worker(this.script, { workerData });
+    const state: FanoutWorker = {
+      index,
+      worker,
+      ring,
+      symbols: new Set(),
+      stale: new Set(),
+      stats: { clients: 0, slowClients: 0 },
+      metrics: [],
+    };
+    this.workers[index] = state;
+
+    worker.on('message', (message: WorkerToMain) => this.handle(state, message));
+    worker.on('error', (error) => console.error(`[Fanout] Worker ${index} error:`, error));
+    worker.on('exit', (code) => {
+      if (this.stopping) return;
+      if (!REUSE_PORT) {
+        // The listening socket is shared and closed with it - let the
+        // supervisor restart the whole process
+        console.error(`[Fanout] Worker ${index} exited (${code}) - shutting down`);
+        process.exit(1);
+      }
+      // Its clients went with it and reconnect to the others; a fresh worker takes its place
+      console.error(`[Fanout] Worker ${index} exited (${code}) - restarting`);
+      this.retire(state);
+      setTimeout(() => {
+        if (!this.stopping) this.spawn(index, port, null);
+      }, RESPAWN_DELAY_MS);
+    });
+    return state;
+  }
+
+  /**
+   * Drop a dead worker's interest, so symbols only it watched are unsubscribed
+   */
+  private retire(state: FanoutWorker): void {
+    for (const symbol of Array.from(state.symbols)) this.removeInterest(symbol, state);
+    state.stats = { clients: 0, slowClients: 0 };
+    state.metrics = [];
+  }
+
+  private handle(state: FanoutWorker, message: WorkerToMain): void {
+    switch (message.op) {
+      case 'sub':
+        this.addInterest(message.symbol.toUpperCase(), state);
+        break;
+      case 'unsub':
+        this.removeInterest(message.symbol.toUpperCase(), state);
+        break;
+      case 'validate':
+        this.handlers.validate(message.symbol)
+          .catch((error: Error): SymbolInfo => ({
+            symbol: message.symbol.toUpperCase(),
+            name: message.symbol.toUpperCase(),
+            assetType: 'crypto',
+            valid: false,
+            error: error.message || 'Validation failed',
+          }))
+          .then(data => this.post(state, { op: 'validation', id: message.id, data }));
+        break;
+      case 'health':
+        this.post(state, { op: 'health', id: message.id, data: this.handlers.health() });
+        break;
+      case 'metrics':
+        this.post(state, { op: 'metrics', id: message.id, data: this.handlers.metrics() });
+        break;
+      case 'stats':
+        state.stats = message.stats;
+        state.metrics = message.metrics;
+        break;
+    }
+  }
+
+  private push(target: FanoutWorker, record: Uint8Array): boolean {
+    const { ok, wake } = target.ring.push(record);
+    if (wake) this.post(target, { op: 'wake' });
+    return ok;
+  }
+
+  /**
+   * Put a symbol's current book and ticker into a worker's ring ahead of anything newer
+   */
+  private resync(target: FanoutWorker, symbol: string): boolean {
+    const { snapshot, orderBook, ticker } = this.handlers.currentState(symbol);
+    if (snapshot && !this.push(target, encodeEvent({ kind: 'delta', data: snapshot }))) return false;
+    if (orderBook && !this.push(target, encodeEvent({ kind: 'orderbook', data: orderBook }))) return false;
+    if (ticker && !this.push(target, encodeEvent({ kind: 'ticker', data: ticker }))) return false;
+    target.stale.delete(symbol);
+    return true;
+  }
+
+  private post(target: FanoutWorker, message: MainToWorker): void {
+    target.worker.postMessage(message);
+  }
+
+  private addInterest(symbol: string, state: FanoutWorker): void {
+    if (state.symbols.has(symbol)) return;
+    state.symbols.add(symbol);
+
+    let targets = this.interest.get(symbol);
+    if (!targets) {
+      targets = new Set();
+      this.interest.set(symbol, targets);
+      this.subscribed.set(symbol, this.handlers.subscribe(symbol));
+    }
+    targets.add(state);
+
+    // Same as a late edge: the worker's clients get the live book right away,
+    // and the recent trades once the upstream subscribe is done (a full ring
+    // just loses them - the worker stops waiting after a while)
+    state.stale.add(symbol);
+    this.resync(state, symbol);
+    this.subscribed.get(symbol)?.then(() => {
+      if (!state.symbols.has(symbol) || this.stopping) return;
+      this.push(state, encodeEvent({ kind: 'history', data: { symbol, trades: this.handlers.recentTrades(symbol) } }));
+    });
+  }
+
+  private removeInterest(symbol: string, state: FanoutWorker): void {
+    state.symbols.delete(symbol);
+    state.stale.delete(symbol);
+    const targets = this.interest.get(symbol);
+    if (!targets) return;
+    targets.delete(state);
+    if (targets.size === 0) {
+      this.interest.delete(symbol);
+      this.subscribed.delete(symbol);
+      this.handlers.unsubscribe(symbol);
+    }
+  }
+}
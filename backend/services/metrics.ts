@@ -0,0 +1,262 @@
+// Metrics - hot-path counters, gauges and histograms, rendered as Prometheus text for /metrics
+
+import { monitorEventLoopDelay } from 'perf_hooks';
+
+export type MetricType = 'counter' | 'gauge' | 'histogram';
+
+// Seconds - 50us to 10s, wide enough to tell a parse from a GC pause from a network stall
+export const LATENCY_BUCKETS = [
+  0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10,
+];
+
+export interface HistogramData {
+  counts: number[];     // Per bucket, not cumulative - the last one is +Inf
+  sum: number;
+  count: number;
+}
+
+/**
+ * One metric family as plain data - what a fan-out worker posts to the main
+ * thread, and what the text format is rendered from
+ */
+export interface FamilySnapshot {
+  name: string;
+  help: string;
+  type: MetricType;
+  label: string | null;
+  buckets?: number[];
+  series: [string, number | HistogramData][];   // Label value ('' if unlabelled) -> value
+}
+
+/**
+ * A named family with at most one label
+ *
+ * One label keeps every hot-path update to a single Map lookup on a string
+ * the caller already has (a symbol, a stage name), with nothing built per
+ * call. Families that need a second dimension are split by name instead.
+ */
+abstract class Family<T> {
+  protected series: Map<string, T> = new Map();
+
+  constructor(readonly name: string, readonly help: string, readonly label: string | null) {}
+
+  abstract readonly type: MetricType;
+
+  remove(labelValue: string): void {
+    this.series.delete(labelValue);
+  }
+
+  clear(): void {
+    this.series.clear();
+  }
+
+  abstract snapshot(): FamilySnapshot;
+}
+
+export class Counter extends Family<number> {
+  readonly type = 'counter';
+
+  inc(labelValue = '', by = 1): void {
+    this.series.set(labelValue, (this.series.get(labelValue) ?? 0) + by);
+  }
+
+  snapshot(): FamilySnapshot {
+    return { name: this.name, help: this.help, type: this.type, label: this.label, series: Array.from(this.series) };
+  }
+}
+
+export class Gauge extends Family<number> {
+  readonly type = 'gauge';
+
+  set(value: number, labelValue = ''): void {
+    this.series.set(labelValue, value);
+  }
+
+  snapshot(): FamilySnapshot {
+    return { name: this.name, help: this.help, type: this.type, label: this.label, series: Array.from(this.series) };
+  }
+}
+
+export class Histogram extends Family<HistogramData> {
+  readonly type = 'histogram';
+
+  constructor(name: string, help: string, label: string | null, readonly buckets: number[] = LATENCY_BUCKETS) {
+    super(name, help, label);
+  }
+
+  observe(value: number, labelValue = ''): void {
+    let data = this.series.get(labelValue);
+    if (!data) {
+      data = { counts: new Array(this.buckets.length + 1).fill(0), sum: 0, count: 0 };
+      this.series.set(labelValue, data);
+    }
+    let i = 0;
+    while (i < this.buckets.length && value > this.buckets[i]) i++;
+    data.counts[i]++;
+    data.sum += value;
+    data.count++;
+  }
+
+  snapshot(): FamilySnapshot {
+    const series: [string, HistogramData][] = Array.from(this.series, ([label, data]) => [
+      label,
+      { counts: data.counts.slice(), sum: data.sum, count: data.count },
+    ]);
+    return { name: this.name, help: this.help, type: this.type, label: this.label, buckets: this.buckets, series };
+  }
+}
+
+/**
+ * Every metric this thread keeps
+ *
+ * Collectors run just before a snapshot, for values that are cheaper to
+ * read at scrape time than to keep current (queue depths, loop delay).
+ */
+export class MetricsRegistry {
+  private families: Map<string, Family<any>> = new Map();
+  private collectors: (() => void)[] = [];
+
+  counter(name: string, help: string, label: string | null = null): Counter {
+    return this.register(new Counter(name, help, label));
+  }
+
+  gauge(name: string, help: string, label: string | null = null): Gauge {
+    return this.register(new Gauge(name, help, label));
+  }
+
+  histogram(name: string, help: string, label: string | null = null, buckets?: number[]): Histogram {
+    return this.register(new Histogram(name, help, label, buckets));
+  }
+
+  onCollect(collector: () => void): void {
+    this.collectors.push(collector);
+  }
+
+  snapshot(): FamilySnapshot[] {
+    for (const collect of this.collectors) {
+      try {
+        collect();
+      } catch (error) {
+        console.error('[Metrics] Collector failed:', (error as Error).message);
+      }
+    }
+    return Array.from(this.families.values(), family => family.snapshot());
+  }
+
+  private register<F extends Family<any>>(family: F): F {
+    if (this.families.has(family.name)) throw new Error(`Metric ${family.name} registered twice`);
+    this.families.set(family.name, family);
+    return family;
+  }
+}
+
+/**
+ * Combine snapshots from several threads into one set of families
+ *
+ * Counters and histograms with the same label value are summed (every
+ * worker's broadcast timings end up in one histogram); for gauges the later
+ * snapshot wins, so gauges that differ per thread carry it in their label.
+ */
+export function mergeSnapshots(snapshots: FamilySnapshot[][]): FamilySnapshot[] {
+  const merged: Map<string, FamilySnapshot> = new Map();
+
+  for (const families of snapshots) {
+    for (const family of families) {
+      const into = merged.get(family.name);
+      if (!into) {
+        const series = family.series.map(([label, value]): [string, number | HistogramData] => [label, copyValue(value)]);
+        merged.set(family.name, { ...family, series });
+        continue;
+      }
+      for (const [label, value] of family.series) {
+        const existing = into.series.find(([l]) => l === label);
+        if (!existing || family.type === 'gauge') {
+          if (existing) existing[1] = value;
+          else into.series.push([label, copyValue(value)]);
+        } else if (typeof value === 'number') {
+          existing[1] = (existing[1] as number) + value;
+        } else {
+          const sum = existing[1] as HistogramData;
+          value.counts.forEach((n, i) => (sum.counts[i] += n));
+          sum.sum += value.sum;
+          sum.count += value.count;
+        }
+      }
+    }
+  }
+  return Array.from(merged.values());
+}
+
+function copyValue(value: number | HistogramData): number | HistogramData {
+  return typeof value === 'number' ? value : { counts: value.counts.slice(), sum: value.sum, count: value.count };
+}
+
+/**
+ * Prometheus text exposition format (version 0.0.4)
+ */
+export function renderPrometheus(families: FamilySnapshot[]): string {
+  const lines: string[] = [];
+
+  for (const family of families) {
+    if (family.series.length === 0) continue;
+    lines.push(`# HELP ${family.name} ${family.help}`);
+    lines.push(`# TYPE ${family.name} ${family.type}`);
+
+    for (const [labelValue, value] of family.series) {
+      const label = family.label ? `${family.label}="${escapeLabel(labelValue)}"` : '';
+      if (typeof value === 'number') {
+        lines.push(`${family.name}${label ? `{${label}}` : ''} ${formatNumber(value)}`);
+        continue;
+      }
+
+      const prefix = label ? `${label},` : '';
+      let cumulative = 0;
+      (family.buckets ?? []).forEach((bound, i) => {
+        cumulative += value.counts[i];
+        lines.push(`${family.name}_bucket{${prefix}le="${bound}"} ${cumulative}`);
+      });
+      lines.push(`${family.name}_bucket{${prefix}le="+Inf"} ${value.count}`);
+      lines.push(`${family.name}_sum${label ? `{${label}}` : ''} ${formatNumber(value.sum)}`);
+      lines.push(`${family.name}_count${label ? `{${label}}` : ''} ${value.count}`);
+    }
+  }
+  return lines.join('\n') + '\n';
+}
+
+function escapeLabel(value: string): string {
+  return value.replace(/\\/g, '\\\\').replace(/"/g, '\\"').replace(/\n/g, '\\n');
+}
+
+function formatNumber(value: number): string {
+  if (Number.isNaN(value)) return 'NaN';
+  if (!Number.isFinite(value)) return value > 0 ? '+Inf' : '-Inf';
+  return String(value);
+}
+
+// One registry per thread - each fan-out worker has its own module instance
+export const metrics = new MetricsRegistry();
+
+/**
+ * Sample this thread's event-loop delay into gauges labelled with threadName
+ *
+ * The percentiles cover the time since the previous collection (a scrape,
+ * or a worker's once-a-second report), so they show current lag rather
+ * than the worst moment since startup.
+ */
+export function trackEventLoopLag(threadName: string): void {
+  const delay = monitorEventLoopDelay({ resolution: 10 });
+  delay.enable();
+
+  const p50 = metrics.gauge('tapeflow_event_loop_lag_p50_seconds', 'Event loop delay, median since the last collection', 'thread');
+  const p99 = metrics.gauge('tapeflow_event_loop_lag_p99_seconds', 'Event loop delay, 99th percentile since the last collection', 'thread');
+  const max = metrics.gauge('tapeflow_event_loop_lag_max_seconds', 'Event loop delay, worst since the last collection', 'thread');
+
+  metrics.onCollect(() => {
+    // The histogram is in nanoseconds
+    if (delay.count === 0) return;
+    p50.set(delay.percentile(50) / 1e9, threadName);
+    p99.set(delay.percentile(99) / 1e9, threadName);
+    max.set(delay.max / 1e9, threadName);
+    delay.reset();
+  });
+}
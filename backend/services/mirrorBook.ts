@@ -0,0 +1,76 @@
+// Mirror book - a local copy of someone else's book, kept current from their delta stream
+
+import { OrderBook, OrderBookDelta } from '../types';
+import { LocalOrderBook } from './orderBookEngine';
+
+/**
+ * Book rebuilt from OrderBookDelta messages rather than from an exchange
+ *
+ * For adapters that re-emit a stream we already normalised (a replay file,
+ * another node on the bus): a snapshot delta replaces the book, later
+ * deltas are applied level by level, and until the first snapshot the book
+ * is not synced and hands out nothing.
+ */
+export class MirrorBook {
+  readonly book: LocalOrderBook;
+  synced = false;
+  seq = 0;
+
+  constructor(readonly symbol: string) {
+    this.book = new LocalOrderBook(symbol);
+  }
+
+  apply(delta: OrderBookDelta): void {
+    if (delta.snapshot) {
+      this.book.applySnapshot(delta.bids, delta.asks, delta.seq);
+      this.synced = true;
+    } else if (this.synced) {
+      for (const [price, size] of delta.bids) this.book.applyLevel('bid', price, size);
+      for (const [price, size] of delta.asks) this.book.applyLevel('ask', price, size);
+      this.book.trim();
+    }
+    this.seq = delta.seq;
+  }
+
+  reset(): void {
+    this.book.clear();
+    this.synced = false;
+    this.seq = 0;
+  }
+
+  /**
+   * Top-N OrderBook, or null until synced
+   */
+  orderBook(depth: number): OrderBook | null {
+    if (!this.synced) return null;
+    const bestBid = this.book.bestBid();
+    const spread = this.book.bestAsk() - bestBid;
+    return {
+      symbol: this.symbol,
+      assetType: 'crypto',
+      timestamp: Date.now(),
+      bids: this.book.topBids(depth),
+      asks: this.book.topAsks(depth),
+      spread,
+      spreadPercent: bestBid > 0 ? (spread / bestBid) * 100 : 0,
+      seq: this.seq,
+    };
+  }
+
+  /**
+   * Full replacement state for a delta client, or null until synced
+   */
+  snapshot(depth: number): OrderBookDelta | null {
+    if (!this.synced) return null;
+    return {
+      symbol: this.symbol,
+      assetType: 'crypto',
+      timestamp: Date.now(),
+      seq: this.seq,
+      prevSeq: 0,
+      bids: this.book.topBidPairs(depth),
+      asks: this.book.topAskPairs(depth),
+      snapshot: true,
+    };
+  }
+}
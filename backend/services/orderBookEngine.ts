@@ -0,0 +1,190 @@
+// Local order book - sorted price levels kept current from exchange diffs
+
+import { OrderBookLevel } from '../types';
+
+export type BookSide = 'bid' | 'ask';
+
+/**
+ * One side of the book as two parallel sorted arrays
+ *
+ * Bids are kept high-to-low and asks low-to-high, so index 0 is always the
+ * best price. Lookups are a binary search; inserts/removes splice, which for
+ * a few thousand levels is a memmove and much cheaper than a tree's pointer
+ * chasing. Most updates hit existing levels near the top anyway.
+ */
+class BookSideLevels {
+  prices: number[] = [];
+  sizes: number[] = [];
+
+  constructor(private descending: boolean) {}
+
+  /**
+   * Index of price if present, otherwise -(insertionPoint + 1)
+   */
+  private search(price: number): number {
+    let lo = 0;
+    let hi = this.prices.length - 1;
+    while (lo <= hi) {
+      const mid = (lo + hi) >>> 1;
+      const p = this.prices[mid];
+      if (p === price) return mid;
+      const before = this.descending ? p > price : p < price;
+      if (before) lo = mid + 1;
+      else hi = mid - 1;
+    }
+    return -(lo + 1);
+  }
+
+  /**
+   * Set (or remove, if size is 0) a level. Returns the level's index before
+   * the change, or -1 if nothing changed.
+   */
+  set(price: number, size: number): number {
+    const i = this.search(price);
+    if (i >= 0) {
+      if (size === 0) {
+        this.prices.splice(i, 1);
+        this.sizes.splice(i, 1);
+        return i;
+      }
+      if (this.sizes[i] === size) return -1;
+      this.sizes[i] = size;
+      return i;
+    }
+    if (size === 0) return -1;
+    const at = -(i + 1);
+    this.prices.splice(at, 0, price);
+    this.sizes.splice(at, 0, size);
+    return at;
+  }
+
+  /**
+   * Size resting at price, 0 if there's no level
+   */
+  sizeAt(price: number): number {
+    const i = this.search(price);
+    return i >= 0 ? this.sizes[i] : 0;
+  }
+
+  get length(): number {
+    return this.prices.length;
+  }
+
+  /**
+   * Drop levels past maxLevels from the far end of the book, adding each
+   * one to removed (size 0) when given
+   */
+  trim(maxLevels: number, removed?: [number, number][]): void {
+    if (this.prices.length > maxLevels) {
+      if (removed) {
+        for (let i = maxLevels; i < this.prices.length; i++) removed.push([this.prices[i], 0]);
+      }
+      this.prices.length = maxLevels;
+      this.sizes.length = maxLevels;
+    }
+  }
+
+  top(n: number): OrderBookLevel[] {
+    const count = Math.min(n, this.prices.length);
+    const levels: OrderBookLevel[] = new Array(count);
+    for (let i = 0; i < count; i++) {
+      levels[i] = { price: this.prices[i], size: this.sizes[i] };
+    }
+    return levels;
+  }
+
+  topPairs(n: number): [number, number][] {
+    const count = Math.min(n, this.prices.length);
+    const levels: [number, number][] = new Array(count);
+    for (let i = 0; i < count; i++) {
+      levels[i] = [this.prices[i], this.sizes[i]];
+    }
+    return levels;
+  }
+
+  clear(): void {
+    this.prices = [];
+    this.sizes = [];
+  }
+}
+
+// Levels kept per side - Binance's REST snapshot depth, so past this the book
+// would only hold levels the diff stream happened to touch
+export const MAX_BOOK_LEVELS = 1000;
+
+/**
+ * Full-depth order book for one symbol
+ *
+ * Seeded from a REST snapshot, then each diff event is applied level by level.
+ * The engine only tracks state - sequencing rules are exchange-specific and
+ * live in the adapter.
+ */
+export class LocalOrderBook {
+  readonly bids = new BookSideLevels(true);
+  readonly asks = new BookSideLevels(false);
+  lastUpdateId = 0;
+
+  constructor(readonly symbol: string, private maxLevels: number = MAX_BOOK_LEVELS) {}
+
+  applySnapshot(bids: [number, number][], asks: [number, number][], lastUpdateId: number): void {
+    this.bids.clear();
+    this.asks.clear();
+    for (const [price, size] of bids) this.bids.set(price, size);
+    for (const [price, size] of asks) this.asks.set(price, size);
+    this.lastUpdateId = lastUpdateId;
+  }
+
+  /**
+   * Apply one level change. Returns the pre-change index of the level
+   * (0 = best price) or -1 if the update was a no-op.
+   */
+  applyLevel(side: BookSide, price: number, size: number): number {
+    return side === 'bid' ? this.bids.set(price, size) : this.asks.set(price, size);
+  }
+
+  /**
+   * Keep memory bounded - far-from-mid levels aren't useful and Binance
+   * never tells us when they'd expire
+   * 
+   * Adapters pass the delta they're building so the trimmed levels go out
+   * as removals; a client mirroring the book would otherwise keep them.
+   */
+  trim(removedBids?: [number, number][], removedAsks?: [number, number][]): void {
+    this.bids.trim(this.maxLevels, removedBids);
+    this.asks.trim(this.maxLevels, removedAsks);
+  }
+
+  sizeAt(side: BookSide, price: number): number {
+    return side === 'bid' ? this.bids.sizeAt(price) : this.asks.sizeAt(price);
+  }
+
+  bestBid(): number {
+    return this.bids.prices[0] ?? 0;
+  }
+
+  bestAsk(): number {
+    return this.asks.prices[0] ?? 0;
+  }
+
+  topBids(n: number): OrderBookLevel[] {
+    return this.bids.top(n);
+  }
+
+  topAsks(n: number): OrderBookLevel[] {
+    return this.asks.top(n);
+  }
+
+  topBidPairs(n: number): [number, number][] {
+    return this.bids.topPairs(n);
+  }
+
+  topAskPairs(n: number): [number, number][] {
+    return this.asks.topPairs(n);
+  }
+
+  clear(): void {
+    this.bids.clear();
+    this.asks.clear();
+    this.lastUpdateId = 0;
+  }
+}
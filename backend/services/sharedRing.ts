@@ -0,0 +1,187 @@
+// Shared ring - single-producer/single-consumer byte queue over a SharedArrayBuffer, plus the event codec it carries
+
+import { BusEvent } from './bus';
+import { Trade, TradeSide } from '../types';
+
+/*
+ * Layout
+ *
+ *   Int32 control[4]   head (next write), tail (next read), idle flag, dropped count
+ *   u8 data[capacity]  records: u32 length, then length bytes
+ *
+ * Records never straddle the end: a producer that can't fit one before the
+ * end writes a WRAP marker (or leaves < 4 bytes, which means the same) and
+ * starts again at 0. head == tail is empty, and the producer always leaves
+ * at least one byte free so full never looks like empty. head and tail are
+ * only ever written by their own side, with Atomics.store after the bytes,
+ * so the other side never sees a half-written record.
+ *
+ * The idle flag is the doorbell: the consumer sets it once it has drained
+ * the ring and the producer clears it (and pokes the consumer) on the next
+ * push, so a busy ring costs no messages at all.
+ */
+
+const HEAD = 0;
+const TAIL = 1;
+const IDLE = 2;
+const DROPPED = 3;
+const CONTROL_BYTES = 16;
+const LENGTH_BYTES = 4;
+const WRAP = 0xffffffff;
+
+export class SharedRing {
+  readonly buffer: SharedArrayBuffer;
+  readonly capacity: number;
+  private control: Int32Array;
+  private data: Uint8Array;
+  private view: DataView;
+
+  static create(capacity: number): SharedRing {
+    const ring = new SharedRing(new SharedArrayBuffer(CONTROL_BYTES + capacity));
+    Atomics.store(ring.control, IDLE, 1);
+    return ring;
+  }
+
+  constructor(buffer: SharedArrayBuffer) {
+    this.buffer = buffer;
+    this.capacity = buffer.byteLength - CONTROL_BYTES;
+    this.control = new Int32Array(buffer, 0, CONTROL_BYTES / 4);
+    this.data = new Uint8Array(buffer, CONTROL_BYTES, this.capacity);
+    this.view = new DataView(buffer, CONTROL_BYTES, this.capacity);
+  }
+
+  /**
+   * Producer: append a record
+   *
+   * ok is false (and the drop counted) if it won't fit; wake is set when
+   * the consumer was idle and needs a poke.
+   */
+  push(record: Uint8Array): { ok: boolean; wake: boolean } {
+    const head = Atomics.load(this.control, HEAD);
+    const tail = Atomics.load(this.control, TAIL);
+    const need = LENGTH_BYTES + record.length;
+    const untilEnd = this.capacity - head;
+    const waste = untilEnd < need ? untilEnd : 0;
+    const used = head >= tail ? head - tail : this.capacity - tail + head;
+
+    if (used + waste + need >= this.capacity) {
+      Atomics.add(this.control, DROPPED, 1);
+      return { ok: false, wake: false };
+    }
+
+    let at = head;
+    if (waste > 0) {
+      if (untilEnd >= LENGTH_BYTES) this.view.setUint32(head, WRAP, true);
+      at = 0;
+    }
+    this.view.setUint32(at, record.length, true);
+    this.data.set(record, at + LENGTH_BYTES);
+    Atomics.store(this.control, HEAD, (at + need) % this.capacity);
+
+    return { ok: true, wake: Atomics.compareExchange(this.control, IDLE, 1, 0) === 1 };
+  }
+
+  /**
+   * Consumer: take the oldest record (copied out), or null if empty
+   */
+  pop(): Buffer | null {
+    const head = Atomics.load(this.control, HEAD);
+    let tail = Atomics.load(this.control, TAIL);
+    if (tail === head) return null;
+
+    if (this.capacity - tail < LENGTH_BYTES || this.view.getUint32(tail, true) === WRAP) tail = 0;
+    const length = this.view.getUint32(tail, true);
+    const start = tail + LENGTH_BYTES;
+    const record = Buffer.from(this.data.subarray(start, start + length));
+    Atomics.store(this.control, TAIL, (start + length) % this.capacity);
+    return record;
+  }
+
+  /**
+   * Consumer: mark ourselves idle - false if a record slipped in meanwhile
+   */
+  sleep(): boolean {
+    Atomics.store(this.control, IDLE, 1);
+    if (Atomics.load(this.control, HEAD) !== Atomics.load(this.control, TAIL)) {
+      Atomics.store(this.control, IDLE, 0);
+      return false;
+    }
+    return true;
+  }
+
+  usedBytes(): number {
+    const head = Atomics.load(this.control, HEAD);
+    const tail = Atomics.load(this.control, TAIL);
+    return head >= tail ? head - tail : this.capacity - tail + head;
+  }
+
+  dropped(): number {
+    return Atomics.load(this.control, DROPPED);
+  }
+}
+
+// Record types - trades are packed by hand since they're most of the traffic,
+// everything else is rare enough that JSON is fine
+const RECORD_TRADE = 1;
+const RECORD_JSON = 2;
+
+const SIDES: TradeSide[] = ['buy', 'sell', 'neutral'];
+
+/**
+ * BusEvent -> ring record
+ *
+ * Trade: u8 type, f64 timestamp, f64 price, f64 volume, u8 side, then
+ * symbol, id and exchange as u8 length + utf8.
+ */
+export function encodeEvent(event: BusEvent): Buffer {
+  if (event.kind !== 'trade') {
+    const json = JSON.stringify(event);
+    const out = Buffer.allocUnsafe(1 + Buffer.byteLength(json));
+    out[0] = RECORD_JSON;
+    out.write(json, 1);
+    return out;
+  }
+
+  const trade = event.data;
+  const exchange = trade.exchange ?? '';
+  const size = 1 + 24 + 1 + 3 + Buffer.byteLength(trade.symbol) + Buffer.byteLength(trade.id) + Buffer.byteLength(exchange);
+  const out = Buffer.allocUnsafe(size);
+  out[0] = RECORD_TRADE;
+  out.writeDoubleLE(trade.timestamp, 1);
+  out.writeDoubleLE(trade.price, 9);
+  out.writeDoubleLE(trade.volume, 17);
+  out[25] = Math.max(0, SIDES.indexOf(trade.side));
+  let offset = 26;
+  for (const text of [trade.symbol, trade.id, exchange]) {
+    const length = out.write(text, offset + 1);
+    out[offset] = length;
+    offset += 1 + length;
+  }
+  return out;
+}
+
+/**
+ * Ring record -> BusEvent
+ */
+export function decodeEvent(record: Buffer): BusEvent {
+  if (record[0] === RECORD_JSON) return JSON.parse(record.toString('utf8', 1));
+
+  const strings: string[] = [];
+  let offset = 26;
+  for (let i = 0; i < 3; i++) {
+    const length = record[offset];
+    strings.push(record.toString('utf8', offset + 1, offset + 1 + length));
+    offset += 1 + length;
+  }
+  const trade: Trade = {
+    id: strings[1],
+    symbol: strings[0],
+    assetType: 'crypto',
+    timestamp: record.readDoubleLE(1),
+    price: record.readDoubleLE(9),
+    volume: record.readDoubleLE(17),
+    side: SIDES[record[25]] ?? 'neutral',
+  };
+  if (strings[2]) trade.exchange = strings[2];
+  return { kind: 'trade', data: trade };
+}
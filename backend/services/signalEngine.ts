@@ -0,0 +1,334 @@
+// Signal engine - whale, velocity, wall and spoof detection, run once per symbol on adapter events
+
+import { Trade, OrderBook, OrderBookDelta, OrderBookLevel, Signal } from '../types';
+
+// Whale prints and spoofed size are judged in USD; BTC-priced symbols need more
+const WHALE_MIN_USD = 50_000;
+const WHALE_MIN_USD_HIGH = 250_000;
+const SPOOF_MIN_USD = 50_000;
+const SPOOF_MIN_USD_HIGH = 300_000;
+const HIGH_PRICE = 50_000;
+
+// Velocity: trades in the last second vs the trailing average
+const VELOCITY_HISTORY_SECONDS = 10;
+const VELOCITY_MIN_SAMPLES = 3;
+const VELOCITY_MIN_AVG = 5;           // trades/sec - below this a "surge" is noise
+const VELOCITY_SPIKE = 3;             // +300% over the average
+
+// Walls: resting size this many times the average top-of-book level
+const WALL_MULTIPLIER = 5;
+const WALL_MIN_USD = 150_000;
+
+// Spoofs: a large level (3x average) that loses 70%+ of its size without
+// at least 10% of the drop trading at that price
+const SPOOF_MULTIPLIER = 3;
+const SPOOF_REMAINING = 0.3;
+const SPOOF_FILL_SHARE = 0.1;
+const FILL_WINDOW_MS = 2000;
+// Trades and depth come down separate streams, so a fill can land just after
+// the depth update that removed the level - wait this long before calling it
+const FILL_GRACE_MS = 250;
+
+/**
+ * Smallest print that counts as a whale at this price - also the 'whale'
+ * preset for client trade filters (services/tradeFilter.ts)
+ */
+export function whaleMinFor(price: number): number {
+  return price >= HIGH_PRICE ? WHALE_MIN_USD_HIGH : WHALE_MIN_USD;
+}
+
+interface RecentFill {
+  volume: number;
+  timestamp: number;
+}
+
+/**
+ * Everything the detectors remember about one symbol
+ *
+ * bidLevels / askLevels hold only the large levels inside the top-of-book
+ * window (price -> size), so a delta touching any other level is one Map
+ * miss. The window and averages are refreshed from each top-N snapshot.
+ */
+interface SymbolState {
+  lastSecond: number;
+  secondCount: number;
+  history: number[];
+  historySum: number;
+  fills: Map<number, RecentFill>;
+  avgBidSize: number;
+  avgAskSize: number;
+  bidEdge: number;          // Worst bid / ask in the last snapshot
+  askEdge: number;
+  bidLevels: Map<number, number>;
+  askLevels: Map<number, number>;
+  bidWalls: Set<number>;
+  askWalls: Set<number>;
+  spoofTimers: Set<NodeJS.Timeout>;
+}
+
+function createState(): SymbolState {
+  return {
+    lastSecond: 0,
+    secondCount: 0,
+    history: [],
+    historySum: 0,
+    fills: new Map(),
+    avgBidSize: 0,
+    avgAskSize: 0,
+    bidEdge: 0,
+    askEdge: 0,
+    bidLevels: new Map(),
+    askLevels: new Map(),
+    bidWalls: new Set(),
+    askWalls: new Set(),
+    spoofTimers: new Set(),
+  };
+}
+
+function averageSize(levels: OrderBookLevel[]): number {
+  if (levels.length === 0) return 0;
+  let sum = 0;
+  for (const level of levels) sum += level.size;
+  return sum / levels.length;
+}
+
+/**
+ * Server-side trading signal detection
+ *
+ * The adapter's events drive everything: trades feed whale and velocity
+ * detection plus the per-price fill record, top-N book snapshots drive wall
+ * detection, and book deltas are checked level by level for pulled size.
+ * Every dashboard watching a symbol gets the same signals from one pass,
+ * and a spoof is seen on the delta that removed it rather than on
+ * whichever poll happened to land afterwards.
+ */
+export class SignalEngine {
+  private symbols: Map<string, SymbolState> = new Map();
+  private onSignal: (signal: Signal) => void;
+
+  constructor(onSignal: (signal: Signal) => void) {
+    this.onSignal = onSignal;
+  }
+
+  private getState(symbol: string): SymbolState {
+    let state = this.symbols.get(symbol);
+    if (!state) {
+      state = createState();
+      this.symbols.set(symbol, state);
+    }
+    return state;
+  }
+
+  handleTrade(trade: Trade): void {
+    const symbol = trade.symbol.toUpperCase();
+    const state = this.getState(symbol);
+    const now = Date.now();
+
+    this.countVelocity(symbol, state, now);
+
+    // Remember what traded where, so pulled size can be told apart from filled size
+    const fill = state.fills.get(trade.price);
+    if (fill && now - fill.timestamp <= FILL_WINDOW_MS) {
+      fill.volume += trade.volume;
+      fill.timestamp = now;
+    } else {
+      state.fills.set(trade.price, { volume: trade.volume, timestamp: now });
+    }
+
+    const value = trade.price * trade.volume;
+    if (value >= whaleMinFor(trade.price) && trade.side !== 'neutral') {
+      this.onSignal({ type: 'whale', symbol, timestamp: now, value, side: trade.side, price: trade.price });
+    }
+  }
+
+  /**
+   * Count a trade into the current second, closing out finished seconds first
+   */
+  private countVelocity(symbol: string, state: SymbolState, now: number): void {
+    const second = Math.floor(now / 1000);
+    if (state.lastSecond === 0) state.lastSecond = second;
+
+    if (second > state.lastSecond) {
+      const count = state.secondCount;
+      const history = state.history;
+
+      if (history.length >= VELOCITY_MIN_SAMPLES) {
+        const avg = state.historySum / history.length;
+        if (avg > VELOCITY_MIN_AVG && count > avg * (1 + VELOCITY_SPIKE)) {
+          this.onSignal({ type: 'velocity', symbol, timestamp: now, value: count, ratio: count / avg });
+        }
+      }
+
+      // Seconds with no trades at all count as zeros
+      const idle = Math.min(second - state.lastSecond - 1, VELOCITY_HISTORY_SECONDS);
+      for (let i = -1; i < idle; i++) {
+        const sample = i < 0 ? count : 0;
+        history.push(sample);
+        state.historySum += sample;
+        if (history.length > VELOCITY_HISTORY_SECONDS) state.historySum -= history.shift()!;
+      }
+
+      state.lastSecond = second;
+      state.secondCount = 0;
+      this.pruneFills(state, now);
+    }
+
+    state.secondCount++;
+  }
+
+  private pruneFills(state: SymbolState, now: number): void {
+    for (const [price, fill] of state.fills) {
+      if (now - fill.timestamp > FILL_WINDOW_MS) state.fills.delete(price);
+    }
+  }
+
+  /**
+   * Top-N snapshot: refresh averages and the tracked window, flag new walls
+   */
+  handleOrderBook(orderBook: OrderBook): void {
+    const symbol = orderBook.symbol.toUpperCase();
+    const state = this.getState(symbol);
+    const { bids, asks } = orderBook;
+    if (bids.length === 0 || asks.length === 0) return;
+
+    state.avgBidSize = averageSize(bids);
+    state.avgAskSize = averageSize(asks);
+    state.bidEdge = bids[bids.length - 1].price;
+    state.askEdge = asks[asks.length - 1].price;
+
+    state.bidWalls = this.detectWalls(symbol, bids, state.avgBidSize, state.bidWalls, 'buy');
+    state.askWalls = this.detectWalls(symbol, asks, state.avgAskSize, state.askWalls, 'sell');
+
+    state.bidLevels = this.largeLevels(bids, state.avgBidSize);
+    state.askLevels = this.largeLevels(asks, state.avgAskSize);
+  }
+
+  private largeLevels(levels: OrderBookLevel[], avgSize: number): Map<number, number> {
+    const large = new Map<number, number>();
+    for (const level of levels) {
+      if (level.size > avgSize * SPOOF_MULTIPLIER) large.set(level.price, level.size);
+    }
+    return large;
+  }
+
+  /**
+   * Signal levels that have just become walls - returns the current wall set
+   */
+  private detectWalls(
+    symbol: string,
+    levels: OrderBookLevel[],
+    avgSize: number,
+    previous: Set<number>,
+    side: 'buy' | 'sell'
+  ): Set<number> {
+    const walls = new Set<number>();
+    for (const level of levels) {
+      const value = level.size * level.price;
+      if (level.size <= avgSize * WALL_MULTIPLIER || value < WALL_MIN_USD) continue;
+      walls.add(level.price);
+      if (!previous.has(level.price)) {
+        this.onSignal({
+          type: 'wall',
+          symbol,
+          timestamp: Date.now(),
+          value,
+          side,
+          price: level.price,
+          ratio: level.size / avgSize,
+        });
+      }
+    }
+    return walls;
+  }
+
+  /**
+   * Level-by-level changes: catch large levels that get pulled
+   */
+  handleOrderBookDelta(delta: OrderBookDelta): void {
+    const symbol = delta.symbol.toUpperCase();
+    const state = this.getState(symbol);
+
+    // A fresh book invalidates everything we were tracking
+    if (delta.snapshot) {
+      state.bidLevels.clear();
+      state.askLevels.clear();
+      state.bidWalls.clear();
+      state.askWalls.clear();
+      return;
+    }
+
+    for (const [price, size] of delta.bids) {
+      this.checkLevel(symbol, state, state.bidLevels, price, size, state.avgBidSize, price >= state.bidEdge, 'buy');
+    }
+    for (const [price, size] of delta.asks) {
+      this.checkLevel(symbol, state, state.askLevels, price, size, state.avgAskSize, price <= state.askEdge, 'sell');
+    }
+  }
+
+  private checkLevel(
+    symbol: string,
+    state: SymbolState,
+    tracked: Map<number, number>,
+    price: number,
+    size: number,
+    avgSize: number,
+    inWindow: boolean,
+    side: 'buy' | 'sell'
+  ): void {
+    const previous = tracked.get(price);
+
+    if (previous !== undefined && size < previous * SPOOF_REMAINING) {
+      const value = previous * price;
+      const spoofMin = price >= HIGH_PRICE ? SPOOF_MIN_USD_HIGH : SPOOF_MIN_USD;
+      if (value >= spoofMin) this.scheduleSpoofCheck(symbol, state, price, previous - size, value, side);
+    }
+
+    if (inWindow && avgSize > 0 && size > avgSize * SPOOF_MULTIPLIER) tracked.set(price, size);
+    else tracked.delete(price);
+  }
+
+  /**
+   * Give the trade stream FILL_GRACE_MS to report fills at the price before
+   * deciding the size was cancelled
+   */
+  private scheduleSpoofCheck(
+    symbol: string,
+    state: SymbolState,
+    price: number,
+    drop: number,
+    value: number,
+    side: 'buy' | 'sell'
+  ): void {
+    const timer = setTimeout(() => {
+      state.spoofTimers.delete(timer);
+      if (this.symbols.get(symbol) !== state) return;  // Symbol was dropped meanwhile
+
+      const now = Date.now();
+      const fill = state.fills.get(price);
+      const traded = fill && now - fill.timestamp <= FILL_WINDOW_MS ? fill.volume : 0;
+      if (traded < drop * SPOOF_FILL_SHARE) {
+        this.onSignal({ type: 'spoof', symbol, timestamp: now, value, side, price });
+      }
+    }, FILL_GRACE_MS);
+    state.spoofTimers.add(timer);
+  }
+
+  /**
+   * Forget a symbol (nobody is watching it anymore)
+   */
+  clear(symbol: string): void {
+    const state = this.symbols.get(symbol.toUpperCase());
+    if (!state) return;
+    for (const timer of state.spoofTimers) clearTimeout(timer);
+    this.symbols.delete(symbol.toUpperCase());
+  }
+
+  /**
+   * Stop all pending checks (on shutdown)
+   */
+  stop(): void {
+    for (const symbol of Array.from(this.symbols.keys())) {
+      this.clear(symbol);
+    }
+  }
+}
@@ -0,0 +1,214 @@
+// Symbol state cache - last known ticker, book and recent trades, for clients that join a live stream
+
+import { Trade, OrderBook, Ticker } from '../types';
+import {
+  FRAME_HISTORY,
+  HEADER_SIZE,
+  MAX_TRADES_PER_FRAME,
+  TRADE_RECORD_SIZE,
+  readTradeRecord,
+  writeFrameHeader,
+  writeTradeRecord,
+} from './binaryProtocol';
+
+/**
+ * Recent trades for one symbol, held as binary-protocol records
+ *
+ * Every trade is stored as the 36-byte record it would go out as, in one
+ * preallocated ring, so a history frame is a header plus at most two
+ * copies out of the ring - nothing is encoded per trade on subscribe, and
+ * a thousand trades cost 36KB instead of a thousand objects.
+ */
+export class TradeTape {
+  readonly capacity: number;
+  private records: Buffer;
+  private view: DataView;
+  private start = 0;        // Slot of the oldest record
+  private count = 0;
+
+  constructor(private symbol: string, capacity: number) {
+    this.capacity = Math.max(1, Math.min(capacity, MAX_TRADES_PER_FRAME));
+    this.records = Buffer.alloc(this.capacity * TRADE_RECORD_SIZE);
+    this.view = new DataView(this.records.buffer, this.records.byteOffset, this.records.byteLength);
+  }
+
+  get length(): number {
+    return this.count;
+  }
+
+  /**
+   * Append a live trade, overwriting the oldest once full
+   */
+  push(trade: Trade): void {
+    const slot = (this.start + this.count) % this.capacity;
+    writeTradeRecord(this.view, slot * TRADE_RECORD_SIZE, trade);
+    if (this.count < this.capacity) this.count++;
+    else this.start = (this.start + 1) % this.capacity;
+  }
+
+  /**
+   * Put older trades (oldest first) in front of what's already here
+   *
+   * Only trades strictly older than the current oldest are taken, so a
+   * backfill that overlaps the live stream doesn't duplicate prints, and
+   * only as many as there's room for - live trades are never pushed out.
+   * Returns how many were added.
+   */
+  prepend(trades: Trade[]): number {
+    const oldest = this.count > 0 ? this.timestampAt(0) : Infinity;
+    let end = trades.length;
+    while (end > 0 && trades[end - 1].timestamp >= oldest) end--;
+
+    const take = Math.min(end, this.capacity - this.count);
+    for (let i = end - 1; i >= end - take; i--) {
+      this.start = (this.start - 1 + this.capacity) % this.capacity;
+      writeTradeRecord(this.view, this.start * TRADE_RECORD_SIZE, trades[i]);
+      this.count++;
+    }
+    return take;
+  }
+
+  /**
+   * FRAME_HISTORY frame of the trades newer than since, oldest first
+   */
+  frame(since = 0): Buffer {
+    const first = this.firstAfter(since);
+    const count = this.count - first;
+    const out = Buffer.allocUnsafe(HEADER_SIZE + count * TRADE_RECORD_SIZE);
+    writeFrameHeader(out, FRAME_HISTORY, count);
+
+    let written = HEADER_SIZE;
+    let slot = (this.start + first) % this.capacity;
+    let remaining = count;
+    while (remaining > 0) {
+      const run = Math.min(remaining, this.capacity - slot);
+      this.records.copy(out, written, slot * TRADE_RECORD_SIZE, (slot + run) * TRADE_RECORD_SIZE);
+      written += run * TRADE_RECORD_SIZE;
+      remaining -= run;
+      slot = 0;
+    }
+    return out;
+  }
+
+  /**
+   * The same trades as objects, for JSON clients and the bus
+   */
+  trades(since = 0): Trade[] {
+    const out: Trade[] = [];
+    for (let i = this.firstAfter(since); i < this.count; i++) {
+      out.push(readTradeRecord(this.view, this.offsetOf(i), this.symbol));
+    }
+    return out;
+  }
+
+  private offsetOf(index: number): number {
+    return ((this.start + index) % this.capacity) * TRADE_RECORD_SIZE;
+  }
+
+  private timestampAt(index: number): number {
+    return this.view.getFloat64(this.offsetOf(index) + 16, true);
+  }
+
+  /**
+   * Index of the first trade newer than since (records are in time order)
+   */
+  private firstAfter(since: number): number {
+    if (since <= 0) return 0;
+    let low = 0;
+    let high = this.count;
+    while (low < high) {
+      const mid = (low + high) >>> 1;
+      if (this.timestampAt(mid) > since) high = mid;
+      else low = mid + 1;
+    }
+    return low;
+  }
+}
+
+export interface SymbolState {
+  ticker: Ticker | null;
+  orderBook: OrderBook | null;
+  tape: TradeTape | null;   // Created on the first trade (or backfill), null if maxTrades is 0
+}
+
+/**
+ * What a late subscriber needs to render the symbol before anything new happens
+ *
+ * The adapter's REST snapshots only run when a symbol is first subscribed
+ * upstream, so anyone joining after that would otherwise see an empty
+ * ticker and tape until the next push. Fed from the adapter callbacks and
+ * dropped with the upstream subscription. The book is only a fallback for
+ * adapters that don't keep a local one - the live book is always fresher.
+ * The tape also takes the adapter's backfill, so the very first subscriber
+ * starts with history too.
+ */
+export class SymbolStateCache {
+  private states: Map<string, SymbolState> = new Map();
+
+  constructor(private maxTrades: number) {}
+
+  recordTrade(trade: Trade): void {
+    this.tape(trade.symbol)?.push(trade);
+  }
+
+  /**
+   * Backfill from before the subscription (oldest first) - see TradeTape.prepend
+   */
+  seedTrades(symbol: string, trades: Trade[]): number {
+    return this.tape(symbol)?.prepend(trades) ?? 0;
+  }
+
+  recordTicker(ticker: Ticker): void {
+    this.state(ticker.symbol).ticker = ticker;
+  }
+
+  recordOrderBook(orderBook: OrderBook): void {
+    this.state(orderBook.symbol).orderBook = orderBook;
+  }
+
+  ticker(symbol: string): Ticker | null {
+    return this.states.get(symbol.toUpperCase())?.ticker ?? null;
+  }
+
+  orderBook(symbol: string): OrderBook | null {
+    return this.states.get(symbol.toUpperCase())?.orderBook ?? null;
+  }
+
+  /**
+   * Up to maxTrades most recent trades, oldest first, newer than since
+   */
+  recentTrades(symbol: string, since = 0): Trade[] {
+    return this.states.get(symbol.toUpperCase())?.tape?.trades(since) ?? [];
+  }
+
+  /**
+   * The same trades as one FRAME_HISTORY frame, or null if there are none
+   */
+  historyFrame(symbol: string, since = 0): Buffer | null {
+    const tape = this.states.get(symbol.toUpperCase())?.tape;
+    if (!tape || tape.length === 0) return null;
+    const frame = tape.frame(since);
+    return frame.length > HEADER_SIZE ? frame : null;
+  }
+
+  clear(symbol: string): void {
+    this.states.delete(symbol.toUpperCase());
+  }
+
+  private tape(symbol: string): TradeTape | null {
+    if (this.maxTrades <= 0) return null;
+    const state = this.state(symbol);
+    state.tape ??= new TradeTape(symbol.toUpperCase(), this.maxTrades);
+    return state.tape;
+  }
+
+  private state(symbol: string): SymbolState {
+    const upperSymbol = symbol.toUpperCase();
+    let state = this.states.get(upperSymbol);
+    if (!state) {
+      state = { ticker: null, orderBook: null, tape: null };
+      this.states.set(upperSymbol, state);
+    }
+    return state;
+  }
+}
@@ -0,0 +1,743 @@
+// Tick capture file - chunked, columnar, delta-encoded record of the normalized adapter stream
+
+import fs from 'fs';
+import path from 'path';
+import { Trade, OrderBook, OrderBookDelta, Ticker, OrderBookLevel, TradeSide, MarketDataAdapter } from '../types';
+
+/*
+ * File layout (little-endian)
+ *
+ *   header   'TFTK' u16 version u16 reserved
+ *   chunk*   'TFCK' u32 bodyLength
+ *            f64 firstTime f64 lastTime u32 eventCount
+ *            u16 stringCount { u8 length, utf8 }*      symbols and exchange names
+ *            u8 columnCount { u32 length }*
+ *            column bytes, in COLUMNS order
+ *
+ * An index sidecar (<file>.idx) gets one 28-byte record per chunk as it is
+ * written: f64 offset, f64 firstTime, f64 lastTime, u32 eventCount. Readers
+ * fall back to walking the chunk headers if it's missing.
+ *
+ * Every chunk decodes on its own (delta state resets at chunk boundaries), so
+ * a reader can seek straight to any chunk the index points at. Times are
+ * capture times - when the adapter emitted the event - which is what replay
+ * paces by; each record's own timestamp is stored relative to that.
+ */
+
+const FILE_MAGIC = 'TFTK';
+const CHUNK_MAGIC = 'TFCK';
+const FORMAT_VERSION = 1;
+const FILE_HEADER_BYTES = 8;
+const INDEX_RECORD_BYTES = 28;
+
+const CHUNK_EVENTS = 8192;        // Cut a chunk at this many events...
+const CHUNK_FLUSH_MS = 1000;      // ...or after this long, whichever comes first
+
+const PRICE_SCALE = 1e8;
+const RAW_DECIMAL = 255;          // Exponent marker for values stored as raw f64
+
+const KIND_TRADE = 1;
+const KIND_ORDERBOOK = 2;
+const KIND_DELTA = 3;
+const KIND_TICKER = 4;
+
+// Column order on disk
+const COL_KIND = 0;       // u8 per event
+const COL_SYMBOL = 1;     // varint string index per event
+const COL_TIME = 2;       // zigzag delta from the previous event's capture time
+const COL_STAMP = 3;      // zigzag: record timestamp - capture time
+const COL_TRADE_ID = 4;   // zigzag delta from the symbol's previous numeric id
+const COL_PRICE = 5;      // zigzag delta of price * 1e8 from the symbol's previous price
+const COL_SIZE = 6;       // decimal: u8 exponent + varint mantissa
+const COL_SIDE = 7;       // u8 per trade
+const COL_META = 8;       // Per-kind extras: book counts and seqs, ticker fields
+const COLUMN_COUNT = 9;
+
+const POW10 = [1, 10, 100, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8];
+
+export type TickEvent =
+  | { kind: 'trade'; time: number; data: Trade }
+  | { kind: 'orderbook'; time: number; data: OrderBook }
+  | { kind: 'delta'; time: number; data: OrderBookDelta }
+  | { kind: 'ticker'; time: number; data: Ticker };
+
+export interface ChunkInfo {
+  offset: number;
+  firstTime: number;
+  lastTime: number;
+  events: number;
+}
+
+/**
+ * Growable byte buffer with the varint/zigzag writers the columns use
+ *
+ * Varints are written with arithmetic, not bit ops, so values up to 2^53
+ * (prices * 1e8, Binance trade ids) survive.
+ */
+class ByteWriter {
+  private buf = Buffer.allocUnsafe(4096);
+  length = 0;
+
+  private ensure(n: number): void {
+    if (this.length + n <= this.buf.length) return;
+    let size = this.buf.length * 2;
+    while (size < this.length + n) size *= 2;
+    const next = Buffer.allocUnsafe(size);
+    this.buf.copy(next, 0, 0, this.length);
+    this.buf = next;
+  }
+
+  u8(v: number): void {
+    this.ensure(1);
+    this.buf[this.length++] = v;
+  }
+
+  u16(v: number): void {
+    this.ensure(2);
+    this.buf.writeUInt16LE(v, this.length);
+    this.length += 2;
+  }
+
+  u32(v: number): void {
+    this.ensure(4);
+    this.buf.writeUInt32LE(v, this.length);
+    this.length += 4;
+  }
+
+  f64(v: number): void {
+    this.ensure(8);
+    this.buf.writeDoubleLE(v, this.length);
+    this.length += 8;
+  }
+
+  varint(v: number): void {
+    this.ensure(8);
+    while (v >= 128) {
+      this.buf[this.length++] = (v % 128) + 128;
+      v = Math.floor(v / 128);
+    }
+    this.buf[this.length++] = v;
+  }
+
+  svarint(v: number): void {
+    this.varint(v >= 0 ? v * 2 : -v * 2 - 1);
+  }
+
+  str(s: string): void {
+    const bytes = Buffer.from(s, 'utf8');
+    this.u8(bytes.length);
+    this.bytes(bytes);
+  }
+
+  bytes(b: Buffer): void {
+    this.ensure(b.length);
+    b.copy(this.buf, this.length);
+    this.length += b.length;
+  }
+
+  view(): Buffer {
+    return this.buf.subarray(0, this.length);
+  }
+
+  reset(): void {
+    this.length = 0;
+  }
+}
+
+class ByteReader {
+  constructor(private buf: Buffer, public pos: number = 0) {}
+
+  u8(): number {
+    return this.buf[this.pos++];
+  }
+
+  u16(): number {
+    const v = this.buf.readUInt16LE(this.pos);
+    this.pos += 2;
+    return v;
+  }
+
+  u32(): number {
+    const v = this.buf.readUInt32LE(this.pos);
+    this.pos += 4;
+    return v;
+  }
+
+  f64(): number {
+    const v = this.buf.readDoubleLE(this.pos);
+    this.pos += 8;
+    return v;
+  }
+
+  varint(): number {
+    let result = 0;
+    let mul = 1;
+    for (;;) {
+      const b = this.buf[this.pos++];
+      result += (b & 127) * mul;
+      if (b < 128) return result;
+      mul *= 128;
+    }
+  }
+
+  svarint(): number {
+    const v = this.varint();
+    return v % 2 === 0 ? v / 2 : -(v + 1) / 2;
+  }
+
+  str(): string {
+    const length = this.u8();
+    const s = this.buf.toString('utf8', this.pos, this.pos + length);
+    this.pos += length;
+    return s;
+  }
+}
+
+/**
+ * Sizes and volumes as an exact decimal (mantissa / 10^exponent) when they
+ * have 8 or fewer decimals - they come from parseFloat on exchange strings,
+ * so m / 10^e gives back the identical double. Anything else is stored raw.
+ */
+function writeDecimal(w: ByteWriter, v: number): void {
+  for (let e = 0; e < POW10.length; e++) {
+    const m = Math.round(v * POW10[e]);
+    if (m / POW10[e] === v && m >= 0 && Number.isSafeInteger(m)) {
+      w.u8(e);
+      w.varint(m);
+      return;
+    }
+  }
+  w.u8(RAW_DECIMAL);
+  w.f64(v);
+}
+
+function readDecimal(r: ByteReader): number {
+  const e = r.u8();
+  if (e === RAW_DECIMAL) return r.f64();
+  return r.varint() / POW10[e];
+}
+
+/**
+ * Per-symbol delta state inside one chunk
+ */
+interface SymbolCursor {
+  price: number;    // Previous price * PRICE_SCALE
+  id: number;       // Previous numeric trade id
+}
+
+/**
+ * Prices are deltas of price * 1e8 against the symbol's previous price, so
+ * consecutive trades and adjacent book levels cost a byte or two. The tag's
+ * low bit marks the rare price that isn't exact at 1e8 (stored raw).
+ */
+function writePrice(w: ByteWriter, cursor: SymbolCursor, price: number): void {
+  const scaled = Math.round(price * PRICE_SCALE);
+  if (scaled / PRICE_SCALE !== price || !Number.isSafeInteger(scaled)) {
+    w.varint(1);
+    w.f64(price);
+    return;
+  }
+  const delta = scaled - cursor.price;
+  w.varint((delta >= 0 ? delta * 2 : -delta * 2 - 1) * 2);
+  cursor.price = scaled;
+}
+
+function readPrice(r: ByteReader, cursor: SymbolCursor): number {
+  const tag = r.varint();
+  if (tag % 2 === 1) return r.f64();
+  const z = tag / 2;
+  cursor.price += z % 2 === 0 ? z / 2 : -(z + 1) / 2;
+  return cursor.price / PRICE_SCALE;
+}
+
+const SIDE_CODES: Record<TradeSide, number> = { neutral: 0, buy: 1, sell: 2 };
+const SIDES: TradeSide[] = ['neutral', 'buy', 'sell'];
+
+/**
+ * Builds one chunk's columns as events come in
+ */
+class ChunkEncoder {
+  private columns: ByteWriter[] = Array.from({ length: COLUMN_COUNT }, () => new ByteWriter());
+  private strings: string[] = [];
+  private stringIndex: Map<string, number> = new Map();
+  private cursors: SymbolCursor[] = [];
+  private previousTime = 0;
+  firstTime = 0;
+  lastTime = 0;
+  events = 0;
+
+  private intern(s: string): number {
+    let i = this.stringIndex.get(s);
+    if (i === undefined) {
+      i = this.strings.length;
+      this.strings.push(s);
+      this.stringIndex.set(s, i);
+      this.cursors.push({ price: 0, id: 0 });
+    }
+    return i;
+  }
+
+  private begin(kind: number, symbol: string, time: number, stamp: number): SymbolCursor {
+    if (this.events === 0) {
+      this.firstTime = time;
+      this.previousTime = time;
+    }
+    const s = this.intern(symbol);
+    this.columns[COL_KIND].u8(kind);
+    this.columns[COL_SYMBOL].varint(s);
+    this.columns[COL_TIME].svarint(time - this.previousTime);
+    this.columns[COL_STAMP].svarint(stamp - time);
+    this.previousTime = time;
+    this.lastTime = Math.max(this.lastTime, time);
+    this.events++;
+    return this.cursors[s];
+  }
+
+  trade(trade: Trade, time: number): void {
+    const cursor = this.begin(KIND_TRADE, trade.symbol, time, trade.timestamp);
+    const ids = this.columns[COL_TRADE_ID];
+    const numericId = /^\d{1,15}$/.test(trade.id) ? Number(trade.id) : NaN;
+    if (Number.isNaN(numericId)) {
+      // Generated ids aren't numbers - keep the string
+      ids.varint(1);
+      ids.str(trade.id);
+    } else {
+      const delta = numericId - cursor.id;
+      ids.varint((delta >= 0 ? delta * 2 : -delta * 2 - 1) * 2);
+      cursor.id = numericId;
+    }
+    writePrice(this.columns[COL_PRICE], cursor, trade.price);
+    writeDecimal(this.columns[COL_SIZE], trade.volume);
+    this.columns[COL_SIDE].u8(SIDE_CODES[trade.side] ?? 0);
+    this.columns[COL_META].varint(trade.exchange ? this.intern(trade.exchange) + 1 : 0);
+  }
+
+  orderBook(book: OrderBook, time: number): void {
+    const cursor = this.begin(KIND_ORDERBOOK, book.symbol, time, book.timestamp);
+    const meta = this.columns[COL_META];
+    meta.varint(book.seq !== undefined ? book.seq + 1 : 0);
+    meta.varint(book.bids.length);
+    meta.varint(book.asks.length);
+    this.levels(cursor, book.bids.map(l => [l.price, l.size] as [number, number]));
+    this.levels(cursor, book.asks.map(l => [l.price, l.size] as [number, number]));
+  }
+
+  delta(delta: OrderBookDelta, time: number): void {
+    const cursor = this.begin(KIND_DELTA, delta.symbol, time, delta.timestamp);
+    const meta = this.columns[COL_META];
+    meta.varint(delta.seq);
+    meta.svarint(delta.seq - delta.prevSeq);
+    meta.u8(delta.snapshot ? 1 : 0);
+    meta.varint(delta.bids.length);
+    meta.varint(delta.asks.length);
+    this.levels(cursor, delta.bids);
+    this.levels(cursor, delta.asks);
+  }
+
+  ticker(ticker: Ticker, time: number): void {
+    this.begin(KIND_TICKER, ticker.symbol, time, ticker.timestamp);
+    const meta = this.columns[COL_META];
+    meta.f64(ticker.lastPrice);
+    meta.f64(ticker.priceChange);
+    meta.f64(ticker.priceChangePercent);
+    meta.f64(ticker.highPrice);
+    meta.f64(ticker.lowPrice);
+    meta.f64(ticker.volume);
+    meta.f64(ticker.quoteVolume);
+    meta.f64(ticker.openPrice);
+  }
+
+  private levels(cursor: SymbolCursor, levels: [number, number][]): void {
+    // Walk from the symbol's last price level by level; restore it afterwards
+    // so trade deltas stay small
+    const saved = cursor.price;
+    for (const [price, size] of levels) {
+      writePrice(this.columns[COL_PRICE], cursor, price);
+      writeDecimal(this.columns[COL_SIZE], size);
+    }
+    if (levels.length > 0) cursor.price = saved;
+  }
+
+  /**
+   * Serialize the chunk and reset for the next one
+   */
+  finish(): Buffer {
+    const header = new ByteWriter();
+    header.f64(this.firstTime);
+    header.f64(this.lastTime);
+    header.u32(this.events);
+    header.u16(this.strings.length);
+    for (const s of this.strings) header.str(s);
+    header.u8(COLUMN_COUNT);
+    let bodyLength = header.length + COLUMN_COUNT * 4;
+    for (const column of this.columns) {
+      header.u32(column.length);
+      bodyLength += column.length;
+    }
+
+    const out = Buffer.allocUnsafe(8 + bodyLength);
+    out.write(CHUNK_MAGIC, 0, 'latin1');
+    out.writeUInt32LE(bodyLength, 4);
+    header.view().copy(out, 8);
+    let pos = 8 + header.length;
+    for (const column of this.columns) {
+      column.view().copy(out, pos);
+      pos += column.length;
+      column.reset();
+    }
+
+    this.strings = [];
+    this.stringIndex.clear();
+    this.cursors = [];
+    this.events = 0;
+    this.firstTime = 0;
+    this.lastTime = 0;
+    return out;
+  }
+}
+
+/**
+ * Decode one chunk body (everything after 'TFCK' + length) into events
+ */
+function decodeChunk(body: Buffer): TickEvent[] {
+  const header = new ByteReader(body);
+  const firstTime = header.f64();
+  header.f64();   // lastTime - only the index needs it
+  const count = header.u32();
+  const stringCount = header.u16();
+  const strings: string[] = [];
+  for (let i = 0; i < stringCount; i++) strings.push(header.str());
+  const columnCount = header.u8();
+  const lengths: number[] = [];
+  for (let i = 0; i < columnCount; i++) lengths.push(header.u32());
+
+  const columns: ByteReader[] = [];
+  let pos = header.pos;
+  for (let i = 0; i < columnCount; i++) {
+    columns.push(new ByteReader(body, pos));
+    pos += lengths[i];
+  }
+
+  const cursors: SymbolCursor[] = strings.map(() => ({ price: 0, id: 0 }));
+  const events: TickEvent[] = new Array(count);
+  let time = firstTime;
+
+  const readLevels = (cursor: SymbolCursor, n: number): [number, number][] => {
+    const saved = cursor.price;
+    const levels: [number, number][] = new Array(n);
+    for (let i = 0; i < n; i++) {
+      const price = readPrice(columns[COL_PRICE], cursor);
+      levels[i] = [price, readDecimal(columns[COL_SIZE])];
+    }
+    if (n > 0) cursor.price = saved;
+    return levels;
+  };
+  const toLevels = (pairs: [number, number][]): OrderBookLevel[] =>
+    pairs.map(([price, size]) => ({ price, size }));
+
+  for (let e = 0; e < count; e++) {
+    const kind = columns[COL_KIND].u8();
+    const s = columns[COL_SYMBOL].varint();
+    time += columns[COL_TIME].svarint();
+    const timestamp = time + columns[COL_STAMP].svarint();
+    const symbol = strings[s];
+    const cursor = cursors[s];
+    const meta = columns[COL_META];
+
+    switch (kind) {
+      case KIND_TRADE: {
+        const ids = columns[COL_TRADE_ID];
+        const tag = ids.varint();
+        let id: string;
+        if (tag % 2 === 1) {
+          id = ids.str();
+        } else {
+          const z = tag / 2;
+          cursor.id += z % 2 === 0 ? z / 2 : -(z + 1) / 2;
+          id = String(cursor.id);
+        }
+        const price = readPrice(columns[COL_PRICE], cursor);
+        const volume = readDecimal(columns[COL_SIZE]);
+        const side = SIDES[columns[COL_SIDE].u8()] ?? 'neutral';
+        const exchange = meta.varint();
+        const trade: Trade = { id, symbol, assetType: 'crypto', timestamp, price, volume, side };
+        if (exchange > 0) trade.exchange = strings[exchange - 1];
+        events[e] = { kind: 'trade', time, data: trade };
+        break;
+      }
+      case KIND_ORDERBOOK: {
+        const seq = meta.varint();
+        const bidCount = meta.varint();
+        const askCount = meta.varint();
+        const bids = toLevels(readLevels(cursor, bidCount));
+        const asks = toLevels(readLevels(cursor, askCount));
+        const bestBid = bids[0]?.price ?? 0;
+        const spread = (asks[0]?.price ?? 0) - bestBid;
+        const book: OrderBook = {
+          symbol,
+          assetType: 'crypto',
+          timestamp,
+          bids,
+          asks,
+          spread,
+          spreadPercent: bestBid > 0 ? (spread / bestBid) * 100 : 0,
+        };
+        if (seq > 0) book.seq = seq - 1;
+        events[e] = { kind: 'orderbook', time, data: book };
+        break;
+      }
+      case KIND_DELTA: {
+        const seq = meta.varint();
+        const prevSeq = seq - meta.svarint();
+        const snapshot = meta.u8() === 1;
+        const bidCount = meta.varint();
+        const askCount = meta.varint();
+        const delta: OrderBookDelta = {
+          symbol,
+          assetType: 'crypto',
+          timestamp,
+          seq,
+          prevSeq,
+          bids: readLevels(cursor, bidCount),
+          asks: readLevels(cursor, askCount),
+        };
+        if (snapshot) delta.snapshot = true;
+        events[e] = { kind: 'delta', time, data: delta };
+        break;
+      }
+      case KIND_TICKER: {
+        events[e] = {
+          kind: 'ticker',
+          time,
+          data: {
+            symbol,
+            assetType: 'crypto',
+            timestamp,
+            lastPrice: meta.f64(),
+            priceChange: meta.f64(),
+            priceChangePercent: meta.f64(),
+            highPrice: meta.f64(),
+            lowPrice: meta.f64(),
+            volume: meta.f64(),
+            quoteVolume: meta.f64(),
+            openPrice: meta.f64(),
+          },
+        };
+        break;
+      }
+      default:
+        throw new Error(`Unknown tick event kind ${kind}`);
+    }
+  }
+
+  return events;
+}
+
+/**
+ * Append-only capture writer
+ *
+ * Events are encoded straight into the open chunk's columns; the chunk is
+ * written out (one write to the data file, one 28-byte index record) every
+ * CHUNK_EVENTS events or CHUNK_FLUSH_MS, so a crash loses at most about a
+ * second. Writes go through append streams and never block the event loop.
+ */
+export class TickFileWriter {
+  private chunk = new ChunkEncoder();
+  private data: fs.WriteStream;
+  private index: fs.WriteStream;
+  private offset: number;
+  private timer: NodeJS.Timeout | null = null;
+
+  constructor(readonly filePath: string) {
+    const exists = fs.existsSync(filePath) && fs.statSync(filePath).size > 0;
+    this.offset = exists ? fs.statSync(filePath).size : 0;
+    this.data = fs.createWriteStream(filePath, { flags: 'a' });
+    this.index = fs.createWriteStream(`${filePath}.idx`, { flags: 'a' });
+
+    if (!exists) {
+      const header = Buffer.alloc(FILE_HEADER_BYTES);
+      header.write(FILE_MAGIC, 0, 'latin1');
+      header.writeUInt16LE(FORMAT_VERSION, 4);
+      this.data.write(header);
+      this.offset = FILE_HEADER_BYTES;
+    }
+  }
+
+  trade(trade: Trade): void {
+    this.chunk.trade(trade, Date.now());
+    this.afterEvent();
+  }
+
+  orderBook(book: OrderBook): void {
+    this.chunk.orderBook(book, Date.now());
+    this.afterEvent();
+  }
+
+  delta(delta: OrderBookDelta): void {
+    this.chunk.delta(delta, Date.now());
+    this.afterEvent();
+  }
+
+  ticker(ticker: Ticker): void {
+    this.chunk.ticker(ticker, Date.now());
+    this.afterEvent();
+  }
+
+  private afterEvent(): void {
+    if (this.chunk.events >= CHUNK_EVENTS) {
+      this.flush();
+    } else if (!this.timer) {
+      this.timer = setTimeout(() => this.flush(), CHUNK_FLUSH_MS);
+    }
+  }
+
+  /**
+   * Write out the open chunk, if it has anything in it
+   */
+  flush(): void {
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    if (this.chunk.events === 0) return;
+
+    const { firstTime, lastTime, events } = this.chunk;
+    const bytes = this.chunk.finish();
+    const record = Buffer.allocUnsafe(INDEX_RECORD_BYTES);
+    record.writeDoubleLE(this.offset, 0);
+    record.writeDoubleLE(firstTime, 8);
+    record.writeDoubleLE(lastTime, 16);
+    record.writeUInt32LE(events, 24);
+
+    this.data.write(bytes);
+    this.index.write(record);
+    this.offset += bytes.length;
+  }
+
+  async close(): Promise<void> {
+    this.flush();
+    await Promise.all([
+      new Promise<void>(resolve => this.data.end(resolve)),
+      new Promise<void>(resolve => this.index.end(resolve)),
+    ]);
+  }
+}
+
+/**
+ * Random-access reader over a capture file
+ *
+ * Chunks are read with positioned reads straight into a Buffer and decoded
+ * from there - the same access pattern as mapping the file, without holding
+ * more than one chunk in memory. A chunk cut short by a crash mid-write is
+ * ignored.
+ */
+export class TickFileReader {
+  readonly chunks: ChunkInfo[] = [];
+  private fd: number;
+  private size: number;
+
+  constructor(readonly filePath: string) {
+    this.fd = fs.openSync(filePath, 'r');
+    this.size = fs.fstatSync(this.fd).size;
+
+    const header = Buffer.alloc(FILE_HEADER_BYTES);
+    fs.readSync(this.fd, header, 0, FILE_HEADER_BYTES, 0);
+    if (header.toString('latin1', 0, 4) !== FILE_MAGIC) {
+      fs.closeSync(this.fd);
+      throw new Error(`${filePath} is not a tick capture file`);
+    }
+    if (header.readUInt16LE(4) !== FORMAT_VERSION) {
+      fs.closeSync(this.fd);
+      throw new Error(`${filePath}: unsupported capture format version ${header.readUInt16LE(4)}`);
+    }
+
+    if (!this.loadIndex()) this.scanChunks();
+  }
+
+  private loadIndex(): boolean {
+    const indexPath = `${this.filePath}.idx`;
+    if (!fs.existsSync(indexPath)) return false;
+    const index = fs.readFileSync(indexPath);
+    for (let pos = 0; pos + INDEX_RECORD_BYTES <= index.length; pos += INDEX_RECORD_BYTES) {
+      const info: ChunkInfo = {
+        offset: index.readDoubleLE(pos),
+        firstTime: index.readDoubleLE(pos + 8),
+        lastTime: index.readDoubleLE(pos + 16),
+        events: index.readUInt32LE(pos + 24),
+      };
+      if (this.chunkLength(info.offset) < 0) break;
+      this.chunks.push(info);
+    }
+    return this.chunks.length > 0;
+  }
+
+  private scanChunks(): void {
+    const head = Buffer.alloc(28);
+    let offset = FILE_HEADER_BYTES;
+    for (;;) {
+      const length = this.chunkLength(offset);
+      if (length < 0) break;
+      fs.readSync(this.fd, head, 0, 28, offset);
+      this.chunks.push({
+        offset,
+        firstTime: head.readDoubleLE(8),
+        lastTime: head.readDoubleLE(16),
+        events: head.readUInt32LE(24),
+      });
+      offset += 8 + length;
+    }
+  }
+
+  /**
+   * Body length of the chunk at offset, or -1 if there's no complete chunk there
+   */
+  private chunkLength(offset: number): number {
+    if (offset + 8 > this.size) return -1;
+    const head = Buffer.alloc(8);
+    fs.readSync(this.fd, head, 0, 8, offset);
+    if (head.toString('latin1', 0, 4) !== CHUNK_MAGIC) return -1;
+    const length = head.readUInt32LE(4);
+    return offset + 8 + length <= this.size ? length : -1;
+  }
+
+  readChunk(i: number): TickEvent[] {
+    const info = this.chunks[i];
+    const length = this.chunkLength(info.offset);
+    const body = Buffer.allocUnsafe(length);
+    fs.readSync(this.fd, body, 0, length, info.offset + 8);
+    return decodeChunk(body);
+  }
+
+  /**
+   * Symbols and exchange names that appear in a chunk, without decoding it
+   */
+  chunkStrings(i: number): string[] {
+    const info = this.chunks[i];
+    const length = this.chunkLength(info.offset);
+    const head = Buffer.allocUnsafe(Math.min(length, 64 * 1024));
+    fs.readSync(this.fd, head, 0, head.length, info.offset + 8);
+    const r = new ByteReader(head, 20);
+    const count = r.u16();
+    const strings: string[] = [];
+    for (let s = 0; s < count; s++) strings.push(r.str());
+    return strings;
+  }
+
+  close(): void {
+    fs.closeSync(this.fd);
+  }
+}
+
+/**
+ * Record everything an adapter emits to a new capture file in dir
+ */
+export function captureAdapter(adapter: MarketDataAdapter, dir: string): TickFileWriter {
+  fs.mkdirSync(dir, { recursive: true });
+  const stamp = new Date().toISOString().replace(/[-:]/g, '').replace(/\..*$/, '');
+  const writer = new TickFileWriter(path.join(dir, `capture-${stamp}.tfc`));
+  adapter.onTrade(trade => writer.trade(trade));
+  adapter.onOrderBook(book => writer.orderBook(book));
+  adapter.onOrderBookDelta(delta => writer.delta(delta));
+  adapter.onTicker(ticker => writer.ticker(ticker));
+  return writer;
+}
@@ -0,0 +1,98 @@
+// Trade micro-batcher - coalesces bursts of trades into one frame per symbol per tick
+
+import { Trade } from '../types';
+
+export interface TradeBatcherConfig {
+  windowMs: number;   // Max time a trade waits before its batch is sent (0 = send immediately)
+  maxBatch: number;   // Flush early once this many trades are pending for a symbol
+}
+
+interface PendingBatch {
+  trades: Trade[];
+  timer: NodeJS.Timeout | null;
+}
+
+/**
+ * Per-symbol coalescing window for trades
+ *
+ * During a liquidation cascade BTCUSDT can print 500+ trades/sec. Sending each
+ * one as its own frame costs a send() per client per trade on our side and a
+ * message event per trade in the browser - which then re-batches them to 60fps
+ * anyway. Holding trades for a few ms and shipping them as one array cuts both
+ * by an order of magnitude, and the added latency is bounded by windowMs.
+ *
+ * The window starts at the first trade of a batch (not a free-running timer),
+ * so a quiet symbol's lone trade waits at most windowMs.
+ */
+export class TradeBatcher {
+  private config: TradeBatcherConfig;
+  private pending: Map<string, PendingBatch> = new Map();
+  private onFlush: (symbol: string, trades: Trade[]) => void;
+
+  constructor(config: TradeBatcherConfig, onFlush: (symbol: string, trades: Trade[]) => void) {
+    this.config = config;
+    this.onFlush = onFlush;
+  }
+
+  add(trade: Trade): void {
+    const symbol = trade.symbol.toUpperCase();
+
+    if (this.config.windowMs <= 0) {
+      this.onFlush(symbol, [trade]);
+      return;
+    }
+
+    let batch = this.pending.get(symbol);
+    if (!batch) {
+      batch = { trades: [], timer: null };
+      this.pending.set(symbol, batch);
+    }
+
+    batch.trades.push(trade);
+
+    if (batch.trades.length >= this.config.maxBatch) {
+      this.flush(symbol);
+    } else if (!batch.timer) {
+      batch.timer = setTimeout(() => this.flush(symbol), this.config.windowMs);
+    }
+  }
+
+  /**
+   * Send whatever is pending for a symbol right now
+   */
+  flush(symbol: string): void {
+    const batch = this.pending.get(symbol);
+    if (!batch) return;
+
+    if (batch.timer) {
+      clearTimeout(batch.timer);
+      batch.timer = null;
+    }
+
+    if (batch.trades.length === 0) return;
+
+    // Hand off the array and start a fresh one - the callback may hold on to it
+    const trades = batch.trades;
+    batch.trades = [];
+    this.onFlush(symbol, trades);
+  }
+
+  /**
+   * Drop pending trades for a symbol (e.g. nobody is watching it anymore)
+   */
+  clear(symbol: string): void {
+    const batch = this.pending.get(symbol.toUpperCase());
+    if (batch?.timer) clearTimeout(batch.timer);
+    this.pending.delete(symbol.toUpperCase());
+  }
+
+  /**
+   * Flush everything and stop all timers (on shutdown)
+   */
+  stop(): void {
+    for (const symbol of Array.from(this.pending.keys())) {
+      this.flush(symbol);
+    }
+    this.pending.clear();
+  }
+}
@@ -0,0 +1,110 @@
+// Trade filters - per-subscription min notional, side and sampling, applied before serialization
+
+import { Trade, TradeFilter } from '../types';
+import { whaleMinFor } from './signalEngine';
+
+/**
+ * Check what a client sent - anything malformed is dropped, and a filter
+ * that would let everything through comes back as null
+ */
+export function normalizeTradeFilter(raw: unknown): TradeFilter | null {
+  if (!raw || typeof raw !== 'object') return null;
+  const input = raw as Record<string, unknown>;
+  const filter: TradeFilter = {};
+
+  if (input.minNotional === 'whale') {
+    filter.minNotional = 'whale';
+  } else {
+    const minNotional = Number(input.minNotional);
+    if (Number.isFinite(minNotional) && minNotional > 0) filter.minNotional = minNotional;
+  }
+  if (input.side === 'buy' || input.side === 'sell') filter.side = input.side;
+  const sampleRate = Number(input.sampleRate);
+  if (Number.isFinite(sampleRate) && sampleRate > 0 && sampleRate < 1) filter.sampleRate = sampleRate;
+
+  return Object.keys(filter).length > 0 ? filter : null;
+}
+
+/**
+ * One filter on one symbol, shared by every client that asked for the same one
+ *
+ * Sampling keeps a running credit instead of rolling dice, so a 0.1 rate
+ * is exactly every tenth passing trade - and because the credit lives here,
+ * every client sharing the filter gets the same trades and the same
+ * serialized frame.
+ */
+export class SymbolTradeFilter {
+  private credit = 0;
+  refs = 0;
+
+  constructor(readonly symbol: string, readonly key: string, readonly spec: TradeFilter) {}
+
+  /**
+   * A live batch - advances the sampling credit (call once per batch)
+   */
+  apply(trades: Trade[]): Trade[] {
+    const out: Trade[] = [];
+    for (const trade of trades) {
+      if (!this.passes(trade)) continue;
+      if (this.spec.sampleRate !== undefined) {
+        this.credit += this.spec.sampleRate;
+        if (this.credit < 1) continue;
+        this.credit -= 1;
+      }
+      out.push(trade);
+    }
+    return out;
+  }
+
+  /**
+   * Subscribe-time history - same thresholds, sampled on its own so the live
+   * stream's spacing isn't disturbed
+   */
+  applyToHistory(trades: Trade[]): Trade[] {
+    let credit = 0;
+    return trades.filter(trade => {
+      if (!this.passes(trade)) return false;
+      if (this.spec.sampleRate === undefined) return true;
+      credit += this.spec.sampleRate;
+      if (credit < 1) return false;
+      credit -= 1;
+      return true;
+    });
+  }
+
+  private passes(trade: Trade): boolean {
+    const { minNotional, side } = this.spec;
+    if (side && trade.side !== side) return false;
+    if (minNotional === undefined) return true;
+    const threshold = minNotional === 'whale' ? whaleMinFor(trade.price) : minNotional;
+    return trade.price * trade.volume >= threshold;
+  }
+}
+
+/**
+ * Refcounted filters per symbol, so identical ones are evaluated once per batch
+ */
+export class TradeFilterRegistry {
+  private filters: Map<string, SymbolTradeFilter> = new Map();
+
+  acquire(symbol: string, spec: TradeFilter): SymbolTradeFilter {
+    const key = `${spec.minNotional ?? ''}|${spec.side ?? ''}|${spec.sampleRate ?? ''}`;
+    const id = `${symbol}:${key}`;
+    let filter = this.filters.get(id);
+    if (!filter) {
+      filter = new SymbolTradeFilter(symbol, key, spec);
+      this.filters.set(id, filter);
+    }
+    filter.refs++;
+    return filter;
+  }
+
+  release(filter: SymbolTradeFilter): void {
+    if (--filter.refs > 0) return;
+    this.filters.delete(`${filter.symbol}:${filter.key}`);
+  }
+
+  get size(): number {
+    return this.filters.size;
+  }
+}
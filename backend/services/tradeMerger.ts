@@ -0,0 +1,164 @@
+// Trade merger - k-way merge of per-venue trade streams into one time-ordered tape per symbol
+
+import { Trade } from '../types';
+import { metrics } from './metrics';
+
+// How often held trades are checked against their deadline
+const FLUSH_INTERVAL_MS = 5;
+
+// Compact a queue once this many consumed slots sit in front of it
+const COMPACT_AFTER = 1024;
+
+const lateTrades = metrics.counter('tapeflow_merge_late_trades_total', 'Trades that arrived after the tape had moved past their timestamp', 'venue');
+const holdSeconds = metrics.histogram('tapeflow_merge_hold_seconds', 'Time a trade waited in the reorder buffer');
+
+/**
+ * One venue's pending trades for one symbol, oldest first
+ *
+ * A plain array with a moving head - shift() is O(n) and this is on the
+ * path of every trade.
+ */
+class VenueQueue {
+  trades: Trade[] = [];
+  arrivals: number[] = [];
+  head = 0;
+
+  get size(): number {
+    return this.trades.length - this.head;
+  }
+
+  peek(): Trade {
+    return this.trades[this.head];
+  }
+
+  push(trade: Trade, arrival: number): void {
+    this.trades.push(trade);
+    this.arrivals.push(arrival);
+  }
+
+  get headArrival(): number {
+    return this.arrivals[this.head];
+  }
+
+  take(): Trade {
+    const trade = this.trades[this.head++];
+    if (this.head >= COMPACT_AFTER && this.head * 2 >= this.trades.length) {
+      this.trades = this.trades.slice(this.head);
+      this.arrivals = this.arrivals.slice(this.head);
+      this.head = 0;
+    }
+    return trade;
+  }
+}
+
+interface SymbolMerge {
+  queues: (VenueQueue | null)[];   // Indexed like venues - null for venues not carrying the symbol
+  lastTimestamp: number;           // Exchange time of the last trade emitted
+}
+
+/**
+ * Merges the venues' trades for each symbol into exchange-time order
+ *
+ * Each venue's own stream is taken to be in order; across venues, network
+ * paths differ, so a trade is held until either every other venue carrying
+ * the symbol has something queued (nothing earlier can still come from
+ * them - the classic k-way merge condition), or the longest-held trade has
+ * waited reorderMs.
+ * The second rule bounds the added latency when a venue goes quiet; the
+ * price is that a venue lagging by more than reorderMs gets its trades
+ * emitted late, out of order, and counted in tapeflow_merge_late_trades_total.
+ *
+ * k is the venue count, a handful - picking the oldest head is a scan, which
+ * beats a heap at this size.
+ */
+export class TradeMerger {
+  private symbols: Map<string, SymbolMerge> = new Map();
+  private timer: NodeJS.Timeout | null = null;
+
+  constructor(
+    private readonly venues: string[],
+    private readonly reorderMs: number,
+    private readonly emit: (trade: Trade) => void
+  ) {}
+
+  /**
+   * Start merging a symbol from the given venues (indexes into venues)
+   */
+  addSymbol(symbol: string, venueIndexes: number[]): void {
+    const queues: (VenueQueue | null)[] = this.venues.map((_, i) => (venueIndexes.includes(i) ? new VenueQueue() : null));
+    this.symbols.set(symbol, { queues, lastTimestamp: 0 });
+    if (!this.timer && this.reorderMs > 0) {
+      this.timer = setInterval(() => this.flush(Date.now()), FLUSH_INTERVAL_MS);
+      this.timer.unref();
+    }
+  }
+
+  /**
+   * Stop merging a symbol - anything still held is emitted first
+   */
+  removeSymbol(symbol: string): void {
+    const merge = this.symbols.get(symbol);
+    if (!merge) return;
+    this.drain(merge, Infinity);
+    this.symbols.delete(symbol);
+    if (this.symbols.size === 0) this.stop();
+  }
+
+  push(venue: number, trade: Trade, now: number = Date.now()): void {
+    const merge = this.symbols.get(trade.symbol);
+    const queue = merge?.queues[venue];
+    // Not merged (one venue, or no reorder window): straight through
+    if (!merge || !queue || this.reorderMs <= 0) {
+      this.emit(trade);
+      return;
+    }
+    // The tape is already past it - holding it can't put it back in order
+    if (trade.timestamp < merge.lastTimestamp) {
+      lateTrades.inc(this.venues[venue]);
+      this.emit(trade);
+      return;
+    }
+    queue.push(trade, now);
+    this.drain(merge, now);
+  }
+
+  /**
+   * Emit whatever is due on every symbol
+   */
+  flush(now: number): void {
+    for (const merge of this.symbols.values()) this.drain(merge, now);
+  }
+
+  stop(): void {
+    if (this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+  }
+
+  private drain(merge: SymbolMerge, now: number): void {
+    for (;;) {
+      let oldest: VenueQueue | null = null;
+      let firstArrival = Infinity;
+      let waiting = false;
+      for (const queue of merge.queues) {
+        if (!queue) continue;
+        if (queue.size === 0) {
+          waiting = true;
+          continue;
+        }
+        if (!oldest || queue.peek().timestamp < oldest.peek().timestamp) oldest = queue;
+        firstArrival = Math.min(firstArrival, queue.headArrival);
+      }
+      if (!oldest) return;
+      // Some venue hasn't spoken - hold on until the longest-waiting trade
+      // is due, then advance the tape in order up to it
+      if (waiting && firstArrival + this.reorderMs > now) return;
+
+      if (Number.isFinite(now)) holdSeconds.observe((now - oldest.headArrival) / 1000);
+      const trade = oldest.take();
+      merge.lastTimestamp = Math.max(merge.lastTimestamp, trade.timestamp);
+      this.emit(trade);
+    }
+  }
+}
@@ -21,6 +21,15 @@ export interface Trade {
   exchange?: string;
 }
 
+/**
+ * Trades from before a subscription, oldest first - seeds the recent-trade
+ * cache, never broadcast as live prints
+ */
+export interface TradeHistory {
+  symbol: string;
+  trades: Trade[];
+}
+
 /**
  * Single price level in the order book
  * 
@@ -36,8 +45,9 @@ export interface OrderBookLevel {
 /**
  * Level 2 order book snapshot
  * 
- * Contains top N bids and asks. We fetch 20 levels from Binance which is enough
- * to calculate imbalance and visualize depth without overwhelming the UI.
+ * Contains top N bids and asks, cut from the local book the adapter keeps in
+ * sync. 20 levels is enough to calculate imbalance and visualize depth
+ * without overwhelming the UI.
  */
 export interface OrderBook {
   symbol: string;
@@ -47,6 +57,27 @@ export interface OrderBook {
   asks: OrderBookLevel[];  // Sorted low to high
   spread: number;          // Absolute: bestAsk - bestBid
   spreadPercent: number;   // Relative to mid price
+  seq?: number;            // Update ID of the local book this was cut from
+}
+
+/**
+ * Incremental order book update
+ * 
+ * Only the levels that changed, as [price, size] pairs - size 0 means the
+ * level is gone. A client applies a delta only if prevSeq matches the seq it
+ * last applied; anything else means it missed one and should ask for a resync.
+ * snapshot=true means "replace your book with these levels" (initial state or
+ * after we resynced with the exchange).
+ */
+export interface OrderBookDelta {
+  symbol: string;
+  assetType: AssetType;
+  timestamp: number;
+  seq: number;
+  prevSeq: number;
+  bids: [number, number][];
+  asks: [number, number][];
+  snapshot?: boolean;
 }
 
 /**
@@ -84,6 +115,46 @@ export interface SymbolInfo {
   error?: string;
 }
 
+export type SignalType = 'whale' | 'velocity' | 'wall' | 'spoof';
+
+/**
+ * Trading signal from the server-side signal engine
+ * 
+ * Kept compact - the client formats the text. value is USD notional for
+ * whale/wall/spoof and trades/sec for velocity; ratio is how many times the
+ * average level size a wall is, or the surge over the average trade rate.
+ */
+export interface Signal {
+  type: SignalType;
+  symbol: string;
+  timestamp: number;
+  value: number;
+  side?: 'buy' | 'sell';
+  price?: number;
+  ratio?: number;
+}
+
+/**
+ * Trades a client missed while it was behind, folded into one record
+ * 
+ * Sent in place of the individual trades once the client's socket drains.
+ * Prices are open/high/low/close over the covered trades.
+ */
+export interface TradeSummary {
+  symbol: string;
+  assetType: AssetType;
+  firstTimestamp: number;
+  lastTimestamp: number;
+  count: number;
+  volume: number;
+  buyVolume: number;
+  sellVolume: number;
+  open: number;
+  high: number;
+  low: number;
+  close: number;
+}
+
 /**
  * Interface that all exchange adapters must implement
  * 
@@ -103,12 +174,17 @@ export interface MarketDataAdapter {
   // Event handlers - register these before calling connect()
   onTrade(callback: (trade: Trade) => void): void;
   onOrderBook(callback: (orderBook: OrderBook) => void): void;
+  onOrderBookDelta(callback: (delta: OrderBookDelta) => void): void;
   onTicker(callback: (ticker: Ticker) => void): void;
   onError(callback: (error: Error) => void): void;
   onConnect(callback: () => void): void;
   onDisconnect(callback: () => void): void;
   
   validateSymbol(symbol: string): Promise<SymbolInfo>;
+  
+  // Current local book, or null until it's synced (late joiners start here)
+  getOrderBook(symbol: string, depth: number): OrderBook | null;
+  getBookSnapshot(symbol: string, depth: number): OrderBookDelta | null;
 }
 
 /**
@@ -122,14 +198,41 @@ export interface BinanceConfig {
   apiSecret?: string;
 }
 
+/**
+ * How trades are delivered to a client
+ * 
+ * - json: one ServerMessage envelope per trade (default, easy to debug)
+ * - binary: fixed-layout records, see services/binaryProtocol.ts
+ */
+export type WireEncoding = 'json' | 'binary';
+
+/**
+ * Per-subscription trade filter, sent with 'subscribe'
+ * 
+ * Applied on the server before serialization, so trades that don't pass
+ * never hit the wire. Only affects trades - book, ticker and signals are
+ * sent as usual.
+ */
+export interface TradeFilter {
+  minNotional?: number | 'whale';   // price * volume; 'whale' = the whale signal's threshold
+  side?: 'buy' | 'sell';
+  sampleRate?: number;              // Keep this share (0-1] of what passes, evenly spaced
+}
+
 /**
  * Messages the client can send to us
  */
 export interface ClientMessage {
-  type: 'subscribe' | 'unsubscribe' | 'validate' | 'ping';
+  type: 'subscribe' | 'unsubscribe' | 'validate' | 'ping' | 'resync';
   symbol?: string;
   symbols?: string[];   // For batch subscribe/unsubscribe
   assetType?: AssetType;
+  encoding?: WireEncoding;  // Negotiated on subscribe, applies to the whole connection
+  bookDeltas?: boolean;     // Opt in to 'orderbook_delta' instead of 20-level snapshots
+  maxRate?: number;         // Cap on book/ticker updates per second per symbol (0 = every update)
+  since?: number;           // Only replay cached trades newer than this on subscribe (resubscribes)
+  filter?: TradeFilter | null;  // Trade filter for these symbols - null clears it, and on an
+                                // existing subscription only the filter changes
 }
 
 /**
@@ -137,14 +240,20 @@ export interface ClientMessage {
  * 
  * The 'data' field type depends on message type:
  * - trade: Trade
+ * - trades: Trade[] (micro-batched, oldest first)
+ * - trade_history: Trade[] (recent trades sent once on subscribe, oldest first)
  * - orderbook: OrderBook  
+ * - orderbook_delta: OrderBookDelta (only to clients that asked for bookDeltas)
  * - ticker: Ticker
+ * - signal: Signal
+ * - trade_summary: TradeSummary (trades held back from a slow client)
  * - validation: SymbolInfo
  */
 export interface ServerMessage {
-  type: 'trade' | 'orderbook' | 'ticker' | 'validation' | 'error' | 'connected' | 'subscribed' | 'unsubscribed' | 'pong';
-  data?: Trade | OrderBook | Ticker | SymbolInfo | SymbolInfo[];
+  type: 'trade' | 'trades' | 'trade_history' | 'trade_summary' | 'orderbook' | 'orderbook_delta' | 'ticker' | 'signal' | 'validation' | 'error' | 'connected' | 'subscribed' | 'unsubscribed' | 'pong';
+  data?: Trade | Trade[] | TradeSummary | OrderBook | OrderBookDelta | Ticker | Signal | SymbolInfo | SymbolInfo[];
   symbol?: string;
+  symbolId?: number;    // Sent with 'subscribed' so binary frames can refer to symbols by ID
   error?: string;
   timestamp?: number;
 }
@@ -1,12 +1,12 @@
-// Trading signal detection: whale trades, velocity surges, walls, spoofs
+// Trading signal feed: whale trades, velocity surges, walls, spoofs (detected server-side)
 
 import { useState, useEffect, useRef, useCallback, memo } from 'react';
 import { cn } from '../lib/utils';
-import { subscribeToTrades, getCurrentOrderBook, getTradeRate, resetTradeRateTracker } from '../services/dataBuffer';
+import { subscribeToSignals, getTradeRate, getCurrentTicker, resetTradeRateTracker } from '../services/dataBuffer';
 import { formatPrice } from '../utils/formatters';
-import type { Trade } from '../types';
-
-type SignalType = 'whale' | 'velocity' | 'spoof' | 'wall' | 'imbalance';
+import { whaleMinFor } from '../utils/calculations';
+import { globalClock } from '../services/globalClock';
+import type { Signal, SignalType } from '../types';
 
 interface AlgoSignal {
   id: string;
@@ -21,7 +21,6 @@ interface AlgoSignal {
 
 interface AlgoSignalsProps {
   symbol: string;
-  velocitySpike?: number;
   maxSignals?: number;
   className?: string;
 }
@@ -38,9 +37,28 @@ function formatTimeShort(timestamp: number): string {
   });
 }
 
+/**
+ * Turn a compact server signal into the line we show
+ */
+function formatSignal(signal: Signal): string {
+  const price = signal.price !== undefined ? formatPrice(signal.price, 'crypto') : '';
+  switch (signal.type) {
+    case 'whale':
+      return `${signal.side === 'buy' ? 'BUY' : 'SELL'} ${formatDollarCompact(signal.value)} @ ${price}`;
+    case 'velocity': {
+      const pct = Math.round(((signal.ratio ?? 1) - 1) * 100);
+      const avg = signal.ratio ? signal.value / signal.ratio : 0;
+      return `SURGE ${signal.value}/sec (+${pct}% vs avg ${avg.toFixed(0)})`;
+    }
+    case 'wall':
+      return `${signal.side === 'buy' ? 'BID' : 'ASK'} WALL ${formatDollarCompact(signal.value)} @ ${price} (${(signal.ratio ?? 0).toFixed(1)}x avg)`;
+    case 'spoof':
+      return `${formatDollarCompact(signal.value)} ${signal.side === 'buy' ? 'Bid' : 'Ask'} Cancelled @ ${price} (No Fill)`;
+  }
+}
+
 export const AlgoSignals = memo(function AlgoSignals({
   symbol,
-  velocitySpike = 300,
   maxSignals = 50,
   className,
 }: AlgoSignalsProps) {
@@ -48,21 +66,12 @@ export const AlgoSignals = memo(function AlgoSignals({
   const [tradesPerSec, setTradesPerSec] = useState(0);
   const [avgTradesPerSec, setAvgTradesPerSec] = useState(0);
   const [currentVelocityPct, setCurrentVelocityPct] = useState(0);
+  const [whaleMin, setWhaleMin] = useState(whaleMinFor(0));
   const [isExpanded, setIsExpanded] = useState(true);
   
   const currentSymbolRef = useRef<string>(symbol);
-  const currentPriceRef = useRef<number>(0);
   const signalIdCounterRef = useRef(0);
   
-  // Dynamic thresholds: BTC uses higher values
-  const getThresholds = useCallback(() => {
-    const isBTC = currentPriceRef.current >= 50000;
-    return {
-      whaleMin: isBTC ? 250000 : 50000,
-      spoofMin: isBTC ? 300000 : 50000,
-    };
-  }, []);
-  
   // Reset on symbol change
   useEffect(() => {
     if (currentSymbolRef.current !== symbol) {
@@ -71,195 +80,50 @@ export const AlgoSignals = memo(function AlgoSignals({
       setAvgTradesPerSec(0);
       setCurrentVelocityPct(0);
       currentSymbolRef.current = symbol;
-      currentPriceRef.current = 0;
       resetTradeRateTracker(symbol);
     }
   }, [symbol]);
   
-  // Track recent volume at each price level (for spoof detection)
-  const recentVolumeRef = useRef<Map<number, { volume: number; timestamp: number }>>(new Map());
-  
   const generateSignalId = useCallback(() => {
     signalIdCounterRef.current++;
     return `signal-${Date.now()}-${signalIdCounterRef.current}`;
   }, []);
   
-  const addSignal = useCallback((signal: Omit<AlgoSignal, 'id' | 'timestamp'>) => {
-    setSignals(prev => [{ ...signal, id: generateSignalId(), timestamp: Date.now() }, ...prev].slice(0, maxSignals));
-  }, [generateSignalId, maxSignals]);
-  
-  // Whale detection via trade subscription + track volume per price for spoof detection
+  // Signals arrive from the backend signal engine, already detected once per
+  // symbol for every client - this panel only formats and lists them
   useEffect(() => {
     const upperSymbol = symbol.toUpperCase();
-    const unsubscribe = subscribeToTrades((trade: Trade) => {
-      if (trade.symbol.toUpperCase() !== upperSymbol) return;
-      currentPriceRef.current = trade.price;
-      
-      // Track volume at this price level (for spoof vs filled detection)
-      const now = Date.now();
-      const existing = recentVolumeRef.current.get(trade.price);
-      recentVolumeRef.current.set(trade.price, {
-        volume: (existing?.volume || 0) + trade.volume,
-        timestamp: now,
-      });
-      
-      const tradeValue = trade.price * trade.volume;
-      const { whaleMin } = getThresholds();
-      
-      if (tradeValue >= whaleMin) {
-        const sideText = trade.side === 'buy' ? 'BUY' : trade.side === 'sell' ? 'SELL' : '';
-        addSignal({
-          type: 'whale',
-          symbol: trade.symbol,
-          message: `${sideText} ${formatDollarCompact(tradeValue)} @ ${formatPrice(trade.price, 'crypto')}`,
-          value: tradeValue,
-          side: trade.side === 'buy' ? 'buy' : trade.side === 'sell' ? 'sell' : undefined,
-          price: trade.price,
-        });
-      }
+    return subscribeToSignals((signal: Signal) => {
+      if (signal.symbol.toUpperCase() !== upperSymbol) return;
+      const entry: AlgoSignal = {
+        id: generateSignalId(),
+        type: signal.type,
+        symbol: signal.symbol,
+        message: formatSignal(signal),
+        value: signal.value,
+        side: signal.side,
+        timestamp: signal.timestamp,
+        price: signal.price,
+      };
+      setSignals(prev => [entry, ...prev].slice(0, maxSignals));
     });
-    return () => unsubscribe();
-  }, [symbol, addSignal, getThresholds]);
+  }, [symbol, generateSignalId, maxSignals]);
   
-  // Velocity detection (1s interval)
+  // Header readouts (1s, right after the rate sample)
   useEffect(() => {
-    const interval = setInterval(() => {
-      // Clean up stale volume data (older than 2s)
-      const now = Date.now();
-      recentVolumeRef.current.forEach((data, price) => {
-        if (now - data.timestamp > 2000) {
-          recentVolumeRef.current.delete(price);
-        }
-      });
-      
+    return globalClock.schedule(() => {
       const rateStats = getTradeRate(symbol);
       setTradesPerSec(rateStats.current);
       setAvgTradesPerSec(rateStats.avg);
+      setWhaleMin(whaleMinFor(getCurrentTicker(symbol)?.lastPrice ?? 0));
       
       if (rateStats.history.length >= 3 && rateStats.avg > 0) {
-        const velocityPct = ((rateStats.current - rateStats.avg) / rateStats.avg) * 100;
-        setCurrentVelocityPct(Math.round(velocityPct));
-        
-        if (rateStats.avg > 5 && rateStats.current > rateStats.avg * (1 + velocitySpike / 100)) {
-          addSignal({
-            type: 'velocity',
-            symbol,
-            message: `SURGE ${rateStats.current}/sec (+${Math.round(velocityPct)}% vs avg ${rateStats.avg.toFixed(0)})`,
-            value: rateStats.current,
-          });
-        }
+        setCurrentVelocityPct(Math.round(((rateStats.current - rateStats.avg) / rateStats.avg) * 100));
       } else {
         setCurrentVelocityPct(0);
       }
-    }, 1000);
-    return () => clearInterval(interval);
-  }, [symbol, velocitySpike, addSignal]);
-  
-  // Wall and spoof detection (500ms interval on order book)
-  const prevOrderBookRef = useRef<{
-    bids: Map<number, { size: number; timestamp: number }>;
-    asks: Map<number, { size: number; timestamp: number }>;
-    avgBidSize: number;
-    avgAskSize: number;
-  } | null>(null);
-  
-  useEffect(() => {
-    const interval = setInterval(() => {
-      const orderBook = getCurrentOrderBook(symbol);
-      if (!orderBook || orderBook.bids.length === 0 || orderBook.asks.length === 0) return;
-      
-      const now = Date.now();
-      const avgBidSize = orderBook.bids.reduce((sum, l) => sum + l.size, 0) / orderBook.bids.length;
-      const avgAskSize = orderBook.asks.reduce((sum, l) => sum + l.size, 0) / orderBook.asks.length;
-      
-      const WALL_MULTIPLIER = 5;
-      const WALL_MIN_USD = 150000;
-      
-      const currentBids = new Map<number, { size: number; timestamp: number }>();
-      const currentAsks = new Map<number, { size: number; timestamp: number }>();
-      
-      orderBook.bids.forEach(level => currentBids.set(level.price, { size: level.size, timestamp: now }));
-      orderBook.asks.forEach(level => currentAsks.set(level.price, { size: level.size, timestamp: now }));
-      
-      // Wall detection
-      orderBook.bids.forEach(level => {
-        const wallValue = level.size * level.price;
-        if (level.size > avgBidSize * WALL_MULTIPLIER && wallValue >= WALL_MIN_USD) {
-          const prev = prevOrderBookRef.current?.bids.get(level.price);
-          if (!prev || prev.size < avgBidSize * WALL_MULTIPLIER) {
-            addSignal({
-              type: 'wall', symbol,
-              message: `BID WALL ${formatDollarCompact(wallValue)} @ ${formatPrice(level.price, 'crypto')} (${(level.size / avgBidSize).toFixed(1)}x avg)`,
-              value: wallValue, side: 'buy', price: level.price,
-            });
-          }
-        }
-      });
-      
-      orderBook.asks.forEach(level => {
-        const wallValue = level.size * level.price;
-        if (level.size > avgAskSize * WALL_MULTIPLIER && wallValue >= WALL_MIN_USD) {
-          const prev = prevOrderBookRef.current?.asks.get(level.price);
-          if (!prev || prev.size < avgAskSize * WALL_MULTIPLIER) {
-            addSignal({
-              type: 'wall', symbol,
-              message: `ASK WALL ${formatDollarCompact(wallValue)} @ ${formatPrice(level.price, 'crypto')} (${(level.size / avgAskSize).toFixed(1)}x avg)`,
-              value: wallValue, side: 'sell', price: level.price,
-            });
-          }
-        }
-      });
-      
-      // Spoof detection - only flag if order was cancelled, not filled
-      if (prevOrderBookRef.current) {
-        const { spoofMin } = getThresholds();
-        
-        prevOrderBookRef.current.bids.forEach((prevLevel, price) => {
-          const currentLevel = currentBids.get(price);
-          const spoofValue = prevLevel.size * price;
-          const sizeDrop = prevLevel.size - (currentLevel?.size || 0);
-          const tradedVolume = recentVolumeRef.current.get(price)?.volume || 0;
-          
-          // Only spoof if <10% was actually traded (rest was cancelled)
-          const wasFilled = tradedVolume >= sizeDrop * 0.1;
-          
-          if (prevLevel.size > avgBidSize * 3 && spoofValue >= spoofMin &&
-              (!currentLevel || currentLevel.size < prevLevel.size * 0.3) &&
-              now - prevLevel.timestamp < 2000 && !wasFilled) {
-            addSignal({
-              type: 'spoof', symbol,
-              message: `${formatDollarCompact(spoofValue)} Bid Cancelled @ ${formatPrice(price, 'crypto')} (No Fill)`,
-              value: spoofValue, side: 'buy', price,
-            });
-          }
-        });
-        
-        prevOrderBookRef.current.asks.forEach((prevLevel, price) => {
-          const currentLevel = currentAsks.get(price);
-          const spoofValue = prevLevel.size * price;
-          const sizeDrop = prevLevel.size - (currentLevel?.size || 0);
-          const tradedVolume = recentVolumeRef.current.get(price)?.volume || 0;
-          
-          // Only spoof if <10% was actually traded (rest was cancelled)
-          const wasFilled = tradedVolume >= sizeDrop * 0.1;
-          
-          if (prevLevel.size > avgAskSize * 3 && spoofValue >= spoofMin &&
-              (!currentLevel || currentLevel.size < prevLevel.size * 0.3) &&
-              now - prevLevel.timestamp < 2000 && !wasFilled) {
-            addSignal({
-              type: 'spoof', symbol,
-              message: `${formatDollarCompact(spoofValue)} Ask Cancelled @ ${formatPrice(price, 'crypto')} (No Fill)`,
-              value: spoofValue, side: 'sell', price,
-            });
-          }
-        });
-      }
-      
-      prevOrderBookRef.current = { bids: currentBids, asks: currentAsks, avgBidSize, avgAskSize };
-    }, 500);
-    
-    return () => { clearInterval(interval); prevOrderBookRef.current = null; };
-  }, [symbol, addSignal, getThresholds]);
+    }, { phase: 'analytics', intervalMs: 1000, name: 'signals' });
+  }, [symbol]);
   
   const getSignalStyle = (signal: AlgoSignal) => {
     switch (signal.type) {
@@ -277,7 +141,6 @@ export const AlgoSignals = memo(function AlgoSignals({
       velocity: { bg: 'bg-[#EAB308]/20', text: 'text-[#EAB308]', label: 'SURGE' },
       spoof: { bg: 'bg-[#A855F7]/20', text: 'text-[#A855F7]', label: 'SPOOF' },
       wall: { bg: 'bg-cyan-500/20', text: 'text-cyan-400', label: 'WALL' },
-      imbalance: { bg: 'bg-purple-500/20', text: 'text-purple-400', label: 'IMB' },
     };
     const s = styles[type] || { bg: 'bg-gray-500/20', text: 'text-gray-400', label: 'INFO' };
     return <span className={`px-1.5 py-0.5 rounded text-[10px] font-bold ${s.bg} ${s.text} border border-current/30`}>{s.label}</span>;
@@ -304,7 +167,7 @@ export const AlgoSignals = memo(function AlgoSignals({
         <div className="flex items-center gap-4 px-3 py-1 bg-black border-b border-gray-800 text-xs flex-none">
           <div className="flex items-center gap-1">
             <span className="text-gray-600 font-mono">Whale:</span>
-            <span className="text-orange-500 font-mono font-bold">${(getThresholds().whaleMin / 1000).toFixed(0)}k</span>
+            <span className="text-orange-500 font-mono font-bold">${(whaleMin / 1000).toFixed(0)}k</span>
           </div>
           <div className="flex items-center gap-1">
             <span className="text-gray-600 font-mono">Velocity:</span>
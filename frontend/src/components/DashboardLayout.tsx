@@ -4,13 +4,25 @@ import { useState, useCallback, useEffect } from 'react';
 import { cn } from '../lib/utils';
 import { TapeTable } from './TapeTable';
 import { OrderBook } from './OrderBook';
+import { DepthCanvas } from './DepthCanvas';
+import { ProfileCanvas } from './ProfileCanvas';
 import { AlgoSignals } from './AlgoSignals';
 import { SymbolSelector } from './SymbolSelector';
 import { SymbolHeader } from './SymbolHeader';
 import { SymbolTab } from './SymbolTab';
 import { RealTimeClock } from './RealTimeClock';
+import { PerfHUD } from './PerfHUD';
 import { useMarketStore } from '../stores/useMarketStore';
 import { useWebSocket } from '../hooks/useWebSocket';
+import type { BookRenderMode } from '../types';
+
+const BOOK_VIEWS: { mode: BookRenderMode; label: string }[] = [
+  { mode: 'levels', label: 'L2' },
+  { mode: 'ladder', label: 'LADDER' },
+  { mode: 'heatmap', label: 'HEATMAP' },
+  { mode: 'profile', label: 'VPROF' },
+  { mode: 'footprint', label: 'FOOTPRINT' },
+];
 
 const PlusIcon = () => (
   <svg className="w-4 h-4" fill="none" stroke="currentColor" viewBox="0 0 24 24">
@@ -84,7 +96,6 @@ export function DashboardLayout() {
 
   const { isConnected, connectionError, reconnect } = useWebSocket();
 
-  const symbols = useMarketStore((state) => state.symbols);
   const tabs = useMarketStore((state) => state.tabs);
   const selectedSymbol = useMarketStore((state) => state.selectedSymbol);
   const selectSymbol = useMarketStore((state) => state.selectSymbol);
@@ -94,7 +105,8 @@ export function DashboardLayout() {
   const combinedTrades = useMarketStore((state) => state.combinedTrades);
   const clearTrades = useMarketStore((state) => state.clearTrades);
 
-  const currentSymbolData = selectedSymbol ? symbols.get(selectedSymbol) : null;
+  // Just the selected entry - a trade or book for another symbol doesn't re-render the shell
+  const currentSymbolData = useMarketStore((state) => (selectedSymbol ? state.symbols.get(selectedSymbol) : undefined));
   const orderBookWidth = Math.min(Math.max(windowSize.width * 0.35, 400), 600);
 
   const handlePopout = useCallback((symbol: string) => {
@@ -239,8 +251,9 @@ export function DashboardLayout() {
               <TapeTable
                 trades={combinedTrades}
                 assetType="crypto"
+                combined
                 pauseScroll={settings.pauseScroll}
-                showAnalytics={true}
+                showAnalytics={!settings.combinedMinNotional}
               />
             </div>
           </div>
@@ -253,7 +266,6 @@ export function DashboardLayout() {
                     symbol={currentSymbolData.symbol}
                     name={currentSymbolData.name}
                     assetType={currentSymbolData.assetType}
-                    lastPrice={currentSymbolData.lastPrice}
                   />
                   <div className="flex-1 overflow-hidden">
                     <TapeTable
@@ -278,24 +290,55 @@ export function DashboardLayout() {
                   <div className="flex-none" style={{ height: '30%', minHeight: '180px' }}>
                     <AlgoSignals
                       symbol={currentSymbolData.symbol}
-                      velocitySpike={300}
                       className="h-full"
                     />
                   </div>
                   <div className="flex-1 bg-black rounded border border-gray-800 overflow-hidden flex flex-col" style={{ minHeight: '350px' }}>
-                    <div className="p-2 border-b border-gray-800">
-                      <h2 className="text-sm font-mono text-orange-500">&gt;&gt; ORDER BOOK</h2>
-                      <p className="text-xs text-gray-600 font-mono">
-                        {currentSymbolData.assetType === 'crypto' ? 'L2 Depth' : 'Quote approximation'}
-                      </p>
+                    <div className="p-2 border-b border-gray-800 flex items-start justify-between">
+                      <div>
+                        <h2 className="text-sm font-mono text-orange-500">&gt;&gt; ORDER BOOK</h2>
+                        <p className="text-xs text-gray-600 font-mono">
+                          {currentSymbolData.assetType === 'crypto' ? 'L2 Depth' : 'Quote approximation'}
+                        </p>
+                      </div>
+                      <div className="flex gap-1 font-mono text-xs">
+                        {BOOK_VIEWS.map(({ mode, label }) => (
+                          <button
+                            key={mode}
+                            onClick={() => updateSettings({ bookView: mode })}
+                            className={cn(
+                              "px-1.5 py-0.5 border rounded transition-colors",
+                              settings.bookView === mode
+                                ? "border-[#00FF41] text-[#00FF41]"
+                                : "border-gray-800 text-gray-600 hover:text-gray-400"
+                            )}
+                          >
+                            {label}
+                          </button>
+                        ))}
+                      </div>
                     </div>
                     <div className="flex-1 overflow-hidden">
-                      <OrderBook
-                        orderBook={currentSymbolData.orderBook}
-                        assetType={currentSymbolData.assetType}
-                        symbol={currentSymbolData.symbol}
-                        showHeatmap={true}
-                      />
+                      {settings.bookView === 'levels' ? (
+                        <OrderBook
+                          orderBook={currentSymbolData.orderBook}
+                          assetType={currentSymbolData.assetType}
+                          symbol={currentSymbolData.symbol}
+                          showHeatmap={true}
+                        />
+                      ) : settings.bookView === 'ladder' || settings.bookView === 'heatmap' ? (
+                        <DepthCanvas
+                          symbol={currentSymbolData.symbol}
+                          assetType={currentSymbolData.assetType}
+                          mode={settings.bookView}
+                        />
+                      ) : (
+                        <ProfileCanvas
+                          symbol={currentSymbolData.symbol}
+                          assetType={currentSymbolData.assetType}
+                          mode={settings.bookView}
+                        />
+                      )}
                     </div>
                   </div>
                 </>
@@ -315,6 +358,8 @@ export function DashboardLayout() {
         </div>
       )}
 
+      {settings.perfHud && <PerfHUD onClose={() => updateSettings({ perfHud: false })} />}
+
       {showSettings && (
         <div className="fixed inset-0 bg-black/50 flex items-center justify-center z-50 backdrop-blur-sm">
           <div className="bg-gray-900 rounded-xl border border-gray-800 p-6 w-full max-w-md">
@@ -337,6 +382,25 @@ export function DashboardLayout() {
                 </button>
               </div>
 
+              <div className="flex items-center justify-between">
+                <span className="text-gray-300">Combined Tape Min Print</span>
+                <select
+                  value={String(settings.combinedMinNotional)}
+                  onChange={(e) => updateSettings({
+                    combinedMinNotional: e.target.value === 'whale' ? 'whale' : parseInt(e.target.value),
+                  })}
+                  disabled={!settings.combinedTape}
+                  className="bg-gray-800 border border-gray-700 rounded px-3 py-1.5 text-sm disabled:opacity-50"
+                >
+                  <option value="0">All</option>
+                  <option value="1000">$1K</option>
+                  <option value="10000">$10K</option>
+                  <option value="50000">$50K</option>
+                  <option value="100000">$100K</option>
+                  <option value="whale">Whales</option>
+                </select>
+              </div>
+
               <div className="flex items-center justify-between">
                 <span className="text-gray-300">Pause Scroll</span>
                 <button
@@ -353,6 +417,38 @@ export function DashboardLayout() {
                 </button>
               </div>
 
+              <div className="flex items-center justify-between">
+                <span className="text-gray-300">Perf HUD</span>
+                <button
+                  onClick={() => updateSettings({ perfHud: !settings.perfHud })}
+                  className={cn(
+                    "w-12 h-6 rounded-full transition-colors",
+                    settings.perfHud ? "bg-blue-600" : "bg-gray-700"
+                  )}
+                >
+                  <div className={cn(
+                    "w-5 h-5 bg-white rounded-full transition-transform",
+                    settings.perfHud ? "translate-x-6" : "translate-x-0.5"
+                  )} />
+                </button>
+              </div>
+
+              <div className="flex items-center justify-between">
+                <span className="text-gray-300">Frame Rate</span>
+                <select
+                  value={String(settings.renderRate)}
+                  onChange={(e) => updateSettings({
+                    renderRate: e.target.value === 'auto' ? 'auto' : (parseInt(e.target.value) as 60 | 30 | 10),
+                  })}
+                  className="bg-gray-800 border border-gray-700 rounded px-3 py-1.5 text-sm"
+                >
+                  <option value="auto">Auto</option>
+                  <option value="60">60 fps</option>
+                  <option value="30">30 fps</option>
+                  <option value="10">10 fps</option>
+                </select>
+              </div>
+
               <div className="flex items-center justify-between">
                 <span className="text-gray-300">Max Trades in Memory</span>
                 <select
@@ -0,0 +1,369 @@
+// Canvas order book views - depth ladder and time-vs-price liquidity heatmap
+
+import { formatPrice, formatOrderBookSize } from '../utils/formatters';
+import type { AssetType } from '../types';
+import { getLocalOrderBook } from '../services/dataBuffer';
+import type { LocalOrderBook } from '../services/localOrderBook';
+import {
+  getDepthHistory,
+  niceStep,
+  bucketOf,
+  COLUMN_BUCKETS,
+  HISTORY_COLUMNS,
+  type DepthHistory,
+  type DepthColumn,
+} from '../services/depthHistory';
+import { beginFrame, drawWaiting, useCanvasRenderer, type CanvasRenderer, type Surface } from '../lib/canvas';
+
+const BID_COLOR = '#00FF41';
+const ASK_COLOR = '#FF4545';
+const WAITING = '> Waiting for L2 data...';
+
+// Ladder
+const LADDER_ROW_PX = 14;
+const LADDER_DEPTH = 500;          // Levels per side the ladder groups into its rows
+
+// Heatmap
+const BUCKET_PX = 2;               // Screen rows per price bucket
+const AXIS_WIDTH = 72;
+const AXIS_LABELS = 8;
+
+interface DepthCanvasProps {
+  symbol: string;
+  assetType: AssetType;
+  mode: 'ladder' | 'heatmap';
+}
+
+/**
+ * Price ladder - asks above the spread, bids below, each row a price bucket
+ *
+ * Up to LADDER_DEPTH levels per side are grouped into however many rows fit,
+ * so the ladder shows walls well away from the touch. The bucket size is kept
+ * until the book's range drifts 2x from what it was sized for, so rows don't
+ * reshuffle on every update. Redraws only when depthVersion moves.
+ */
+class LadderRenderer implements CanvasRenderer {
+  private drawnVersion = -1;
+  private step = 0;
+  private bidRows = new Float64Array(0);
+  private askRows = new Float64Array(0);
+
+  constructor(private surface: Surface, private book: LocalOrderBook, private assetType: AssetType) {}
+
+  draw(_now: number, force: boolean): void {
+    const book = this.book;
+    if (!force && book.depthVersion === this.drawnVersion) return;
+    this.drawnVersion = book.depthVersion;
+
+    const bids = book.bids;
+    const asks = book.asks;
+    if (!book.synced || bids.prices.length === 0 || asks.prices.length === 0) {
+      drawWaiting(this.surface, WAITING);
+      return;
+    }
+
+    const { width, height } = this.surface;
+    const half = Math.max(1, Math.floor(height / LADDER_ROW_PX / 2));
+    if (this.bidRows.length !== half) {
+      this.bidRows = new Float64Array(half);
+      this.askRows = new Float64Array(half);
+    } else {
+      this.bidRows.fill(0);
+      this.askRows.fill(0);
+    }
+
+    const far = Math.min(LADDER_DEPTH, bids.prices.length, asks.prices.length) - 1;
+    const raw = (asks.prices[far] - bids.prices[far]) / (half * 2);
+    if (this.step === 0 || raw > this.step * 2 || raw < this.step / 2) {
+      this.step = niceStep(raw) || niceStep(bids.prices[0] * 1e-5);
+    }
+    const step = this.step;
+
+    // Row 0 on each side is the bucket holding the touch
+    const bidBase = bucketOf(bids.prices[0], step);
+    const askBase = bucketOf(asks.prices[0], step);
+    let maxRow = 0;
+    for (let i = 0; i < bids.prices.length; i++) {
+      const row = bidBase - bucketOf(bids.prices[i], step);
+      if (row >= half) break;
+      this.bidRows[row] += bids.sizes[i];
+      if (this.bidRows[row] > maxRow) maxRow = this.bidRows[row];
+    }
+    for (let i = 0; i < asks.prices.length; i++) {
+      const row = bucketOf(asks.prices[i], step) - askBase;
+      if (row >= half) break;
+      this.askRows[row] += asks.sizes[i];
+      if (this.askRows[row] > maxRow) maxRow = this.askRows[row];
+    }
+
+    const ctx = beginFrame(this.surface);
+    const mid = half * LADDER_ROW_PX;
+    const barMax = width * 0.6;
+
+    this.drawSide(ctx, this.askRows, askBase, 1, mid, maxRow, barMax, ASK_COLOR, 'rgba(255,69,69,');
+    this.drawSide(ctx, this.bidRows, bidBase, -1, mid, maxRow, barMax, BID_COLOR, 'rgba(0,255,65,');
+
+    // Spread line
+    ctx.strokeStyle = '#374151';
+    ctx.lineWidth = 1;
+    ctx.beginPath();
+    ctx.moveTo(0, mid + 0.5);
+    ctx.lineTo(width, mid + 0.5);
+    ctx.stroke();
+    const spread = asks.prices[0] - bids.prices[0];
+    ctx.fillStyle = '#000';
+    ctx.fillRect(width / 2 - 70, mid - 7, 140, 14);
+    ctx.fillStyle = '#9ca3af';
+    ctx.textAlign = 'center';
+    ctx.fillText(`SPREAD ${formatPrice(spread, this.assetType)}  STEP ${+step.toPrecision(6)}`, width / 2, mid);
+  }
+
+  private drawSide(
+    ctx: CanvasRenderingContext2D,
+    rows: Float64Array,
+    base: number,
+    direction: 1 | -1,        // Asks step up in price from the touch, bids step down
+    mid: number,
+    maxRow: number,
+    barMax: number,
+    color: string,
+    rgbaPrefix: string
+  ): void {
+    const { width } = this.surface;
+    const total = rows.reduce((sum, size) => sum + size, 0);
+    let cumulative = 0;
+
+    for (let row = 0; row < rows.length; row++) {
+      const y = direction === 1 ? mid - (row + 1) * LADDER_ROW_PX : mid + row * LADDER_ROW_PX;
+      const size = rows[row];
+      cumulative += size;
+
+      // Cumulative depth behind, this row's size in front
+      if (total > 0) {
+        ctx.fillStyle = `${rgbaPrefix}0.06)`;
+        ctx.fillRect(width - (cumulative / total) * width, y, (cumulative / total) * width, LADDER_ROW_PX);
+      }
+      if (size > 0) {
+        const barWidth = Math.max(1, (size / maxRow) * barMax);
+        ctx.fillStyle = `${rgbaPrefix}${0.15 + (size / maxRow) * 0.35})`;
+        ctx.fillRect(width - barWidth, y + 1, barWidth, LADDER_ROW_PX - 2);
+      }
+
+      const price = (base + direction * row) * this.step;
+      ctx.textAlign = 'left';
+      ctx.fillStyle = size > 0 ? color : '#374151';
+      ctx.fillText(formatPrice(price, this.assetType), 6, y + LADDER_ROW_PX / 2);
+      if (size > 0) {
+        ctx.textAlign = 'right';
+        ctx.fillStyle = '#d1d5db';
+        ctx.fillText(formatOrderBookSize(size), width - 6, y + LADDER_ROW_PX / 2);
+      }
+    }
+  }
+}
+
+/**
+ * 256-step color ramps as packed RGBA for ImageData's Uint32 view
+ * (little-endian, so the bytes are A B G R from high to low)
+ */
+function buildRamp(r: number, g: number, b: number): Uint32Array {
+  const ramp = new Uint32Array(256);
+  for (let i = 0; i < 256; i++) {
+    const t = i / 255;
+    // Black up to the side color, then toward white for the biggest walls
+    const w = t > 0.75 ? (t - 0.75) / 0.25 : 0;
+    const k = Math.min(t / 0.75, 1);
+    const rr = Math.round(r * k + (255 - r) * w);
+    const gg = Math.round(g * k + (255 - g) * w);
+    const bb = Math.round(b * k + (255 - b) * w);
+    ramp[i] = ((255 << 24) | (bb << 16) | (gg << 8) | rr) >>> 0;
+  }
+  return ramp;
+}
+
+const BID_RAMP = buildRamp(0, 255, 65);
+const ASK_RAMP = buildRamp(255, 69, 69);
+const BLANK_PIXEL = BID_RAMP[0];
+
+/**
+ * Liquidity heatmap - x is time (HISTORY_COLUMNS wide), y is price
+ *
+ * Columns are painted once into an offscreen canvas at 1px x 1 bucket. A
+ * new column shifts the offscreen image left and writes one ImageData
+ * column, then the whole thing is scaled onto the visible canvas - so a tick
+ * costs one column of pixels regardless of how much history is on screen.
+ * The offscreen image is rebuilt from the stored columns only when price
+ * walks far enough from the center that the view has to re-anchor.
+ */
+class HeatmapRenderer implements CanvasRenderer {
+  private offscreen = document.createElement('canvas');
+  private offCtx = this.offscreen.getContext('2d');
+  private columnImage: ImageData | null = null;
+  private pixels = new Uint32Array(0);
+  private viewFirstBucket = 0;
+  private viewBuckets = 0;
+  private viewStep = 0;
+  private paintedVersion = -1;
+  private scale = 1;
+
+  constructor(
+    private surface: Surface,
+    private book: LocalOrderBook,
+    private history: DepthHistory,
+    private assetType: AssetType
+  ) {
+    this.offscreen.width = HISTORY_COLUMNS;
+  }
+
+  draw(now: number, force: boolean): void {
+    const history = this.history;
+    const captured = history.capture(this.book, now);
+    if (!captured && !force) return;
+
+    const columns = history.columns;
+    const offCtx = this.offCtx;
+    if (columns.length === 0 || !offCtx) {
+      drawWaiting(this.surface, WAITING);
+      return;
+    }
+
+    const { width, height } = this.surface;
+    const plotWidth = Math.max(1, width - AXIS_WIDTH);
+    const buckets = Math.max(1, Math.floor(height / BUCKET_PX));
+    const newest = columns.get(columns.length - 1)!;
+    const midBucket = newest.firstBucket + COLUMN_BUCKETS / 2;
+    const added = history.version - this.paintedVersion;
+
+    const rebuild = force ||
+      buckets !== this.viewBuckets ||
+      history.step !== this.viewStep ||
+      added >= columns.length ||
+      Math.abs(midBucket - (this.viewFirstBucket + buckets / 2)) > buckets / 4;
+
+    if (rebuild) {
+      this.viewBuckets = buckets;
+      this.viewStep = history.step;
+      this.viewFirstBucket = midBucket - Math.floor(buckets / 2);
+      this.offscreen.height = buckets;
+      this.columnImage = offCtx.createImageData(1, buckets);
+      this.pixels = new Uint32Array(this.columnImage.data.buffer);
+      this.scale = history.peak || 1;
+      offCtx.fillStyle = '#000';
+      offCtx.fillRect(0, 0, HISTORY_COLUMNS, buckets);
+      for (let i = 0; i < columns.length; i++) {
+        this.paintColumn(columns.get(i)!, HISTORY_COLUMNS - columns.length + i);
+      }
+    } else if (added > 0) {
+      // Slide history left and paint only what's new on the right edge
+      offCtx.globalCompositeOperation = 'copy';
+      offCtx.drawImage(this.offscreen, -added, 0);
+      offCtx.globalCompositeOperation = 'source-over';
+      this.scale = history.peak || 1;
+      for (let i = columns.length - added; i < columns.length; i++) {
+        this.paintColumn(columns.get(i)!, HISTORY_COLUMNS - columns.length + i);
+      }
+    }
+    this.paintedVersion = history.version;
+
+    const ctx = beginFrame(this.surface);
+    ctx.imageSmoothingEnabled = false;
+    ctx.drawImage(this.offscreen, 0, 0, HISTORY_COLUMNS, buckets, 0, 0, plotWidth, buckets * BUCKET_PX);
+    this.drawTouch(ctx, plotWidth);
+    this.drawAxis(ctx, plotWidth, newest);
+  }
+
+  private paintColumn(column: DepthColumn, x: number): void {
+    if (!this.offCtx || !this.columnImage) return;
+    const pixels = this.pixels;
+    const buckets = this.viewBuckets;
+    const offset = this.viewFirstBucket - column.firstBucket;
+    const inverse = 1 / this.scale;
+
+    // Row 0 is the top of the image, i.e. the highest price
+    for (let r = 0; r < buckets; r++) {
+      const index = offset + buckets - 1 - r;
+      const v = index >= 0 && index < COLUMN_BUCKETS ? column.sizes[index] : 0;
+      if (v === 0) {
+        pixels[r] = BLANK_PIXEL;
+      } else {
+        // sqrt so mid-sized resting orders stay visible next to the walls
+        const level = Math.min(255, (Math.sqrt(Math.abs(v) * inverse) * 255) | 0);
+        pixels[r] = v > 0 ? BID_RAMP[level] : ASK_RAMP[level];
+      }
+    }
+    this.offCtx.putImageData(this.columnImage, x, 0);
+  }
+
+  private priceToY(price: number): number {
+    const bucket = price / this.viewStep - this.viewFirstBucket;
+    return (this.viewBuckets - bucket) * BUCKET_PX;
+  }
+
+  /**
+   * Best bid / best ask traces over the history
+   */
+  private drawTouch(ctx: CanvasRenderingContext2D, plotWidth: number): void {
+    const columns = this.history.columns;
+    const columnWidth = plotWidth / HISTORY_COLUMNS;
+    const start = HISTORY_COLUMNS - columns.length;
+
+    ctx.lineWidth = 1;
+    for (const side of ['bid', 'ask'] as const) {
+      ctx.strokeStyle = side === 'bid' ? BID_COLOR : ASK_COLOR;
+      ctx.beginPath();
+      for (let i = 0; i < columns.length; i++) {
+        const column = columns.get(i)!;
+        const x = (start + i + 0.5) * columnWidth;
+        const y = this.priceToY(side === 'bid' ? column.bestBid : column.bestAsk);
+        if (i === 0) ctx.moveTo(x, y);
+        else ctx.lineTo(x, y);
+      }
+      ctx.stroke();
+    }
+  }
+
+  private drawAxis(ctx: CanvasRenderingContext2D, plotWidth: number, newest: DepthColumn): void {
+    const { height } = this.surface;
+    ctx.fillStyle = '#000';
+    ctx.fillRect(plotWidth, 0, AXIS_WIDTH, height);
+    ctx.textAlign = 'left';
+    ctx.fillStyle = '#6b7280';
+
+    const spacing = height / AXIS_LABELS;
+    for (let i = 0; i < AXIS_LABELS; i++) {
+      const y = (i + 0.5) * spacing;
+      const bucket = this.viewFirstBucket + this.viewBuckets - y / BUCKET_PX;
+      ctx.fillText(formatPrice(bucket * this.viewStep, this.assetType), plotWidth + 6, y);
+    }
+
+    // Current touch, labelled on the axis
+    const mid = (newest.bestBid + newest.bestAsk) / 2;
+    const y = this.priceToY(mid);
+    ctx.fillStyle = '#111827';
+    ctx.fillRect(plotWidth, y - 7, AXIS_WIDTH, 14);
+    ctx.fillStyle = '#fff';
+    ctx.fillText(formatPrice(mid, this.assetType), plotWidth + 6, y);
+  }
+}
+
+/**
+ * Order book drawn to a canvas on the shared clock tick
+ *
+ * Reads the incremental book straight from the buffer - no React state,
+ * no per-level DOM - so hundreds of levels and minutes of heatmap history
+ * cost the same per frame as the 20-level DOM view.
+ */
+export function DepthCanvas({ symbol, assetType, mode }: DepthCanvasProps) {
+  const { containerRef, canvasRef } = useCanvasRenderer((surface) => {
+    const book = getLocalOrderBook(symbol);
+    return mode === 'ladder'
+      ? new LadderRenderer(surface, book, assetType)
+      : new HeatmapRenderer(surface, book, getDepthHistory(symbol), assetType);
+  }, [symbol, assetType, mode], { name: mode });
+
+  return (
+    <div ref={containerRef} className="relative h-full w-full bg-black overflow-hidden">
+      <canvas ref={canvasRef} className="absolute inset-0" />
+    </div>
+  );
+}
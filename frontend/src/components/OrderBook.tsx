@@ -2,14 +2,19 @@
 
 import { useMemo, useEffect, useRef, useState } from 'react';
 import { cn } from '../lib/utils';
-import { formatPrice, formatOrderBookSize } from '../utils/formatters';
+import { formatPrice } from '../utils/formatters';
+import { TimeFormatter, bookSizeCache, priceCache } from '../utils/formatCache';
 import type { OrderBook as OrderBookType, OrderBookLevel, AssetType } from '../types';
-import { calculateOrderBookImbalance, getMidPrice } from '../utils/calculations';
 import { globalClock } from '../services/globalClock';
+import { recordPaint } from '../services/perfProbe';
 import { flushOrderBookBuffer } from '../services/dataBuffer';
+import { bookViewFromOrderBook, type BookView } from '../services/localOrderBook';
 
 const RENDER_INTERVAL_MS = 100;
 
+// The book's timestamp is rewritten every frame but only changes per update
+const bookTime = new TimeFormatter();
+
 interface OrderBookProps {
   orderBook: OrderBookType | null;
   assetType: AssetType;
@@ -29,12 +34,11 @@ function HeatmapBar({ intensity, side }: { intensity: number; side: 'bid' | 'ask
 }
 
 function OrderBookSide({
-  levels, side, maxSize, assetType, showHeatmap
+  levels, side, maxSize, showHeatmap
 }: {
   levels: OrderBookLevel[];
   side: 'bid' | 'ask';
   maxSize: number;
-  assetType: AssetType;
   showHeatmap: boolean;
 }) {
   const isBid = side === 'bid';
@@ -60,13 +64,13 @@ function OrderBookSide({
               {showHeatmap && <HeatmapBar intensity={intensity} side={side} />}
               {isBid ? (
                 <>
-                  <span className="text-left text-gray-400 relative z-10 tabular-nums">{formatOrderBookSize(level.size)}</span>
-                  <span className="text-right text-[#00FF41] font-medium relative z-10 tabular-nums">{formatPrice(level.price, assetType)}</span>
+                  <span className="text-left text-gray-400 relative z-10 tabular-nums">{bookSizeCache.get(level.size)}</span>
+                  <span className="text-right text-[#00FF41] font-medium relative z-10 tabular-nums">{priceCache.get(level.price)}</span>
                 </>
               ) : (
                 <>
-                  <span className="text-left text-[#FF4545] font-medium relative z-10 tabular-nums">{formatPrice(level.price, assetType)}</span>
-                  <span className="text-right text-gray-400 relative z-10 tabular-nums">{formatOrderBookSize(level.size)}</span>
+                  <span className="text-left text-[#FF4545] font-medium relative z-10 tabular-nums">{priceCache.get(level.price)}</span>
+                  <span className="text-right text-gray-400 relative z-10 tabular-nums">{bookSizeCache.get(level.size)}</span>
                 </>
               )}
             </div>
@@ -84,73 +88,55 @@ export function OrderBook({
   const agoRef = useRef<HTMLSpanElement>(null);
   const orderBookTimestampRef = useRef<number>(0);
   
-  const [displayOrderBook, setDisplayOrderBook] = useState<OrderBookType | null>(null);
+  // The buffer hands us a view with aggregates already computed, and only
+  // when the visible levels actually changed
+  const [displayBook, setDisplayBook] = useState<BookView | null>(null);
   const [stats, setStats] = useState({ updatesPerSecond: 0 });
   const updateCountRef = useRef(0);
   const lastStatsUpdateRef = useRef(Date.now());
   
   useEffect(() => {
     if (!symbol) return;
-    const intervalId = setInterval(() => {
-      const { orderBook: newOB, hasNewData, updateCount } = flushOrderBookBuffer(symbol);
-      if (!hasNewData || !newOB) return;
-      
-      setDisplayOrderBook(newOB);
+    return globalClock.schedule((now) => {
+      const { view, hasNewData, updateCount } = flushOrderBookBuffer(symbol, maxLevels);
       updateCountRef.current += updateCount;
-      const now = Date.now();
+      if (hasNewData && view) setDisplayBook(view);
+      
       if (now - lastStatsUpdateRef.current >= 1000) {
         setStats({ updatesPerSecond: updateCountRef.current });
         updateCountRef.current = 0;
         lastStatsUpdateRef.current = now;
       }
-    }, RENDER_INTERVAL_MS);
-    return () => clearInterval(intervalId);
-  }, [symbol]);
+    }, { phase: 'render', intervalMs: RENDER_INTERVAL_MS, name: 'book' });
+  }, [symbol, maxLevels]);
   
-  const orderBook = symbol ? displayOrderBook : externalOrderBook;
+  const externalBook = useMemo(
+    () => (!symbol && externalOrderBook ? bookViewFromOrderBook(externalOrderBook, maxLevels) : null),
+    [symbol, externalOrderBook, maxLevels]
+  );
+  const orderBook = symbol ? displayBook : externalBook;
   
   useEffect(() => {
-    if (orderBook) orderBookTimestampRef.current = orderBook.timestamp;
+    if (!orderBook) return;
+    orderBookTimestampRef.current = orderBook.timestamp;
+    recordPaint('book', orderBook.timestamp);
   }, [orderBook?.timestamp]);
   
   useEffect(() => {
-    const unsubscribe = globalClock.subscribe((now) => {
+    const unsubscribe = globalClock.schedule((now) => {
       const ts = orderBookTimestampRef.current;
       if (!ts) return;
-      if (timestampRef.current) timestampRef.current.textContent = globalClock.formatTime(ts).full;
+      if (timestampRef.current) timestampRef.current.textContent = bookTime.format(ts);
       if (agoRef.current) {
         const diff = now - ts;
         const agoText = diff < 1000 ? `${diff}ms` : diff < 60000 ? `${(diff / 1000).toFixed(1)}s` : `${Math.floor(diff / 60000)}m`;
         agoRef.current.textContent = `(${agoText} ago)`;
         agoRef.current.className = diff < 200 ? 'text-green-400 ml-2 text-xs' : diff < 1000 ? 'text-yellow-400 ml-2 text-xs' : 'text-red-400 ml-2 text-xs';
       }
-    });
+    }, { phase: 'render', priority: 'low', name: 'book clock' });
     return unsubscribe;
   }, []);
   
-  const { maxBidSize, maxAskSize, bidLevels, askLevels } = useMemo(() => {
-    if (!orderBook) return { maxBidSize: 0, maxAskSize: 0, bidLevels: [], askLevels: [] };
-    const bids = orderBook.bids.slice(0, maxLevels);
-    const asks = orderBook.asks.slice(0, maxLevels);
-    return {
-      maxBidSize: Math.max(...bids.map(l => l.size), 0),
-      maxAskSize: Math.max(...asks.map(l => l.size), 0),
-      bidLevels: bids,
-      askLevels: asks,
-    };
-  }, [orderBook, maxLevels]);
-  
-  const imbalance = useMemo(() => orderBook ? calculateOrderBookImbalance(orderBook) : 0, [orderBook]);
-  const midPrice = useMemo(() => orderBook ? getMidPrice(orderBook) : 0, [orderBook]);
-  
-  const { spread, spreadPercent } = useMemo(() => {
-    if (!orderBook || bidLevels.length === 0 || askLevels.length === 0) return { spread: 0, spreadPercent: 0 };
-    const bestBid = bidLevels[0].price;
-    const bestAsk = askLevels[0].price;
-    const s = bestAsk - bestBid;
-    return { spread: s, spreadPercent: bestBid > 0 ? (s / bestBid) * 100 : 0 };
-  }, [orderBook, bidLevels, askLevels]);
-  
   if (!orderBook) {
     return (
       <div className="flex items-center justify-center h-64 text-gray-600 bg-black">
@@ -162,6 +148,8 @@ export function OrderBook({
     );
   }
   
+  const { bids: bidLevels, asks: askLevels, maxBidSize, maxAskSize, imbalance, midPrice, spread, spreadPercent } = orderBook;
+  
   return (
     <div className="flex flex-col h-full bg-black overflow-hidden">
       {symbol && (
@@ -214,9 +202,9 @@ export function OrderBook({
       </div>
       
       <div className="flex flex-1 overflow-hidden bg-black">
-        <OrderBookSide levels={bidLevels} side="bid" maxSize={maxBidSize} assetType={assetType} showHeatmap={showHeatmap} />
+        <OrderBookSide levels={bidLevels} side="bid" maxSize={maxBidSize} showHeatmap={showHeatmap} />
         <div className="w-px bg-gray-800" />
-        <OrderBookSide levels={askLevels} side="ask" maxSize={maxAskSize} assetType={assetType} showHeatmap={showHeatmap} />
+        <OrderBookSide levels={askLevels} side="ask" maxSize={maxAskSize} showHeatmap={showHeatmap} />
       </div>
     </div>
   );
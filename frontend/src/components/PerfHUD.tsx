@@ -0,0 +1,133 @@
+// Perf HUD - frame time, per-task flush time, parse cost, heap churn and event -> paint latency
+
+import { useEffect, useState } from 'react';
+import { cn } from '../lib/utils';
+import { globalClock } from '../services/globalClock';
+import { getPerfWindow, LATENCY_BUCKETS_MS, setPerfHud, type PaintView, type PerfWindow } from '../services/perfProbe';
+
+const REFRESH_MS = 250;
+const MAX_TASKS = 8;
+
+const BUCKET_LABELS = [
+  ...LATENCY_BUCKETS_MS.map(bound => `≤${bound}`),
+  `>${LATENCY_BUCKETS_MS[LATENCY_BUCKETS_MS.length - 1]}`,
+];
+
+/**
+ * Upper bound of the bucket the given quantile falls in, or null with no samples
+ */
+function bucketQuantile(counts: number[], quantile: number): string | null {
+  const total = counts.reduce((sum, n) => sum + n, 0);
+  if (total === 0) return null;
+  let seen = 0;
+  for (let i = 0; i < counts.length; i++) {
+    seen += counts[i];
+    if (seen >= total * quantile) return BUCKET_LABELS[i];
+  }
+  return BUCKET_LABELS[BUCKET_LABELS.length - 1];
+}
+
+function LatencyHistogram({ view, counts }: { view: PaintView; counts: number[] }) {
+  const peak = Math.max(1, ...counts);
+  const p50 = bucketQuantile(counts, 0.5);
+  const p99 = bucketQuantile(counts, 0.99);
+  return (
+    <div>
+      <div className="flex justify-between text-gray-500">
+        <span>{view.toUpperCase()} → PAINT</span>
+        <span>{p50 ? `p50 ${p50} p99 ${p99}ms` : '-'}</span>
+      </div>
+      {counts.map((count, i) => (
+        <div key={i} className="flex items-center gap-1">
+          <span className="w-10 text-right text-gray-600">{BUCKET_LABELS[i]}</span>
+          <div className="flex-1 h-1.5 bg-gray-900">
+            <div
+              className={cn("h-full", i < 3 ? "bg-[#00FF41]" : i < 5 ? "bg-yellow-500" : "bg-[#FF4545]")}
+              style={{ width: `${(count / peak) * 100}%` }}
+            />
+          </div>
+          <span className="w-10 text-right text-gray-500 tabular-nums">{count}</span>
+        </div>
+      ))}
+    </div>
+  );
+}
+
+/**
+ * The HUD is the probe's on switch: timing only runs while it's mounted
+ */
+export function PerfHUD({ onClose }: { onClose: () => void }) {
+  const [stats, setStats] = useState<PerfWindow | null>(null);
+
+  useEffect(() => {
+    setPerfHud(true);
+    const stop = globalClock.schedule(() => {
+      const next = getPerfWindow();
+      setStats(prev => (prev === next ? prev : next));
+    }, { phase: 'render', priority: 'low', intervalMs: REFRESH_MS, name: 'perf hud' });
+    return () => {
+      stop();
+      setPerfHud(false);
+    };
+  }, []);
+
+  return (
+    <div className="fixed bottom-2 left-2 z-40 w-72 p-2 bg-black/90 border border-gray-800 rounded font-mono text-xs text-gray-300 space-y-2">
+      <div className="flex justify-between">
+        <span className="text-orange-500">&gt;&gt; PERF</span>
+        <button onClick={onClose} className="text-gray-600 hover:text-white">[x]</button>
+      </div>
+
+      {!stats ? (
+        <div className="text-gray-600">Sampling...</div>
+      ) : (
+        <>
+          <div className="grid grid-cols-2 gap-x-2 tabular-nums">
+            <span className="text-gray-500">FRAMES/S</span>
+            <span className="text-right">{stats.frames}</span>
+            <span className="text-gray-500">TARGET</span>
+            <span className={cn("text-right", stats.rateMode === 'auto' && stats.renderRate < 60 && "text-yellow-500")}>
+              {stats.renderRate}fps{stats.rateMode === 'auto' ? ' (auto)' : ''}
+            </span>
+            <span className="text-gray-500">FRAME AVG/MAX</span>
+            <span className={cn("text-right", stats.maxFrameInterval > 34 && "text-yellow-500")}>
+              {stats.avgFrameInterval.toFixed(1)} / {stats.maxFrameInterval.toFixed(1)}ms
+            </span>
+            <span className="text-gray-500">WORK AVG/MAX</span>
+            <span className={cn("text-right", stats.maxFrameWork > 10 && "text-yellow-500")}>
+              {stats.avgFrameWork.toFixed(2)} / {stats.maxFrameWork.toFixed(1)}ms
+            </span>
+            <span className="text-gray-500">LATE FRAMES</span>
+            <span className={cn("text-right", stats.lateFrames > 0 && "text-[#FF4545]")}>{stats.lateFrames}</span>
+            <span className="text-gray-500">PARSE</span>
+            <span className="text-right">
+              {stats.parse.totalMs.toFixed(1)}ms / {stats.parse.messages} msgs
+            </span>
+            <span className="text-gray-500">HEAP</span>
+            <span className="text-right">
+              {stats.heap ? `${stats.heap.usedMB.toFixed(0)}MB +${stats.heap.allocatedMB.toFixed(1)}/s` : 'n/a'}
+            </span>
+            <span className="text-gray-500">GC/S</span>
+            <span className="text-right">{stats.heap ? stats.heap.collections : 'n/a'}</span>
+          </div>
+
+          <div>
+            <div className="flex justify-between text-gray-500">
+              <span>TASK</span>
+              <span>MS/S · MAX</span>
+            </div>
+            {stats.tasks.slice(0, MAX_TASKS).map(task => (
+              <div key={task.name} className="flex justify-between tabular-nums">
+                <span className="truncate">{task.name} <span className="text-gray-600">×{task.runs}</span></span>
+                <span>{task.totalMs.toFixed(1)} · {task.maxMs.toFixed(1)}</span>
+              </div>
+            ))}
+          </div>
+
+          <LatencyHistogram view="tape" counts={stats.latency.tape} />
+          <LatencyHistogram view="book" counts={stats.latency.book} />
+        </>
+      )}
+    </div>
+  );
+}
@@ -0,0 +1,344 @@
+// Canvas traded-volume views - session volume profile and footprint bars
+
+import { formatPrice, formatOrderBookSize, formatVolume } from '../utils/formatters';
+import { bookSizeCache, priceCache } from '../utils/formatCache';
+import type { AssetType } from '../types';
+import { getLocalOrderBook } from '../services/dataBuffer';
+import type { LocalOrderBook } from '../services/localOrderBook';
+import { niceStep, bucketOf } from '../services/depthHistory';
+import { getSymbolProfile, type SymbolProfile, type FootprintBar } from '../services/volumeProfile';
+import { beginFrame, drawWaiting, useCanvasRenderer, type CanvasRenderer, type Surface } from '../lib/canvas';
+
+const BUY_COLOR = '#00FF41';
+const SELL_COLOR = '#FF4545';
+const POC_COLOR = '#EAB308';
+const WAITING = '> Waiting for trades...';
+
+// Profile
+const PROFILE_ROW_PX = 8;
+const LABEL_WIDTH = 72;
+const LABEL_SPACING_PX = 16;
+
+// Footprint
+const CELL_PX = 14;
+const COLUMN_PX = 104;
+const HEADER_PX = 16;
+const FOOTER_PX = 16;
+const AXIS_WIDTH = 72;
+const IMBALANCE_RATIO = 3;         // One side 3x the other marks the cell as imbalanced
+
+interface ProfileCanvasProps {
+  symbol: string;
+  assetType: AssetType;
+  mode: 'profile' | 'footprint';
+}
+
+function currentPrice(book: LocalOrderBook, profile: SymbolProfile): number {
+  if (book.synced && book.bids.prices.length > 0 && book.asks.prices.length > 0) {
+    return (book.bids.prices[0] + book.asks.prices[0]) / 2;
+  }
+  const bars = profile.bars;
+  return bars.length > 0 ? bars.get(bars.length - 1)!.close : 0;
+}
+
+function formatBarTime(timestamp: number): string {
+  return new Date(timestamp).toLocaleTimeString('en-US', { hour12: false, hour: '2-digit', minute: '2-digit' });
+}
+
+/**
+ * Session volume profile - one horizontal bar per price row, sell volume
+ * then buy volume, with the value area shaded and the POC outlined
+ *
+ * The whole traded range is grouped into however many rows fit. Redraws
+ * only when the profile's version moves.
+ */
+class ProfileRenderer implements CanvasRenderer {
+  private drawnVersion = -1;
+  private rowBuy = new Float64Array(0);
+  private rowSell = new Float64Array(0);
+
+  constructor(
+    private surface: Surface,
+    private profile: SymbolProfile,
+    private book: LocalOrderBook,
+    private assetType: AssetType
+  ) {}
+
+  draw(_now: number, force: boolean): void {
+    const profile = this.profile;
+    if (!force && profile.version === this.drawnVersion) return;
+    this.drawnVersion = profile.version;
+
+    const session = profile.session;
+    if (!session || session.isEmpty) {
+      drawWaiting(this.surface, WAITING);
+      return;
+    }
+
+    const { width, height } = this.surface;
+    const rows = Math.max(1, Math.floor(height / PROFILE_ROW_PX));
+    const first = session.firstIndex;
+    const span = session.lastIndex - first + 1;
+    const group = Math.max(1, Math.ceil(span / rows));
+    const used = Math.ceil(span / group);
+
+    if (this.rowBuy.length !== rows) {
+      this.rowBuy = new Float64Array(rows);
+      this.rowSell = new Float64Array(rows);
+    } else {
+      this.rowBuy.fill(0);
+      this.rowSell.fill(0);
+    }
+
+    let maxRow = 0;
+    for (let i = first; i <= session.lastIndex; i++) {
+      const r = Math.floor((i - first) / group);
+      this.rowBuy[r] += session.buyAt(i);
+      this.rowSell[r] += session.sellAt(i);
+    }
+    for (let r = 0; r < used; r++) {
+      const total = this.rowBuy[r] + this.rowSell[r];
+      if (total > maxRow) maxRow = total;
+    }
+
+    const lowPrice = session.priceAt(first);
+    const rowStep = session.bucketSize * group;
+    const rowOf = (price: number) => bucketOf(price - lowPrice, rowStep);
+    // Row 0 is the lowest price; a short profile sits in the middle of the panel
+    const bottom = height - Math.floor((rows - used) / 2) * PROFILE_ROW_PX;
+    const yOf = (r: number) => bottom - (r + 1) * PROFILE_ROW_PX;
+
+    const ctx = beginFrame(this.surface);
+    const barMax = Math.max(1, width - LABEL_WIDTH - 8);
+    const va = session.valueArea();
+    const vaLow = va ? rowOf(va.low) : -1;
+    const vaHigh = va ? rowOf(va.high - session.bucketSize) : -1;
+    const pocRow = va ? rowOf(va.poc) : -1;
+
+    if (va) {
+      ctx.fillStyle = 'rgba(255,255,255,0.04)';
+      ctx.fillRect(LABEL_WIDTH, yOf(vaHigh), barMax, (vaHigh - vaLow + 1) * PROFILE_ROW_PX);
+    }
+
+    for (let r = 0; r < used; r++) {
+      const sell = this.rowSell[r];
+      const buy = this.rowBuy[r];
+      if (sell + buy === 0) continue;
+      const y = yOf(r) + 1;
+      const inValueArea = r >= vaLow && r <= vaHigh;
+      const sellWidth = (sell / maxRow) * barMax;
+      const buyWidth = (buy / maxRow) * barMax;
+      ctx.fillStyle = inValueArea ? 'rgba(255,69,69,0.7)' : 'rgba(255,69,69,0.35)';
+      ctx.fillRect(LABEL_WIDTH, y, sellWidth, PROFILE_ROW_PX - 2);
+      ctx.fillStyle = inValueArea ? 'rgba(0,255,65,0.7)' : 'rgba(0,255,65,0.35)';
+      ctx.fillRect(LABEL_WIDTH + sellWidth, y, buyWidth, PROFILE_ROW_PX - 2);
+    }
+
+    if (pocRow >= 0) {
+      const total = this.rowBuy[pocRow] + this.rowSell[pocRow];
+      ctx.strokeStyle = POC_COLOR;
+      ctx.lineWidth = 1;
+      ctx.strokeRect(LABEL_WIDTH + 0.5, yOf(pocRow) + 0.5, Math.max(1, (total / maxRow) * barMax), PROFILE_ROW_PX - 1);
+    }
+
+    // Price labels, spaced so they don't overlap
+    ctx.textAlign = 'left';
+    ctx.fillStyle = '#6b7280';
+    const every = Math.max(1, Math.ceil(LABEL_SPACING_PX / PROFILE_ROW_PX));
+    for (let r = 0; r < used; r += every) {
+      ctx.fillText(priceCache.get(lowPrice + r * rowStep), 6, yOf(r) + PROFILE_ROW_PX / 2);
+    }
+
+    // Current price marker
+    const price = currentPrice(this.book, profile);
+    if (price > 0) {
+      const y = bottom - ((price - lowPrice) / rowStep) * PROFILE_ROW_PX;
+      if (y >= 0 && y <= height) {
+        ctx.strokeStyle = '#9ca3af';
+        ctx.setLineDash([3, 3]);
+        ctx.beginPath();
+        ctx.moveTo(LABEL_WIDTH, y + 0.5);
+        ctx.lineTo(width, y + 0.5);
+        ctx.stroke();
+        ctx.setLineDash([]);
+      }
+    }
+
+    if (va) {
+      ctx.fillStyle = '#000';
+      ctx.fillRect(LABEL_WIDTH, 0, width - LABEL_WIDTH, 16);
+      ctx.textAlign = 'right';
+      ctx.fillStyle = '#9ca3af';
+      ctx.fillText(
+        `POC ${formatPrice(va.poc, this.assetType)}  VA ${formatPrice(va.low, this.assetType)}-${formatPrice(va.high, this.assetType)}  VOL ${formatVolume(session.totalVolume)}`,
+        width - 6,
+        8
+      );
+    }
+  }
+}
+
+/**
+ * Footprint chart - one column per FOOTPRINT_BAR_MS bar, each cell showing
+ * sell x buy volume traded at that price inside the bar
+ *
+ * Cells are tinted by whichever side dominates and highlighted when one side
+ * is IMBALANCE_RATIO times the other; each bar's own POC cell is outlined.
+ * Rows share one price step across every visible bar so cells line up.
+ */
+class FootprintRenderer implements CanvasRenderer {
+  private drawnVersion = -1;
+  private cellBuy = new Float64Array(0);
+  private cellSell = new Float64Array(0);
+
+  constructor(private surface: Surface, private profile: SymbolProfile, private assetType: AssetType) {}
+
+  draw(_now: number, force: boolean): void {
+    const profile = this.profile;
+    if (!force && profile.version === this.drawnVersion) return;
+    this.drawnVersion = profile.version;
+
+    const bars = profile.bars;
+    const session = profile.session;
+    if (!session || bars.length === 0) {
+      drawWaiting(this.surface, WAITING);
+      return;
+    }
+
+    const { width, height } = this.surface;
+    const plotWidth = Math.max(1, width - AXIS_WIDTH);
+    const count = Math.min(bars.length, Math.max(1, Math.floor(plotWidth / COLUMN_PX)));
+    const firstBar = bars.length - count;
+
+    let low = Infinity;
+    let high = -Infinity;
+    for (let b = firstBar; b < bars.length; b++) {
+      const bar = bars.get(b)!;
+      if (bar.low < low) low = bar.low;
+      if (bar.high > high) high = bar.high;
+    }
+
+    const plotHeight = Math.max(CELL_PX, height - HEADER_PX - FOOTER_PX);
+    const rows = Math.max(1, Math.floor(plotHeight / CELL_PX));
+    const step = Math.max(session.bucketSize, niceStep((high - low) / rows) || session.bucketSize);
+    const base = bucketOf(low, step);
+    const rowCount = Math.min(rows, bucketOf(high, step) - base + 1);
+    const top = HEADER_PX + Math.floor((rows - rowCount) / 2) * CELL_PX;
+    const yOf = (r: number) => top + (rowCount - 1 - r) * CELL_PX;
+
+    if (this.cellBuy.length < rowCount) {
+      this.cellBuy = new Float64Array(rowCount);
+      this.cellSell = new Float64Array(rowCount);
+    }
+
+    const ctx = beginFrame(this.surface);
+    for (let b = firstBar; b < bars.length; b++) {
+      this.drawBar(ctx, bars.get(b)!, (b - firstBar) * COLUMN_PX, base, step, rowCount, yOf);
+    }
+
+    // Price axis
+    ctx.fillStyle = '#000';
+    ctx.fillRect(plotWidth, 0, AXIS_WIDTH, height);
+    ctx.textAlign = 'left';
+    ctx.fillStyle = '#6b7280';
+    const every = Math.max(1, Math.ceil(LABEL_SPACING_PX / CELL_PX));
+    for (let r = 0; r < rowCount; r += every) {
+      ctx.fillText(priceCache.get((base + r) * step), plotWidth + 6, yOf(r) + CELL_PX / 2);
+    }
+  }
+
+  private drawBar(
+    ctx: CanvasRenderingContext2D,
+    bar: FootprintBar,
+    x: number,
+    base: number,
+    step: number,
+    rowCount: number,
+    yOf: (r: number) => number
+  ): void {
+    const { height } = this.surface;
+    const cellBuy = this.cellBuy;
+    const cellSell = this.cellSell;
+    cellBuy.fill(0, 0, rowCount);
+    cellSell.fill(0, 0, rowCount);
+
+    const fp = bar.profile;
+    for (let i = fp.firstIndex; i >= 0 && i <= fp.lastIndex; i++) {
+      const r = bucketOf(fp.priceAt(i), step) - base;
+      if (r < 0 || r >= rowCount) continue;
+      cellBuy[r] += fp.buyAt(i);
+      cellSell[r] += fp.sellAt(i);
+    }
+
+    let maxCell = 0;
+    let pocRow = -1;
+    for (let r = 0; r < rowCount; r++) {
+      const total = cellBuy[r] + cellSell[r];
+      if (total > maxCell) {
+        maxCell = total;
+        pocRow = r;
+      }
+    }
+
+    const cellWidth = COLUMN_PX - 4;
+    ctx.textAlign = 'center';
+    for (let r = 0; r < rowCount; r++) {
+      const buy = cellBuy[r];
+      const sell = cellSell[r];
+      if (buy + sell === 0) continue;
+      const y = yOf(r);
+      const strength = 0.08 + ((buy + sell) / maxCell) * 0.3;
+      ctx.fillStyle = buy >= sell ? `rgba(0,255,65,${strength})` : `rgba(255,69,69,${strength})`;
+      ctx.fillRect(x + 4, y + 1, cellWidth, CELL_PX - 2);
+
+      const imbalance = buy > sell * IMBALANCE_RATIO ? 'buy' : sell > buy * IMBALANCE_RATIO ? 'sell' : null;
+      ctx.fillStyle = imbalance === 'sell' ? SELL_COLOR : '#9ca3af';
+      ctx.fillText(bookSizeCache.get(sell), x + 4 + cellWidth * 0.27, y + CELL_PX / 2);
+      ctx.fillStyle = '#4b5563';
+      ctx.fillText('x', x + 4 + cellWidth / 2, y + CELL_PX / 2);
+      ctx.fillStyle = imbalance === 'buy' ? BUY_COLOR : '#9ca3af';
+      ctx.fillText(bookSizeCache.get(buy), x + 4 + cellWidth * 0.73, y + CELL_PX / 2);
+    }
+
+    if (pocRow >= 0) {
+      ctx.strokeStyle = POC_COLOR;
+      ctx.lineWidth = 1;
+      ctx.strokeRect(x + 4.5, yOf(pocRow) + 0.5, cellWidth - 1, CELL_PX - 1);
+    }
+
+    // Open-to-close body along the left edge
+    const clampRow = (price: number) => Math.min(rowCount - 1, Math.max(0, bucketOf(price, step) - base));
+    const openRow = clampRow(bar.open);
+    const closeRow = clampRow(bar.close);
+    ctx.fillStyle = bar.close >= bar.open ? BUY_COLOR : SELL_COLOR;
+    const bodyTop = yOf(Math.max(openRow, closeRow));
+    ctx.fillRect(x + 1, bodyTop, 2, yOf(Math.min(openRow, closeRow)) + CELL_PX - bodyTop);
+
+    ctx.fillStyle = '#6b7280';
+    ctx.fillText(formatBarTime(bar.start), x + COLUMN_PX / 2, HEADER_PX / 2);
+    ctx.fillStyle = bar.delta >= 0 ? BUY_COLOR : SELL_COLOR;
+    const delta = formatOrderBookSize(Math.abs(bar.delta));
+    ctx.fillText(`${bar.delta >= 0 ? '+' : '-'}${delta}`, x + COLUMN_PX / 2, height - FOOTER_PX / 2);
+  }
+}
+
+/**
+ * Traded volume by price, drawn to a canvas a few times a second
+ *
+ * Reads the per-symbol profile that the trade path fills, so switching to
+ * this view shows the whole session, not just what traded since it opened.
+ */
+export function ProfileCanvas({ symbol, assetType, mode }: ProfileCanvasProps) {
+  const { containerRef, canvasRef } = useCanvasRenderer((surface) => {
+    const profile = getSymbolProfile(symbol);
+    return mode === 'profile'
+      ? new ProfileRenderer(surface, profile, getLocalOrderBook(symbol), assetType)
+      : new FootprintRenderer(surface, profile, assetType);
+  }, [symbol, assetType, mode], { priority: 'low', intervalMs: 250, name: mode });
+
+  return (
+    <div ref={containerRef} className="relative h-full w-full bg-black overflow-hidden">
+      <canvas ref={canvasRef} className="absolute inset-0" />
+    </div>
+  );
+}
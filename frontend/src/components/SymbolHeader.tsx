@@ -4,46 +4,43 @@ import { useEffect, useState } from 'react';
 import { cn } from '../lib/utils';
 import { formatPrice, formatPercent, getPriceChangeColor, getAssetTypeColor, formatVolume } from '../utils/formatters';
 import type { AssetType } from '../types';
-import { flushTickerBuffer, getCurrentVwap, getLatency, resetLatencyTracker } from '../services/dataBuffer';
+import { getCurrentVwap, getLatency, resetLatencyTracker } from '../services/dataBuffer';
+import { globalClock } from '../services/globalClock';
+import { getRollingStats } from '../utils/calculations';
+import { useSymbolSlice } from '../hooks/useSymbolSlice';
 
 interface SymbolHeaderProps {
   symbol: string;
   name?: string;
   assetType: AssetType;
-  lastPrice: number;
 }
 
-export function SymbolHeader({ symbol, name, assetType, lastPrice: fallbackPrice }: SymbolHeaderProps) {
-  const [stats, setStats] = useState({
-    lastPrice: fallbackPrice, priceChange: 0, priceChangePercent: 0,
-    highPrice: 0, lowPrice: 0, vwap: 0, volume: 0,
-  });
+export function SymbolHeader({ symbol, name, assetType }: SymbolHeaderProps) {
+  // The ticker is replaced whole, so selecting it re-renders only when a new one lands
+  const ticker = useSymbolSlice(symbol, (slice) => slice.ticker);
+  const tradePrice = useSymbolSlice(symbol, (slice) => slice.lastPrice);
+  const [vwap, setVwap] = useState(0);
   const [latencyMs, setLatencyMs] = useState<number | null>(null);
+  const [windowed, setWindowed] = useState({ vwap1m: 0, realizedVol5m: 0 });
   
   useEffect(() => {
     if (!symbol) return;
     resetLatencyTracker(symbol);
     
-    const intervalId = setInterval(() => {
-      const { ticker } = flushTickerBuffer(symbol);
-      const vwap = getCurrentVwap(symbol);
-      
-      if (ticker || vwap > 0) {
-        setStats(prev => ({
-          lastPrice: ticker?.lastPrice || prev.lastPrice || fallbackPrice,
-          priceChange: ticker?.priceChange || prev.priceChange,
-          priceChangePercent: ticker?.priceChangePercent || prev.priceChangePercent,
-          highPrice: ticker?.highPrice || prev.highPrice,
-          lowPrice: ticker?.lowPrice || prev.lowPrice,
-          vwap: vwap || prev.vwap,
-          volume: ticker?.volume || prev.volume,
-        }));
-      }
+    return globalClock.schedule((now) => {
+      const sessionVwap = getCurrentVwap(symbol);
+      if (sessionVwap > 0) setVwap(sessionVwap);
       setLatencyMs(getLatency(symbol));
-    }, 100);
-    
-    return () => clearInterval(intervalId);
-  }, [symbol, fallbackPrice]);
+      
+      const oneMinute = getRollingStats(symbol, '1m', now);
+      const fiveMinutes = getRollingStats(symbol, '5m', now);
+      const vwap1m = oneMinute?.vwap ?? 0;
+      const realizedVol5m = fiveMinutes?.realizedVol ?? 0;
+      setWindowed(prev => (prev.vwap1m === vwap1m && prev.realizedVol5m === realizedVol5m
+        ? prev
+        : { vwap1m, realizedVol5m }));
+    }, { phase: 'render', priority: 'low', intervalMs: 100, name: 'header' });
+  }, [symbol]);
   
   const getLatencyColor = (latency: number | null) => {
     if (latency === null) return 'text-gray-600';
@@ -52,7 +49,12 @@ export function SymbolHeader({ symbol, name, assetType, lastPrice: fallbackPrice
     return 'text-[#FF4545]';
   };
   
-  const displayPrice = stats.lastPrice || fallbackPrice;
+  const displayPrice = ticker?.lastPrice || tradePrice;
+  const priceChange = ticker?.priceChange ?? 0;
+  const priceChangePercent = ticker?.priceChangePercent ?? 0;
+  const highPrice = ticker?.highPrice ?? 0;
+  const lowPrice = ticker?.lowPrice ?? 0;
+  const volume = ticker?.volume ?? 0;
   
   return (
     <div className="p-3 border-b border-gray-800 bg-black">
@@ -73,29 +75,39 @@ export function SymbolHeader({ symbol, name, assetType, lastPrice: fallbackPrice
         <div className="flex items-center gap-4">
           <div className="text-right">
             <div className="text-xl font-mono font-bold text-white tabular-nums">{formatPrice(displayPrice, assetType)}</div>
-            <div className={cn("text-sm font-mono tabular-nums", getPriceChangeColor(stats.priceChange))}>
-              {formatPercent(stats.priceChangePercent)}
+            <div className={cn("text-sm font-mono tabular-nums", getPriceChangeColor(priceChange))}>
+              {formatPercent(priceChangePercent)}
             </div>
           </div>
           
           <div className="text-right text-xs">
             <div className="text-gray-600 font-mono">VWAP</div>
-            <div className="font-mono text-gray-300 tabular-nums">{stats.vwap > 0 ? formatPrice(stats.vwap, assetType) : '-'}</div>
+            <div className="font-mono text-gray-300 tabular-nums">{vwap > 0 ? formatPrice(vwap, assetType) : '-'}</div>
+          </div>
+          
+          <div className="text-right text-xs">
+            <div className="text-gray-600 font-mono">VWAP 1M</div>
+            <div className="font-mono text-gray-300 tabular-nums">{windowed.vwap1m > 0 ? formatPrice(windowed.vwap1m, assetType) : '-'}</div>
+          </div>
+          
+          <div className="text-right text-xs">
+            <div className="text-gray-600 font-mono">RV 5M</div>
+            <div className="font-mono text-gray-300 tabular-nums">{windowed.realizedVol5m > 0 ? `${windowed.realizedVol5m.toFixed(3)}%` : '-'}</div>
           </div>
           
           <div className="text-right text-xs">
             <div className="text-gray-600 font-mono">HIGH</div>
-            <div className="font-mono text-[#00FF41] tabular-nums">{stats.highPrice > 0 ? formatPrice(stats.highPrice, assetType) : '-'}</div>
+            <div className="font-mono text-[#00FF41] tabular-nums">{highPrice > 0 ? formatPrice(highPrice, assetType) : '-'}</div>
           </div>
           
           <div className="text-right text-xs">
             <div className="text-gray-600 font-mono">LOW</div>
-            <div className="font-mono text-[#FF4545] tabular-nums">{stats.lowPrice > 0 ? formatPrice(stats.lowPrice, assetType) : '-'}</div>
+            <div className="font-mono text-[#FF4545] tabular-nums">{lowPrice > 0 ? formatPrice(lowPrice, assetType) : '-'}</div>
           </div>
           
           <div className="text-right text-xs">
             <div className="text-gray-600 font-mono">VOL</div>
-            <div className="font-mono text-gray-400 tabular-nums">{stats.volume > 0 ? formatVolume(stats.volume) : '-'}</div>
+            <div className="font-mono text-gray-400 tabular-nums">{volume > 0 ? formatVolume(volume) : '-'}</div>
           </div>
         </div>
       </div>
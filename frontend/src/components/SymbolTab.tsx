@@ -1,12 +1,14 @@
 // Tab button showing symbol, price, and 24hr change
 
-import { useRef, useEffect, useState } from 'react';
 import { cn } from '../lib/utils';
 import { formatPrice, formatPercent, getPriceChangeColor, getAssetTypeColor } from '../utils/formatters';
 import type { AssetType } from '../types';
-import { flushTickerBuffer } from '../services/dataBuffer';
+import { useSymbolSlice } from '../hooks/useSymbolSlice';
 
-const RENDER_INTERVAL_MS = 100;
+// The selected symbol's price ticks with its panels; the others' trades still
+// land in their buffers, the tab label just catches up once a second
+const ACTIVE_REFRESH_MS = 100;
+const INACTIVE_REFRESH_MS = 1000;
 
 interface SymbolTabProps {
   symbol: string;
@@ -41,31 +43,14 @@ export function SymbolTab({
   onClose,
   onPopout,
 }: SymbolTabProps) {
-  const [tickerData, setTickerData] = useState({
-    lastPrice: fallbackPrice,
-    priceChangePercent: fallbackChangePercent,
-  });
-  const hasReceivedTickerRef = useRef(false);
+  // The 24h ticker once it's in, the tape's last print until then
+  const { price, changePercent } = useSymbolSlice(symbol, (slice) => ({
+    price: slice.ticker?.lastPrice || slice.lastPrice,
+    changePercent: slice.ticker ? slice.ticker.priceChangePercent : null,
+  }), isActive ? ACTIVE_REFRESH_MS : INACTIVE_REFRESH_MS);
 
-  useEffect(() => {
-    if (!symbol) return;
-
-    const intervalId = setInterval(() => {
-      const { ticker } = flushTickerBuffer(symbol);
-      if (ticker) {
-        hasReceivedTickerRef.current = true;
-        setTickerData({
-          lastPrice: ticker.lastPrice,
-          priceChangePercent: ticker.priceChangePercent,
-        });
-      }
-    }, RENDER_INTERVAL_MS);
-
-    return () => clearInterval(intervalId);
-  }, [symbol]);
-
-  const displayPrice = (hasReceivedTickerRef.current ? tickerData.lastPrice : fallbackPrice) ?? 0;
-  const displayChangePercent = (hasReceivedTickerRef.current ? tickerData.priceChangePercent : fallbackChangePercent) ?? 0;
+  const displayPrice = price || fallbackPrice || 0;
+  const displayChangePercent = changePercent ?? fallbackChangePercent ?? 0;
 
   return (
     <button
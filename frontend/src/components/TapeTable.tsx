@@ -1,16 +1,27 @@
-// Real-time trade stream (tape) - renders at 60fps using buffered data
+// Real-time trade stream (tape) - windowed renderer over a fixed pool of recycled rows
 
-import { useRef, useEffect, useState, memo, useMemo } from 'react';
+import { useRef, useEffect, useLayoutEffect, useState, type ReactElement, type MouseEvent as ReactMouseEvent } from 'react';
 import { cn } from '../lib/utils';
-import { formatPrice, formatTime, getSideColor, getSideBackground } from '../utils/formatters';
+import { formatPrice, getSideColor, getSideBackground } from '../utils/formatters';
+import { FormatCache, TimeFormatter, priceCache, quantizeCompact, quantizePrice } from '../utils/formatCache';
 import type { TradeWithAnalytics, AssetType } from '../types';
-import { flushTradeBuffer, setProcessedTrades, updateVwap, clearSymbolBuffer, getTradeRate, resetTradeRateTracker } from '../services/dataBuffer';
-import { enrichTradeWithAnalytics } from '../utils/calculations';
+import { flushTradeBuffer, flushCombinedBuffer, setProcessedTrades, updateVwap, clearSymbolBuffer, getTradeRate, resetTradeRateTracker } from '../services/dataBuffer';
+import { ObjectRing } from '../services/ringBuffer';
+import { globalClock } from '../services/globalClock';
+import { recordPaint } from '../services/perfProbe';
 
-const RENDER_INTERVAL_MS = 16;  // 60fps
-const MAX_VISIBLE_ROWS = 50;
+const ROW_HEIGHT = 30;            // px - fixed, so a scroll offset maps straight to a print index
+const HISTORY_SIZE = 5000;        // Prints kept for scrollback
+const OVERSCAN_ROWS = 6;
+const DEFAULT_POOL_ROWS = 40;     // Until the container has been measured
 const WHALE_THRESHOLD_USD = 50000;
 const AGGREGATION_WINDOW_MS = 50;
+const NEW_FLASH_MS = 500;
+const AGGREGATED_FLASH_MS = 300;
+const STATS_INTERVAL_MS = 250;
+
+const NEW_FLASH_CLASSES = ['brightness-150'];
+const AGGREGATED_FLASH_CLASSES = ['ring-1', 'ring-inset', 'ring-white/40'];
 
 // Number formatters
 const volumeFormatter = new Intl.NumberFormat('en-US', { minimumFractionDigits: 0, maximumFractionDigits: 6 });
@@ -36,224 +47,480 @@ function formatCVD(value: number): string {
   return `${sign}$${abs.toLocaleString('en-US', { maximumFractionDigits: 0 })}`;
 }
 
+// Every visible cell is rewritten when a row is recycled, so the strings
+// come from caches - sizes repeat exactly, amounts, deltas and VWAP once
+// rounded to what's shown, and times only rebuild when the second changes.
+// VWAP gets its own cache: it drifts with every print and would push the
+// book's prices out of the shared one.
+const vwapCache = new FormatCache(price => formatPrice(price), quantizePrice);
+const volumeCache = new FormatCache(formatVolume);
+const amountCache = new FormatCache(formatAmount, quantizeCompact);
+const cvdCache = new FormatCache(formatCVD, value => Math.abs(value) >= 1000000 ? Math.round(value / 1000) * 1000 : Math.round(value));
+const tapeTime = new TimeFormatter();
+
 interface TapeTableProps {
   trades: TradeWithAnalytics[];
   assetType: AssetType;
   symbol?: string;
+  combined?: boolean;             // Drain the all-symbols buffer instead of one symbol's
   pauseScroll?: boolean;
   showAnalytics?: boolean;
   maxHeight?: string;
   onTradeClick?: (trade: TradeWithAnalytics) => void;
 }
 
-interface TradeRowProps {
-  trade: TradeWithAnalytics;
-  assetType: AssetType;
-  isNew: boolean;
-  isAggregated: boolean;
-  onClick?: () => void;
-  showAnalytics: boolean;
+/**
+ * One line on the tape - a trade plus any same price/side prints folded into it
+ */
+interface TapePrint {
+  trade: TradeWithAnalytics;      // First print of the run (shared upstream, never mutated)
+  volume: number;
+  timestamp: number;
+  delta: number;
+  amount: number;
+  seq: number;                    // Position in the visible list, newest highest
+  version: number;                // Bumped when a later print is folded in
+  flashUntil: number;
+  aggregatedUntil: number;
 }
 
-const TradeRow = memo(function TradeRow({ trade, assetType, onClick, showAnalytics }: TradeRowProps) {
-  const amount = trade.price * trade.volume;
-  const isWhale = amount >= WHALE_THRESHOLD_USD;
-  
-  return (
-    <div
-      onClick={onClick}
-      className={cn(
-        "flex border-b border-gray-900/50 text-sm",
-        getSideBackground(trade.side),
-        isWhale && (trade.side === 'buy' 
-          ? "!bg-[#001100] !border-l-[#00FF41] shadow-[0_0_8px_rgba(0,255,65,0.3)]" 
-          : "!bg-[#110000] !border-l-[#FF4545] shadow-[0_0_8px_rgba(255,69,69,0.3)]"),
-        onClick && "cursor-pointer hover:bg-gray-900/50"
-      )}
-    >
-      <div className="w-24 px-3 py-1.5 text-left">
-        <span className={cn("font-mono text-xs", isWhale ? "text-white font-bold" : "text-gray-300")}>
-          {formatTime(trade.timestamp)}
-        </span>
-      </div>
-      
-      <div className="w-24 px-3 py-1.5 text-right">
-        <span className={cn("font-mono", getSideColor(trade.side), isWhale ? "font-bold text-base" : "font-semibold")}>
-          {formatPrice(trade.price, assetType)}
-        </span>
-      </div>
-      
-      <div className="w-24 px-3 py-1.5 text-right">
-        <span className={cn("font-mono font-semibold", isWhale ? "text-white text-base font-bold" : "text-gray-100")}>
-          {formatVolume(trade.volume)}
-        </span>
-      </div>
-      
-      <div className="w-24 px-3 py-1.5 text-right">
-        <span className={cn("font-mono font-semibold", isWhale ? "text-white text-sm font-bold" : "text-gray-200 text-xs")}>
-          {formatAmount(amount)}
-        </span>
-      </div>
-      
-      <div className="w-16 px-3 py-1.5 text-center">
-        <span className={cn(
-          "px-2 py-0.5 rounded text-xs font-black uppercase tracking-wider",
-          trade.side === 'buy' ? 'bg-[#001100] text-[#00FF41] ring-1 ring-[#00FF41]/50' 
-            : trade.side === 'sell' ? 'bg-[#110000] text-[#FF4545] ring-1 ring-[#FF4545]/50' 
-            : 'bg-gray-900 text-gray-400'
-        )}>
-          {trade.side === 'buy' ? 'BUY' : trade.side === 'sell' ? 'SELL' : '?'}
-        </span>
-      </div>
-      
-      {showAnalytics && (
-        <>
-          <div className="w-24 px-3 py-1.5 text-right">
-            <span className="text-gray-200 font-mono font-semibold text-sm">
-              {formatPrice(trade.vwap, assetType)}
-            </span>
-          </div>
-          
-          <div className="w-24 px-3 py-1.5 text-right">
-            <span className={cn(
-              "font-mono font-semibold",
-              trade.delta > 0 ? 'text-[#00FF41]' : trade.delta < 0 ? 'text-[#FF4545]' : 'text-gray-500'
-            )}>
-              {formatCVD(trade.delta * trade.price)}
-            </span>
-          </div>
-        </>
-      )}
-    </div>
-  );
-}, (prev, next) => prev.trade.id === next.trade.id && prev.showAnalytics === next.showAnalytics);
+/**
+ * Prints for one tape: everything kept for scrollback, and the subset that
+ * passes the Min $ filter (what's actually scrolled through)
+ */
+class TapeModel {
+  private history = new ObjectRing<TapePrint>(HISTORY_SIZE);
+  private visible = new ObjectRing<TapePrint>(HISTORY_SIZE);
+  private minAmount = 0;
+  private nextSeq = 0;
+  added = 0;                      // Rows inserted at the top since the last paint
+  flashDeadline = 0;
+  dirty = true;
+
+  get count(): number {
+    return this.visible.length;
+  }
+
+  /**
+   * index 0 is the newest visible print
+   */
+  at(index: number): TapePrint | undefined {
+    return this.visible.get(this.visible.length - 1 - index);
+  }
+
+  ingest(trades: TradeWithAnalytics[], now: number, aggregate: boolean): void {
+    for (const trade of trades) {
+      const top = this.history.length > 0 ? this.history.get(this.history.length - 1) : undefined;
+
+      // Aggregate same price/side within 50ms
+      if (aggregate && top && top.trade.side === trade.side && top.trade.price === trade.price &&
+          Math.abs(trade.timestamp - top.timestamp) <= AGGREGATION_WINDOW_MS) {
+        const wasVisible = top.amount >= this.minAmount;
+        top.volume += trade.volume;
+        top.timestamp = Math.max(top.timestamp, trade.timestamp);
+        top.delta = trade.delta;
+        top.amount = top.trade.price * top.volume;
+        top.version++;
+        top.aggregatedUntil = now + AGGREGATED_FLASH_MS;
+        // Folding in can lift a run over the filter - it's still the newest print
+        if (!wasVisible && top.amount >= this.minAmount) this.show(top);
+        continue;
+      }
+
+      const print: TapePrint = {
+        trade,
+        volume: trade.volume,
+        timestamp: trade.timestamp,
+        delta: trade.delta,
+        amount: trade.price * trade.volume,
+        seq: 0,
+        version: 0,
+        // History fills in below the live edge quietly
+        flashUntil: trade.backfill ? 0 : now + NEW_FLASH_MS,
+        aggregatedUntil: 0,
+      };
+      this.history.push(print);
+      if (print.amount >= this.minAmount) this.show(print);
+    }
+    this.flashDeadline = now + NEW_FLASH_MS;
+    this.dirty = true;
+  }
 
+  setMinAmount(minAmount: number): void {
+    this.minAmount = minAmount;
+    this.visible.clear();
+    for (let i = 0; i < this.history.length; i++) {
+      const print = this.history.get(i);
+      if (print && print.amount >= minAmount) {
+        print.seq = this.nextSeq++;
+        this.visible.push(print);
+      }
+    }
+    this.added = 0;
+    this.dirty = true;
+  }
+
+  reset(): void {
+    this.history.clear();
+    this.visible.clear();
+    this.added = 0;
+    this.dirty = true;
+  }
+
+  private show(print: TapePrint): void {
+    print.seq = this.nextSeq++;
+    this.visible.push(print);
+    this.added++;
+  }
+}
+
+/**
+ * A pooled row node and what it currently shows
+ */
+interface RowSlot {
+  row: HTMLDivElement;
+  cells: HTMLSpanElement[];       // time, price, size, amount, side[, vwap, cvd]
+  print: TapePrint | null;
+  version: number;
+  offset: number;
+  styleKey: string;
+  flash: number;                  // 0 none, 1 new, 2 aggregated, -1 unknown
+  frame: number;
+}
+
+interface RowStyle {
+  row: string;
+  time: string;
+  price: string;
+  size: string;
+  amount: string;
+  badge: string;
+}
+
+const rowStyles = new Map<string, RowStyle>();
+
+/**
+ * Class strings for a row - only a handful of combinations, built once each
+ */
+function getRowStyle(key: string, side: string, isWhale: boolean, clickable: boolean): RowStyle {
+  let style = rowStyles.get(key);
+  if (style) return style;
+
+  style = {
+    row: cn(
+      "absolute inset-x-0 top-0 flex border-b border-gray-900/50 text-sm",
+      getSideBackground(side),
+      isWhale && (side === 'buy'
+        ? "!bg-[#001100] !border-l-[#00FF41] shadow-[0_0_8px_rgba(0,255,65,0.3)]"
+        : "!bg-[#110000] !border-l-[#FF4545] shadow-[0_0_8px_rgba(255,69,69,0.3)]"),
+      clickable && "cursor-pointer hover:bg-gray-900/50"
+    ),
+    time: cn("font-mono text-xs", isWhale ? "text-white font-bold" : "text-gray-300"),
+    price: cn("font-mono", getSideColor(side), isWhale ? "font-bold text-base" : "font-semibold"),
+    size: cn("font-mono font-semibold", isWhale ? "text-white text-base font-bold" : "text-gray-100"),
+    amount: cn("font-mono font-semibold", isWhale ? "text-white text-sm font-bold" : "text-gray-200 text-xs"),
+    badge: cn(
+      "px-2 py-0.5 rounded text-xs font-black uppercase tracking-wider",
+      side === 'buy' ? 'bg-[#001100] text-[#00FF41] ring-1 ring-[#00FF41]/50'
+        : side === 'sell' ? 'bg-[#110000] text-[#FF4545] ring-1 ring-[#FF4545]/50'
+        : 'bg-gray-900 text-gray-400'
+    ),
+  };
+  rowStyles.set(key, style);
+  return style;
+}
+
+const CVD_UP = 'font-mono font-semibold text-[#00FF41]';
+const CVD_DOWN = 'font-mono font-semibold text-[#FF4545]';
+const CVD_FLAT = 'font-mono font-semibold text-gray-500';
+
+/**
+ * Write a print into a recycled row - text and classes only, no React
+ */
+function writeRow(slot: RowSlot, print: TapePrint, clickable: boolean): void {
+  const { trade } = print;
+  const isWhale = print.amount >= WHALE_THRESHOLD_USD;
+  const key = `${trade.side}|${isWhale ? 1 : 0}|${clickable ? 1 : 0}`;
+  const cells = slot.cells;
+
+  if (slot.styleKey !== key) {
+    const style = getRowStyle(key, trade.side, isWhale, clickable);
+    slot.row.className = style.row;
+    cells[0].className = style.time;
+    cells[1].className = style.price;
+    cells[2].className = style.size;
+    cells[3].className = style.amount;
+    cells[4].className = style.badge;
+    slot.styleKey = key;
+    slot.flash = -1;  // className reset dropped any flash classes
+  }
+
+  cells[0].textContent = tapeTime.format(print.timestamp);
+  cells[1].textContent = priceCache.get(trade.price);
+  cells[2].textContent = volumeCache.get(print.volume);
+  cells[3].textContent = amountCache.get(print.amount);
+  cells[4].textContent = trade.side === 'buy' ? 'BUY' : trade.side === 'sell' ? 'SELL' : '?';
+
+  if (cells.length > 5) {
+    cells[5].textContent = vwapCache.get(trade.vwap);
+    cells[6].className = print.delta > 0 ? CVD_UP : print.delta < 0 ? CVD_DOWN : CVD_FLAT;
+    cells[6].textContent = cvdCache.get(print.delta * trade.price);
+  }
+
+  slot.print = print;
+  slot.version = print.version;
+}
+
+function setFlash(slot: RowSlot, flash: number): void {
+  const list = slot.row.classList;
+  if (flash === 1) list.add(...NEW_FLASH_CLASSES);
+  else list.remove(...NEW_FLASH_CLASSES);
+  if (flash === 2) list.add(...AGGREGATED_FLASH_CLASSES);
+  else list.remove(...AGGREGATED_FLASH_CLASSES);
+  slot.flash = flash;
+}
+
+/**
+ * Trade tape
+ *
+ * Prints live in a ring (HISTORY_SIZE deep) and the scroll area is a spacer
+ * of count * ROW_HEIGHT. Only a viewport's worth of row nodes exists; each
+ * print is drawn into slot seq % poolSize and positioned with a transform,
+ * so a new print costs one row's text writes plus a translate for the rows
+ * below it - however many prints are buffered.
+ */
 export function TapeTable({
   trades: externalTrades,
-  assetType,
   symbol,
+  combined = false,
   pauseScroll = false,
   showAnalytics = true,
   maxHeight = 'calc(100vh - 200px)',
   onTradeClick,
 }: TapeTableProps) {
   const containerRef = useRef<HTMLDivElement>(null);
-  const [displayTrades, setDisplayTrades] = useState<TradeWithAnalytics[]>([]);
-  const [newTradeIds, setNewTradeIds] = useState<Set<string>>(new Set());
-  const [aggregatedIds, setAggregatedIds] = useState<Set<string>>(new Set());
-  const [stats, setStats] = useState({ tradesPerSecond: 0, avgTradesPerSecond: 0, totalTrades: 0 });
+  const spacerRef = useRef<HTMLDivElement>(null);
+  const countRef = useRef<HTMLSpanElement>(null);
+  const rateRef = useRef<HTMLSpanElement>(null);
+  const avgRef = useRef<HTMLSpanElement>(null);
+  const slotsRef = useRef<RowSlot[]>([]);
+  const [model] = useState(() => new TapeModel());
+  const [poolSize, setPoolSize] = useState(DEFAULT_POOL_ROWS);
+  const [isEmpty, setIsEmpty] = useState(true);
+  const emptyRef = useRef(true);
   const [minTradeSize, setMinTradeSize] = useState(100);
-  const totalTradesRef = useRef(0);
-  
+
+  // Latest props for the clock callback without resubscribing
+  const pauseRef = useRef(pauseScroll);
+  const clickableRef = useRef(!!onTradeClick);
+  const onTradeClickRef = useRef(onTradeClick);
+  pauseRef.current = pauseScroll;
+  clickableRef.current = !!onTradeClick;
+  onTradeClickRef.current = onTradeClick;
+
+  const streaming = !!symbol || combined;
+
   // Reset on symbol change
   useEffect(() => {
+    model.reset();
+    emptyRef.current = true;
+    setIsEmpty(true);
+    if (containerRef.current) containerRef.current.scrollTop = 0;
     if (!symbol) return;
-    setDisplayTrades([]);
-    setNewTradeIds(new Set());
-    setAggregatedIds(new Set());
-    setStats({ tradesPerSecond: 0, avgTradesPerSecond: 0, totalTrades: 0 });
-    totalTradesRef.current = 0;
     resetTradeRateTracker(symbol);
     clearSymbolBuffer(symbol);
     updateVwap(symbol, 0);
     setProcessedTrades(symbol, []);
-  }, [symbol]);
+  }, [symbol, combined, model]);
 
-  // Main render loop at 60fps
+  // Externally supplied trades (newest first) - shown as given, no aggregation
   useEffect(() => {
-    if (!symbol) return;
-    
-    const intervalId = setInterval(() => {
-      const { trades: newTrades, hasNewData } = flushTradeBuffer(symbol);
-      if (!hasNewData || newTrades.length === 0) return;
-      
-      const enrichedTrades = newTrades.map(t => enrichTradeWithAnalytics(t, null));
-      
-      setDisplayTrades(prev => {
-        const result = [...prev];
-        const aggregatedTradeIds: string[] = [];
-        
-        for (const newTrade of enrichedTrades) {
-          if (result.length > 0) {
-            const top = result[0];
-            const timeDiff = Math.abs(newTrade.timestamp - top.timestamp);
-            
-            // Aggregate same price/side within 50ms
-            if (top.side === newTrade.side && top.price === newTrade.price && timeDiff <= AGGREGATION_WINDOW_MS) {
-              result[0] = {
-                ...top,
-                volume: top.volume + newTrade.volume,
-                timestamp: Math.max(top.timestamp, newTrade.timestamp),
-                delta: newTrade.delta,
-              };
-              aggregatedTradeIds.push(top.id);
-              continue;
-            }
-          }
-          result.unshift(newTrade);
+    if (streaming) return;
+    model.reset();
+    const oldestFirst: TradeWithAnalytics[] = [];
+    for (let i = externalTrades.length - 1; i >= 0; i--) oldestFirst.push(externalTrades[i]);
+    model.ingest(oldestFirst, globalClock.now(), false);
+    emptyRef.current = model.count === 0;
+    setIsEmpty(emptyRef.current);
+  }, [streaming, externalTrades, model]);
+
+  useEffect(() => {
+    model.setMinAmount(minTradeSize);
+  }, [minTradeSize, model]);
+
+  // Size the pool to the viewport
+  useEffect(() => {
+    const container = containerRef.current;
+    if (!container) return;
+    const observer = new ResizeObserver(() => {
+      setPoolSize(Math.ceil(container.clientHeight / ROW_HEIGHT) + OVERSCAN_ROWS);
+      model.dirty = true;
+    });
+    observer.observe(container);
+    return () => observer.disconnect();
+  }, [model]);
+
+  // Pick up the pooled row nodes after React (re)creates them
+  useLayoutEffect(() => {
+    const spacer = spacerRef.current;
+    if (!spacer) return;
+    slotsRef.current = Array.from(spacer.children, (row) => {
+      // Recreated slots start empty - hide whatever the node showed before
+      (row as HTMLDivElement).style.display = 'none';
+      return {
+        row: row as HTMLDivElement,
+        cells: Array.from(row.querySelectorAll('span')),
+        print: null,
+        version: -1,
+        offset: -1,
+        styleKey: '',
+        flash: -1,
+        frame: 0,
+      };
+    });
+    model.dirty = true;
+  }, [poolSize, showAnalytics, model]);
+
+  // Drain in the ingest phase, paint in the render phase
+  useEffect(() => {
+    let frame = 0;
+    let lastCount = -1;
+    let lastStats = 0;
+    let unpainted = 0;    // Oldest trade timestamp drained but not yet painted
+
+    const paint = (now: number) => {
+      const container = containerRef.current;
+      const spacer = spacerRef.current;
+      if (!container || !spacer) return;
+
+      const count = model.count;
+      if (count !== lastCount) {
+        spacer.style.height = `${count * ROW_HEIGHT}px`;
+        if (countRef.current) countRef.current.textContent = `${count} trades`;
+        lastCount = count;
+      }
+
+      // Keep what the reader is looking at in place while scrolled back (or paused)
+      if (model.added > 0) {
+        if (pauseRef.current || container.scrollTop > 0) {
+          container.scrollTop += model.added * ROW_HEIGHT;
         }
-        
-        const sorted = result.sort((a, b) => b.timestamp - a.timestamp).slice(0, MAX_VISIBLE_ROWS);
-        setProcessedTrades(symbol, sorted);
-        
-        if (sorted.length > 0 && sorted[0].vwap > 0) {
-          updateVwap(symbol, sorted[0].vwap);
+        model.added = 0;
+      }
+
+      const slots = slotsRef.current;
+      const pool = slots.length;
+      if (pool === 0) return;
+      frame++;
+
+      const first = Math.floor(container.scrollTop / ROW_HEIGHT);
+      const last = Math.min(count, first + pool);
+      for (let index = first; index < last; index++) {
+        const print = model.at(index);
+        if (!print) continue;
+        const slot = slots[print.seq % pool];
+
+        if (slot.print !== print || slot.version !== print.version) {
+          if (slot.print === null) slot.row.style.display = '';
+          writeRow(slot, print, clickableRef.current);
         }
-        
-        if (aggregatedTradeIds.length > 0) {
-          setAggregatedIds(new Set(aggregatedTradeIds));
-          setTimeout(() => setAggregatedIds(new Set()), 300);
+        const offset = index * ROW_HEIGHT;
+        if (slot.offset !== offset) {
+          slot.row.style.transform = `translateY(${offset}px)`;
+          slot.offset = offset;
         }
-        
-        return sorted;
-      });
-      
-      const newIds = new Set(enrichedTrades.map(t => t.id));
-      setNewTradeIds(newIds);
-      setTimeout(() => setNewTradeIds(new Set()), 500);
-      
-      totalTradesRef.current += newTrades.length;
-      const rateStats = getTradeRate(symbol);
-      setStats({
-        tradesPerSecond: rateStats.current,
-        avgTradesPerSecond: rateStats.avg,
-        totalTrades: totalTradesRef.current,
-      });
-    }, RENDER_INTERVAL_MS);
-    
-    return () => clearInterval(intervalId);
-  }, [symbol]);
-  
-  const tradesToDisplay = useMemo(() => {
-    const source = symbol ? displayTrades : externalTrades.slice(0, MAX_VISIBLE_ROWS);
-    if (minTradeSize <= 0) return source;
-    return source.filter(t => (t.price * t.volume) >= minTradeSize);
-  }, [symbol, displayTrades, externalTrades, minTradeSize]);
-  
-  useEffect(() => {
-    if (!pauseScroll && containerRef.current && tradesToDisplay.length > 0) {
-      containerRef.current.scrollTop = 0;
-    }
-  }, [tradesToDisplay.length, pauseScroll]);
-  
-  if (tradesToDisplay.length === 0) {
-    return (
-      <div className="flex items-center justify-center h-64 text-gray-500">
-        <div className="text-center">
-          <div className="text-4xl mb-2 text-gray-600">...</div>
-          <p>Waiting for trades...</p>
-          {symbol && <p className="text-xs mt-2 text-gray-600">Listening for {symbol}</p>}
-        </div>
+        const flash = now < print.aggregatedUntil ? 2 : now < print.flashUntil ? 1 : 0;
+        if (slot.flash !== flash) setFlash(slot, flash);
+        slot.frame = frame;
+      }
+
+      // Slots with nothing in the window this frame
+      for (const slot of slots) {
+        if (slot.frame !== frame && slot.print !== null) {
+          slot.row.style.display = 'none';
+          slot.print = null;
+        }
+      }
+    };
+
+    // Drain every frame so the upstream buffer never overflows, even when
+    // painting gets pushed back
+    const stopIngest = streaming ? globalClock.schedule((now) => {
+      // Already enriched upstream - re-running analytics here would count every trade twice
+      const { trades, hasNewData } = combined ? flushCombinedBuffer() : flushTradeBuffer(symbol!);
+      if (!hasNewData || trades.length === 0) return;
+      model.ingest(trades, now, true);
+      if (unpainted === 0) unpainted = trades[0].timestamp;
+      const newest = trades[trades.length - 1];
+      if (symbol && newest.vwap > 0) updateVwap(symbol, newest.vwap);
+      if (emptyRef.current && model.count > 0) {
+        emptyRef.current = false;
+        setIsEmpty(false);
+      }
+    }, { phase: 'ingest', priority: 'high', name: 'tape ingest' }) : null;
+
+    const stopRender = globalClock.schedule((now) => {
+      if (model.dirty || now < model.flashDeadline) {
+        model.dirty = false;
+        paint(now);
+        if (unpainted > 0) {
+          recordPaint('tape', unpainted);
+          unpainted = 0;
+        }
+      }
+
+      if (symbol && now - lastStats >= STATS_INTERVAL_MS) {
+        lastStats = now;
+        const rateStats = getTradeRate(symbol);
+        if (rateRef.current) rateRef.current.textContent = `${rateStats.current}/sec`;
+        if (avgRef.current) {
+          avgRef.current.textContent = rateStats.avg > 0 ? `(avg: ${rateStats.avg.toFixed(0)})` : '';
+        }
+      }
+    }, { phase: 'render', name: 'tape paint' });
+
+    return () => {
+      stopIngest?.();
+      stopRender();
+    };
+  }, [symbol, combined, streaming, model]);
+
+  const handleClick = (e: ReactMouseEvent<HTMLDivElement>) => {
+    const callback = onTradeClickRef.current;
+    if (!callback) return;
+    const row = (e.target as HTMLElement).closest<HTMLElement>('[data-slot]');
+    const print = row ? slotsRef.current[Number(row.dataset.slot)]?.print : null;
+    if (!print) return;
+    callback({ ...print.trade, volume: print.volume, timestamp: print.timestamp, delta: print.delta });
+  };
+
+  const rows: ReactElement[] = [];
+  for (let i = 0; i < poolSize; i++) {
+    rows.push(
+      <div key={i} data-slot={i} style={{ height: ROW_HEIGHT, display: 'none' }}>
+        <div className="w-24 px-3 flex items-center justify-start"><span /></div>
+        <div className="w-24 px-3 flex items-center justify-end"><span /></div>
+        <div className="w-24 px-3 flex items-center justify-end"><span /></div>
+        <div className="w-24 px-3 flex items-center justify-end"><span /></div>
+        <div className="w-16 px-3 flex items-center justify-center"><span /></div>
+        {showAnalytics && (
+          <>
+            <div className="w-24 px-3 flex items-center justify-end">
+              <span className="text-gray-200 font-mono font-semibold text-sm" />
+            </div>
+            <div className="w-24 px-3 flex items-center justify-end"><span /></div>
+          </>
+        )}
       </div>
     );
   }
-  
+
   return (
-    <div className="flex flex-col h-full">
+    <div className="flex flex-col h-full relative">
       {symbol && (
         <div className="flex items-center justify-between bg-gray-800/30 px-3 py-1.5 text-xs text-gray-400 border-b border-gray-800">
           <div className="flex items-center gap-4">
-            <span>{tradesToDisplay.length} trades displayed</span>
+            <span ref={countRef}>0 trades</span>
             <div className="flex items-center gap-1.5">
               <label className="text-gray-500">Min $</label>
               <input
@@ -267,14 +534,12 @@ export function TapeTable({
             </div>
           </div>
           <span className="text-green-400">
-            {stats.tradesPerSecond}/sec
-            {stats.avgTradesPerSecond > 0 && (
-              <span className="text-gray-500 ml-1">(avg: {stats.avgTradesPerSecond.toFixed(0)})</span>
-            )}
+            <span ref={rateRef}>0/sec</span>
+            <span ref={avgRef} className="text-gray-500 ml-1" />
           </span>
         </div>
       )}
-      
+
       <div className="flex bg-gray-800/50 border-b border-gray-700 sticky top-0 z-10 text-xs font-medium text-gray-400 uppercase tracking-wider">
         <div className="w-24 px-3 py-2 text-left">Time</div>
         <div className="w-24 px-3 py-2 text-right">Price</div>
@@ -288,27 +553,30 @@ export function TapeTable({
           </>
         )}
       </div>
-      
+
       <div
         ref={containerRef}
-        className="time-sales-container flex-1 overflow-y-auto"
+        className="time-sales-container flex-1 overflow-y-auto relative"
         style={{ maxHeight, scrollbarWidth: 'none', msOverflowStyle: 'none' }}
+        onScroll={() => { model.dirty = true; }}
       >
         <style>{`.time-sales-container::-webkit-scrollbar { width: 0px; background: transparent; }`}</style>
-        {tradesToDisplay.map((trade) => (
-          <TradeRow
-            key={trade.id}
-            trade={trade}
-            assetType={assetType}
-            isNew={newTradeIds.has(trade.id)}
-            isAggregated={aggregatedIds.has(trade.id)}
-            onClick={onTradeClick ? () => onTradeClick(trade) : undefined}
-            showAnalytics={showAnalytics}
-          />
-        ))}
+        <div ref={spacerRef} className="relative" onClick={handleClick}>
+          {rows}
+        </div>
+
+        {isEmpty && (
+          <div className="absolute inset-0 flex items-center justify-center text-gray-500">
+            <div className="text-center">
+              <div className="text-4xl mb-2 text-gray-600">...</div>
+              <p>Waiting for trades...</p>
+              {symbol && <p className="text-xs mt-2 text-gray-600">Listening for {symbol}</p>}
+            </div>
+          </div>
+        )}
       </div>
-      
-      {pauseScroll && tradesToDisplay.length > 0 && (
+
+      {pauseScroll && !isEmpty && (
         <div className="absolute bottom-4 right-4 bg-yellow-500/20 text-yellow-400 px-3 py-1.5 rounded-full text-xs font-medium flex items-center gap-2">
           <span className="w-2 h-2 bg-yellow-400 rounded-full animate-pulse" />
           Scroll Paused
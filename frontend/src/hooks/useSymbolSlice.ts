@@ -0,0 +1,42 @@
+// React hook for a symbol's live slice - re-renders on the frame clock, only when the selected value changes
+
+import { useEffect, useRef, useState } from 'react';
+import { shallow } from 'zustand/shallow';
+import { readSymbolSlice, type SymbolSlice } from '../services/symbolSlices';
+import { globalClock } from '../services/globalClock';
+
+const DEFAULT_INTERVAL_MS = 100;
+
+/**
+ * Select from a symbol's slice, checked once per render tick
+ *
+ * The selector only runs when the slice's version moved, and the component
+ * only re-renders when the result differs (shallowly, so selectors can
+ * return small objects). Components for other symbols never notice.
+ */
+export function useSymbolSlice<T>(
+  symbol: string,
+  select: (slice: Readonly<SymbolSlice>) => T,
+  intervalMs: number = DEFAULT_INTERVAL_MS
+): T {
+  const selectRef = useRef(select);
+  selectRef.current = select;
+  const [value, setValue] = useState(() => select(readSymbolSlice(symbol)));
+
+  useEffect(() => {
+    let seen: Readonly<SymbolSlice> | null = null;
+    let seenVersion = -1;
+    const read = () => {
+      const slice = readSymbolSlice(symbol);
+      if (slice === seen && slice.version === seenVersion) return;
+      seen = slice;
+      seenVersion = slice.version;
+      const next = selectRef.current(slice);
+      setValue(prev => (shallow(prev, next) ? prev : next));
+    };
+    read();
+    return globalClock.schedule(read, { phase: 'render', priority: 'low', intervalMs, name: 'slices' });
+  }, [symbol, intervalMs]);
+
+  return value;
+}
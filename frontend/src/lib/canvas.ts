@@ -0,0 +1,98 @@
+// Canvas panel plumbing - DPR-aware surface sized to its container, drawn on the shared clock
+
+import { useEffect, useRef, type DependencyList } from 'react';
+import { globalClock, type TaskPriority } from '../services/globalClock';
+
+export const CANVAS_FONT = '11px ui-monospace, SFMono-Regular, Menlo, monospace';
+
+export interface Surface {
+  ctx: CanvasRenderingContext2D;
+  width: number;      // CSS px
+  height: number;
+  dpr: number;
+}
+
+export interface CanvasRenderer {
+  /**
+   * Draw if anything changed (or force) - called every scheduled tick
+   */
+  draw(now: number, force: boolean): void;
+}
+
+export function beginFrame(surface: Surface): CanvasRenderingContext2D {
+  const { ctx, width, height, dpr } = surface;
+  ctx.setTransform(dpr, 0, 0, dpr, 0, 0);
+  ctx.fillStyle = '#000';
+  ctx.fillRect(0, 0, width, height);
+  ctx.font = CANVAS_FONT;
+  ctx.textBaseline = 'middle';
+  return ctx;
+}
+
+export function drawWaiting(surface: Surface, message: string): void {
+  const ctx = beginFrame(surface);
+  ctx.fillStyle = '#4b5563';
+  ctx.textAlign = 'center';
+  ctx.fillText(message, surface.width / 2, surface.height / 2);
+}
+
+interface CanvasRendererOptions {
+  priority?: TaskPriority;
+  intervalMs?: number;
+  name?: string;        // Task name in the perf HUD
+}
+
+/**
+ * Run a renderer on a canvas that tracks its container's size
+ *
+ * create() is called again whenever deps change. A resize forces the next
+ * draw; otherwise renderers decide for themselves whether anything moved.
+ */
+export function useCanvasRenderer(
+  create: (surface: Surface) => CanvasRenderer,
+  deps: DependencyList,
+  options: CanvasRendererOptions = {}
+) {
+  const containerRef = useRef<HTMLDivElement>(null);
+  const canvasRef = useRef<HTMLCanvasElement>(null);
+  const { priority, intervalMs, name } = options;
+
+  useEffect(() => {
+    const container = containerRef.current;
+    const canvas = canvasRef.current;
+    const ctx = canvas?.getContext('2d');
+    if (!container || !canvas || !ctx) return;
+
+    const surface: Surface = { ctx, width: 0, height: 0, dpr: 1 };
+    const renderer = create(surface);
+    let force = true;
+
+    const resize = () => {
+      surface.dpr = window.devicePixelRatio || 1;
+      surface.width = container.clientWidth;
+      surface.height = container.clientHeight;
+      canvas.width = Math.max(1, Math.round(surface.width * surface.dpr));
+      canvas.height = Math.max(1, Math.round(surface.height * surface.dpr));
+      canvas.style.width = `${surface.width}px`;
+      canvas.style.height = `${surface.height}px`;
+      force = true;
+    };
+    resize();
+    const observer = new ResizeObserver(resize);
+    observer.observe(container);
+
+    const unsubscribe = globalClock.schedule((now) => {
+      if (surface.width === 0 || surface.height === 0) return;
+      renderer.draw(now, force);
+      force = false;
+    }, { phase: 'render', priority, intervalMs, name });
+
+    return () => {
+      unsubscribe();
+      observer.disconnect();
+    };
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [...deps, priority, intervalMs]);
+
+  return { containerRef, canvasRef };
+}
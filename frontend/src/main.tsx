@@ -1,8 +1,16 @@
 import React from 'react';
 import ReactDOM from 'react-dom/client';
 import App from './App';
+import { installPerfProbe } from './services/perfProbe';
+import { useMarketStore } from './stores/useMarketStore';
 import './index.css';
 
+installPerfProbe((symbol) => {
+  const store = useMarketStore.getState();
+  store.subscribe(symbol, 'crypto');
+  store.addTab({ symbol, assetType: 'crypto' });
+});
+
 ReactDOM.createRoot(document.getElementById('root')!).render(
   <React.StrictMode>
     <App />
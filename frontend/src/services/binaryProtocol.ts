@@ -0,0 +1,79 @@
+// Binary trade frame decoder - mirror of backend/services/binaryProtocol.ts
+
+import type { Trade, TradeSide } from '../types';
+
+/**
+ * Frame layout (little-endian)
+ *
+ * Header (4 bytes): u8 frameType, u8 version, u16 count
+ *   frameType is FRAME_TRADES for live trades, FRAME_HISTORY for the
+ *   recent trades sent once on subscribe (same records)
+ * Trade record (36 bytes):
+ *   f64 price, f64 volume, f64 timestamp, f64 tradeId,
+ *   u16 symbolId, u8 side (0 neutral / 1 buy / 2 sell), u8 venue
+ */
+export const PROTOCOL_VERSION = 1;
+export const FRAME_TRADES = 1;
+export const FRAME_HISTORY = 2;
+export const HEADER_SIZE = 4;
+export const TRADE_RECORD_SIZE = 36;
+
+// Append only - the index is what's on the wire
+export const VENUES = ['', 'BINANCE', 'BYBIT', 'OKX', 'COINBASE'];
+
+const SIDES: TradeSide[] = ['neutral', 'buy', 'sell'];
+
+// symbolId -> symbol, filled in from 'subscribed' messages
+const symbolTable = new Map<number, string>();
+
+export function registerSymbolId(symbolId: number, symbol: string): void {
+  symbolTable.set(symbolId, symbol.toUpperCase());
+}
+
+export function resolveSymbolId(symbolId: number): string | undefined {
+  return symbolTable.get(symbolId);
+}
+
+export function isHistoryFrame(buffer: ArrayBuffer): boolean {
+  return buffer.byteLength >= HEADER_SIZE && new DataView(buffer).getUint8(0) === FRAME_HISTORY;
+}
+
+/**
+ * Decode a binary trade frame (live or history)
+ *
+ * Records for symbols we haven't seen a 'subscribed' for yet are skipped -
+ * that only happens in the gap between subscribe and its confirmation.
+ */
+export function decodeTradeFrame(buffer: ArrayBuffer): Trade[] {
+  const view = new DataView(buffer);
+  if (view.byteLength < HEADER_SIZE) return [];
+  const frameType = view.getUint8(0);
+  if ((frameType !== FRAME_TRADES && frameType !== FRAME_HISTORY) || view.getUint8(1) !== PROTOCOL_VERSION) return [];
+
+  const count = view.getUint16(2, true);
+  const trades: Trade[] = [];
+
+  for (let i = 0; i < count; i++) {
+    const offset = HEADER_SIZE + i * TRADE_RECORD_SIZE;
+    if (offset + TRADE_RECORD_SIZE > view.byteLength) break;
+
+    const symbol = symbolTable.get(view.getUint16(offset + 32, true));
+    if (!symbol) continue;
+
+    const timestamp = view.getFloat64(offset + 16, true);
+    const tradeId = view.getFloat64(offset + 24, true);
+
+    trades.push({
+      id: Number.isNaN(tradeId) ? `${timestamp}-${i}` : String(tradeId),
+      symbol,
+      assetType: 'crypto',
+      timestamp,
+      price: view.getFloat64(offset, true),
+      volume: view.getFloat64(offset + 8, true),
+      side: SIDES[view.getUint8(offset + 34)] ?? 'neutral',
+      exchange: VENUES[view.getUint8(offset + 35)] || undefined,
+    });
+  }
+
+  return trades;
+}
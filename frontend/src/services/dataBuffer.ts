@@ -1,16 +1,27 @@
 // Data buffer - decouples WebSocket from React (500+ trades/sec -> 60fps render)
 
-import type { Trade, OrderBook, Ticker, TradeWithAnalytics } from '../types';
+import type { OrderBook, OrderBookDelta, Signal, Ticker, TradeWithAnalytics } from '../types';
+import { NumberRing, ObjectRing } from './ringBuffer';
+import { LocalOrderBook, type DeltaResult } from './localOrderBook';
+import { globalClock } from './globalClock';
+import { recordProfileTrade } from './volumeProfile';
+import { readSymbolSlice, recordSliceTicker } from './symbolSlices';
 
 const MAX_BUFFER = 1000;
 const MAX_VISIBLE = 100;
+const RATE_HISTORY_SECONDS = 10;
+const LATENCY_SAMPLES = 10;
 
 // Trade rate tracking (single source of truth for all components)
+// Trades are counted as they arrive and rolled into a 10s history ring once
+// per second - O(1) per trade, no timestamp arrays to filter.
 interface RateTracker {
-  timestamps: number[];
+  pending: number;        // Trades since the last 1s tick
   current: number;
   avg: number;
-  history: number[];
+  history: NumberRing;
+  historySum: number;
+  historySnapshot: number[];  // Rebuilt once per second, handed out by getTradeRate
 }
 
 const rateTrackers = new Map<string, RateTracker>();
@@ -19,33 +30,51 @@ function getRateTracker(symbol: string): RateTracker {
   const key = symbol.toUpperCase();
   let t = rateTrackers.get(key);
   if (!t) {
-    t = { timestamps: [], current: 0, avg: 0, history: [] };
+    t = {
+      pending: 0,
+      current: 0,
+      avg: 0,
+      history: new NumberRing(RATE_HISTORY_SECONDS),
+      historySum: 0,
+      historySnapshot: [],
+    };
     rateTrackers.set(key, t);
   }
   return t;
 }
 
 function recordTradeRate(symbol: string): void {
-  getRateTracker(symbol).timestamps.push(Date.now());
+  getRateTracker(symbol).pending++;
 }
 
-function updateRates(symbol: string): void {
+function updateRates(symbol: string, elapsedMs: number): void {
   const t = getRateTracker(symbol);
-  const now = Date.now();
-  t.timestamps = t.timestamps.filter(ts => ts > now - 10000);
-  t.current = t.timestamps.filter(ts => ts > now - 1000).length;
+  // Per second of wall time - frames stop while the tab is hidden, so the
+  // first sample after it comes back can cover much more than a second
+  t.current = Math.round((t.pending * 1000) / Math.max(elapsedMs, 1000));
+  t.pending = 0;
+  
+  // Running sum: subtract the sample that's about to be overwritten
+  if (t.history.length === t.history.capacity) {
+    t.historySum -= t.history.get(0);
+  }
   t.history.push(t.current);
-  if (t.history.length > 10) t.history.shift();
-  t.avg = t.history.length ? t.history.reduce((a, b) => a + b, 0) / t.history.length : 0;
+  t.historySum += t.current;
+  t.avg = t.history.length ? t.historySum / t.history.length : 0;
+  t.historySnapshot = t.history.toArray();
 }
 
-setInterval(() => {
-  for (const sym of rateTrackers.keys()) updateRates(sym);
-}, 1000);
+let lastRateSample = Date.now();
+
+globalClock.schedule((now) => {
+  const elapsed = now - lastRateSample;
+  lastRateSample = now;
+  for (const sym of rateTrackers.keys()) updateRates(sym, elapsed);
+}, { phase: 'analytics', priority: 'high', intervalMs: 1000, name: 'rates' });
 
 export function getTradeRate(symbol: string) {
   const t = getRateTracker(symbol);
-  return { current: t.current, avg: t.avg, history: [...t.history] };
+  return { current: t.current, avg: t.avg, history: t.historySnapshot };
 }
 
 export function resetTradeRateTracker(symbol: string): void {
@@ -54,7 +83,7 @@ export function resetTradeRateTracker(symbol: string): void {
 
 // Latency tracking (uses min sample as clock offset)
 interface LatencyTracker {
-  samples: number[];
+  samples: NumberRing;
   offset: number | null;
 }
 
@@ -64,7 +93,7 @@ function getLatencyTracker(symbol: string): LatencyTracker {
   const key = symbol.toUpperCase();
   let t = latencyTrackers.get(key);
   if (!t) {
-    t = { samples: [], offset: null };
+    t = { samples: new NumberRing(LATENCY_SAMPLES), offset: null };
     latencyTrackers.set(key, t);
   }
   return t;
@@ -74,22 +103,23 @@ export function recordTradeLatency(symbol: string, tradeTimestamp: number): void
   const t = getLatencyTracker(symbol);
   const raw = Date.now() - tradeTimestamp;
   t.samples.push(raw);
-  if (t.samples.length > 10) t.samples.shift();
-  t.offset = Math.min(...t.samples);
+  t.offset = t.samples.min() ?? null;
 }
 
 export function getLatency(symbol: string): number | null {
   const t = getLatencyTracker(symbol);
-  if (!t.samples.length || t.offset === null) return null;
-  return Math.max(0, t.samples[t.samples.length - 1] - t.offset);
+  const latest = t.samples.last();
+  if (latest === undefined || t.offset === null) return null;
+  return Math.max(0, latest - t.offset);
 }
 
 export function resetLatencyTracker(symbol: string): void {
   latencyTrackers.delete(symbol.toUpperCase());
 }
 
-// Trade listeners (observer pattern for AlgoSignals)
-type TradeListener = (trade: Trade) => void;
+// Trade listeners (observer pattern for AlgoSignals) - they see the same
+// enriched trade the tapes do, never a second copy
+type TradeListener = (trade: TradeWithAnalytics) => void;
 const tradeListeners = new Set<TradeListener>();
 
 export function subscribeToTrades(listener: TradeListener): () => void {
@@ -97,15 +127,34 @@ export function subscribeToTrades(listener: TradeListener): () => void {
   return () => tradeListeners.delete(listener);
 }
 
-function notifyListeners(trade: Trade): void {
+function notifyListeners(trade: TradeWithAnalytics): void {
   for (const fn of tradeListeners) {
     try { fn(trade); } catch (e) { console.error('Listener error:', e); }
   }
 }
 
+// Signal listeners - signals are detected server-side and just fanned out here
+type SignalListener = (signal: Signal) => void;
+const signalListeners = new Set<SignalListener>();
+
+export function subscribeToSignals(listener: SignalListener): () => void {
+  signalListeners.add(listener);
+  return () => signalListeners.delete(listener);
+}
+
+export function pushSignal(signal: Signal): void {
+  for (const fn of signalListeners) {
+    try { fn(signal); } catch (e) { console.error('Listener error:', e); }
+  }
+}
+
 // Trade buffer
+// Trades land here already enriched - analytics run exactly once per trade,
+// upstream (store or ingest worker), because every enrichment call advances
+// the shared VWAP/CVD state. When the render loop falls behind, the ring
+// keeps the newest MAX_BUFFER and overwrites the oldest in O(1).
 interface TradeBuffer {
-  incoming: Trade[];
+  pending: ObjectRing<TradeWithAnalytics>;
   processed: TradeWithAnalytics[];
   hasNewData: boolean;
 }
@@ -116,31 +165,56 @@ function getTradeBuffer(symbol: string): TradeBuffer {
   const key = symbol.toUpperCase();
   let b = tradeBuffers.get(key);
   if (!b) {
-    b = { incoming: [], processed: [], hasNewData: false };
+    b = {
+      pending: new ObjectRing<TradeWithAnalytics>(MAX_BUFFER),
+      processed: [],
+      hasNewData: false,
+    };
     tradeBuffers.set(key, b);
   }
   return b;
 }
 
-export function pushTrade(trade: Trade): void {
+/**
+ * Push an enriched trade to its symbol's tape, rate/latency trackers, volume
+ * profile and listeners
+ */
+export function pushEnrichedTrade(trade: TradeWithAnalytics): void {
   const b = getTradeBuffer(trade.symbol);
-  b.incoming.push(trade);
+  b.pending.push(trade);
   b.hasNewData = true;
   recordTradeLatency(trade.symbol, trade.timestamp);
   recordTradeRate(trade.symbol);
+  recordProfileTrade(trade);
   notifyListeners(trade);
-  if (b.incoming.length > MAX_BUFFER) b.incoming.shift();
 }
 
-export function pushTrades(trades: Trade[]): void {
-  trades.forEach(pushTrade);
+/**
+ * Push subscribe-time history (enriched, oldest first) in one pass
+ * 
+ * Lands on the tape and volume profile like live trades, but skips the
+ * rate and latency trackers and the listeners - these prints are history,
+ * counting them would spike the rate and fire signals for the past.
+ */
+export function pushTradeHistory(trades: TradeWithAnalytics[]): void {
+  let b: TradeBuffer | null = null;
+  let symbol = '';
+  for (let i = 0; i < trades.length; i++) {
+    const trade = trades[i];
+    if (trade.symbol !== symbol) {
+      symbol = trade.symbol;
+      b = getTradeBuffer(symbol);
+      b.hasNewData = true;
+    }
+    b!.pending.push(trade);
+    recordProfileTrade(trade);
+  }
 }
 
 export function flushTradeBuffer(symbol: string) {
   const b = getTradeBuffer(symbol);
   if (!b.hasNewData) return { trades: [], hasNewData: false, pendingCount: 0 };
-  const trades = b.incoming.slice();
-  b.incoming = [];
+  const trades = b.pending.drain();
   b.hasNewData = false;
   return { trades, hasNewData: true, pendingCount: trades.length };
 }
@@ -153,10 +227,11 @@ export function setProcessedTrades(symbol: string, trades: TradeWithAnalytics[])
   getTradeBuffer(symbol).processed = trades.slice(0, MAX_BUFFER);
 }
 
-// Order book buffer
+// Order book buffer - one incremental book per symbol, deltas applied in place
 interface OBBuffer {
-  current: OrderBook | null;
-  hasNewData: boolean;
+  book: LocalOrderBook;
+  flushedVersion: number;
+  updateCount: number;
 }
 
 const obBuffers = new Map<string, OBBuffer>();
@@ -165,7 +240,7 @@ function getOBBuffer(symbol: string): OBBuffer {
   const key = symbol.toUpperCase();
   let b = obBuffers.get(key);
   if (!b) {
-    b = { current: null, hasNewData: false };
+    b = { book: new LocalOrderBook(key), flushedVersion: 0, updateCount: 0 };
     obBuffers.set(key, b);
   }
   return b;
@@ -173,54 +248,55 @@ function getOBBuffer(symbol: string): OBBuffer {
 
 export function pushOrderBook(orderBook: OrderBook): void {
   const b = getOBBuffer(orderBook.symbol);
-  b.current = orderBook;
-  b.hasNewData = true;
-}
-
-export function flushOrderBookBuffer(symbol: string) {
+  b.book.applyOrderBook(orderBook);
+  b.updateCount++;
+}
+
+/**
+ * Apply a server delta - 'gap' means the caller should request a resync
+ */
+export function pushOrderBookDelta(delta: OrderBookDelta): DeltaResult {
+  const b = getOBBuffer(delta.symbol);
+  const result = b.book.applyDelta(delta);
+  if (result === 'applied') b.updateCount++;
+  return result;
+}
+
+/**
+ * Aggregated top of book if it changed since the last flush
+ * 
+ * Updates below the visible levels bump updateCount but not the view, so the
+ * panel doesn't re-render for changes it wouldn't show.
+ */
+export function flushOrderBookBuffer(symbol: string, levels?: number) {
   const b = getOBBuffer(symbol);
-  if (!b.hasNewData) return { orderBook: null, hasNewData: false, updateCount: 0 };
-  b.hasNewData = false;
-  return { orderBook: b.current, hasNewData: true, updateCount: 1 };
+  const updateCount = b.updateCount;
+  b.updateCount = 0;
+  if (!b.book.synced || b.book.version === b.flushedVersion) {
+    return { view: null, hasNewData: false, updateCount };
+  }
+  b.flushedVersion = b.book.version;
+  return { view: b.book.view(levels), hasNewData: true, updateCount };
 }
 
 export function getCurrentOrderBook(symbol: string): OrderBook | null {
-  return getOBBuffer(symbol).current;
+  const { book } = getOBBuffer(symbol);
+  return book.synced ? book.toOrderBook() : null;
 }
 
-// Ticker buffer
-interface TickerBuffer {
-  current: Ticker | null;
-  hasNewData: boolean;
-}
-
-const tickerBuffers = new Map<string, TickerBuffer>();
-
-function getTickerBuffer(symbol: string): TickerBuffer {
-  const key = symbol.toUpperCase();
-  let b = tickerBuffers.get(key);
-  if (!b) {
-    b = { current: null, hasNewData: false };
-    tickerBuffers.set(key, b);
-  }
-  return b;
+export function getLocalOrderBook(symbol: string): LocalOrderBook {
+  return getOBBuffer(symbol).book;
 }
 
+// Ticker - lives on the symbol's slice, where every reader (tab, header)
+// picks up a new one by version. A consume-on-read flag here meant only the
+// first reader each frame ever saw it.
 export function pushTicker(ticker: Ticker): void {
-  const b = getTickerBuffer(ticker.symbol);
-  b.current = ticker;
-  b.hasNewData = true;
-}
-
-export function flushTickerBuffer(symbol: string) {
-  const b = getTickerBuffer(symbol);
-  if (!b.hasNewData) return { ticker: b.current, hasNewData: false };
-  b.hasNewData = false;
-  return { ticker: b.current, hasNewData: true };
+  recordSliceTicker(ticker);
 }
 
 export function getCurrentTicker(symbol: string): Ticker | null {
-  return getTickerBuffer(symbol).current;
+  return readSymbolSlice(symbol).ticker;
 }
 
 // VWAP
@@ -234,44 +310,39 @@ export function getCurrentVwap(symbol: string): number {
   return vwapValues.get(symbol.toUpperCase()) || 0;
 }
 
-// Combined tape (all symbols)
-const combinedTrades: TradeWithAnalytics[] = [];
+// Combined tape (all symbols) - drained by the tape each frame like the
+// per-symbol buffers; the tape keeps its own scrollback
+const combinedTrades = new ObjectRing<TradeWithAnalytics>(MAX_BUFFER);
 
 export function pushToCombinedBuffer(trade: TradeWithAnalytics): void {
-  combinedTrades.unshift(trade);
-  if (combinedTrades.length > MAX_BUFFER) combinedTrades.pop();
-}
-
-export function getCombinedTrades(): TradeWithAnalytics[] {
-  return combinedTrades.slice(0, MAX_VISIBLE);
+  combinedTrades.push(trade);
 }
 
 export function flushCombinedBuffer() {
-  return { trades: combinedTrades.slice(0, MAX_VISIBLE), hasNewData: combinedTrades.length > 0 };
+  if (combinedTrades.length === 0) return { trades: [], hasNewData: false, pendingCount: 0 };
+  const trades = combinedTrades.drain();
+  return { trades, hasNewData: true, pendingCount: trades.length };
 }
 
-// Cleanup
+// Cleanup - the order book survives a per-symbol clear: it's kept in sync by
+// deltas and dropping it would mean a resync round trip
 export function clearSymbolBuffer(symbol: string): void {
   const key = symbol.toUpperCase();
   tradeBuffers.delete(key);
-  obBuffers.delete(key);
-  tickerBuffers.delete(key);
   vwapValues.delete(key);
 }
 
 export function clearAllBuffers(): void {
   tradeBuffers.clear();
   obBuffers.clear();
-  tickerBuffers.clear();
   vwapValues.clear();
-  combinedTrades.length = 0;
+  combinedTrades.clear();
 }
 
 export function getBufferStats() {
   return {
     tradeBuffers: tradeBuffers.size,
     orderBookBuffers: obBuffers.size,
-    tickerBuffers: tickerBuffers.size,
     combinedTradesCount: combinedTrades.length,
   };
 }
@@ -0,0 +1,143 @@
+// Rolling time-vs-price liquidity history - one bucketed column of resting size per tick
+
+import { ObjectRing } from './ringBuffer';
+import type { LocalOrderBook } from './localOrderBook';
+
+export const COLUMN_INTERVAL_MS = 250;
+export const HISTORY_COLUMNS = 1200;   // 5 minutes at 250ms
+export const COLUMN_BUCKETS = 512;     // Price buckets stored per column, centered on mid
+
+// Levels per side used to size a bucket: the top RANGE_LEVELS of each side
+// should span about half a column
+const RANGE_LEVELS = 200;
+
+// Per-column decay of the brightest size seen, so colors adapt after a wall leaves
+const PEAK_DECAY = 0.995;
+
+// Guards floor(price / step) against 0.1-style float error
+const BUCKET_EPSILON = 1e-9;
+
+export interface DepthColumn {
+  time: number;
+  firstBucket: number;     // Bucket index (floor(price / step)) of sizes[0]
+  sizes: Float32Array;     // Resting size per bucket - bids positive, asks negative
+  bestBid: number;
+  bestAsk: number;
+}
+
+/**
+ * Round a raw bucket size to 1, 2 or 5 x 10^n so the price grid reads cleanly
+ */
+export function niceStep(raw: number): number {
+  if (!(raw > 0)) return 0;
+  const power = Math.pow(10, Math.floor(Math.log10(raw)));
+  const m = raw / power;
+  return (m <= 1 ? 1 : m <= 2 ? 2 : m <= 5 ? 5 : 10) * power;
+}
+
+export function bucketOf(price: number, step: number): number {
+  return Math.floor(price / step + BUCKET_EPSILON);
+}
+
+/**
+ * Heatmap history for one symbol
+ *
+ * Each capture buckets the whole local book onto a fixed price grid (step
+ * is picked from the first synced book and kept, so columns line up row for
+ * row). Columns live in a ring; once it's full the oldest column's arrays are
+ * reused, so capturing allocates nothing in steady state. version counts
+ * captures - renderers diff it to draw only the new columns.
+ */
+export class DepthHistory {
+  readonly columns = new ObjectRing<DepthColumn>(HISTORY_COLUMNS);
+  step = 0;
+  peak = 0;
+  version = 0;
+  private lastCapture = 0;
+
+  /**
+   * Take a column if COLUMN_INTERVAL_MS has passed - returns true if one was added
+   */
+  capture(book: LocalOrderBook, now: number): boolean {
+    if (!book.synced || now - this.lastCapture < COLUMN_INTERVAL_MS) return false;
+    const bids = book.bids;
+    const asks = book.asks;
+    if (bids.prices.length === 0 || asks.prices.length === 0) return false;
+    this.lastCapture = now;
+
+    if (this.step === 0) {
+      const far = Math.min(RANGE_LEVELS, bids.prices.length, asks.prices.length) - 1;
+      const range = asks.prices[far] - bids.prices[far];
+      this.step = niceStep(range / (COLUMN_BUCKETS / 2)) || niceStep(bids.prices[0] * 1e-5);
+    }
+    const step = this.step;
+
+    const bestBid = bids.prices[0];
+    const bestAsk = asks.prices[0];
+    const firstBucket = bucketOf((bestBid + bestAsk) / 2, step) - COLUMN_BUCKETS / 2;
+
+    let column: DepthColumn;
+    if (this.columns.length === this.columns.capacity) {
+      // The push below overwrites the oldest slot - give it the same object back
+      column = this.columns.get(0)!;
+      column.sizes.fill(0);
+    } else {
+      column = { time: 0, firstBucket: 0, sizes: new Float32Array(COLUMN_BUCKETS), bestBid: 0, bestAsk: 0 };
+    }
+    column.time = now;
+    column.firstBucket = firstBucket;
+    column.bestBid = bestBid;
+    column.bestAsk = bestAsk;
+
+    const sizes = column.sizes;
+    let columnPeak = 0;
+
+    // Bids descend, so bucket indexes only go down - stop once off the grid
+    for (let i = 0; i < bids.prices.length; i++) {
+      const b = bucketOf(bids.prices[i], step) - firstBucket;
+      if (b < 0) break;
+      if (b >= COLUMN_BUCKETS) continue;
+      sizes[b] += bids.sizes[i];
+      if (sizes[b] > columnPeak) columnPeak = sizes[b];
+    }
+    for (let i = 0; i < asks.prices.length; i++) {
+      const b = bucketOf(asks.prices[i], step) - firstBucket;
+      if (b >= COLUMN_BUCKETS) break;
+      if (b < 0) continue;
+      sizes[b] -= asks.sizes[i];
+      if (-sizes[b] > columnPeak) columnPeak = -sizes[b];
+    }
+
+    this.columns.push(column);
+    this.peak = Math.max(this.peak * PEAK_DECAY, columnPeak);
+    this.version++;
+    return true;
+  }
+
+  clear(): void {
+    this.columns.clear();
+    this.step = 0;
+    this.peak = 0;
+    this.version++;
+    this.lastCapture = 0;
+  }
+}
+
+const histories = new Map<string, DepthHistory>();
+
+/**
+ * History outlives the heatmap component, so switching views doesn't lose it
+ */
+export function getDepthHistory(symbol: string): DepthHistory {
+  const key = symbol.toUpperCase();
+  let h = histories.get(key);
+  if (!h) {
+    h = new DepthHistory();
+    histories.set(key, h);
+  }
+  return h;
+}
+
+export function clearDepthHistory(symbol: string): void {
+  histories.delete(symbol.toUpperCase());
+}
@@ -1,69 +1,357 @@
-// Global 60fps clock - single RAF loop shared by all components that need time updates
+// Global frame scheduler - one RAF loop runs every component's flush/compute work in phases
+
+import { TimeFormatter, type TimeParts } from '../utils/formatCache';
+import type { RenderRateMode } from '../types';
 
 type ClockListener = (timestamp: number) => void;
 
+/**
+ * Phases run in this order every frame: data is drained from buffers,
+ * derived state is computed from it, then components paint
+ */
+export type FramePhase = 'ingest' | 'analytics' | 'render';
+
+/**
+ * high   - runs every time it's due, whatever the frame costs
+ * normal - pushed to the next frame once this frame's budget is spent
+ * low    - also skipped while frames are arriving late (jank)
+ */
+export type TaskPriority = 'high' | 'normal' | 'low';
+
+export interface TaskOptions {
+  phase?: FramePhase;
+  priority?: TaskPriority;
+  intervalMs?: number;    // Minimum time between runs, 0 = every frame
+  name?: string;          // What the perf HUD calls it (defaults to the phase)
+}
+
+interface FrameTask {
+  run: ClockListener;
+  name: string;
+  priority: TaskPriority;
+  intervalMs: number;
+  lastRun: number;
+  deferredSince: number;  // 0 unless the task is due and has been pushed back
+}
+
+const PHASES: FramePhase[] = ['ingest', 'analytics', 'render'];
+// What still runs while the page is hidden - buffers keep draining, nothing paints
+const HIDDEN_PHASES: FramePhase[] = ['ingest', 'analytics'];
+
+// Leave the rest of a 60Hz frame for React's commit, layout and paint
+const FRAME_BUDGET_MS = 10;
+// Two 60Hz frames - anything slower means we're already dropping frames
+const LATE_FRAME_MS = 34;
+// Deferred work still runs at least this often
+const MAX_DEFER_MS = 250;
+
+// 'auto' walks these in order
+const RENDER_RATES = [60, 30, 10];
+// RAF timing jitters - a frame this close to its slot still runs
+const FRAME_SLACK_MS = 4;
+// A working frame followed by a gap longer than this missed a 60Hz vsync
+const OVER_BUDGET_MS = 25;
+// Smoothing for the share of working frames that ran over
+const OVER_BUDGET_SMOOTHING = 0.1;
+// Step down above this share, allow stepping back up below this one
+const DEGRADE_ABOVE = 0.3;
+const RECOVER_BELOW = 0.05;
+// Time at a rate before stepping down again, or back up
+const DEGRADE_HOLD_MS = 2000;
+const RECOVER_HOLD_MS = 10000;
+// Animation frames stop in a hidden page; ingest and analytics run off a timer instead
+const HIDDEN_TICK_MS = 250;
+
+export interface SchedulerStats {
+  frameMs: number;        // Time spent in tasks last frame
+  frameInterval: number;  // Time between the last two frames
+  deferred: number;       // Tasks pushed back last frame
+  lateFrames: number;     // Frames that arrived later than LATE_FRAME_MS
+  renderRate: number;     // Frames/sec currently aimed for
+  rateMode: RenderRateMode;
+  hidden: boolean;        // Page hidden - only ingest and analytics are running
+}
+
+/**
+ * Time spent in every task sharing a name, since the last takeTaskProfile()
+ */
+export interface TaskProfile {
+  runs: number;
+  totalMs: number;
+  maxMs: number;
+}
+
+/**
+ * Every periodic flush in the app (buffer drains, rate sampling, signal
+ * detection, painting) registers here instead of owning a setInterval or
+ * its own RAF. All of it runs inside one animation-frame callback, so React
+ * batches every setState made during a frame into a single commit, and work
+ * that doesn't fit the frame budget slides to the next frame instead of
+ * stretching this one.
+ *
+ * Frames are paced to the render rate: animation frames between slots are
+ * skipped outright, so at 30 or 10fps every task (and React) runs that much
+ * less. While the page is hidden no frames come at all - a timer keeps the
+ * ingest and analytics phases going so buffers drain and stats stay
+ * current, and painting resumes when the page is shown.
+ */
 class GlobalClockService {
-  private listeners: Set<ClockListener> = new Set();
+  private phases: Record<FramePhase, Set<FrameTask>> = {
+    ingest: new Set(),
+    analytics: new Set(),
+    render: new Set(),
+  };
+  private taskCount: number = 0;
   private animationFrameId: number | null = null;
+  private hiddenTimer: ReturnType<typeof setTimeout> | null = null;
   private currentTime: number = Date.now();
+  private lastFrameStart: number = 0;     // Last frame that ran tasks
+  private lastTickStart: number = 0;      // Last animation frame, whether it ran tasks or not
+  private lastWorked: boolean = false;    // Whether that animation frame ran tasks
   private isRunning: boolean = false;
+  private rateMode: RenderRateMode = 'auto';
+  private rateIndex: number = 0;
+  private rateChangedAt: number = 0;
+  private overBudget: number = 0;         // Smoothed share of working frames that ran over
+  private stats: SchedulerStats = {
+    frameMs: 0, frameInterval: 0, deferred: 0, lateFrames: 0, renderRate: RENDER_RATES[0], rateMode: 'auto', hidden: false,
+  };
+  private timeFormatter = new TimeFormatter();
+  // Only while the perf HUD is open - otherwise tasks run with no timing around them
+  private profile: Map<string, TaskProfile> | null = null;
+  
+  constructor() {
+    if (typeof document !== 'undefined') {
+      this.stats.hidden = document.hidden;
+      document.addEventListener('visibilitychange', this.handleVisibilityChange);
+    }
+  }
   
   start(): void {
     if (this.isRunning) return;
     this.isRunning = true;
-    this.tick();
+    this.resume();
   }
   
   stop(): void {
     this.isRunning = false;
+    this.cancelFrames();
+  }
+  
+  /**
+   * Pin the frame rate, or let it adapt to how long frames take ('auto')
+   */
+  setRenderRate(mode: RenderRateMode): void {
+    this.rateMode = mode;
+    this.setRateIndex(mode === 'auto' ? 0 : Math.max(0, RENDER_RATES.indexOf(mode)), performance.now());
+  }
+  
+  private resume(): void {
+    this.cancelFrames();
+    this.lastFrameStart = 0;
+    this.lastTickStart = 0;
+    this.lastWorked = false;
+    if (typeof document !== 'undefined' && document.hidden) {
+      this.hiddenTimer = setTimeout(this.hiddenTick, HIDDEN_TICK_MS);
+    } else {
+      this.animationFrameId = requestAnimationFrame(this.tick);
+    }
+  }
+  
+  private cancelFrames(): void {
     if (this.animationFrameId !== null) {
       cancelAnimationFrame(this.animationFrameId);
       this.animationFrameId = null;
     }
+    if (this.hiddenTimer !== null) {
+      clearTimeout(this.hiddenTimer);
+      this.hiddenTimer = null;
+    }
   }
   
+  private handleVisibilityChange = (): void => {
+    this.stats.hidden = document.hidden;
+    if (this.isRunning) this.resume();
+  };
+  
   /**
-   * Main loop - runs every animation frame
+   * Main loop - runs every animation frame, does work on the ones that
+   * fall in a render-rate slot
    */
   private tick = (): void => {
     if (!this.isRunning) return;
     
-    this.currentTime = Date.now();
+    const frameStart = performance.now();
+    const sinceLastTick = this.lastTickStart ? frameStart - this.lastTickStart : 0;
+    this.lastTickStart = frameStart;
+    // The gap after a working frame is what the frame really cost - tasks,
+    // React's commit, layout and paint
+    if (this.lastWorked) this.sampleBudget(sinceLastTick > OVER_BUDGET_MS, frameStart);
     
-    // Notify all subscribers
-    for (const listener of this.listeners) {
-      try {
-        listener(this.currentTime);
-      } catch (e) {
-        console.error('Clock listener error:', e);
-      }
-    }
+    const slotMs = 1000 / RENDER_RATES[this.rateIndex];
+    this.lastWorked = !this.lastFrameStart || frameStart - this.lastFrameStart >= slotMs - FRAME_SLACK_MS;
+    if (this.lastWorked) this.runFrame(frameStart, sinceLastTick > LATE_FRAME_MS, PHASES);
     
     this.animationFrameId = requestAnimationFrame(this.tick);
   };
   
   /**
-   * Subscribe to clock updates
+   * Stand-in loop while the page is hidden
+   */
+  private hiddenTick = (): void => {
+    this.hiddenTimer = null;
+    if (!this.isRunning) return;
+    this.runFrame(performance.now(), false, HIDDEN_PHASES);
+    this.hiddenTimer = setTimeout(this.hiddenTick, HIDDEN_TICK_MS);
+  };
+  
+  /**
+   * Auto mode: step down a rate once frames keep running over, and back up
+   * after a long stretch of them fitting
+   */
+  private sampleBudget(over: boolean, now: number): void {
+    this.overBudget += ((over ? 1 : 0) - this.overBudget) * OVER_BUDGET_SMOOTHING;
+    if (this.rateMode !== 'auto') return;
+    const held = now - this.rateChangedAt;
+    if (this.overBudget > DEGRADE_ABOVE && held >= DEGRADE_HOLD_MS && this.rateIndex < RENDER_RATES.length - 1) {
+      this.setRateIndex(this.rateIndex + 1, now);
+    } else if (this.overBudget < RECOVER_BELOW && held >= RECOVER_HOLD_MS && this.rateIndex > 0) {
+      this.setRateIndex(this.rateIndex - 1, now);
+    }
+  }
+  
+  private setRateIndex(index: number, now: number): void {
+    this.rateIndex = index;
+    this.rateChangedAt = now;
+    // Judge the new rate on its own frames
+    this.overBudget = (DEGRADE_ABOVE + RECOVER_BELOW) / 2;
+    this.stats.renderRate = RENDER_RATES[index];
+    this.stats.rateMode = this.rateMode;
+  }
+  
+  private runFrame(frameStart: number, late: boolean, phases: FramePhase[]): void {
+    const now = Date.now();
+    this.currentTime = now;
+    
+    const frameInterval = this.lastFrameStart ? frameStart - this.lastFrameStart : 0;
+    this.lastFrameStart = frameStart;
+    let deferred = 0;
+    
+    for (const phase of phases) {
+      for (const task of this.phases[phase]) {
+        if (now - task.lastRun < task.intervalMs) continue;
+        
+        if (task.priority !== 'high') {
+          const starved = task.deferredSince > 0 && now - task.deferredSince >= MAX_DEFER_MS;
+          const overBudget = performance.now() - frameStart > FRAME_BUDGET_MS;
+          if (!starved && (overBudget || (late && task.priority === 'low'))) {
+            if (task.deferredSince === 0) task.deferredSince = now;
+            deferred++;
+            continue;
+          }
+        }
+        
+        task.lastRun = now;
+        task.deferredSince = 0;
+        try {
+          if (this.profile) this.runProfiled(task, now);
+          else task.run(now);
+        } catch (e) {
+          console.error('Clock listener error:', e);
+        }
+      }
+    }
+    
+    this.stats.frameMs = performance.now() - frameStart;
+    this.stats.frameInterval = frameInterval;
+    this.stats.deferred = deferred;
+    if (late) this.stats.lateFrames++;
+  }
+  
+  private runProfiled(task: FrameTask, now: number): void {
+    const start = performance.now();
+    try {
+      task.run(now);
+    } finally {
+      const ms = performance.now() - start;
+      let entry = this.profile?.get(task.name);
+      if (!entry) {
+        entry = { runs: 0, totalMs: 0, maxMs: 0 };
+        this.profile?.set(task.name, entry);
+      }
+      entry.runs++;
+      entry.totalMs += ms;
+      if (ms > entry.maxMs) entry.maxMs = ms;
+    }
+  }
+  
+  /**
+   * Register work to run on the frame loop
    * Returns unsubscribe function for cleanup
    */
-  subscribe(listener: ClockListener): () => void {
-    this.listeners.add(listener);
+  schedule(run: ClockListener, options: TaskOptions = {}): () => void {
+    const intervalMs = options.intervalMs ?? 0;
+    const task: FrameTask = {
+      run,
+      name: options.name ?? options.phase ?? 'render',
+      priority: options.priority ?? 'normal',
+      intervalMs,
+      // Interval tasks wait one interval before their first run, like setInterval
+      lastRun: intervalMs > 0 ? Date.now() : 0,
+      deferredSince: 0,
+    };
+    const tasks = this.phases[options.phase ?? 'render'];
+    tasks.add(task);
+    this.taskCount++;
     
-    // Start ticking if this is the first subscriber
-    if (this.listeners.size === 1) {
+    // Start ticking if this is the first task
+    if (this.taskCount === 1) {
       this.start();
     }
     
+    let active = true;
     return () => {
-      this.listeners.delete(listener);
+      if (!active) return;
+      active = false;
+      tasks.delete(task);
+      this.taskCount--;
       
-      // Stop if no more subscribers
-      if (this.listeners.size === 0) {
+      // Stop if nothing is left to run
+      if (this.taskCount === 0) {
         this.stop();
       }
     };
   }
   
+  /**
+   * Subscribe to clock updates - a normal-priority render task every frame
+   * Returns unsubscribe function for cleanup
+   */
+  subscribe(listener: ClockListener): () => void {
+    return this.schedule(listener);
+  }
+  
+  getStats(): SchedulerStats {
+    return { ...this.stats };
+  }
+  
+  /**
+   * Start (or stop) timing every task by name
+   */
+  setProfiling(enabled: boolean): void {
+    if (enabled && !this.profile) this.profile = new Map();
+    else if (!enabled) this.profile = null;
+  }
+  
+  /**
+   * Per-name task timings since the last call, then start over
+   */
+  takeTaskProfile(): Map<string, TaskProfile> {
+    const profile = this.profile ?? new Map<string, TaskProfile>();
+    if (this.profile) this.profile = new Map();
+    return profile;
+  }
+  
   /**
    * Get current time without subscribing
    */
@@ -73,23 +361,12 @@ class GlobalClockService {
   
   /**
    * Format timestamp with millisecond precision
+   * 
+   * Called every frame for the current time - the date fields are only
+   * rebuilt when the second changes.
    */
-  formatTime(timestamp?: number): { hours: string; minutes: string; seconds: string; milliseconds: string; full: string } {
-    const time = timestamp ?? this.currentTime;
-    const date = new Date(time);
-    
-    const hours = date.getHours().toString().padStart(2, '0');
-    const minutes = date.getMinutes().toString().padStart(2, '0');
-    const seconds = date.getSeconds().toString().padStart(2, '0');
-    const milliseconds = date.getMilliseconds().toString().padStart(3, '0');
-    
-    return {
-      hours,
-      minutes,
-      seconds,
-      milliseconds,
-      full: `${hours}:${minutes}:${seconds}.${milliseconds}`
-    };
+  formatTime(timestamp?: number): TimeParts {
+    return this.timeFormatter.parts(timestamp ?? this.currentTime);
   }
   
   /**
@@ -139,7 +416,7 @@ export function useGlobalClock(throttleMs: number = 0): number {
 /**
  * Hook that returns formatted time parts
  */
-export function useFormattedTime(): { hours: string; minutes: string; seconds: string; milliseconds: string; full: string } {
+export function useFormattedTime(): TimeParts {
   const [formatted, setFormatted] = useState(globalClock.formatTime());
   
   useEffect(() => {
@@ -0,0 +1,286 @@
+// Client-side order book - applies server deltas in place and caches aggregates
+
+import type { OrderBook, OrderBookDelta, OrderBookLevel } from '../types';
+import { calculateImbalance } from '../utils/calculations';
+
+// Top-of-book window the UI reads from. Imbalance is measured over this many
+// levels, same as the 20-level snapshots the server used to send.
+export const BOOK_VIEW_LEVELS = 20;
+
+// Deeper levels are kept (walls, depth ladder) but not forever
+const MAX_LEVELS = 1000;
+
+export type DeltaResult = 'applied' | 'stale' | 'gap';
+
+/**
+ * Everything the order book panel needs, computed once per top-of-book change
+ */
+export interface BookView {
+  symbol: string;
+  timestamp: number;
+  seq: number;
+  bids: OrderBookLevel[];      // Best first
+  asks: OrderBookLevel[];
+  bidCumulative: number[];     // Running size from the best price outward
+  askCumulative: number[];
+  maxBidSize: number;
+  maxAskSize: number;
+  imbalance: number;
+  midPrice: number;
+  spread: number;
+  spreadPercent: number;
+}
+
+/**
+ * One side as parallel sorted arrays, best price at index 0
+ *
+ * totalSize tracks the whole side's resting size as levels change, so deep
+ * depth is O(1) to read.
+ */
+class BookSide {
+  prices: number[] = [];
+  sizes: number[] = [];
+  totalSize = 0;
+
+  constructor(private descending: boolean) {}
+
+  private search(price: number): number {
+    let lo = 0;
+    let hi = this.prices.length - 1;
+    while (lo <= hi) {
+      const mid = (lo + hi) >>> 1;
+      const p = this.prices[mid];
+      if (p === price) return mid;
+      if (this.descending ? p > price : p < price) lo = mid + 1;
+      else hi = mid - 1;
+    }
+    return -(lo + 1);
+  }
+
+  /**
+   * Set or remove (size 0) a level - returns its index, or -1 for a no-op
+   */
+  set(price: number, size: number): number {
+    const i = this.search(price);
+    if (i >= 0) {
+      const prev = this.sizes[i];
+      if (size === 0) {
+        this.prices.splice(i, 1);
+        this.sizes.splice(i, 1);
+      } else if (prev === size) {
+        return -1;
+      } else {
+        this.sizes[i] = size;
+      }
+      this.totalSize += size - prev;
+      return i;
+    }
+    if (size === 0) return -1;
+    const at = -(i + 1);
+    this.prices.splice(at, 0, price);
+    this.sizes.splice(at, 0, size);
+    this.totalSize += size;
+    return at;
+  }
+
+  trim(maxLevels: number): void {
+    for (let i = maxLevels; i < this.prices.length; i++) {
+      this.totalSize -= this.sizes[i];
+    }
+    if (this.prices.length > maxLevels) {
+      this.prices.length = maxLevels;
+      this.sizes.length = maxLevels;
+    }
+  }
+
+  clear(): void {
+    this.prices = [];
+    this.sizes = [];
+    this.totalSize = 0;
+  }
+}
+
+/**
+ * Book for one symbol, kept current from 'orderbook_delta' messages
+ *
+ * A delta costs a binary search (plus a splice for new/removed levels) per
+ * changed price. version only moves when a change lands inside the top
+ * BOOK_VIEW_LEVELS (depthVersion on any change), so consumers polling view()
+ * at render rate rebuild the aggregates at most once per visible change and
+ * otherwise get the cached one.
+ */
+export class LocalOrderBook {
+  readonly bids = new BookSide(true);
+  readonly asks = new BookSide(false);
+  seq = 0;
+  timestamp = 0;
+  synced = false;
+  version = 0;
+  depthVersion = 0;
+
+  private cachedView: BookView | null = null;
+  private cachedViewKey = '';
+  private cachedOrderBook: OrderBook | null = null;
+  private cachedOrderBookVersion = -1;
+
+  constructor(readonly symbol: string) {}
+
+  /**
+   * Apply a delta from the server. 'gap' means our book is no longer
+   * trustworthy and the caller should ask for a resync.
+   */
+  applyDelta(delta: OrderBookDelta): DeltaResult {
+    if (delta.snapshot) {
+      this.applySnapshot(delta.bids, delta.asks, delta.seq, delta.timestamp);
+      return 'applied';
+    }
+
+    if (this.synced && delta.seq <= this.seq) return 'stale';
+    if (!this.synced || delta.prevSeq !== this.seq) {
+      this.synced = false;
+      return 'gap';
+    }
+
+    let topChanged = false;
+    let changed = false;
+    for (let i = 0; i < delta.bids.length; i++) {
+      const index = this.bids.set(delta.bids[i][0], delta.bids[i][1]);
+      if (index < 0) continue;
+      changed = true;
+      if (index < BOOK_VIEW_LEVELS) topChanged = true;
+    }
+    for (let i = 0; i < delta.asks.length; i++) {
+      const index = this.asks.set(delta.asks[i][0], delta.asks[i][1]);
+      if (index < 0) continue;
+      changed = true;
+      if (index < BOOK_VIEW_LEVELS) topChanged = true;
+    }
+
+    this.bids.trim(MAX_LEVELS);
+    this.asks.trim(MAX_LEVELS);
+    this.seq = delta.seq;
+    this.timestamp = delta.timestamp;
+    if (topChanged) this.version++;
+    if (changed) this.depthVersion++;
+    return 'applied';
+  }
+
+  /**
+   * Replace the book with a full snapshot from the 20-level protocol
+   */
+  applyOrderBook(orderBook: OrderBook): void {
+    this.bids.clear();
+    this.asks.clear();
+    for (const level of orderBook.bids) this.bids.set(level.price, level.size);
+    for (const level of orderBook.asks) this.asks.set(level.price, level.size);
+    this.seq = orderBook.seq ?? 0;
+    this.timestamp = orderBook.timestamp;
+    this.synced = true;
+    this.version++;
+    this.depthVersion++;
+  }
+
+  private applySnapshot(bids: [number, number][], asks: [number, number][], seq: number, timestamp: number): void {
+    this.bids.clear();
+    this.asks.clear();
+    for (let i = 0; i < bids.length; i++) this.bids.set(bids[i][0], bids[i][1]);
+    for (let i = 0; i < asks.length; i++) this.asks.set(asks[i][0], asks[i][1]);
+    this.seq = seq;
+    this.timestamp = timestamp;
+    this.synced = true;
+    this.version++;
+    this.depthVersion++;
+  }
+
+  /**
+   * Top `levels` of the book with aggregates - cached until the top changes
+   */
+  view(levels: number = BOOK_VIEW_LEVELS): BookView {
+    const key = `${levels <= BOOK_VIEW_LEVELS ? this.version : `d${this.depthVersion}`}:${levels}`;
+    if (this.cachedView && this.cachedViewKey === key) return this.cachedView;
+
+    const bidSide = summarizeSide(this.bids, levels);
+    const askSide = summarizeSide(this.asks, levels);
+    const bestBid = this.bids.prices[0] ?? 0;
+    const bestAsk = this.asks.prices[0] ?? 0;
+    const hasBoth = bestBid > 0 && bestAsk > 0;
+    const spread = hasBoth ? bestAsk - bestBid : 0;
+
+    this.cachedView = {
+      symbol: this.symbol,
+      timestamp: this.timestamp,
+      seq: this.seq,
+      bids: bidSide.levels,
+      asks: askSide.levels,
+      bidCumulative: bidSide.cumulative,
+      askCumulative: askSide.cumulative,
+      maxBidSize: bidSide.maxSize,
+      maxAskSize: askSide.maxSize,
+      imbalance: calculateImbalance(bidSide.imbalanceVolume, askSide.imbalanceVolume),
+      midPrice: hasBoth ? (bestBid + bestAsk) / 2 : 0,
+      spread,
+      spreadPercent: hasBoth ? (spread / bestBid) * 100 : 0,
+    };
+    this.cachedViewKey = key;
+    return this.cachedView;
+  }
+
+  /**
+   * Top of the book as a plain OrderBook, for code that still takes one
+   * (enrichment's spread-at-print, signal detection)
+   */
+  toOrderBook(): OrderBook {
+    if (this.cachedOrderBook && this.cachedOrderBookVersion === this.version) {
+      return this.cachedOrderBook;
+    }
+    const view = this.view(BOOK_VIEW_LEVELS);
+    this.cachedOrderBook = {
+      symbol: this.symbol,
+      assetType: 'crypto',
+      timestamp: this.timestamp,
+      bids: view.bids,
+      asks: view.asks,
+      spread: view.spread,
+      spreadPercent: view.spreadPercent,
+      seq: this.seq,
+    };
+    this.cachedOrderBookVersion = this.version;
+    return this.cachedOrderBook;
+  }
+}
+
+/**
+ * Single pass over the top of one side: levels, cumulative size, max size,
+ * and the volume that feeds imbalance (always BOOK_VIEW_LEVELS deep)
+ */
+function summarizeSide(side: BookSide, levels: number) {
+  const visible = Math.min(levels, side.prices.length);
+  const scan = Math.min(Math.max(levels, BOOK_VIEW_LEVELS), side.prices.length);
+  const out: OrderBookLevel[] = new Array(visible);
+  const cumulative: number[] = new Array(visible);
+  let running = 0;
+  let maxSize = 0;
+  let imbalanceVolume = 0;
+
+  for (let i = 0; i < scan; i++) {
+    const size = side.sizes[i];
+    if (i < BOOK_VIEW_LEVELS) imbalanceVolume += size;
+    if (i < visible) {
+      out[i] = { price: side.prices[i], size };
+      running += size;
+      cumulative[i] = running;
+      if (size > maxSize) maxSize = size;
+    }
+  }
+
+  return { levels: out, cumulative, maxSize, imbalanceVolume };
+}
+
+/**
+ * Same aggregates for a plain OrderBook (components handed one directly)
+ */
+export function bookViewFromOrderBook(orderBook: OrderBook, levels: number = BOOK_VIEW_LEVELS): BookView {
+  const book = new LocalOrderBook(orderBook.symbol);
+  book.applyOrderBook(orderBook);
+  return book.view(levels);
+}
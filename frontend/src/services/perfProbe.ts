@@ -0,0 +1,288 @@
+// Perf probe - frame times, task timings, parse cost, heap churn and event-to-paint latency,
+// collected for the bench (?perf in the URL) and while the perf HUD is open
+
+import { globalClock } from './globalClock';
+import type { RenderRateMode } from '../types';
+
+export type PaintView = 'tape' | 'book';
+
+// Per series - a few minutes of a busy session, then new samples are dropped
+const MAX_SAMPLES = 50_000;
+
+// Upper bounds (ms) of the HUD's event -> paint buckets - one more catches the rest
+export const LATENCY_BUCKETS_MS = [10, 25, 50, 100, 250, 500, 1000];
+
+// The HUD shows the last complete window of this length
+const WINDOW_MS = 1000;
+
+export interface PerfSnapshot {
+  frameInterval: number[];  // ms between frames
+  frameWork: number[];      // ms spent in scheduled tasks per frame
+  tape: number[];           // Event timestamp -> painted, per TapeTable paint
+  book: number[];           // Same for OrderBook
+  lateFrames: number;
+}
+
+export interface TaskTiming {
+  name: string;
+  runs: number;
+  totalMs: number;
+  maxMs: number;
+}
+
+/**
+ * One window of what the HUD shows
+ *
+ * heap is null outside Chromium (no performance.memory), and coarse inside
+ * it - the browser quantizes the numbers, so a collection only shows up as
+ * the used heap going down. latency is cumulative since the HUD opened.
+ */
+export interface PerfWindow {
+  frames: number;
+  avgFrameInterval: number;
+  maxFrameInterval: number;
+  avgFrameWork: number;
+  maxFrameWork: number;
+  lateFrames: number;
+  renderRate: number;                       // Frames/sec the clock aims for at the end of the window
+  rateMode: RenderRateMode;
+  tasks: TaskTiming[];                      // Busiest first
+  parse: { messages: number; totalMs: number };
+  heap: { usedMB: number; allocatedMB: number; collections: number } | null;
+  latency: Record<PaintView, number[]>;     // Count per LATENCY_BUCKETS_MS bucket
+}
+
+interface PerfProbeApi {
+  snapshot(): PerfSnapshot;
+  reset(): void;
+}
+
+declare global {
+  interface Window {
+    __tapeflowPerf?: PerfProbeApi;
+  }
+}
+
+// Only Chromium has it, and it isn't in the DOM typings
+interface MemoryInfo {
+  usedJSHeapSize: number;
+}
+
+const benchEnabled = typeof window !== 'undefined' && new URLSearchParams(window.location.search).has('perf');
+let hudOpen = false;
+const hudListeners = new Set<(open: boolean) => void>();
+
+let series: PerfSnapshot = createSeries();
+let stopSampling: (() => void) | null = null;
+
+function createSeries(): PerfSnapshot {
+  return { frameInterval: [], frameWork: [], tape: [], book: [], lateFrames: 0 };
+}
+
+function createLatency(): Record<PaintView, number[]> {
+  return {
+    tape: new Array(LATENCY_BUCKETS_MS.length + 1).fill(0),
+    book: new Array(LATENCY_BUCKETS_MS.length + 1).fill(0),
+  };
+}
+
+// The window being filled, and the last complete one
+interface WindowState {
+  start: number;
+  frames: number;
+  intervalSum: number;
+  intervalMax: number;
+  workSum: number;
+  workMax: number;
+  lateFrames: number;
+  parseMessages: number;
+  parseMs: number;
+  allocatedBytes: number;
+  collections: number;
+}
+
+let current: WindowState = createWindow(0);
+let latency = createLatency();
+let lastHeap = 0;
+let lastWindow: PerfWindow | null = null;
+
+function createWindow(start: number): WindowState {
+  return {
+    start, frames: 0, intervalSum: 0, intervalMax: 0, workSum: 0, workMax: 0, lateFrames: 0,
+    parseMessages: 0, parseMs: 0, allocatedBytes: 0, collections: 0,
+  };
+}
+
+function push(list: number[], value: number): void {
+  if (list.length < MAX_SAMPLES) list.push(value);
+}
+
+function readHeap(): number | null {
+  const memory = (performance as Performance & { memory?: MemoryInfo }).memory;
+  return memory ? memory.usedJSHeapSize : null;
+}
+
+function bucketFor(ms: number): number {
+  let i = 0;
+  while (i < LATENCY_BUCKETS_MS.length && ms > LATENCY_BUCKETS_MS[i]) i++;
+  return i;
+}
+
+/**
+ * Note that a view just drew data stamped eventTimestamp
+ *
+ * Called from render-phase work, which runs before the browser paints the
+ * frame - a zero-delay task lands after that paint, so the sample is close
+ * to when the rows actually hit the screen. No-op unless ?perf is set or
+ * the HUD is open.
+ */
+export function recordPaint(view: PaintView, eventTimestamp: number): void {
+  if ((!benchEnabled && !hudOpen) || eventTimestamp <= 0) return;
+  setTimeout(() => {
+    const ms = Date.now() - eventTimestamp;
+    if (benchEnabled) push(series[view], ms);
+    if (hudOpen) latency[view][bucketFor(ms)]++;
+  }, 0);
+}
+
+/**
+ * Time spent decoding market data off the socket (main thread or worker)
+ */
+export function recordParse(totalMs: number, messages: number): void {
+  if (!hudOpen) return;
+  current.parseMs += totalMs;
+  current.parseMessages += messages;
+}
+
+export function isPerfHudOpen(): boolean {
+  return hudOpen;
+}
+
+/**
+ * Called back whenever the HUD opens or closes - the ingest worker only
+ * times its parsing while someone is looking
+ */
+export function onPerfHudChange(listener: (open: boolean) => void): () => void {
+  hudListeners.add(listener);
+  return () => hudListeners.delete(listener);
+}
+
+/**
+ * Start or stop what only the HUD needs: task timing in the clock, parse
+ * timing, heap sampling and the latency histograms
+ */
+export function setPerfHud(open: boolean): void {
+  if (open === hudOpen) return;
+  hudOpen = open;
+  globalClock.setProfiling(open);
+  if (open) {
+    current = createWindow(Date.now());
+    latency = createLatency();
+    lastHeap = readHeap() ?? 0;
+    lastWindow = null;
+    globalClock.takeTaskProfile();
+  }
+  updateSampling();
+  hudListeners.forEach(listener => listener(open));
+}
+
+/**
+ * The last complete window, or null until the first one is done
+ */
+export function getPerfWindow(): PerfWindow | null {
+  return lastWindow;
+}
+
+function closeWindow(now: number): void {
+  const tasks: TaskTiming[] = [];
+  for (const [name, profile] of globalClock.takeTaskProfile()) tasks.push({ name, ...profile });
+  tasks.sort((a, b) => b.totalMs - a.totalMs);
+
+  const heap = readHeap();
+  const { renderRate, rateMode } = globalClock.getStats();
+  lastWindow = {
+    frames: current.frames,
+    avgFrameInterval: current.frames ? current.intervalSum / current.frames : 0,
+    maxFrameInterval: current.intervalMax,
+    avgFrameWork: current.frames ? current.workSum / current.frames : 0,
+    maxFrameWork: current.workMax,
+    lateFrames: current.lateFrames,
+    renderRate,
+    rateMode,
+    tasks,
+    parse: { messages: current.parseMessages, totalMs: current.parseMs },
+    heap: heap === null ? null : {
+      usedMB: heap / 1_048_576,
+      allocatedMB: current.allocatedBytes / 1_048_576,
+      collections: current.collections,
+    },
+    latency: { tape: latency.tape.slice(), book: latency.book.slice() },
+  };
+  current = createWindow(now);
+}
+
+/**
+ * One high-priority ingest task samples the previous frame, for whichever
+ * of the bench and the HUD is on - and is gone when neither is
+ */
+function updateSampling(): void {
+  if (!benchEnabled && !hudOpen) {
+    stopSampling?.();
+    stopSampling = null;
+    return;
+  }
+  if (stopSampling) return;
+
+  let lateFrames = globalClock.getStats().lateFrames;
+  stopSampling = globalClock.schedule((now) => {
+    const stats = globalClock.getStats();
+    const late = stats.lateFrames - lateFrames;
+    lateFrames = stats.lateFrames;
+
+    if (benchEnabled) {
+      if (stats.frameInterval > 0) push(series.frameInterval, stats.frameInterval);
+      push(series.frameWork, stats.frameMs);
+      series.lateFrames += late;
+    }
+    if (!hudOpen) return;
+
+    current.frames++;
+    current.intervalSum += stats.frameInterval;
+    current.intervalMax = Math.max(current.intervalMax, stats.frameInterval);
+    current.workSum += stats.frameMs;
+    current.workMax = Math.max(current.workMax, stats.frameMs);
+    current.lateFrames += late;
+
+    const heap = readHeap();
+    if (heap !== null) {
+      if (heap < lastHeap) current.collections++;
+      else current.allocatedBytes += heap - lastHeap;
+      lastHeap = heap;
+    }
+    if (now - current.start >= WINDOW_MS) closeWindow(now);
+  }, { phase: 'ingest', priority: 'high', name: 'perf' });
+}
+
+/**
+ * Start sampling frames and expose window.__tapeflowPerf for the headless
+ * bench (backend/bench/browser.ts). ?perf=BTCUSDT,ETHUSDT also opens those
+ * symbols, so the bench doesn't have to drive the symbol picker.
+ */
+export function installPerfProbe(openSymbol: (symbol: string) => void): void {
+  if (!benchEnabled || window.__tapeflowPerf) return;
+
+  const symbols = new URLSearchParams(window.location.search).get('perf') ?? '';
+  for (const symbol of symbols.split(',')) {
+    if (symbol.trim()) openSymbol(symbol.trim().toUpperCase());
+  }
+
+  updateSampling();
+
+  window.__tapeflowPerf = {
+    snapshot: () => series,
+    reset: () => {
+      series = createSeries();
+    },
+  };
+  console.log('[Perf] Probe enabled');
+}
@@ -0,0 +1,143 @@
+// Fixed-capacity ring buffers - O(1), allocation-free pushes for the hot paths
+
+import type { TradeSide } from '../types';
+
+/**
+ * Ring of numbers backed by a Float64Array
+ *
+ * Once full, each push overwrites the oldest value. Index 0 is always the
+ * oldest element, length - 1 the newest.
+ */
+export class NumberRing {
+  private data: Float64Array;
+  private head = 0;   // Index of the oldest element
+  private size = 0;
+
+  constructor(readonly capacity: number) {
+    this.data = new Float64Array(capacity);
+  }
+
+  get length(): number {
+    return this.size;
+  }
+
+  push(value: number): void {
+    const tail = (this.head + this.size) % this.capacity;
+    this.data[tail] = value;
+    if (this.size < this.capacity) {
+      this.size++;
+    } else {
+      this.head = (this.head + 1) % this.capacity;
+    }
+  }
+
+  get(index: number): number {
+    return this.data[(this.head + index) % this.capacity];
+  }
+
+  last(): number | undefined {
+    return this.size ? this.get(this.size - 1) : undefined;
+  }
+
+  min(): number | undefined {
+    if (!this.size) return undefined;
+    let m = Infinity;
+    for (let i = 0; i < this.size; i++) {
+      const v = this.data[(this.head + i) % this.capacity];
+      if (v < m) m = v;
+    }
+    return m;
+  }
+
+  clear(): void {
+    this.head = 0;
+    this.size = 0;
+  }
+
+  toArray(): number[] {
+    const out = new Array<number>(this.size);
+    for (let i = 0; i < this.size; i++) out[i] = this.get(i);
+    return out;
+  }
+}
+
+/**
+ * Ring of object references
+ *
+ * Same overwrite-oldest semantics as NumberRing. Used where we need to keep
+ * the objects themselves (e.g. enriched trades for the combined tape).
+ */
+export class ObjectRing<T> {
+  private data: (T | undefined)[];
+  private head = 0;
+  private size = 0;
+
+  constructor(readonly capacity: number) {
+    this.data = new Array(capacity);
+  }
+
+  get length(): number {
+    return this.size;
+  }
+
+  push(value: T): void {
+    const tail = (this.head + this.size) % this.capacity;
+    this.data[tail] = value;
+    if (this.size < this.capacity) {
+      this.size++;
+    } else {
+      this.head = (this.head + 1) % this.capacity;
+    }
+  }
+
+  get(index: number): T | undefined {
+    return this.data[(this.head + index) % this.capacity];
+  }
+
+  /**
+   * Newest `count` elements, newest first
+   */
+  latest(count: number): T[] {
+    const n = Math.min(count, this.size);
+    const out = new Array<T>(n);
+    for (let i = 0; i < n; i++) {
+      out[i] = this.data[(this.head + this.size - 1 - i) % this.capacity] as T;
+    }
+    return out;
+  }
+
+  /**
+   * Take everything (oldest first) and empty the ring
+   */
+  drain(): T[] {
+    const out = new Array<T>(this.size);
+    for (let i = 0; i < this.size; i++) {
+      const index = (this.head + i) % this.capacity;
+      out[i] = this.data[index] as T;
+      this.data[index] = undefined;
+    }
+    this.head = 0;
+    this.size = 0;
+    return out;
+  }
+
+  clear(): void {
+    this.data.fill(undefined);
+    this.head = 0;
+    this.size = 0;
+  }
+}
+
+export const SIDE_NEUTRAL = 0;
+export const SIDE_BUY = 1;
+export const SIDE_SELL = 2;
+
+const SIDE_FROM_CODE: TradeSide[] = ['neutral', 'buy', 'sell'];
+
+export function encodeSide(side: TradeSide): number {
+  return side === 'buy' ? SIDE_BUY : side === 'sell' ? SIDE_SELL : SIDE_NEUTRAL;
+}
+
+export function decodeSide(code: number): TradeSide {
+  return SIDE_FROM_CODE[code] ?? 'neutral';
+}
@@ -0,0 +1,68 @@
+// Shared trade ring tests - the reader never hands back a row the writer could be overwriting
+
+import assert from 'node:assert/strict';
+import { describe, it, mock } from 'node:test';
+import { createSharedTradeRing, SharedTradeReader, SharedTradeWriter } from './sharedTradeRing';
+import { TradeWithAnalytics } from '../types';
+
+const CAPACITY = 8192;
+
+function row(id: number): TradeWithAnalytics {
+  return {
+    id: String(id),
+    symbol: 'BTCUSDT',
+    assetType: 'crypto',
+    timestamp: 1_700_000_000_000 + id,
+    price: 100,
+    volume: 1,
+    side: 'buy',
+    vwap: 100,
+    vwapDrift: 0,
+    delta: id,
+    relativeStrength: 1,
+    momentum: 0,
+    spreadAtPrint: 0,
+  };
+}
+
+describe('SharedTradeReader', () => {
+  it('reads everything written since the last read', () => {
+    const ring = createSharedTradeRing();
+    const writer = new SharedTradeWriter(ring);
+    const reader = new SharedTradeReader(ring);
+    for (let id = 1; id <= 3; id++) writer.write(row(id));
+
+    assert.deepEqual(reader.read().map(trade => trade.id), ['1', '2', '3']);
+    assert.equal(reader.read().length, 0);
+  });
+
+  it('drops rows the writer laps during a read, and the one it is writing', () => {
+    const ring = createSharedTradeRing();
+    const writer = new SharedTradeWriter(ring);
+    const reader = new SharedTradeReader(ring);
+    let next = 1;
+    while (next <= CAPACITY) writer.write(row(next++));
+
+    // read() loads the write seq before copying and again after - in between,
+    // the writer publishes 10 more rows and starts on the 11th
+    const load = Atomics.load.bind(Atomics) as (array: Int32Array, index: number) => number;
+    let calls = 0;
+    const spy = mock.method(Atomics, 'load', (array: Int32Array, index: number) => {
+      if (++calls !== 2) return load(array, index);
+      for (let n = 0; n < 10; n++) writer.write(row(next++));
+      const after = load(array, index);
+      writer.write(row(next++));  // Not yet published when the reader looks
+      return after;
+    });
+
+    try {
+      const trades = reader.read();
+      // Seqs 0-9 were overwritten and seq 10 is the slot still being written
+      assert.equal(trades.length, CAPACITY - 11);
+      assert.equal(trades[0].id, '12');
+      assert.equal(trades[trades.length - 1].id, String(CAPACITY));
+    } finally {
+      spy.mock.restore();
+    }
+  });
+});
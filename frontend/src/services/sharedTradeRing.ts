@@ -0,0 +1,230 @@
+// SharedArrayBuffer trade ring - worker writes enriched trades, main thread reads them per frame
+
+import type { TradeWithAnalytics } from '../types';
+import { decodeSide, encodeSide } from './ringBuffer';
+import { VENUES } from './binaryProtocol';
+
+/**
+ * Single-producer / single-consumer ring laid out as columns
+ *
+ *   control  Int32Array   [writeSeq, symbolCount]
+ *   symbols  Uint8Array   SYMBOL_SLOTS x SYMBOL_BYTES ASCII names
+ *   f64 cols price, volume, timestamp, tradeId, vwap, vwapDrift, delta,
+ *            relativeStrength, momentum, spreadAtPrint
+ *   i32 cols side, symbolIndex, venue, backfill
+ *
+ * The writer never blocks: if the reader falls more than CAPACITY trades
+ * behind (e.g. the tab was backgrounded) it just loses the oldest ones, same
+ * as the per-symbol buffers do. writeSeq is published with Atomics.store after
+ * the row is written, so a reader that sees seq N can read rows < N.
+ */
+const CAPACITY = 8192;            // Must be a power of two
+const MASK = CAPACITY - 1;
+const SYMBOL_SLOTS = 256;
+const SYMBOL_BYTES = 16;
+
+const CTRL_WRITE_SEQ = 0;
+const CTRL_SYMBOL_COUNT = 1;
+const CONTROL_BYTES = 64;
+const SYMBOLS_OFFSET = CONTROL_BYTES;
+const F64_OFFSET = SYMBOLS_OFFSET + SYMBOL_SLOTS * SYMBOL_BYTES;
+
+const F64_COLUMNS = [
+  'price', 'volume', 'timestamp', 'tradeId', 'vwap', 'vwapDrift',
+  'delta', 'relativeStrength', 'momentum', 'spreadAtPrint',
+] as const;
+const I32_COLUMNS = ['side', 'symbolIndex', 'venue', 'backfill'] as const;
+
+type F64Column = typeof F64_COLUMNS[number];
+type I32Column = typeof I32_COLUMNS[number];
+
+const I32_OFFSET = F64_OFFSET + F64_COLUMNS.length * CAPACITY * 8;
+const TOTAL_BYTES = I32_OFFSET + I32_COLUMNS.length * CAPACITY * 4;
+
+/**
+ * True when the page is cross-origin isolated and SharedArrayBuffer is usable
+ */
+export function isSharedMemoryAvailable(): boolean {
+  return typeof SharedArrayBuffer !== 'undefined' &&
+    (typeof crossOriginIsolated === 'undefined' || crossOriginIsolated);
+}
+
+export function createSharedTradeRing(): SharedArrayBuffer {
+  return new SharedArrayBuffer(TOTAL_BYTES);
+}
+
+interface RingViews {
+  control: Int32Array;
+  symbols: Uint8Array;
+  f64: Record<F64Column, Float64Array>;
+  i32: Record<I32Column, Int32Array>;
+}
+
+function mapViews(buffer: SharedArrayBuffer): RingViews {
+  const f64 = {} as Record<F64Column, Float64Array>;
+  F64_COLUMNS.forEach((name, i) => {
+    f64[name] = new Float64Array(buffer, F64_OFFSET + i * CAPACITY * 8, CAPACITY);
+  });
+  const i32 = {} as Record<I32Column, Int32Array>;
+  I32_COLUMNS.forEach((name, i) => {
+    i32[name] = new Int32Array(buffer, I32_OFFSET + i * CAPACITY * 4, CAPACITY);
+  });
+  return {
+    control: new Int32Array(buffer, 0, CONTROL_BYTES / 4),
+    symbols: new Uint8Array(buffer, SYMBOLS_OFFSET, SYMBOL_SLOTS * SYMBOL_BYTES),
+    f64,
+    i32,
+  };
+}
+
+/**
+ * Producer side - lives in the ingest worker
+ */
+export class SharedTradeWriter {
+  private views: RingViews;
+  private symbolIndex: Map<string, number> = new Map();
+  private rejected: Set<string> = new Set();
+  private seq = 0;
+
+  constructor(buffer: SharedArrayBuffer) {
+    this.views = mapViews(buffer);
+  }
+
+  /**
+   * The symbol's slot in the name table, or -1 if it can't have one - the
+   * table is full, or the name isn't ASCII or doesn't fit in SYMBOL_BYTES.
+   * Sharing or truncating a slot would read trades back under another name.
+   */
+  private getSymbolIndex(symbol: string): number {
+    let index = this.symbolIndex.get(symbol);
+    if (index !== undefined) return index;
+    if (this.rejected.has(symbol)) return -1;
+
+    index = this.symbolIndex.size;
+    if (index >= SYMBOL_SLOTS || symbol.length > SYMBOL_BYTES || !/^[\x01-\x7f]*$/.test(symbol)) {
+      this.rejected.add(symbol);
+      console.warn(`[SharedTradeRing] No slot for ${symbol} (${index >= SYMBOL_SLOTS ? `all ${SYMBOL_SLOTS} in use` : `name must be ASCII, at most ${SYMBOL_BYTES} bytes`}) - its trades will be posted instead`);
+      return -1;
+    }
+
+    // Names are plain ASCII tickers - write them byte by byte, zero-padded
+    const base = index * SYMBOL_BYTES;
+    for (let i = 0; i < SYMBOL_BYTES; i++) {
+      this.views.symbols[base + i] = i < symbol.length ? symbol.charCodeAt(i) : 0;
+    }
+    this.symbolIndex.set(symbol, index);
+    Atomics.store(this.views.control, CTRL_SYMBOL_COUNT, this.symbolIndex.size);
+    return index;
+  }
+
+  /**
+   * Append a trade - false (nothing written) when its symbol has no slot,
+   * see getSymbolIndex; the caller sends those some other way
+   */
+  write(trade: TradeWithAnalytics): boolean {
+    const symbolIndex = this.getSymbolIndex(trade.symbol);
+    if (symbolIndex < 0) return false;
+
+    const { f64, i32, control } = this.views;
+    const i = this.seq & MASK;
+    const numericId = Number(trade.id);
+
+    f64.price[i] = trade.price;
+    f64.volume[i] = trade.volume;
+    f64.timestamp[i] = trade.timestamp;
+    f64.tradeId[i] = Number.isFinite(numericId) ? numericId : NaN;
+    f64.vwap[i] = trade.vwap;
+    f64.vwapDrift[i] = trade.vwapDrift;
+    f64.delta[i] = trade.delta;
+    f64.relativeStrength[i] = trade.relativeStrength;
+    f64.momentum[i] = trade.momentum;
+    f64.spreadAtPrint[i] = trade.spreadAtPrint;
+    i32.side[i] = encodeSide(trade.side);
+    i32.symbolIndex[i] = symbolIndex;
+    i32.venue[i] = Math.max(0, VENUES.indexOf(trade.exchange ?? ''));
+    i32.backfill[i] = trade.backfill ? 1 : 0;
+
+    this.seq = (this.seq + 1) | 0;
+    Atomics.store(control, CTRL_WRITE_SEQ, this.seq);
+    return true;
+  }
+}
+
+/**
+ * Consumer side - main thread, drained once per frame
+ */
+export class SharedTradeReader {
+  private views: RingViews;
+  private symbolNames: string[] = [];
+  private readSeq = 0;
+
+  constructor(buffer: SharedArrayBuffer) {
+    this.views = mapViews(buffer);
+  }
+
+  private getSymbolName(index: number): string {
+    let name = this.symbolNames[index];
+    if (name !== undefined) return name;
+
+    // TextDecoder refuses views over shared memory, and these are ASCII anyway
+    const base = index * SYMBOL_BYTES;
+    name = '';
+    for (let i = 0; i < SYMBOL_BYTES; i++) {
+      const c = this.views.symbols[base + i];
+      if (c === 0) break;
+      name += String.fromCharCode(c);
+    }
+    this.symbolNames[index] = name;
+    return name;
+  }
+
+  /**
+   * Everything written since the last read, oldest first
+   */
+  read(): TradeWithAnalytics[] {
+    const { f64, i32, control } = this.views;
+    const writeSeq = Atomics.load(control, CTRL_WRITE_SEQ);
+
+    let start = this.readSeq;
+    if (((writeSeq - start) | 0) > CAPACITY) {
+      start = (writeSeq - CAPACITY) | 0;
+    }
+
+    const count = (writeSeq - start) | 0;
+    if (count <= 0) return [];
+
+    const out: TradeWithAnalytics[] = [];
+    for (let n = 0; n < count; n++) {
+      const seq = (start + n) | 0;
+      const i = seq & MASK;
+      const timestamp = f64.timestamp[i];
+      const tradeId = f64.tradeId[i];
+
+      out.push({
+        id: Number.isNaN(tradeId) ? `${timestamp}-${seq}` : String(tradeId),
+        symbol: this.getSymbolName(i32.symbolIndex[i]),
+        assetType: 'crypto',
+        timestamp,
+        price: f64.price[i],
+        volume: f64.volume[i],
+        side: decodeSide(i32.side[i]),
+        exchange: VENUES[i32.venue[i]] || undefined,
+        vwap: f64.vwap[i],
+        vwapDrift: f64.vwapDrift[i],
+        delta: f64.delta[i],
+        relativeStrength: f64.relativeStrength[i],
+        momentum: f64.momentum[i],
+        spreadAtPrint: f64.spreadAtPrint[i],
+        backfill: i32.backfill[i] === 1,
+      });
+    }
+
+    // If the writer lapped us while we were copying, the oldest rows may be
+    // torn - drop anything it could have overwritten, including the slot of
+    // the write it may be in the middle of (seq `after`)
+    const after = Atomics.load(control, CTRL_WRITE_SEQ);
+    const overwritten = ((after - CAPACITY + 1) - start) | 0;
+    this.readSeq = writeSeq;
+    return overwritten > 0 ? out.slice(overwritten) : out;
+  }
+}
@@ -0,0 +1,103 @@
+// Per-symbol live slices - versioned price/volume/ticker state outside React, read on the frame clock
+
+import type { Ticker, Trade } from '../types';
+
+/**
+ * Everything about a symbol that changes with the market
+ *
+ * Written in place on the hot paths and never handed to zustand - a write
+ * only bumps version, and readers (useSymbolSlice) compare that once per
+ * render tick, so a change in one symbol re-renders nothing but that
+ * symbol's components, at frame rate at most. The ticker is replaced
+ * whole, never mutated, so readers can also compare it by identity.
+ */
+export interface SymbolSlice {
+  symbol: string;
+  version: number;
+  lastPrice: number;
+  priceChange: number;
+  priceChangePercent: number;
+  totalBuyVolume: number;
+  totalSellVolume: number;
+  lastTradeTime: number;    // Newest trade timestamp seen, sent as 'since' on resubscribe
+  ticker: Ticker | null;
+}
+
+const slices = new Map<string, SymbolSlice>();
+
+function createSlice(symbol: string): SymbolSlice {
+  return {
+    symbol,
+    version: 0,
+    lastPrice: 0,
+    priceChange: 0,
+    priceChangePercent: 0,
+    totalBuyVolume: 0,
+    totalSellVolume: 0,
+    lastTradeTime: 0,
+    ticker: null,
+  };
+}
+
+// What readers see for a symbol without a slice - never written to
+const EMPTY_SLICE: Readonly<SymbolSlice> = Object.freeze(createSlice(''));
+
+/**
+ * The symbol's slice, created empty if it doesn't exist yet (on subscribe)
+ */
+export function getSymbolSlice(symbol: string): SymbolSlice {
+  const key = symbol.toUpperCase();
+  let slice = slices.get(key);
+  if (!slice) {
+    slice = createSlice(key);
+    slices.set(key, slice);
+  }
+  return slice;
+}
+
+/**
+ * The symbol's slice, or a shared empty one - for readers, which shouldn't
+ * create slices for symbols that are going away
+ */
+export function readSymbolSlice(symbol: string): Readonly<SymbolSlice> {
+  return slices.get(symbol.toUpperCase()) ?? EMPTY_SLICE;
+}
+
+/**
+ * Fold a trade into its symbol's price tracking
+ *
+ * Like every writer here, a no-op for symbols without a slice, so
+ * stragglers for one we just unsubscribed don't bring it back.
+ */
+export function recordSliceTrade(trade: Trade): void {
+  const slice = slices.get(trade.symbol.toUpperCase());
+  if (!slice) return;
+
+  if (trade.timestamp > slice.lastTradeTime) slice.lastTradeTime = trade.timestamp;
+  const priceChange = trade.price - (slice.lastPrice || trade.price);
+  if (Math.abs(priceChange) > 0) {
+    slice.lastPrice = trade.price;
+    slice.priceChange = priceChange;
+    slice.priceChangePercent = slice.lastPrice ? (priceChange / slice.lastPrice) * 100 : 0;
+
+    if (trade.side === 'buy') {
+      slice.totalBuyVolume += trade.volume;
+    } else if (trade.side === 'sell') {
+      slice.totalSellVolume += trade.volume;
+    }
+  } else if (slice.lastPrice === 0) {
+    slice.lastPrice = trade.price;
+  }
+  slice.version++;
+}
+
+export function recordSliceTicker(ticker: Ticker): void {
+  const slice = slices.get(ticker.symbol.toUpperCase());
+  if (!slice) return;
+  slice.ticker = ticker;
+  slice.version++;
+}
+
+export function deleteSymbolSlice(symbol: string): void {
+  slices.delete(symbol.toUpperCase());
+}
@@ -0,0 +1,181 @@
+// Market data transports - main-thread WebSocket, or a Web Worker that owns the socket
+
+import type { ClientMessage, ServerMessage, Trade, TradeWithAnalytics } from '../types';
+import { decodeTradeFrame, isHistoryFrame, registerSymbolId } from './binaryProtocol';
+import { createSharedTradeRing, isSharedMemoryAvailable, SharedTradeReader } from './sharedTradeRing';
+import { resetAnalytics, resetAllAnalytics } from '../utils/calculations';
+import { globalClock } from './globalClock';
+import { onPerfHudChange, isPerfHudOpen, recordParse } from './perfProbe';
+import type { WorkerCommand, WorkerEvent } from '../workers/ingest.worker';
+
+/**
+ * Callbacks the store registers with whichever transport is active
+ *
+ * onTrades gets raw trades that still need enrichment (main-thread path),
+ * and onTradeHistory the subscribe-time history the same way.
+ * onEnrichedTrades gets trades the worker already ran through analytics -
+ * history included, marked with backfill.
+ */
+export interface TransportHandlers {
+  onOpen: () => void;
+  onClose: () => void;
+  onError: () => void;
+  onMessage: (message: ServerMessage) => void;
+  onTrades: (trades: Trade[]) => void;
+  onTradeHistory: (trades: Trade[]) => void;
+  onEnrichedTrades: (trades: TradeWithAnalytics[]) => void;
+}
+
+export interface MarketTransport {
+  readonly kind: 'socket' | 'worker';
+  send: (message: ClientMessage) => void;
+  close: () => void;
+  resetAnalytics: (symbol?: string) => void;
+}
+
+/**
+ * Plain WebSocket on the main thread
+ *
+ * Parsing and enrichment compete with React here, but it works everywhere -
+ * this is the fallback when the page isn't cross-origin isolated.
+ */
+export function createSocketTransport(url: string, handlers: TransportHandlers): MarketTransport {
+  const ws = new WebSocket(url);
+  ws.binaryType = 'arraybuffer';
+
+  ws.onopen = () => handlers.onOpen();
+  ws.onerror = () => handlers.onError();
+  ws.onclose = () => handlers.onClose();
+
+  ws.onmessage = (event) => {
+    // Binary frames are always trades - decode straight from the buffer, no JSON
+    const start = performance.now();
+    if (event.data instanceof ArrayBuffer) {
+      const trades = decodeTradeFrame(event.data);
+      recordParse(performance.now() - start, 1);
+      if (isHistoryFrame(event.data)) handlers.onTradeHistory(trades);
+      else handlers.onTrades(trades);
+      return;
+    }
+
+    try {
+      const message: ServerMessage = JSON.parse(event.data);
+      recordParse(performance.now() - start, 1);
+      if (message.type === 'trade' && message.data) {
+        handlers.onTrades([message.data as Trade]);
+      } else if (message.type === 'trades' && Array.isArray(message.data)) {
+        handlers.onTrades(message.data as Trade[]);
+      } else if (message.type === 'trade_history' && Array.isArray(message.data)) {
+        handlers.onTradeHistory(message.data as Trade[]);
+      } else {
+        if (message.type === 'subscribed' && message.symbol && message.symbolId !== undefined) {
+          registerSymbolId(message.symbolId, message.symbol);
+        }
+        handlers.onMessage(message);
+      }
+    } catch (error) {
+      console.error('Error parsing message:', error);
+    }
+  };
+
+  return {
+    kind: 'socket',
+    send: (message) => {
+      if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify(message));
+    },
+    close: () => ws.close(),
+    resetAnalytics: (symbol) => (symbol ? resetAnalytics(symbol) : resetAllAnalytics()),
+  };
+}
+
+// One worker for the life of the page - reconnects reuse it so the
+// analytics cache it owns survives a dropped socket
+let ingestWorker: Worker | null = null;
+let sharedReader: SharedTradeReader | null = null;
+let workerHandlers: TransportHandlers | null = null;
+let stopActiveDrain: (() => void) | null = null;
+let connectionId = 0;
+
+function getIngestWorker(): { worker: Worker; reader: SharedTradeReader } {
+  if (!ingestWorker || !sharedReader) {
+    const sharedRing = createSharedTradeRing();
+    sharedReader = new SharedTradeReader(sharedRing);
+    ingestWorker = new Worker(new URL('../workers/ingest.worker.ts', import.meta.url), { type: 'module' });
+    ingestWorker.onmessage = (event: MessageEvent<WorkerEvent>) => {
+      const msg = event.data;
+      const handlers = workerHandlers;
+      // Ignore stragglers from a socket we've already replaced
+      if (!handlers || msg.connectionId !== connectionId) return;
+      switch (msg.kind) {
+        case 'open': handlers.onOpen(); break;
+        case 'close': handlers.onClose(); break;
+        case 'error': handlers.onError(); break;
+        case 'message': handlers.onMessage(msg.message); break;
+        case 'parse': recordParse(msg.totalMs, msg.messages); break;
+        case 'trades': handlers.onEnrichedTrades(msg.trades); break;
+      }
+    };
+    const init: WorkerCommand = { kind: 'init', ring: sharedRing };
+    ingestWorker.postMessage(init);
+
+    // The worker only times its parsing while the perf HUD is open
+    const worker = ingestWorker;
+    const setPerf = (enabled: boolean) => {
+      const command: WorkerCommand = { kind: 'perf', enabled };
+      worker.postMessage(command);
+    };
+    if (isPerfHudOpen()) setPerf(true);
+    onPerfHudChange(setPerf);
+  }
+  return { worker: ingestWorker, reader: sharedReader };
+}
+
+/**
+ * WebSocket, JSON.parse and enrichment all run in a Web Worker
+ *
+ * Trades come back through the SharedArrayBuffer ring and are drained once
+ * per animation frame, so the main thread only ever does buffer bookkeeping
+ * and rendering. Everything else (book, ticker, control) is low-rate and
+ * arrives via postMessage, already parsed.
+ */
+export function createWorkerTransport(url: string, encoding: ClientMessage['encoding'], handlers: TransportHandlers): MarketTransport {
+  const { worker, reader } = getIngestWorker();
+  const id = ++connectionId;
+  workerHandlers = handlers;
+
+  const post = (command: WorkerCommand) => worker.postMessage(command);
+  const drain = () => {
+    const trades = reader.read();
+    if (trades.length > 0) handlers.onEnrichedTrades(trades);
+  };
+
+  // Only one connection drains the ring at a time
+  stopActiveDrain?.();
+  const stopDraining = globalClock.schedule(drain, { phase: 'ingest', priority: 'high', name: 'drain' });
+  stopActiveDrain = stopDraining;
+
+  post({ kind: 'connect', connectionId: id, url, encoding });
+
+  return {
+    kind: 'worker',
+    send: (message) => post({ kind: 'send', message }),
+    close: () => {
+      // Drain whatever is left so nothing in flight gets lost, then detach
+      drain();
+      stopDraining();
+      if (stopActiveDrain === stopDraining) stopActiveDrain = null;
+      post({ kind: 'disconnect' });
+    },
+    resetAnalytics: (symbol) => post({ kind: 'resetAnalytics', symbol }),
+  };
+}
+
+/**
+ * Pick the worker pipeline when shared memory is available (and not disabled
+ * with VITE_INGEST_WORKER=off), otherwise fall back to the main thread
+ */
+export function canUseIngestWorker(): boolean {
+  return import.meta.env.VITE_INGEST_WORKER !== 'off' &&
+    typeof Worker !== 'undefined' &&
+    isSharedMemoryAvailable();
+}
@@ -0,0 +1,359 @@
+// Traded volume by price - session volume profile and footprint bars on dense typed arrays
+
+import type { Trade, TradeSide } from '../types';
+import { ObjectRing } from './ringBuffer';
+
+const INITIAL_BUCKETS = 1024;
+const FOOTPRINT_BUCKETS = 64;
+const MAX_BUCKETS = 16384;        // Past this, buckets double in size instead of growing further
+
+// Window for "was this level actually traded" checks (filled vs pulled size)
+const RECENT_MS = 2000;
+
+const VALUE_AREA_SHARE = 0.7;
+
+export const FOOTPRINT_BAR_MS = 60_000;
+const FOOTPRINT_BARS = 60;
+
+/**
+ * Tick size assumed from price magnitude - the same bands formatPrice uses
+ * for precision, which match Binance's spot tick sizes for the pairs we show
+ */
+export function defaultTickSize(price: number): number {
+  if (price >= 100) return 0.01;
+  if (price >= 1) return 0.0001;
+  if (price >= 0.01) return 0.000001;
+  return 0.00000001;
+}
+
+export interface ValueArea {
+  poc: number;      // Price of the highest-volume bucket
+  low: number;      // Value area: the ~70% of volume around the POC
+  high: number;
+}
+
+/**
+ * Volume traded at each price, split by aggressor side
+ *
+ * Prices are quantized to integer tick keys (round(price / tickSize)), and
+ * a bucket is groupTicks ticks wide. Buckets are dense Float64Arrays indexed
+ * by key - origin, so a trade is one index computation and two adds, with
+ * no Map entries keyed by floats. The array grows (doubling, re-centered)
+ * when price walks off either end. Once it would pass MAX_BUCKETS,
+ * neighbouring buckets are merged and groupTicks doubles instead, so memory
+ * stays bounded however far price trends in a session.
+ *
+ * The point of control is tracked as trades land; the value area is computed
+ * on demand from the POC outward.
+ */
+export class VolumeProfile {
+  groupTicks = 1;
+  totalVolume = 0;
+
+  private origin = 0;             // Bucket key at index 0
+  private capacity = 0;
+  private buy = new Float64Array(0);
+  private sell = new Float64Array(0);
+  private recentVolume = new Float64Array(0);
+  private recentTime = new Float64Array(0);
+  private lo = -1;                // Lowest / highest index with volume
+  private hi = -1;
+  private pocIndex = -1;
+  private pocVolume = 0;
+
+  constructor(readonly tickSize: number, private initialBuckets: number = INITIAL_BUCKETS) {}
+
+  get bucketSize(): number {
+    return this.tickSize * this.groupTicks;
+  }
+
+  get isEmpty(): boolean {
+    return this.lo < 0;
+  }
+
+  /**
+   * Record one trade - O(1) except when the arrays have to grow
+   */
+  add(price: number, volume: number, side: TradeSide, now: number): void {
+    const i = this.indexFor(price);
+
+    // Unclassified prints still count as "traded here" for recency, but the
+    // profile itself is split by aggressor
+    if (side === 'buy') this.buy[i] += volume;
+    else if (side === 'sell') this.sell[i] += volume;
+    if (side !== 'neutral') this.totalVolume += volume;
+
+    if (now - this.recentTime[i] > RECENT_MS) this.recentVolume[i] = 0;
+    this.recentVolume[i] += volume;
+    this.recentTime[i] = now;
+
+    if (this.lo < 0 || i < this.lo) this.lo = i;
+    if (i > this.hi) this.hi = i;
+
+    const total = this.buy[i] + this.sell[i];
+    if (total > this.pocVolume) {
+      this.pocVolume = total;
+      this.pocIndex = i;
+    }
+  }
+
+  /**
+   * Volume traded at price's bucket within the last RECENT_MS
+   */
+  recentVolumeAt(price: number, now: number): number {
+    const i = this.keyOf(price) - this.origin;
+    if (i < 0 || i >= this.capacity) return 0;
+    return now - this.recentTime[i] <= RECENT_MS ? this.recentVolume[i] : 0;
+  }
+
+  // -- Reading buckets (panels walk firstIndex..lastIndex) --
+
+  get firstIndex(): number {
+    return this.lo;
+  }
+
+  get lastIndex(): number {
+    return this.hi;
+  }
+
+  priceAt(index: number): number {
+    return (this.origin + index) * this.bucketSize;
+  }
+
+  buyAt(index: number): number {
+    return this.buy[index] ?? 0;
+  }
+
+  sellAt(index: number): number {
+    return this.sell[index] ?? 0;
+  }
+
+  indexOfPrice(price: number): number {
+    return this.keyOf(price) - this.origin;
+  }
+
+  get maxBucketVolume(): number {
+    return this.pocVolume;
+  }
+
+  /**
+   * POC plus the value area, grown one bucket at a time toward whichever
+   * neighbour traded more until it holds VALUE_AREA_SHARE of the volume
+   */
+  valueArea(): ValueArea | null {
+    if (this.pocIndex < 0) return null;
+    const target = this.totalVolume * VALUE_AREA_SHARE;
+    let low = this.pocIndex;
+    let high = this.pocIndex;
+    let volume = this.pocVolume;
+
+    while (volume < target && (low > this.lo || high < this.hi)) {
+      const below = low > this.lo ? this.buy[low - 1] + this.sell[low - 1] : -1;
+      const above = high < this.hi ? this.buy[high + 1] + this.sell[high + 1] : -1;
+      if (above >= below) {
+        high++;
+        volume += above;
+      } else {
+        low--;
+        volume += below;
+      }
+    }
+
+    return {
+      poc: this.priceAt(this.pocIndex),
+      low: this.priceAt(low),
+      high: this.priceAt(high) + this.bucketSize,
+    };
+  }
+
+  private keyOf(price: number): number {
+    return Math.floor(Math.round(price / this.tickSize) / this.groupTicks);
+  }
+
+  /**
+   * Array index for a bucket key, growing or coarsening the arrays if needed
+   */
+  private indexFor(price: number): number {
+    for (;;) {
+      const key = this.keyOf(price);
+      if (this.capacity === 0) {
+        this.relayout(this.initialBuckets, key - (this.initialBuckets >> 1));
+        return key - this.origin;
+      }
+
+      const i = key - this.origin;
+      if (i >= 0 && i < this.capacity) return i;
+
+      // Span the new key together with what's already filled
+      const usedLow = this.lo < 0 ? key : Math.min(key, this.origin + this.lo);
+      const usedHigh = this.lo < 0 ? key : Math.max(key, this.origin + this.hi);
+      const span = usedHigh - usedLow + 1;
+
+      if (span * 2 <= MAX_BUCKETS) {
+        let capacity = this.capacity;
+        while (capacity < span * 2) capacity *= 2;
+        this.relayout(capacity, usedLow - ((capacity - span) >> 1));
+        return key - this.origin;
+      }
+
+      // Too wide at this bucket size - merge pairs and look the price up again
+      this.coarsen();
+    }
+  }
+
+  /**
+   * Move the filled buckets into arrays of `capacity` starting at key `origin`
+   */
+  private relayout(capacity: number, origin: number): void {
+    const buy = new Float64Array(capacity);
+    const sell = new Float64Array(capacity);
+    const recentVolume = new Float64Array(capacity);
+    const recentTime = new Float64Array(capacity);
+    const shift = this.origin - origin;
+
+    if (this.lo >= 0) {
+      buy.set(this.buy.subarray(this.lo, this.hi + 1), this.lo + shift);
+      sell.set(this.sell.subarray(this.lo, this.hi + 1), this.lo + shift);
+      recentVolume.set(this.recentVolume.subarray(this.lo, this.hi + 1), this.lo + shift);
+      recentTime.set(this.recentTime.subarray(this.lo, this.hi + 1), this.lo + shift);
+      this.lo += shift;
+      this.hi += shift;
+      if (this.pocIndex >= 0) this.pocIndex += shift;
+    }
+
+    this.buy = buy;
+    this.sell = sell;
+    this.recentVolume = recentVolume;
+    this.recentTime = recentTime;
+    this.capacity = capacity;
+    this.origin = origin;
+  }
+
+  /**
+   * Double the bucket width, merging neighbouring buckets
+   */
+  private coarsen(): void {
+    const oldBuy = this.buy;
+    const oldSell = this.sell;
+    const oldRecentVolume = this.recentVolume;
+    const oldRecentTime = this.recentTime;
+    const oldOrigin = this.origin;
+    const oldLo = this.lo;
+    const oldHi = this.hi;
+
+    this.groupTicks *= 2;
+    const lowKey = Math.floor((oldOrigin + oldLo) / 2);
+    const highKey = Math.floor((oldOrigin + oldHi) / 2);
+    const span = highKey - lowKey + 1;
+    const capacity = this.capacity;
+    const origin = lowKey - ((capacity - span) >> 1);
+
+    this.buy = new Float64Array(capacity);
+    this.sell = new Float64Array(capacity);
+    this.recentVolume = new Float64Array(capacity);
+    this.recentTime = new Float64Array(capacity);
+    this.origin = origin;
+    this.lo = lowKey - origin;
+    this.hi = highKey - origin;
+    this.pocIndex = -1;
+    this.pocVolume = 0;
+
+    for (let i = oldLo; i <= oldHi; i++) {
+      const j = Math.floor((oldOrigin + i) / 2) - origin;
+      this.buy[j] += oldBuy[i];
+      this.sell[j] += oldSell[i];
+      this.recentVolume[j] += oldRecentVolume[i];
+      if (oldRecentTime[i] > this.recentTime[j]) this.recentTime[j] = oldRecentTime[i];
+    }
+    for (let j = this.lo; j <= this.hi; j++) {
+      const total = this.buy[j] + this.sell[j];
+      if (total > this.pocVolume) {
+        this.pocVolume = total;
+        this.pocIndex = j;
+      }
+    }
+  }
+}
+
+/**
+ * One time bar of the footprint chart
+ */
+export interface FootprintBar {
+  start: number;
+  open: number;
+  high: number;
+  low: number;
+  close: number;
+  delta: number;          // Buy - sell volume in the bar
+  profile: VolumeProfile;
+}
+
+/**
+ * Everything tracked per symbol: the session profile and recent footprint bars
+ */
+export class SymbolProfile {
+  session: VolumeProfile | null = null;
+  readonly bars = new ObjectRing<FootprintBar>(FOOTPRINT_BARS);
+  version = 0;
+
+  add(trade: Trade): void {
+    const { price, volume, side, timestamp } = trade;
+    if (!(price > 0) || !(volume > 0)) return;
+
+    // Recency is local receive time, so checks against Date.now() don't
+    // depend on exchange clock skew; bars are cut on exchange time
+    const now = Date.now();
+    if (!this.session) this.session = new VolumeProfile(defaultTickSize(price));
+    this.session.add(price, volume, side, now);
+
+    const start = timestamp - (timestamp % FOOTPRINT_BAR_MS);
+    let bar = this.bars.length > 0 ? this.bars.get(this.bars.length - 1) : undefined;
+    if (!bar || start > bar.start) {
+      bar = {
+        start,
+        open: price,
+        high: price,
+        low: price,
+        close: price,
+        delta: 0,
+        profile: new VolumeProfile(this.session.tickSize, FOOTPRINT_BUCKETS),
+      };
+      this.bars.push(bar);
+    }
+    if (price > bar.high) bar.high = price;
+    if (price < bar.low) bar.low = price;
+    bar.close = price;
+    if (side === 'buy') bar.delta += volume;
+    else if (side === 'sell') bar.delta -= volume;
+    bar.profile.add(price, volume, side, now);
+
+    this.version++;
+  }
+
+  /**
+   * Volume traded at a price in the last couple of seconds
+   */
+  recentVolumeAt(price: number, now: number): number {
+    return this.session ? this.session.recentVolumeAt(price, now) : 0;
+  }
+}
+
+const profiles = new Map<string, SymbolProfile>();
+
+export function getSymbolProfile(symbol: string): SymbolProfile {
+  const key = symbol.toUpperCase();
+  let p = profiles.get(key);
+  if (!p) {
+    p = new SymbolProfile();
+    profiles.set(key, p);
+  }
+  return p;
+}
+
+export function recordProfileTrade(trade: Trade): void {
+  getSymbolProfile(trade.symbol).add(trade);
+}
+
+export function clearSymbolProfile(symbol: string): void {
+  profiles.delete(symbol.toUpperCase());
+}
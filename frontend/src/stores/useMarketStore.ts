@@ -5,7 +5,10 @@ import { subscribeWithSelector } from 'zustand/middleware';
 import {
   Trade,
   OrderBook,
+  OrderBookDelta,
   Ticker,
+  Signal,
+  TradeSummary,
   SymbolInfo,
   SymbolState,
   TradeWithAnalytics,
@@ -13,16 +16,39 @@ import {
   LayoutSettings,
   AssetType,
   ServerMessage,
+  TradeFilter,
+  WireEncoding,
 } from '../types';
-import { enrichTradeWithAnalytics, resetAnalytics } from '../utils/calculations';
-import { pushTrade, pushOrderBook, pushTicker, pushToCombinedBuffer } from '../services/dataBuffer';
+import { enrichTradeHistory, enrichTradeWithAnalytics, recordRollingStats, resetAnalytics, whaleMinFor } from '../utils/calculations';
+import {
+  pushEnrichedTrade,
+  pushTradeHistory,
+  pushOrderBook,
+  pushOrderBookDelta,
+  pushTicker,
+  pushSignal,
+  pushToCombinedBuffer,
+  getCurrentOrderBook,
+  clearSymbolBuffer,
+} from '../services/dataBuffer';
+import { clearDepthHistory } from '../services/depthHistory';
+import { clearSymbolProfile } from '../services/volumeProfile';
+import { deleteSymbolSlice, getSymbolSlice, readSymbolSlice, recordSliceTrade } from '../services/symbolSlices';
+import { globalClock } from '../services/globalClock';
+import {
+  MarketTransport,
+  TransportHandlers,
+  canUseIngestWorker,
+  createSocketTransport,
+  createWorkerTransport,
+} from '../services/transport';
 
 interface MarketStore {
   // Connection
   isConnected: boolean;
   connectionError: string | null;
   reconnectAttempts: number;
-  ws: WebSocket | null;
+  transport: MarketTransport | null;
   
   // Market data
   symbols: Map<string, SymbolState>;
@@ -47,17 +73,64 @@ interface MarketStore {
   clearTrades: (symbol?: string) => void;
   
   // Internal
-  _handleMessage: (event: MessageEvent) => void;
+  _handleMessage: (message: ServerMessage) => void;
   _handleTrade: (trade: Trade) => void;
+  _handleTradeHistory: (trades: Trade[]) => void;
+  _handleEnrichedTrades: (trades: TradeWithAnalytics[]) => void;
   _handleOrderBook: (orderBook: OrderBook) => void;
+  _handleOrderBookDelta: (delta: OrderBookDelta) => void;
   _reconnect: () => void;
 }
 
 // Config
 const WS_URL = import.meta.env.VITE_WS_URL || 'ws://localhost:3001';
+// Binary trade frames skip JSON.parse on the hottest path; set VITE_WIRE_ENCODING=json to debug
+const WIRE_ENCODING: WireEncoding = import.meta.env.VITE_WIRE_ENCODING === 'json' ? 'json' : 'binary';
+// The book panels repaint at most every 100ms, so the server can conflate
+// book and ticker updates down to this many per symbol per second
+const BOOK_MAX_RATE = 10;
+// ...and a hidden page paints nothing, so it only needs to be current when it comes back
+const HIDDEN_BOOK_MAX_RATE = 1;
 const MAX_TRADES = 500;
 const MAX_RECONNECT_ATTEMPTS = 10;
 const RECONNECT_DELAY = 1000;
+// Don't ask for another book resync while one is (probably) still in flight
+const RESYNC_INTERVAL_MS = 2000;
+
+/**
+ * The server-side filter for every subscription, while the combined tape
+ * with a minimum print is all that's on screen
+ * 
+ * Nothing else reads trades then, so small prints are dropped before the
+ * server serializes them. What does arrive is a filtered stream: it feeds
+ * the combined tape and nothing per-symbol (VWAP, CVD, tape, profile),
+ * which would otherwise depend on a display setting. Dropping the filter
+ * starts those afresh from the tape the server sends back.
+ */
+function combinedTapeFilter(settings: LayoutSettings): TradeFilter | undefined {
+  if (!settings.combinedTape || !settings.combinedMinNotional) return undefined;
+  return { minNotional: settings.combinedMinNotional };
+}
+
+/**
+ * Whether a print makes the combined tape - the server's filter, applied
+ * again here for the trades already in flight when it changed
+ */
+function onCombinedTape(trade: Trade, settings: LayoutSettings): boolean {
+  const min = settings.combinedMinNotional;
+  if (!min) return true;
+  return trade.price * trade.volume >= (min === 'whale' ? whaleMinFor(trade.price) : min);
+}
+
+function bookMaxRate(): number {
+  return typeof document !== 'undefined' && document.hidden ? HIDDEN_BOOK_MAX_RATE : BOOK_MAX_RATE;
+}
+
+// validateSymbol callers waiting on a 'validation' reply, oldest first
+const validationWaiters: ((info: SymbolInfo | null) => void)[] = [];
+
+// Last time we asked the server for a fresh book, per symbol
+const lastResyncRequest = new Map<string, number>();
 
 export const useMarketStore = create<MarketStore>()(
   subscribeWithSelector((set, get) => ({
@@ -65,7 +138,7 @@ export const useMarketStore = create<MarketStore>()(
     isConnected: false,
     connectionError: null,
     reconnectAttempts: 0,
-    ws: null,
+    transport: null,
     symbols: new Map(),
     activeSymbols: [],
     selectedSymbol: null,
@@ -73,65 +146,83 @@ export const useMarketStore = create<MarketStore>()(
     combinedTrades: [],
     settings: {
       combinedTape: false,
+      combinedMinNotional: 0,
       darkMode: true,
       pauseScroll: false,
       maxTrades: MAX_TRADES,
+      bookView: 'levels',
+      perfHud: false,
+      renderRate: 'auto',
     },
     
     /**
      * Connect to the WebSocket server
      */
     connect: () => {
-      const { ws, isConnected } = get();
+      const { transport, isConnected } = get();
       
-      if (ws && isConnected) {
+      if (transport && isConnected) {
         console.log('Already connected');
         return;
       }
       
       try {
-        console.log(`Connecting to ${WS_URL}...`);
-        const newWs = new WebSocket(WS_URL);
+        const useWorker = canUseIngestWorker();
+        console.log(`Connecting to ${WS_URL}${useWorker ? ' (ingest worker)' : ''}...`);
         
-        newWs.onopen = () => {
-          console.log('WebSocket connected');
-          set({
-            ws: newWs,
-            isConnected: true,
-            connectionError: null,
-            reconnectAttempts: 0,
-          });
-          
-          // Resubscribe to any symbols we were watching before disconnect
-          const { activeSymbols, symbols } = get();
-          for (const symbol of activeSymbols) {
-            const state = symbols.get(symbol);
-            if (state) {
-              newWs.send(JSON.stringify({
-                type: 'subscribe',
-                symbol,
-                assetType: state.assetType,
-              }));
+        let newTransport: MarketTransport | null = null;
+        const handlers: TransportHandlers = {
+          onOpen: () => {
+            console.log('WebSocket connected');
+            set({
+              transport: newTransport,
+              isConnected: true,
+              connectionError: null,
+              reconnectAttempts: 0,
+            });
+            
+            // Resubscribe to any symbols we were watching before disconnect
+            const { activeSymbols, symbols, settings } = get();
+            const filter = combinedTapeFilter(settings);
+            for (const symbol of activeSymbols) {
+              const state = symbols.get(symbol);
+              if (state) {
+                newTransport?.send({
+                  type: 'subscribe',
+                  symbol,
+                  assetType: state.assetType,
+                  encoding: WIRE_ENCODING,
+                  bookDeltas: true,
+                  maxRate: bookMaxRate(),
+                  since: readSymbolSlice(symbol).lastTradeTime || undefined,
+                  filter,
+                });
+              }
             }
-          }
+          },
+          onMessage: (message) => get()._handleMessage(message),
+          onTrades: (trades) => {
+            const { _handleTrade } = get();
+            for (const trade of trades) _handleTrade(trade);
+          },
+          onTradeHistory: (trades) => get()._handleTradeHistory(trades),
+          onEnrichedTrades: (trades) => get()._handleEnrichedTrades(trades),
+          onError: () => {
+            console.error('WebSocket error');
+            set({ connectionError: 'Connection error' });
+          },
+          onClose: () => {
+            console.log('WebSocket disconnected');
+            set({ isConnected: false, transport: null });
+            get()._reconnect();
+          },
         };
         
-        newWs.onmessage = (event) => {
-          get()._handleMessage(event);
-        };
+        newTransport = useWorker
+          ? createWorkerTransport(WS_URL, WIRE_ENCODING, handlers)
+          : createSocketTransport(WS_URL, handlers);
         
-        newWs.onerror = (error) => {
-          console.error('WebSocket error:', error);
-          set({ connectionError: 'Connection error' });
-        };
-        
-        newWs.onclose = () => {
-          console.log('WebSocket disconnected');
-          set({ isConnected: false, ws: null });
-          get()._reconnect();
-        };
-        
-        set({ ws: newWs });
+        set({ transport: newTransport });
       } catch (error) {
         console.error('Failed to connect:', error);
         set({ connectionError: 'Failed to connect' });
@@ -142,12 +233,12 @@ export const useMarketStore = create<MarketStore>()(
      * Disconnect and stop auto-reconnect
      */
     disconnect: () => {
-      const { ws } = get();
-      if (ws) {
-        ws.close();
+      const { transport } = get();
+      if (transport) {
+        transport.close();
       }
       set({
-        ws: null,
+        transport: null,
         isConnected: false,
         reconnectAttempts: MAX_RECONNECT_ATTEMPTS, // Prevent auto-reconnect
       });
@@ -174,44 +265,60 @@ export const useMarketStore = create<MarketStore>()(
     },
     
     /**
-     * Route incoming WebSocket messages to appropriate handlers
+     * Route incoming server messages to appropriate handlers
+     * 
+     * Trades never come through here - the transport decodes them (JSON or
+     * binary) and hands them to _handleTrade / _handleTradeHistory /
+     * _handleEnrichedTrades directly.
      */
-    _handleMessage: (event: MessageEvent) => {
-      try {
-        const message: ServerMessage = JSON.parse(event.data);
-        
-        switch (message.type) {
-          case 'trade':
-            if (message.data) {
-              get()._handleTrade(message.data as Trade);
-            }
-            break;
-          case 'orderbook':
-            if (message.data) {
-              get()._handleOrderBook(message.data as OrderBook);
-            }
-            break;
-          case 'ticker':
-            if (message.data) {
-              // Ticker goes straight to buffer - no state update
-              pushTicker(message.data as Ticker);
-            }
-            break;
-          case 'subscribed':
-            console.log(`Subscribed to ${message.symbol}`);
-            break;
-          case 'unsubscribed':
-            console.log(`Unsubscribed from ${message.symbol}`);
-            break;
-          case 'error':
-            console.error('Server error:', message.error);
-            break;
-          case 'connected':
-            console.log('Server confirmed connection');
-            break;
-        }
-      } catch (error) {
-        console.error('Error parsing message:', error);
+    _handleMessage: (message: ServerMessage) => {
+      switch (message.type) {
+        case 'orderbook':
+          if (message.data) {
+            get()._handleOrderBook(message.data as OrderBook);
+          }
+          break;
+        case 'orderbook_delta':
+          if (message.data) {
+            get()._handleOrderBookDelta(message.data as OrderBookDelta);
+          }
+          break;
+        case 'ticker':
+          if (message.data) {
+            // Ticker goes straight to buffer - no state update
+            pushTicker(message.data as Ticker);
+          }
+          break;
+        case 'signal':
+          if (message.data) {
+            pushSignal(message.data as Signal);
+          }
+          break;
+        case 'trade_summary':
+          if (message.data) {
+            // We fell behind and the server skipped these - the tape has a gap here
+            const summary = message.data as TradeSummary;
+            console.warn(
+              `Connection fell behind on ${summary.symbol}: ${summary.count} trades ` +
+              `(${summary.volume.toFixed(4)} vol, ${summary.open} -> ${summary.close}) summarised by the server`
+            );
+          }
+          break;
+        case 'validation':
+          validationWaiters.shift()?.(message.data as SymbolInfo);
+          break;
+        case 'subscribed':
+          console.log(`Subscribed to ${message.symbol}`);
+          break;
+        case 'unsubscribed':
+          console.log(`Unsubscribed from ${message.symbol}`);
+          break;
+        case 'error':
+          console.error('Server error:', message.error);
+          break;
+        case 'connected':
+          console.log('Server confirmed connection');
+          break;
       }
     },
     
@@ -225,94 +332,120 @@ export const useMarketStore = create<MarketStore>()(
      * at 60fps, batching hundreds of trades into one re-render.
      * 
      * What we DO update (cheap):
-     * - Last price (primitive, no re-render cascade)
-     * - Buy/sell volume accumulators (primitives)
+     * - The symbol's slice: last price, buy/sell volume, a version bump.
+     *   Components read it on the frame clock (useSymbolSlice).
      * 
      * What we DON'T update (expensive):
-     * - trades[] array (would trigger array diff in React)
-     * - Any nested objects (would trigger deep comparison)
+     * - Anything in the zustand store - a set() here re-renders every
+     *   subscriber of whatever it touched, on every trade
+     * 
+     * Enrichment happens here and only here: it advances the running
+     * VWAP/CVD state, so the symbol tape, combined tape and signals all
+     * share this one result.
      */
     _handleTrade: (trade: Trade) => {
-      const { symbols, settings } = get();
-      const symbol = trade.symbol.toUpperCase();
+      const { settings } = get();
+      const enrichedTrade = enrichTradeWithAnalytics(trade, getCurrentOrderBook(trade.symbol));
       
-      // Create symbol state if this is the first trade
-      let state = symbols.get(symbol);
-      if (!state) {
-        state = {
-          symbol,
-          assetType: trade.assetType,
-          trades: [],
-          orderBook: null,
-          isLoading: false,
-          vwap: 0,
-          totalBuyVolume: 0,
-          totalSellVolume: 0,
-          delta: 0,
-          lastPrice: trade.price,
-          priceChange: 0,
-          priceChangePercent: 0,
-          highPrice: trade.price,
-          lowPrice: trade.price,
-        };
-        symbols.set(symbol, state);
-        set({ symbols: new Map(symbols) });
+      // Filtered stream - the combined tape's alone
+      if (combinedTapeFilter(settings)) {
+        if (onCombinedTape(enrichedTrade, settings)) pushToCombinedBuffer(enrichedTrade);
+        return;
       }
       
       // Push to buffer - NO React re-render here!
-      pushTrade(trade);
+      pushEnrichedTrade(enrichedTrade);
       
       // Also add to combined buffer if that mode is enabled
-      if (settings.combinedTape) {
-        const enrichedTrade = enrichTradeWithAnalytics(trade, state.orderBook);
+      if (settings.combinedTape && onCombinedTape(enrichedTrade, settings)) {
         pushToCombinedBuffer(enrichedTrade);
       }
       
-      // Update price tracking (this is fast, minimal state)
-      const priceChange = trade.price - (state.lastPrice || trade.price);
-      if (Math.abs(priceChange) > 0) {
-        state.lastPrice = trade.price;
-        state.priceChange = priceChange;
-        state.priceChangePercent = state.lastPrice ? (priceChange / state.lastPrice) * 100 : 0;
-        
-        if (trade.side === 'buy') {
-          state.totalBuyVolume += trade.volume;
-        } else if (trade.side === 'sell') {
-          state.totalSellVolume += trade.volume;
+      recordSliceTrade(trade);
+    },
+    
+    /**
+     * Handle the recent trades the server sends once on subscribe
+     * 
+     * One analytics sweep and one buffer push for the whole batch, instead
+     * of _handleTrade per print. History stays off the combined tape - it
+     * would land out of order between other symbols' live prints.
+     */
+    _handleTradeHistory: (trades: Trade[]) => {
+      if (combinedTapeFilter(get().settings)) return;
+      pushTradeHistory(enrichTradeHistory(trades));
+      for (const trade of trades) recordSliceTrade(trade);
+    },
+    
+    /**
+     * Handle a batch of trades the ingest worker already enriched
+     * 
+     * Same bookkeeping as _handleTrade minus the analytics, which were
+     * computed once, off the main thread. Only the rolling windows are
+     * advanced here, so windowed stats can be read on this side. Runs of
+     * backfill go to the tape as history, in order with the live prints.
+     */
+    _handleEnrichedTrades: (trades: TradeWithAnalytics[]) => {
+      const { settings } = get();
+      let history: TradeWithAnalytics[] | null = null;
+      
+      if (combinedTapeFilter(settings)) {
+        for (const trade of trades) {
+          if (!trade.backfill && onCombinedTape(trade, settings)) pushToCombinedBuffer(trade);
+        }
+        return;
+      }
+      
+      for (const trade of trades) {
+        recordRollingStats(trade);
+        recordSliceTrade(trade);
+        if (trade.backfill) {
+          if (!history) history = [];
+          history.push(trade);
+          continue;
+        }
+        if (history) {
+          pushTradeHistory(history);
+          history = null;
+        }
+        pushEnrichedTrade(trade);
+        if (settings.combinedTape && onCombinedTape(trade, settings)) {
+          pushToCombinedBuffer(trade);
         }
       }
+      if (history) pushTradeHistory(history);
     },
     
     /**
-     * Handle incoming order book update
+     * Handle incoming order book snapshot
      * Same deal as trades - goes to buffer, not React state
      */
     _handleOrderBook: (orderBook: OrderBook) => {
       pushOrderBook(orderBook);
+    },
+    
+    /**
+     * Apply an incremental book update in place
+     * 
+     * If the sequence doesn't line up we've missed a delta - the book is
+     * wrong until the server sends a fresh snapshot, so ask for one (at most
+     * every RESYNC_INTERVAL_MS per symbol).
+     */
+    _handleOrderBookDelta: (delta: OrderBookDelta) => {
+      const symbol = delta.symbol.toUpperCase();
       
-      // Ensure symbol state exists
-      const { symbols } = get();
-      const symbol = orderBook.symbol.toUpperCase();
+      if (pushOrderBookDelta(delta) === 'gap') {
+        const now = Date.now();
+        if (now - (lastResyncRequest.get(symbol) ?? 0) >= RESYNC_INTERVAL_MS) {
+          lastResyncRequest.set(symbol, now);
+          console.log(`Order book gap for ${symbol} - requesting resync`);
+          get().transport?.send({ type: 'resync', symbol });
+        }
+        return;
+      }
       
-      if (!symbols.has(symbol)) {
-        const state: SymbolState = {
-          symbol,
-          assetType: orderBook.assetType,
-          trades: [],
-          orderBook: null,
-          isLoading: false,
-          vwap: 0,
-          totalBuyVolume: 0,
-          totalSellVolume: 0,
-          delta: 0,
-          lastPrice: 0,
-          priceChange: 0,
-          priceChangePercent: 0,
-          highPrice: 0,
-          lowPrice: 0,
-        };
-        symbols.set(symbol, state);
-        set({ symbols: new Map(symbols) });
+      if (delta.snapshot) {
+        lastResyncRequest.delete(symbol);
       }
     },
     
@@ -320,7 +453,7 @@ export const useMarketStore = create<MarketStore>()(
      * Subscribe to a symbol's market data
      */
     subscribe: (symbol: string, assetType?: AssetType) => {
-      const { ws, activeSymbols, symbols, isConnected } = get();
+      const { transport, activeSymbols, symbols, isConnected, settings } = get();
       const upperSymbol = symbol.toUpperCase();
       
       if (activeSymbols.includes(upperSymbol)) {
@@ -337,31 +470,25 @@ export const useMarketStore = create<MarketStore>()(
         trades: [],
         orderBook: null,
         isLoading: true,
-        vwap: 0,
-        totalBuyVolume: 0,
-        totalSellVolume: 0,
-        delta: 0,
-        lastPrice: 0,
-        priceChange: 0,
-        priceChangePercent: 0,
-        highPrice: 0,
-        lowPrice: 0,
       };
-      
-      symbols.set(upperSymbol, state);
+      getSymbolSlice(upperSymbol);
       
       set({
-        symbols: new Map(symbols),
+        symbols: new Map(symbols).set(upperSymbol, state),
         activeSymbols: [...activeSymbols, upperSymbol],
       });
       
       // Tell the server to start streaming
-      if (ws && isConnected) {
-        ws.send(JSON.stringify({
+      if (transport && isConnected) {
+        transport.send({
           type: 'subscribe',
           symbol: upperSymbol,
           assetType: detectedType,
-        }));
+          encoding: WIRE_ENCODING,
+          bookDeltas: true,
+          maxRate: bookMaxRate(),
+          filter: combinedTapeFilter(settings),
+        });
       }
     },
     
@@ -369,12 +496,16 @@ export const useMarketStore = create<MarketStore>()(
      * Unsubscribe from a symbol
      */
     unsubscribe: (symbol: string) => {
-      const { ws, activeSymbols, symbols, tabs, selectedSymbol, isConnected } = get();
+      const { transport, activeSymbols, symbols, tabs, selectedSymbol, isConnected } = get();
       const upperSymbol = symbol.toUpperCase();
       
       const newActiveSymbols = activeSymbols.filter(s => s !== upperSymbol);
-      symbols.delete(upperSymbol);
-      resetAnalytics(upperSymbol);
+      const newSymbols = new Map(symbols);
+      newSymbols.delete(upperSymbol);
+      deleteSymbolSlice(upperSymbol);
+      resetSymbolAnalytics(transport, upperSymbol);
+      clearDepthHistory(upperSymbol);
+      clearSymbolProfile(upperSymbol);
       
       const newTabs = tabs.filter(t => t.symbol !== upperSymbol);
       
@@ -385,17 +516,17 @@ export const useMarketStore = create<MarketStore>()(
       }
       
       set({
-        symbols: new Map(symbols),
+        symbols: newSymbols,
         activeSymbols: newActiveSymbols,
         tabs: newTabs,
         selectedSymbol: newSelectedSymbol,
       });
       
-      if (ws && isConnected) {
-        ws.send(JSON.stringify({
+      if (transport && isConnected) {
+        transport.send({
           type: 'unsubscribe',
           symbol: upperSymbol,
-        }));
+        });
       }
     },
     
@@ -403,38 +534,32 @@ export const useMarketStore = create<MarketStore>()(
      * Validate a symbol before subscribing
      */
     validateSymbol: async (symbol: string): Promise<SymbolInfo | null> => {
-      const { ws, isConnected } = get();
+      const { transport, isConnected } = get();
       
-      if (!ws || !isConnected) {
+      if (!transport || !isConnected) {
         return null;
       }
       
       return new Promise((resolve) => {
-        const upperSymbol = symbol.toUpperCase();
-        
-        const handler = (event: MessageEvent) => {
-          try {
-            const message: ServerMessage = JSON.parse(event.data);
-            if (message.type === 'validation') {
-              ws.removeEventListener('message', handler);
-              resolve(message.data as SymbolInfo);
-            }
-          } catch (error) {
-            // Ignore parse errors
-          }
+        // Replies come back in request order, _handleMessage resolves the oldest waiter
+        let settled = false;
+        const waiter = (info: SymbolInfo | null) => {
+          if (settled) return;
+          settled = true;
+          resolve(info);
         };
+        validationWaiters.push(waiter);
         
-        ws.addEventListener('message', handler);
-        
-        ws.send(JSON.stringify({
+        transport.send({
           type: 'validate',
-          symbol: upperSymbol,
-        }));
+          symbol: symbol.toUpperCase(),
+        });
         
         // Don't wait forever
         setTimeout(() => {
-          ws.removeEventListener('message', handler);
-          resolve(null);
+          const index = validationWaiters.indexOf(waiter);
+          if (index >= 0) validationWaiters.splice(index, 1);
+          waiter(null);
         }, 5000);
       });
     },
@@ -462,8 +587,28 @@ export const useMarketStore = create<MarketStore>()(
     },
     
     updateSettings: (newSettings: Partial<LayoutSettings>) => {
-      const { settings } = get();
-      set({ settings: { ...settings, ...newSettings } });
+      const { settings, transport, isConnected, activeSymbols } = get();
+      const next = { ...settings, ...newSettings };
+      set({ settings: next });
+      if (next.renderRate !== settings.renderRate) globalClock.setRenderRate(next.renderRate);
+      
+      const filter = combinedTapeFilter(next);
+      const previous = combinedTapeFilter(settings);
+      if (filter?.minNotional === previous?.minNotional) return;
+      
+      // Back to whole streams: what was built from the filtered ones goes,
+      // and the server resends each symbol's recent tape to start from
+      if (previous && !filter) {
+        for (const symbol of activeSymbols) {
+          resetSymbolAnalytics(transport, symbol);
+          clearSymbolBuffer(symbol);
+          clearSymbolProfile(symbol);
+        }
+      }
+      // Re-sending subscribe for symbols we already have only swaps their filter
+      if (transport && isConnected && activeSymbols.length > 0) {
+        transport.send({ type: 'subscribe', symbols: activeSymbols, filter: filter ?? null });
+      }
     },
     
     /**
@@ -472,21 +617,21 @@ export const useMarketStore = create<MarketStore>()(
     clearTrades: (symbol?: string) => {
       const { symbols } = get();
       
+      // Entries are replaced, not mutated, so only their own selectors fire
       if (symbol) {
         const state = symbols.get(symbol.toUpperCase());
         if (state) {
-          state.trades = [];
-          resetAnalytics(symbol.toUpperCase());
-          set({ symbols: new Map(symbols) });
+          resetSymbolAnalytics(get().transport, state.symbol);
+          set({ symbols: new Map(symbols).set(state.symbol, { ...state, trades: [] }) });
         }
       } else {
-        // Clear all
+        const cleared = new Map<string, SymbolState>();
         for (const state of symbols.values()) {
-          state.trades = [];
-          resetAnalytics(state.symbol);
+          cleared.set(state.symbol, { ...state, trades: [] });
+          resetSymbolAnalytics(get().transport, state.symbol);
         }
         set({
-          symbols: new Map(symbols),
+          symbols: cleared,
           combinedTrades: [],
         });
       }
@@ -494,8 +639,31 @@ export const useMarketStore = create<MarketStore>()(
   }))
 );
 
+// Hidden, the server conflates books and tickers down to HIDDEN_BOOK_MAX_RATE;
+// a subscribe with no symbols changes only the rate. Trades keep coming at
+// full rate so the tape, CVD and stats are whole when the page is shown.
+if (typeof document !== 'undefined') {
+  document.addEventListener('visibilitychange', () => {
+    const { transport, isConnected } = useMarketStore.getState();
+    if (transport && isConnected) {
+      transport.send({ type: 'subscribe', symbols: [], maxRate: bookMaxRate() });
+    }
+  });
+}
+
 /**
- * Asset type is always crypto since we only support Binance
+ * Reset analytics wherever they live - the main-thread cache always, plus
+ * the ingest worker's copy when that's where trades are being enriched
+ */
+function resetSymbolAnalytics(transport: MarketTransport | null, symbol: string): void {
+  resetAnalytics(symbol);
+  if (transport?.kind === 'worker') {
+    transport.resetAnalytics(symbol);
+  }
+}
+
+/**
+ * Asset type is always crypto - every venue we consolidate is a crypto exchange
  */
 function detectAssetType(_symbol: string): AssetType {
   return 'crypto';
@@ -505,14 +673,20 @@ function detectAssetType(_symbol: string): AssetType {
 // Selector Hooks - Extract specific pieces of state for components
 // ============================================================================
 
+// Each of these returns one symbol's entry (or a field of it), and entries
+// are only replaced when that symbol changes - other symbols' updates
+// leave them alone. For live prices and volumes see useSymbolSlice.
 export const useSymbolData = (symbol: string) => 
   useMarketStore((state) => state.symbols.get(symbol.toUpperCase()));
 
 export const useOrderBook = (symbol: string) =>
   useMarketStore((state) => state.symbols.get(symbol.toUpperCase())?.orderBook);
 
+// Shared fallback - a fresh [] per call would never compare equal and re-render every update
+const NO_TRADES: TradeWithAnalytics[] = [];
+
 export const useTrades = (symbol: string) =>
-  useMarketStore((state) => state.symbols.get(symbol.toUpperCase())?.trades || []);
+  useMarketStore((state) => state.symbols.get(symbol.toUpperCase())?.trades ?? NO_TRADES);
 
 export const useIsConnected = () =>
   useMarketStore((state) => state.isConnected);
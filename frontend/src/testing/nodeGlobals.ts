@@ -0,0 +1,9 @@
+// Node stand-ins for the browser globals the app touches on import
+
+// The frame clock starts as soon as something schedules on it; under node
+// there's no rAF to drive it, and the tests call what they need directly
+const g = globalThis as unknown as Record<string, unknown>;
+if (typeof g.requestAnimationFrame !== 'function') {
+  g.requestAnimationFrame = () => 0;
+  g.cancelAnimationFrame = () => {};
+}
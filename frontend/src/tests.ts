@@ -0,0 +1,7 @@
+// Test entry - `npm test` bundles this for node with vite's SSR build and runs it under node:test
+
+// First, so the stand-ins are in place before any app module loads
+import './testing/nodeGlobals';
+
+import './services/sharedTradeRing.test';
+import './utils/calculations.test';
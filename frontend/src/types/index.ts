@@ -35,6 +35,24 @@ export interface OrderBook {
   asks: OrderBookLevel[];
   spread: number;
   spreadPercent: number;
+  seq?: number;
+}
+
+/**
+ * Incremental book update - only changed levels as [price, size], size 0 = removed
+ * 
+ * Applies only if prevSeq matches the last seq we applied. snapshot=true
+ * replaces the whole book (initial state or a server-side resync).
+ */
+export interface OrderBookDelta {
+  symbol: string;
+  assetType: AssetType;
+  timestamp: number;
+  seq: number;
+  prevSeq: number;
+  bids: [number, number][];
+  asks: [number, number][];
+  snapshot?: boolean;
 }
 
 /**
@@ -81,10 +99,16 @@ export interface TradeWithAnalytics extends Trade {
   relativeStrength: number;  // Buy volume as % of total volume
   momentum: number;       // Recent price trend direction
   spreadAtPrint: number;  // Spread at time of trade (if available)
+  backfill?: boolean;     // From the subscribe-time history, not a live print
 }
 
 /**
- * All state we track for a single symbol
+ * What the store keeps for a single symbol
+ * 
+ * Only what changes with subscribe/unsubscribe and the like - entries are
+ * replaced, never mutated, so a selector on one symbol's entry re-renders
+ * only when that entry does. Prices and volumes change with every trade
+ * and live on the symbol's slice instead (services/symbolSlices.ts).
  */
 export interface SymbolState {
   symbol: string;
@@ -94,36 +118,84 @@ export interface SymbolState {
   orderBook: OrderBook | null;
   isLoading: boolean;
   error?: string;
-  
-  // Running analytics
-  vwap: number;
-  totalBuyVolume: number;
-  totalSellVolume: number;
-  delta: number;
-  lastPrice: number;
-  priceChange: number;
-  priceChangePercent: number;
-  highPrice: number;
-  lowPrice: number;
 }
 
+/**
+ * Trade delivery format negotiated with the backend on subscribe
+ */
+export type WireEncoding = 'json' | 'binary';
+
 /**
  * Messages we send to the backend
  */
 export interface ClientMessage {
-  type: 'subscribe' | 'unsubscribe' | 'validate' | 'ping';
+  type: 'subscribe' | 'unsubscribe' | 'validate' | 'ping' | 'resync';
   symbol?: string;
   symbols?: string[];
   assetType?: AssetType;
+  encoding?: WireEncoding;
+  bookDeltas?: boolean;
+  maxRate?: number;     // Cap on book/ticker updates per second per symbol, 0 = all
+  since?: number;       // Newest trade we already have - the server skips older cached ones
+  filter?: TradeFilter | null;  // Server-side trade filter for these symbols, null clears it
+}
+
+/**
+ * Which trades the server sends for a subscription - mirrors the backend's
+ * TradeFilter. 'whale' is the server's per-price whale signal threshold.
+ */
+export interface TradeFilter {
+  minNotional?: number | 'whale';
+  side?: 'buy' | 'sell';
+  sampleRate?: number;  // 0..1, deterministic (every Nth passing trade)
+}
+
+export type SignalType = 'whale' | 'velocity' | 'wall' | 'spoof';
+
+/**
+ * Trading signal detected by the backend signal engine
+ * 
+ * value is USD notional (whale/wall/spoof) or trades/sec (velocity); ratio
+ * is a wall's multiple of the average level size, or a surge's multiple of
+ * the average trade rate.
+ */
+export interface Signal {
+  type: SignalType;
+  symbol: string;
+  timestamp: number;
+  value: number;
+  side?: 'buy' | 'sell';
+  price?: number;
+  ratio?: number;
+}
+
+/**
+ * Trades the server held back while this client was behind, folded into one
+ * record (open/high/low/close over the covered trades)
+ */
+export interface TradeSummary {
+  symbol: string;
+  assetType: AssetType;
+  firstTimestamp: number;
+  lastTimestamp: number;
+  count: number;
+  volume: number;
+  buyVolume: number;
+  sellVolume: number;
+  open: number;
+  high: number;
+  low: number;
+  close: number;
 }
 
 /**
  * Messages we receive from the backend
  */
 export interface ServerMessage {
-  type: 'trade' | 'orderbook' | 'ticker' | 'validation' | 'error' | 'connected' | 'subscribed' | 'unsubscribed' | 'pong';
-  data?: Trade | OrderBook | Ticker | SymbolInfo | SymbolInfo[];
+  type: 'trade' | 'trades' | 'trade_history' | 'trade_summary' | 'orderbook' | 'orderbook_delta' | 'ticker' | 'signal' | 'validation' | 'error' | 'connected' | 'subscribed' | 'unsubscribed' | 'pong';
+  data?: Trade | Trade[] | TradeSummary | OrderBook | OrderBookDelta | Ticker | Signal | SymbolInfo | SymbolInfo[];
   symbol?: string;
+  symbolId?: number;
   error?: string;
   timestamp?: number;
 }
@@ -137,12 +209,29 @@ export interface TabData {
   assetType: AssetType;
 }
 
+/**
+ * How the order book panel draws: DOM levels, canvas depth ladder, a
+ * canvas time-vs-price liquidity heatmap, or traded volume by price
+ * (session profile / footprint bars)
+ */
+export type BookRenderMode = 'levels' | 'ladder' | 'heatmap' | 'profile' | 'footprint';
+
+/**
+ * Frames per second the dashboard paints at - 'auto' drops to 30, then 10,
+ * while frames run over budget and climbs back once they fit
+ */
+export type RenderRateMode = 'auto' | 60 | 30 | 10;
+
 /**
  * User preferences persisted in the store
  */
 export interface LayoutSettings {
   combinedTape: boolean;  // Show all symbols in one tape
+  combinedMinNotional: number | 'whale';  // Smallest print the combined tape shows, 0 = all
   darkMode: boolean;      // Theme (always dark for now)
   pauseScroll: boolean;   // Freeze the tape for inspection
   maxTrades: number;      // How many trades to keep in memory
+  bookView: BookRenderMode;
+  perfHud: boolean;       // Frame/task/parse/latency overlay - timing only runs while it's shown
+  renderRate: RenderRateMode;
 }
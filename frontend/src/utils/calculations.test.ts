@@ -0,0 +1,124 @@
+// Analytics tests - VWAP and CVD come out the same whichever path a trade takes to the tape
+
+import assert from 'node:assert/strict';
+import { beforeEach, describe, it } from 'node:test';
+import { enrichTradeWithAnalytics, getCumulativeDelta, getCurrentVWAP, getRollingStats, resetAllAnalytics } from './calculations';
+import { clearAllBuffers, flushCombinedBuffer, flushTradeBuffer } from '../services/dataBuffer';
+import { createSharedTradeRing, SharedTradeReader, SharedTradeWriter } from '../services/sharedTradeRing';
+import { useMarketStore } from '../stores/useMarketStore';
+import { Trade, TradeSide, TradeWithAnalytics } from '../types';
+
+const SYMBOL = 'BTCUSDT';
+const START = Date.now() - 10_000;
+
+const PRINTS: [number, number, TradeSide][] = [
+  [100, 1, 'buy'],
+  [101, 2, 'sell'],
+  [99, 3, 'buy'],
+  [100, 4, 'neutral'],
+  [102, 0.5, 'sell'],
+];
+
+const TRADES: Trade[] = PRINTS.map(([price, volume, side], i) => ({
+  id: String(i + 1),
+  symbol: SYMBOL,
+  assetType: 'crypto',
+  timestamp: START + i * 1000,
+  price,
+  volume,
+  side,
+}));
+
+// Running session VWAP and CVD after each trade, worked out the long way
+const EXPECTED = (() => {
+  let notional = 0;
+  let volume = 0;
+  let cvd = 0;
+  return TRADES.map(trade => {
+    notional += trade.price * trade.volume;
+    volume += trade.volume;
+    if (trade.side === 'buy') cvd += trade.volume;
+    else if (trade.side === 'sell') cvd -= trade.volume;
+    return { vwap: notional / volume, delta: cvd };
+  });
+})();
+const FINAL = EXPECTED[EXPECTED.length - 1];
+
+function assertClose(actual: number, expected: number, what: string): void {
+  assert.ok(Math.abs(actual - expected) < 1e-9, `${what}: ${actual}, expected ${expected}`);
+}
+
+function assertRows(rows: TradeWithAnalytics[]): void {
+  assert.equal(rows.length, TRADES.length);
+  rows.forEach((row, i) => {
+    assert.equal(row.id, TRADES[i].id);
+    assertClose(row.vwap, EXPECTED[i].vwap, `vwap of trade ${row.id}`);
+    assertClose(row.delta, EXPECTED[i].delta, `delta of trade ${row.id}`);
+  });
+}
+
+function assertSessionStats(): void {
+  const session = getRollingStats(SYMBOL, 'session', START + TRADES.length * 1000);
+  assert.ok(session);
+  assertClose(session.vwap, FINAL.vwap, 'session vwap');
+  assertClose(session.cvd, FINAL.delta, 'session cvd');
+}
+
+function setCombinedTape(combinedTape: boolean): void {
+  const { settings } = useMarketStore.getState();
+  useMarketStore.setState({ settings: { ...settings, combinedTape, combinedMinNotional: 0 } });
+}
+
+function reset(): void {
+  resetAllAnalytics();
+  clearAllBuffers();
+  flushCombinedBuffer();
+}
+
+describe('enrichTradeWithAnalytics', () => {
+  beforeEach(reset);
+
+  it('carries the running session VWAP and CVD on each row', () => {
+    assertRows(TRADES.map(trade => enrichTradeWithAnalytics(trade, null)));
+    assertClose(getCurrentVWAP(SYMBOL), FINAL.vwap, 'current vwap');
+    assertClose(getCumulativeDelta(SYMBOL), FINAL.delta, 'cumulative delta');
+    assertSessionStats();
+  });
+});
+
+for (const combinedTape of [false, true]) describe(`combined tape ${combinedTape ? 'on' : 'off'}`, () => {
+  beforeEach(reset);
+
+  it('main thread: enriches each trade once', () => {
+    setCombinedTape(combinedTape);
+    const { _handleTrade } = useMarketStore.getState();
+    for (const trade of TRADES) _handleTrade(trade);
+
+    assertRows(flushTradeBuffer(SYMBOL).trades);
+    const combined = flushCombinedBuffer().trades;
+    if (combinedTape) assertRows(combined);
+    else assert.equal(combined.length, 0);
+
+    // A second enrichment per trade would have counted every volume twice
+    assertClose(getCumulativeDelta(SYMBOL), FINAL.delta, 'cumulative delta');
+    assertSessionStats();
+  });
+
+  it('ingest worker: rows and main-thread windows match', () => {
+    setCombinedTape(combinedTape);
+    const ring = createSharedTradeRing();
+    const writer = new SharedTradeWriter(ring);
+    for (const trade of TRADES) writer.write(enrichTradeWithAnalytics(trade, null));
+
+    // The worker's analytics live in its own thread - start this side empty
+    resetAllAnalytics();
+    useMarketStore.getState()._handleEnrichedTrades(new SharedTradeReader(ring).read());
+
+    assertRows(flushTradeBuffer(SYMBOL).trades);
+    const combined = flushCombinedBuffer().trades;
+    if (combinedTape) assertRows(combined);
+    else assert.equal(combined.length, 0);
+
+    assertSessionStats();
+  });
+});
@@ -1,20 +1,19 @@
 // Trade analytics - VWAP, momentum, volume stats, and algo signal detection
 
 import { Trade, TradeWithAnalytics, OrderBook } from '../types';
+import { NumberRing } from '../services/ringBuffer';
+import { RollingStats, type RollingWindowKey, type WindowStats } from './rollingStats';
 
-interface VWAPState {
-  numerator: number;   // Sum of (price * volume)
-  denominator: number; // Sum of volume
-}
+const MOMENTUM_PRICES = 20;     // Trades between the two ends of a momentum reading
+const MOMENTUM_SMOOTHING = 10;  // Readings averaged
 
 interface AnalyticsState {
-  vwap: VWAPState;
-  totalBuyVolume: number;
-  totalSellVolume: number;
-  prices: number[];     // Recent prices for momentum
+  rolling: RollingStats;        // 1m / 5m / session VWAP, CVD, volatility, rate
+  prices: NumberRing;           // Recent prices for momentum
+  momentum: NumberRing;         // Recent momentum values
+  momentumSum: number;
   highPrice: number;
   lowPrice: number;
-  momentum: number[];   // Recent momentum values
 }
 
 // Cache outside React - updated on every trade without re-renders
@@ -24,46 +23,31 @@ const analyticsCache = new Map<string, AnalyticsState>();
  * Get or create analytics state for a symbol
  */
 function getState(symbol: string): AnalyticsState {
-  if (!analyticsCache.has(symbol)) {
-    analyticsCache.set(symbol, {
-      vwap: { numerator: 0, denominator: 0 },
-      totalBuyVolume: 0,
-      totalSellVolume: 0,
-      prices: [],
+  let state = analyticsCache.get(symbol);
+  if (!state) {
+    state = {
+      rolling: new RollingStats(),
+      prices: new NumberRing(MOMENTUM_PRICES),
+      momentum: new NumberRing(MOMENTUM_SMOOTHING),
+      momentumSum: 0,
       highPrice: 0,
       lowPrice: Infinity,
-      momentum: [],
-    });
+    };
+    analyticsCache.set(symbol, state);
   }
-  return analyticsCache.get(symbol)!;
+  return state;
 }
 
 /**
- * Calculate VWAP (Volume Weighted Average Price)
- * 
- * VWAP = Sum(Price * Volume) / Sum(Volume)
+ * Get current VWAP without updating
  * 
- * This is a running calculation - each trade updates the cumulative totals.
+ * VWAP = Sum(Price * Volume) / Sum(Volume), cumulative since subscribe.
  * Traders use VWAP to see if they're getting good fills relative to the
  * day's average price.
  */
-export function calculateVWAP(symbol: string, price: number, volume: number): number {
-  const state = getState(symbol);
-  
-  state.vwap.numerator += price * volume;
-  state.vwap.denominator += volume;
-  
-  if (state.vwap.denominator === 0) return price;
-  return state.vwap.numerator / state.vwap.denominator;
-}
-
-/**
- * Get current VWAP without updating
- */
 export function getCurrentVWAP(symbol: string): number {
   const state = analyticsCache.get(symbol);
-  if (!state || state.vwap.denominator === 0) return 0;
-  return state.vwap.numerator / state.vwap.denominator;
+  return state ? state.rolling.windows.session.vwap : 0;
 }
 
 /**
@@ -78,30 +62,14 @@ export function calculateVWAPDrift(currentPrice: number, vwap: number): number {
 }
 
 /**
- * Calculate cumulative delta (buy volume - sell volume)
+ * Get cumulative delta (buy volume - sell volume) without updating
  * 
  * This is one of the most important order flow metrics. Positive delta means
  * more aggressive buying, negative means more aggressive selling.
  */
-export function calculateDelta(symbol: string, side: string, volume: number): number {
-  const state = getState(symbol);
-  
-  if (side === 'buy') {
-    state.totalBuyVolume += volume;
-  } else if (side === 'sell') {
-    state.totalSellVolume += volume;
-  }
-  
-  return state.totalBuyVolume - state.totalSellVolume;
-}
-
-/**
- * Get cumulative delta without updating
- */
 export function getCumulativeDelta(symbol: string): number {
   const state = analyticsCache.get(symbol);
-  if (!state) return 0;
-  return state.totalBuyVolume - state.totalSellVolume;
+  return state ? state.rolling.windows.session.cvd : 0;
 }
 
 /**
@@ -113,43 +81,55 @@ export function getCumulativeDelta(symbol: string): number {
  */
 export function calculateRelativeStrength(symbol: string): number {
   const state = analyticsCache.get(symbol);
-  if (!state) return 50;
-  
-  const total = state.totalBuyVolume + state.totalSellVolume;
-  if (total === 0) return 50;
-  
-  return (state.totalBuyVolume / total) * 100;
+  return state ? state.rolling.windows.session.buyRatio : 50;
+}
+
+/**
+ * Windowed VWAP, CVD, realized volatility, buy/sell ratio and trade rate
+ * 
+ * Maintained incrementally as trades are enriched, so reading any window
+ * for any symbol is O(1).
+ */
+export function getRollingStats(symbol: string, window: RollingWindowKey, now?: number): WindowStats | null {
+  const state = analyticsCache.get(symbol);
+  return state ? state.rolling.stats(window, now) : null;
+}
+
+/**
+ * Feed a trade enriched elsewhere (the ingest worker) into this thread's
+ * rolling windows, so getRollingStats works on the main thread either way
+ */
+export function recordRollingStats(trade: Trade): void {
+  getState(trade.symbol).rolling.add(trade.timestamp, trade.price, trade.volume, trade.side);
 }
 
 /**
  * Calculate momentum from recent price changes
  * 
  * Uses a 20-trade window to smooth out noise. Positive = trending up.
+ * Both windows are rings with a running sum, so this is O(1) per trade.
  */
 export function calculateMomentum(symbol: string, price: number): number {
   const state = getState(symbol);
+  const prices = state.prices;
   
-  state.prices.push(price);
-  
-  // Keep last 20 prices
-  if (state.prices.length > 20) {
-    state.prices.shift();
-  }
-  
-  if (state.prices.length < 2) return 0;
+  prices.push(price);
+  if (prices.length < 2) return 0;
   
   // Momentum = % change from oldest to newest
-  const oldPrice = state.prices[0];
+  const oldPrice = prices.get(0);
   const momentum = ((price - oldPrice) / oldPrice) * 100;
   
   // Keep momentum history for averaging
-  state.momentum.push(momentum);
-  if (state.momentum.length > 10) {
-    state.momentum.shift();
+  const history = state.momentum;
+  if (history.length === history.capacity) {
+    state.momentumSum -= history.get(0);
   }
+  history.push(momentum);
+  state.momentumSum += momentum;
   
   // Return average momentum
-  return state.momentum.reduce((a, b) => a + b, 0) / state.momentum.length;
+  return state.momentumSum / history.length;
 }
 
 /**
@@ -188,22 +168,34 @@ export function getSpreadAtPrint(orderBook: OrderBook | null): number {
   return orderBook.spread;
 }
 
+/**
+ * Smallest print that counts as a whale at this price - mirrors the
+ * backend's whale signal threshold
+ */
+export function whaleMinFor(price: number): number {
+  return price >= 50000 ? 250000 : 50000;
+}
+
 /**
  * Enrich a raw trade with computed analytics
  * 
- * This is called on every incoming trade. We compute VWAP, delta, momentum,
- * etc. and attach them to the trade object for display.
+ * This is called on every incoming trade. We advance the rolling windows,
+ * compute VWAP, delta, momentum, etc. and attach them to the trade object
+ * for display.
  */
 export function enrichTradeWithAnalytics(
   trade: Trade,
   orderBook: OrderBook | null
 ): TradeWithAnalytics {
-  const { symbol, price, volume, side } = trade;
+  const { symbol, price, volume, side, timestamp } = trade;
+  const rolling = getState(symbol).rolling;
+  rolling.add(timestamp, price, volume, side);
+  const session = rolling.windows.session;
   
-  const vwap = calculateVWAP(symbol, price, volume);
+  const vwap = session.vwap || price;
   const vwapDrift = calculateVWAPDrift(price, vwap);
-  const delta = calculateDelta(symbol, side, volume);
-  const relativeStrength = calculateRelativeStrength(symbol);
+  const delta = session.cvd;
+  const relativeStrength = session.buyRatio;
   const momentum = calculateMomentum(symbol, price);
   const spreadAtPrint = getSpreadAtPrint(orderBook);
   
@@ -220,6 +212,68 @@ export function enrichTradeWithAnalytics(
   };
 }
 
+/**
+ * Enrich one symbol's subscribe-time history (oldest first) in a single sweep
+ * 
+ * Gives the same rows enrichTradeWithAnalytics would one call at a time -
+ * each row's VWAP/CVD depends on everything before it, so the rolling
+ * windows still see every trade - but the symbol's state is looked up
+ * once, momentum and high/low run in locals and are written back at the
+ * end. There's no book for prints from before we subscribed, so
+ * spreadAtPrint is 0.
+ */
+export function enrichTradeHistory(trades: Trade[]): TradeWithAnalytics[] {
+  const enriched: TradeWithAnalytics[] = new Array(trades.length);
+  if (trades.length === 0) return enriched;
+  
+  const state = getState(trades[0].symbol);
+  const { rolling, prices, momentum: momentumHistory } = state;
+  const session = rolling.windows.session;
+  let momentumSum = state.momentumSum;
+  let high = state.highPrice;
+  let low = state.lowPrice;
+  
+  for (let i = 0; i < trades.length; i++) {
+    const trade = trades[i];
+    const { price, volume, side, timestamp } = trade;
+    rolling.add(timestamp, price, volume, side);
+    const vwap = session.vwap || price;
+    
+    // Same rings as calculateMomentum
+    prices.push(price);
+    let momentum = 0;
+    if (prices.length >= 2) {
+      const oldPrice = prices.get(0);
+      const reading = ((price - oldPrice) / oldPrice) * 100;
+      if (momentumHistory.length === momentumHistory.capacity) {
+        momentumSum -= momentumHistory.get(0);
+      }
+      momentumHistory.push(reading);
+      momentumSum += reading;
+      momentum = momentumSum / momentumHistory.length;
+    }
+    
+    if (price > high) high = price;
+    if (price < low) low = price;
+    
+    enriched[i] = {
+      ...trade,
+      vwap,
+      vwapDrift: calculateVWAPDrift(price, vwap),
+      delta: session.cvd,
+      relativeStrength: session.buyRatio,
+      momentum,
+      spreadAtPrint: 0,
+      backfill: true,
+    };
+  }
+  
+  state.momentumSum = momentumSum;
+  state.highPrice = high;
+  state.lowPrice = low;
+  return enriched;
+}
+
 /**
  * Reset analytics for a symbol (on unsubscribe)
  */
@@ -245,8 +299,17 @@ export function calculateOrderBookImbalance(orderBook: OrderBook): number {
   
   const bidVolume = orderBook.bids.reduce((sum, level) => sum + level.size, 0);
   const askVolume = orderBook.asks.reduce((sum, level) => sum + level.size, 0);
+  return calculateImbalance(bidVolume, askVolume);
+}
+
+/**
+ * Imbalance from already-summed side volumes (-100 to +100)
+ * 
+ * The incremental book keeps running volumes, so it calls this directly
+ * instead of re-reducing the levels.
+ */
+export function calculateImbalance(bidVolume: number, askVolume: number): number {
   const total = bidVolume + askVolume;
-  
   if (total === 0) return 0;
   return ((bidVolume - askVolume) / total) * 100;
 }
@@ -0,0 +1,135 @@
+// Formatting caches - memoized number strings and incremental timestamps for per-frame cell writes
+
+import { formatOrderBookSize, formatPrice } from './formatters';
+
+const DEFAULT_MAX_ENTRIES = 4096;
+
+/**
+ * A formatter memoized on the value it's given
+ *
+ * Prices on a tick grid and book sizes at a level repeat frame after frame,
+ * so most calls become one Map lookup that hands back a string already in
+ * memory - no toFixed, no garbage. quantize maps a value to the one the
+ * output depends on (e.g. rounded to what's displayed), so values that
+ * would print the same share an entry; without it the value itself is the
+ * key, which is exact.
+ *
+ * When the cache is full it's dropped wholesale rather than kept in LRU
+ * order - refilling from the values on screen is cheap, bookkeeping on
+ * every hit isn't.
+ */
+export class FormatCache {
+  private entries: Map<number, string> = new Map();
+
+  constructor(
+    private readonly format: (value: number) => string,
+    private readonly quantize?: (value: number) => number,
+    private readonly maxEntries: number = DEFAULT_MAX_ENTRIES
+  ) {}
+
+  get(value: number): string {
+    const key = this.quantize ? this.quantize(value) : value;
+    let text = this.entries.get(key);
+    if (text === undefined) {
+      text = this.format(key);
+      if (this.entries.size >= this.maxEntries) this.entries.clear();
+      this.entries.set(key, text);
+    }
+    return text;
+  }
+
+  clear(): void {
+    this.entries.clear();
+  }
+
+  get size(): number {
+    return this.entries.size;
+  }
+}
+
+/**
+ * Round to what a $x.xxM / $x.xxK / $x.xx label shows
+ *
+ * Amounts are price * size and rarely repeat exactly, but they do once
+ * they're rounded to the displayed precision.
+ */
+export function quantizeCompact(value: number): number {
+  const abs = Math.abs(value);
+  if (abs >= 1_000_000) return Math.round(value / 10_000) * 10_000;
+  if (abs >= 1_000) return Math.round(value / 10) * 10;
+  return Math.round(value * 100) / 100;
+}
+
+/**
+ * Round a price to the decimals formatPrice shows for its magnitude
+ *
+ * For values like VWAP that drift continuously instead of sitting on a tick.
+ */
+export function quantizePrice(value: number): number {
+  const abs = Math.abs(value);
+  if (abs >= 100) return Math.round(value * 100) / 100;
+  if (abs >= 1) return Math.round(value * 10_000) / 10_000;
+  if (abs >= 0.01) return Math.round(value * 1_000_000) / 1_000_000;
+  return Math.round(value * 100_000_000) / 100_000_000;
+}
+
+export interface TimeParts {
+  hours: string;
+  minutes: string;
+  seconds: string;
+  milliseconds: string;
+  full: string;
+}
+
+// '000'..'999', so the millisecond part is a lookup
+const MILLISECONDS: string[] = Array.from({ length: 1000 }, (_, ms) => ms.toString().padStart(3, '0'));
+
+/**
+ * HH:MM:SS.mmm in local time, rebuilt only when the second changes
+ *
+ * Within a second only the milliseconds move: the date fields, their
+ * padding and the 'HH:MM:SS.' prefix are kept from the last call, and the
+ * milliseconds come from a table. Timestamps that flip back and forth
+ * across a second boundary (a tape of mixed symbols) cost a Date each flip;
+ * time going forward, the usual case, costs one per second.
+ */
+export class TimeFormatter {
+  private second = NaN;
+  private hours = '00';
+  private minutes = '00';
+  private seconds = '00';
+  private prefix = '00:00:00.';
+
+  format(timestamp: number): string {
+    if (!timestamp) return '-';
+    this.advance(timestamp);
+    return this.prefix + MILLISECONDS[(timestamp - this.second * 1000) | 0];
+  }
+
+  parts(timestamp: number): TimeParts {
+    this.advance(timestamp);
+    const milliseconds = MILLISECONDS[(timestamp - this.second * 1000) | 0];
+    return {
+      hours: this.hours,
+      minutes: this.minutes,
+      seconds: this.seconds,
+      milliseconds,
+      full: this.prefix + milliseconds,
+    };
+  }
+
+  private advance(timestamp: number): void {
+    const second = Math.floor(timestamp / 1000);
+    if (second === this.second) return;
+    this.second = second;
+    const date = new Date(second * 1000);
+    this.hours = MILLISECONDS[date.getHours()].slice(1);
+    this.minutes = MILLISECONDS[date.getMinutes()].slice(1);
+    this.seconds = MILLISECONDS[date.getSeconds()].slice(1);
+    this.prefix = `${this.hours}:${this.minutes}:${this.seconds}.`;
+  }
+}
+
+// Shared by the tape, the book and the profile axes - the same prices show up in all three
+export const priceCache = new FormatCache(price => formatPrice(price));
+export const bookSizeCache = new FormatCache(formatOrderBookSize);
@@ -0,0 +1,234 @@
+// Rolling-window trade statistics - O(1) per trade via running sums over time buckets
+
+import type { TradeSide } from '../types';
+
+export type RollingWindowKey = '1m' | '5m' | 'session';
+
+export const ROLLING_WINDOW_MS: Record<RollingWindowKey, number> = {
+  '1m': 60_000,
+  '5m': 300_000,
+  session: Infinity,
+};
+
+// Window edges move in whole buckets - a 1m window is 60 one-second buckets
+const BUCKET_MS = 1000;
+
+export interface WindowStats {
+  vwap: number;
+  cvd: number;            // Buy volume - sell volume inside the window
+  volume: number;
+  buyRatio: number;       // Buy volume as % of buy + sell (50 when empty)
+  realizedVol: number;    // sqrt(sum of squared log returns), in %
+  tradeRate: number;      // Trades/sec over the part of the window we've seen
+  trades: number;
+}
+
+/**
+ * Statistics over the trailing windowMs of trades
+ *
+ * Trades land in per-second buckets held as parallel Float64Arrays in a
+ * ring; the window's totals are running sums. Adding a trade touches one
+ * bucket, and moving into a new second subtracts the buckets that fell out
+ * (each bucket is evicted once, so that's O(1) amortized). The sums are
+ * re-added from the buckets every time the ring wraps, so floating-point
+ * drift from the add/subtract pairs can't build up.
+ *
+ * windowMs = Infinity is the session window: no buckets, just the sums.
+ */
+export class RollingWindow {
+  private readonly buckets: number;
+  private readonly notional: Float64Array;
+  private readonly volume: Float64Array;
+  private readonly buyVolume: Float64Array;
+  private readonly sellVolume: Float64Array;
+  private readonly count: Float64Array;
+  private readonly sqReturns: Float64Array;
+
+  private currentBucket = -1;
+  private firstTimestamp = 0;
+  private lastTimestamp = 0;
+
+  private sumNotional = 0;
+  private sumVolume = 0;
+  private sumBuy = 0;
+  private sumSell = 0;
+  private sumCount = 0;
+  private sumSqReturns = 0;
+
+  constructor(readonly windowMs: number) {
+    this.buckets = Number.isFinite(windowMs) ? Math.max(1, Math.ceil(windowMs / BUCKET_MS)) : 0;
+    this.notional = new Float64Array(this.buckets);
+    this.volume = new Float64Array(this.buckets);
+    this.buyVolume = new Float64Array(this.buckets);
+    this.sellVolume = new Float64Array(this.buckets);
+    this.count = new Float64Array(this.buckets);
+    this.sqReturns = new Float64Array(this.buckets);
+  }
+
+  /**
+   * Add one trade. sqReturn is the squared log return from the previous
+   * trade's price (0 for the first one).
+   */
+  add(timestamp: number, price: number, volume: number, side: TradeSide, sqReturn: number): void {
+    if (this.firstTimestamp === 0) this.firstTimestamp = timestamp;
+    if (timestamp > this.lastTimestamp) this.lastTimestamp = timestamp;
+
+    const notional = price * volume;
+    const buy = side === 'buy' ? volume : 0;
+    const sell = side === 'sell' ? volume : 0;
+
+    // Expire first - clearing or re-summing after the sums were bumped would lose this trade
+    this.advance(timestamp);
+
+    this.sumNotional += notional;
+    this.sumVolume += volume;
+    this.sumBuy += buy;
+    this.sumSell += sell;
+    this.sumCount++;
+    this.sumSqReturns += sqReturn;
+
+    if (this.buckets === 0) return;
+
+    // Late prints count toward the current bucket rather than reopening an old one
+    const slot = this.currentBucket % this.buckets;
+    this.notional[slot] += notional;
+    this.volume[slot] += volume;
+    this.buyVolume[slot] += buy;
+    this.sellVolume[slot] += sell;
+    this.count[slot]++;
+    this.sqReturns[slot] += sqReturn;
+  }
+
+  /**
+   * Drop whatever has fallen out of the window as of `now`
+   */
+  advance(now: number): void {
+    if (this.buckets === 0) return;
+    const bucket = Math.floor(now / BUCKET_MS);
+    if (bucket <= this.currentBucket) return;
+
+    if (this.currentBucket < 0 || bucket - this.currentBucket >= this.buckets) {
+      // First trade, or the whole window expired
+      this.clearBuckets();
+      this.currentBucket = bucket;
+      return;
+    }
+
+    while (this.currentBucket < bucket) {
+      this.currentBucket++;
+      const slot = this.currentBucket % this.buckets;
+      this.sumNotional -= this.notional[slot];
+      this.sumVolume -= this.volume[slot];
+      this.sumBuy -= this.buyVolume[slot];
+      this.sumSell -= this.sellVolume[slot];
+      this.sumCount -= this.count[slot];
+      this.sumSqReturns -= this.sqReturns[slot];
+      this.notional[slot] = 0;
+      this.volume[slot] = 0;
+      this.buyVolume[slot] = 0;
+      this.sellVolume[slot] = 0;
+      this.count[slot] = 0;
+      this.sqReturns[slot] = 0;
+      if (slot === 0) this.resum();
+    }
+  }
+
+  stats(): WindowStats {
+    const sideVolume = this.sumBuy + this.sumSell;
+    const spanMs = Number.isFinite(this.windowMs)
+      ? Math.min(this.windowMs, this.lastTimestamp - this.firstTimestamp + BUCKET_MS)
+      : this.lastTimestamp - this.firstTimestamp + BUCKET_MS;
+    return {
+      vwap: this.sumVolume > 0 ? this.sumNotional / this.sumVolume : 0,
+      cvd: this.sumBuy - this.sumSell,
+      volume: this.sumVolume,
+      buyRatio: sideVolume > 0 ? (this.sumBuy / sideVolume) * 100 : 50,
+      realizedVol: Math.sqrt(Math.max(this.sumSqReturns, 0)) * 100,
+      tradeRate: this.sumCount > 0 ? (this.sumCount * 1000) / spanMs : 0,
+      trades: Math.round(this.sumCount),
+    };
+  }
+
+  /**
+   * Session totals, read without building a stats object (enrichment hot path)
+   */
+  get vwap(): number {
+    return this.sumVolume > 0 ? this.sumNotional / this.sumVolume : 0;
+  }
+
+  get cvd(): number {
+    return this.sumBuy - this.sumSell;
+  }
+
+  get buyRatio(): number {
+    const sideVolume = this.sumBuy + this.sumSell;
+    return sideVolume > 0 ? (this.sumBuy / sideVolume) * 100 : 50;
+  }
+
+  private resum(): void {
+    let notional = 0, volume = 0, buy = 0, sell = 0, count = 0, sq = 0;
+    for (let i = 0; i < this.buckets; i++) {
+      notional += this.notional[i];
+      volume += this.volume[i];
+      buy += this.buyVolume[i];
+      sell += this.sellVolume[i];
+      count += this.count[i];
+      sq += this.sqReturns[i];
+    }
+    this.sumNotional = notional;
+    this.sumVolume = volume;
+    this.sumBuy = buy;
+    this.sumSell = sell;
+    this.sumCount = count;
+    this.sumSqReturns = sq;
+  }
+
+  private clearBuckets(): void {
+    this.notional.fill(0);
+    this.volume.fill(0);
+    this.buyVolume.fill(0);
+    this.sellVolume.fill(0);
+    this.count.fill(0);
+    this.sqReturns.fill(0);
+    this.sumNotional = 0;
+    this.sumVolume = 0;
+    this.sumBuy = 0;
+    this.sumSell = 0;
+    this.sumCount = 0;
+    this.sumSqReturns = 0;
+  }
+}
+
+/**
+ * The standard set of windows for one symbol
+ */
+export class RollingStats {
+  readonly windows: Record<RollingWindowKey, RollingWindow> = {
+    '1m': new RollingWindow(ROLLING_WINDOW_MS['1m']),
+    '5m': new RollingWindow(ROLLING_WINDOW_MS['5m']),
+    session: new RollingWindow(ROLLING_WINDOW_MS.session),
+  };
+  private lastPrice = 0;
+
+  add(timestamp: number, price: number, volume: number, side: TradeSide): void {
+    let sqReturn = 0;
+    if (this.lastPrice > 0 && price > 0) {
+      const r = Math.log(price / this.lastPrice);
+      sqReturn = r * r;
+    }
+    if (price > 0) this.lastPrice = price;
+
+    this.windows['1m'].add(timestamp, price, volume, side, sqReturn);
+    this.windows['5m'].add(timestamp, price, volume, side, sqReturn);
+    this.windows.session.add(timestamp, price, volume, side, sqReturn);
+  }
+
+  /**
+   * Stats for one window, expiring anything older than `now` first
+   */
+  stats(window: RollingWindowKey, now: number = Date.now()): WindowStats {
+    const w = this.windows[window];
+    w.advance(now);
+    return w.stats();
+  }
+}
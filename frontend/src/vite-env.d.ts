@@ -3,6 +3,8 @@
 interface ImportMetaEnv {
   readonly VITE_WS_URL: string;
   readonly VITE_API_URL: string;
+  readonly VITE_WIRE_ENCODING?: 'json' | 'binary';
+  readonly VITE_INGEST_WORKER?: 'on' | 'off';
 }
 
 interface ImportMeta {
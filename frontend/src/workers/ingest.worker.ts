@@ -0,0 +1,209 @@
+// Ingest worker - owns the WebSocket, parses and enriches trades off the main thread
+
+import type { ClientMessage, OrderBook, OrderBookDelta, ServerMessage, Trade, TradeWithAnalytics } from '../types';
+import { decodeTradeFrame, isHistoryFrame, registerSymbolId } from '../services/binaryProtocol';
+import { SharedTradeWriter } from '../services/sharedTradeRing';
+import { LocalOrderBook } from '../services/localOrderBook';
+import { enrichTradeHistory, enrichTradeWithAnalytics, resetAnalytics, resetAllAnalytics } from '../utils/calculations';
+
+/**
+ * Commands from the main thread
+ */
+export type WorkerCommand =
+  | { kind: 'init'; ring: SharedArrayBuffer }
+  | { kind: 'connect'; connectionId: number; url: string; encoding?: ClientMessage['encoding'] }
+  | { kind: 'disconnect' }
+  | { kind: 'send'; message: ClientMessage }
+  | { kind: 'resetAnalytics'; symbol?: string }
+  | { kind: 'perf'; enabled: boolean };
+
+/**
+ * Events back to the main thread (trades go through the shared ring instead,
+ * except those of symbols the ring has no slot for - see SharedTradeWriter)
+ */
+export type WorkerEvent =
+  | { kind: 'open'; connectionId: number }
+  | { kind: 'close'; connectionId: number }
+  | { kind: 'error'; connectionId: number }
+  | { kind: 'message'; connectionId: number; message: ServerMessage }
+  | { kind: 'parse'; connectionId: number; messages: number; totalMs: number }
+  | { kind: 'trades'; connectionId: number; trades: TradeWithAnalytics[] };
+
+let writer: SharedTradeWriter | null = null;
+let ws: WebSocket | null = null;
+let activeConnectionId = 0;
+
+// Decode time, summed and posted once a second while the perf HUD is open
+const PARSE_REPORT_MS = 1000;
+let parseTiming: ReturnType<typeof setInterval> | null = null;
+let parseMessages = 0;
+let parseMs = 0;
+
+// Our own copy of each book so enrichment can record the spread at print
+// time. Gaps are left to the main thread, which requests the resync.
+const latestBooks = new Map<string, LocalOrderBook>();
+
+function getBook(symbol: string): LocalOrderBook {
+  const key = symbol.toUpperCase();
+  let book = latestBooks.get(key);
+  if (!book) {
+    book = new LocalOrderBook(key);
+    latestBooks.set(key, book);
+  }
+  return book;
+}
+
+function post(event: WorkerEvent): void {
+  self.postMessage(event);
+}
+
+/**
+ * Write enriched trades to the ring, posting any it can't take
+ */
+function writeTrades(enriched: TradeWithAnalytics[]): void {
+  if (!writer) return;
+  let unwritten: TradeWithAnalytics[] | null = null;
+  for (let i = 0; i < enriched.length; i++) {
+    if (writer.write(enriched[i])) continue;
+    if (!unwritten) unwritten = [];
+    unwritten.push(enriched[i]);
+  }
+  if (unwritten) post({ kind: 'trades', connectionId: activeConnectionId, trades: unwritten });
+}
+
+function ingestTrades(trades: Trade[]): void {
+  if (!writer) return;
+  const enriched: TradeWithAnalytics[] = new Array(trades.length);
+  for (let i = 0; i < trades.length; i++) {
+    const trade = trades[i];
+    const book = latestBooks.get(trade.symbol.toUpperCase());
+    enriched[i] = enrichTradeWithAnalytics(trade, book?.synced ? book.toOrderBook() : null);
+  }
+  writeTrades(enriched);
+}
+
+/**
+ * Subscribe-time history - enriched in one sweep and marked as backfill, so
+ * the main thread keeps it out of the rate/latency trackers
+ */
+function ingestHistory(trades: Trade[]): void {
+  if (!writer) return;
+  writeTrades(enrichTradeHistory(trades));
+}
+
+function recordParse(start: number): void {
+  if (!parseTiming) return;
+  parseMs += performance.now() - start;
+  parseMessages++;
+}
+
+function setParseTiming(enabled: boolean): void {
+  if (parseTiming) clearInterval(parseTiming);
+  parseTiming = null;
+  parseMessages = 0;
+  parseMs = 0;
+  if (!enabled) return;
+  parseTiming = setInterval(() => {
+    post({ kind: 'parse', connectionId: activeConnectionId, messages: parseMessages, totalMs: parseMs });
+    parseMessages = 0;
+    parseMs = 0;
+  }, PARSE_REPORT_MS);
+}
+
+function handleSocketMessage(data: unknown, connectionId: number): void {
+  const start = performance.now();
+  if (data instanceof ArrayBuffer) {
+    const trades = decodeTradeFrame(data);
+    recordParse(start);
+    if (isHistoryFrame(data)) ingestHistory(trades);
+    else ingestTrades(trades);
+    return;
+  }
+
+  try {
+    const message: ServerMessage = JSON.parse(data as string);
+    recordParse(start);
+    switch (message.type) {
+      case 'trade':
+        if (message.data) ingestTrades([message.data as Trade]);
+        return;
+      case 'trades':
+        if (Array.isArray(message.data)) ingestTrades(message.data as Trade[]);
+        return;
+      case 'trade_history':
+        if (Array.isArray(message.data)) ingestHistory(message.data as Trade[]);
+        return;
+      case 'orderbook':
+        if (message.data) {
+          const orderBook = message.data as OrderBook;
+          getBook(orderBook.symbol).applyOrderBook(orderBook);
+        }
+        break;
+      case 'orderbook_delta':
+        if (message.data) {
+          const delta = message.data as OrderBookDelta;
+          getBook(delta.symbol).applyDelta(delta);
+        }
+        break;
+      case 'subscribed':
+        if (message.symbol && message.symbolId !== undefined) {
+          registerSymbolId(message.symbolId, message.symbol);
+        }
+        break;
+    }
+    post({ kind: 'message', connectionId, message });
+  } catch (error) {
+    console.error('[ingest] Error parsing message:', error);
+  }
+}
+
+function connect(url: string, connectionId: number): void {
+  if (ws) {
+    ws.onclose = null;
+    ws.close();
+  }
+
+  const socket = new WebSocket(url);
+  socket.binaryType = 'arraybuffer';
+  ws = socket;
+  activeConnectionId = connectionId;
+
+  socket.onopen = () => post({ kind: 'open', connectionId });
+  socket.onerror = () => post({ kind: 'error', connectionId });
+  socket.onclose = () => {
+    if (ws === socket) ws = null;
+    post({ kind: 'close', connectionId });
+  };
+  socket.onmessage = (event) => handleSocketMessage(event.data, connectionId);
+}
+
+self.onmessage = (event: MessageEvent<WorkerCommand>) => {
+  const command = event.data;
+  switch (command.kind) {
+    case 'init':
+      writer = new SharedTradeWriter(command.ring);
+      break;
+    case 'connect':
+      connect(command.url, command.connectionId);
+      break;
+    case 'disconnect':
+      ws?.close();
+      break;
+    case 'send':
+      if (ws && ws.readyState === WebSocket.OPEN) {
+        ws.send(JSON.stringify(command.message));
+      }
+      break;
+    case 'perf':
+      setParseTiming(command.enabled);
+      break;
+    case 'resetAnalytics':
+      // Books stay - they're kept in sync by deltas and can't be rebuilt locally
+      if (command.symbol) {
+        resetAnalytics(command.symbol);
+      } else {
+        resetAllAnalytics();
+      }
+      break;
+  }
+};
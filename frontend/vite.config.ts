@@ -2,6 +2,13 @@ import { defineConfig } from 'vite';
 import react from '@vitejs/plugin-react';
 import path from 'path';
 
+// Cross-origin isolation unlocks SharedArrayBuffer, which the ingest worker
+// uses to hand trades to the main thread without structured-clone copies
+const crossOriginIsolationHeaders = {
+  'Cross-Origin-Opener-Policy': 'same-origin',
+  'Cross-Origin-Embedder-Policy': 'require-corp',
+};
+
 export default defineConfig({
   plugins: [react()],
   resolve: {
@@ -11,6 +18,7 @@ export default defineConfig({
   },
   server: {
     port: 5173,
+    headers: crossOriginIsolationHeaders,
     proxy: {
       '/api': {
         target: 'http://localhost:3001',
@@ -22,6 +30,12 @@ export default defineConfig({
       },
     },
   },
+  preview: {
+    headers: crossOriginIsolationHeaders,
+  },
+  worker: {
+    format: 'es',
+  },
   build: {
     outDir: 'dist',
     sourcemap: true,